@@ -236,6 +236,33 @@ struct ObjectKey {
   }
 };
 
+/* Instance Source Key
+ *
+ * Identifies an instanced object together with the object that instances it, ignoring the
+ * persistent instance ID. Used to share settings between all instances. */
+
+struct InstanceSourceKey {
+  void *parent;
+  void *ob;
+  bool use_particle_hair;
+
+  InstanceSourceKey(void *parent_, void *ob_, bool use_particle_hair_)
+      : parent(parent_), ob(ob_), use_particle_hair(use_particle_hair_)
+  {
+  }
+
+  bool operator<(const InstanceSourceKey &k) const
+  {
+    if (ob != k.ob) {
+      return ob < k.ob;
+    }
+    if (parent != k.parent) {
+      return parent < k.parent;
+    }
+    return use_particle_hair < k.use_particle_hair;
+  }
+};
+
 /* Geometry Key
  *
  * We export separate geometry for a mesh and its particle hair, so key needs to
@@ -96,7 +96,21 @@ bool BlenderSync::object_is_light(BL::Object &b_ob)
   return (b_ob_data && b_ob_data.is_a(&RNA_Light));
 }
 
-void BlenderSync::sync_object_motion_init(BL::Object &b_parent, BL::Object &b_ob, Object *object)
+static bool object_attributes_equal(const vector<ParamValue> &a, const vector<ParamValue> &b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].name() != b[i].name() || a[i].datasize() != b[i].datasize() ||
+        memcmp(a[i].data(), b[i].data(), a[i].datasize()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BlenderSync::sync_object_motion_init(const InstanceSourceData &source, Object *object)
 {
   /* Initialize motion blur for object, detecting if it's enabled and creating motion
    * steps array if so. */
@@ -115,9 +129,9 @@ void BlenderSync::sync_object_motion_init(BL::Object &b_parent, BL::Object &b_ob
   uint motion_steps;
 
   if (need_motion == Scene::MOTION_BLUR) {
-    motion_steps = object_motion_steps(b_parent, b_ob, Object::MAX_MOTION_STEPS);
+    motion_steps = source.motion_steps;
     geom->set_motion_steps(motion_steps);
-    if (motion_steps && object_use_deform_motion(b_parent, b_ob)) {
+    if (source.use_deform_motion) {
       geom->set_use_motion_blur(true);
     }
   }
@@ -197,35 +211,37 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
     return NULL;
   }
 
-  /* Visibility flags for both parent and child. */
-  PointerRNA cobject = RNA_pointer_get(&b_ob.ptr, "cycles");
-  bool use_holdout = get_boolean(cobject, "is_holdout") ||
-                     b_parent.holdout_get(PointerRNA_NULL, b_view_layer);
-  uint visibility = object_ray_visibility(b_ob) & PATH_RAY_ALL_VISIBILITY;
-
-  if (b_parent.ptr.data != b_ob.ptr.data) {
-    visibility &= object_ray_visibility(b_parent);
-  }
-
-  /* TODO: make holdout objects on excluded layer invisible for non-camera rays. */
-#if 0
-  if (use_holdout && (layer_flag & view_layer.exclude_layer)) {
-    visibility &= ~(PATH_RAY_ALL_VISIBILITY - PATH_RAY_CAMERA);
-  }
-#endif
-
-  /* Clear camera visibility for indirect only objects. */
-  bool use_indirect_only = !use_holdout &&
-                           b_parent.indirect_only_get(PointerRNA_NULL, b_view_layer);
-  if (use_indirect_only) {
-    visibility &= ~PATH_RAY_CAMERA;
+  /* Settings shared by all instances of the object, only looked up for the first instance. */
+  InstanceSourceKey source_key(b_parent.ptr.data, b_ob_instance.ptr.data, use_particle_hair);
+  auto source_it = instance_sources.find(source_key);
+  if (source_it == instance_sources.end()) {
+    source_it = instance_sources
+                    .insert(std::make_pair(source_key,
+                                           sync_instance_source(b_view_layer, b_ob, b_parent)))
+                    .first;
   }
+  InstanceSourceData &source = source_it->second;
 
   /* Don't export completely invisible objects. */
-  if (visibility == 0) {
+  if (source.visibility == 0) {
     return NULL;
   }
 
+  /* Instances without motion blur or particle data all go into a single object per source,
+   * so they only cost an entry in its instance arrays. */
+  if (is_instance && !b_instance.particle_system() &&
+      scene->need_motion() == Scene::MOTION_NONE) {
+    return sync_object_instance(b_depsgraph,
+                                b_instance,
+                                b_ob,
+                                b_parent,
+                                b_ob_instance,
+                                source_key,
+                                source,
+                                tfm,
+                                use_particle_hair);
+  }
+
   /* Use task pool only for non-instances, since sync_dupli_particle accesses
    * geometry. This restriction should be removed for better performance. */
   TaskPool *object_geom_task_pool = (is_instance) ? NULL : geom_task_pool;
@@ -268,53 +284,58 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
   /* b_ob is owned by the iterator and will go out of scope at the end of the block.
    * b_ob_instance is the original object and will remain valid for deferred geometry
    * sync. */
-  Geometry *geometry = sync_geometry(b_depsgraph,
-                                     b_ob_instance,
-                                     b_ob_instance,
-                                     object_updated,
-                                     use_particle_hair,
-                                     object_geom_task_pool);
+  Geometry *geometry = source.geometry;
+  if (geometry == NULL || geometry_synced.find(geometry) == geometry_synced.end()) {
+    geometry = sync_geometry(b_depsgraph,
+                             b_ob_instance,
+                             b_ob_instance,
+                             object_updated,
+                             use_particle_hair,
+                             object_geom_task_pool);
+    source.geometry = geometry;
+  }
   object->set_geometry(geometry);
 
   /* special case not tracked by object update flags */
 
-  if (sync_object_attributes(b_instance, object)) {
-    object_updated = true;
+  /* Attribute values only differ between instances of a source for particle system instances,
+   * other instances copy the values of the first one. */
+  const bool use_source_attributes = !(is_instance && b_instance.particle_system());
+  if (use_source_attributes && source.attributes_synced) {
+    if (!object_attributes_equal(object->attributes, source.attributes)) {
+      object->attributes = source.attributes;
+      object_updated = true;
+    }
+  }
+  else {
+    if (sync_object_attributes(b_instance, object)) {
+      object_updated = true;
+    }
+    if (use_source_attributes) {
+      source.attributes = object->attributes;
+      source.attributes_synced = true;
+    }
   }
 
   /* holdout */
-  object->set_use_holdout(use_holdout);
+  object->set_use_holdout(source.use_holdout);
 
-  object->set_visibility(visibility);
+  object->set_visibility(source.visibility);
 
-  bool is_shadow_catcher = get_boolean(cobject, "is_shadow_catcher");
-  object->set_is_shadow_catcher(is_shadow_catcher);
-
-  float shadow_terminator_offset = get_float(cobject, "shadow_terminator_offset");
-  object->set_shadow_terminator_offset(shadow_terminator_offset);
+  object->set_is_shadow_catcher(source.is_shadow_catcher);
+  object->set_shadow_terminator_offset(source.shadow_terminator_offset);
 
   /* sync the asset name for Cryptomatte */
-  BL::Object parent = b_ob.parent();
-  ustring parent_name;
-  if (parent) {
-    while (parent.parent()) {
-      parent = parent.parent();
-    }
-    parent_name = parent.name();
-  }
-  else {
-    parent_name = b_ob.name();
-  }
-  object->set_asset_name(parent_name);
+  object->set_asset_name(source.asset_name);
 
   /* object sync
    * transform comparison should not be needed, but duplis don't work perfect
    * in the depsgraph and may not signal changes, so this is a workaround */
   if (object->is_modified() || object_updated ||
       (object->get_geometry() && object->get_geometry()->is_modified())) {
-    object->name = b_ob.name().c_str();
-    object->set_pass_id(b_ob.pass_index());
-    object->set_color(get_float3(b_ob.color()));
+    object->name = source.name;
+    object->set_pass_id(source.pass_id);
+    object->set_color(source.color);
     object->set_tfm(tfm);
 
     /* dupli texture coordinates and random_id */
@@ -333,7 +354,7 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
     object->tag_update(scene);
   }
 
-  sync_object_motion_init(b_parent, b_ob, object);
+  sync_object_motion_init(source, object);
 
   if (is_instance) {
     /* Sync possible particle data. */
@@ -343,6 +364,152 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
   return object;
 }
 
+Object *BlenderSync::sync_object_instance(BL::Depsgraph &b_depsgraph,
+                                          BL::DepsgraphObjectInstance &b_instance,
+                                          BL::Object &b_ob,
+                                          BL::Object &b_parent,
+                                          BL::Object &b_ob_instance,
+                                          const InstanceSourceKey &source_key,
+                                          InstanceSourceData &source,
+                                          const Transform &tfm,
+                                          bool use_particle_hair)
+{
+  if (source.instance_object == NULL) {
+    /* First instance of the source, sync the settings shared by all instances. */
+    Object *object;
+    bool object_updated = instance_array_map.add_or_update(
+        &object, b_ob, b_parent, source_key);
+
+    Geometry *geometry = source.geometry;
+    if (geometry == NULL || geometry_synced.find(geometry) == geometry_synced.end()) {
+      geometry = sync_geometry(
+          b_depsgraph, b_ob_instance, b_ob_instance, object_updated, use_particle_hair, NULL);
+      source.geometry = geometry;
+    }
+    object->set_geometry(geometry);
+
+    if (sync_object_attributes(b_instance, object)) {
+      object_updated = true;
+    }
+
+    object->name = source.name;
+    object->set_use_holdout(source.use_holdout);
+    object->set_visibility(source.visibility);
+    object->set_is_shadow_catcher(source.is_shadow_catcher);
+    object->set_shadow_terminator_offset(source.shadow_terminator_offset);
+    object->set_asset_name(source.asset_name);
+    object->set_pass_id(source.pass_id);
+    object->set_color(source.color);
+
+    /* The instance arrays replace the transform and dupli data. */
+    object->set_tfm(transform_identity());
+    object->set_dupli_generated(zero_float3());
+    object->set_dupli_uv(zero_float2());
+    object->set_random_id(0);
+
+    sync_object_motion_init(source, object);
+
+    source.instance_object = object;
+    source.instance_object_updated = object_updated;
+  }
+
+  source.instance_tfm.push_back_slow(tfm);
+  source.instance_random_id.push_back_slow(b_instance.random_id());
+  source.instance_dupli_generated.push_back_slow(0.5f * get_float3(b_instance.orco()) -
+                                                 make_float3(0.5f, 0.5f, 0.5f));
+  source.instance_dupli_uv.push_back_slow(get_float2(b_instance.uv()));
+
+  return source.instance_object;
+}
+
+void BlenderSync::sync_instance_arrays()
+{
+  for (auto &it : instance_sources) {
+    InstanceSourceData &source = it.second;
+    Object *object = source.instance_object;
+    if (object == NULL) {
+      continue;
+    }
+
+    object->set_instance_tfm(source.instance_tfm);
+    object->set_instance_random_id(source.instance_random_id);
+    object->set_instance_dupli_generated(source.instance_dupli_generated);
+    object->set_instance_dupli_uv(source.instance_dupli_uv);
+
+    if (object->is_modified() || source.instance_object_updated ||
+        (object->get_geometry() && object->get_geometry()->is_modified())) {
+      object->tag_update(scene);
+    }
+  }
+}
+
+BlenderSync::InstanceSourceData BlenderSync::sync_instance_source(BL::ViewLayer &b_view_layer,
+                                                                  BL::Object &b_ob,
+                                                                  BL::Object &b_parent)
+{
+  InstanceSourceData source;
+  source.geometry = NULL;
+  source.motion_steps = 0;
+  source.use_deform_motion = false;
+  source.attributes_synced = false;
+  source.instance_object = NULL;
+  source.instance_object_updated = false;
+
+  /* Visibility flags for both parent and child. */
+  PointerRNA cobject = RNA_pointer_get(&b_ob.ptr, "cycles");
+  source.use_holdout = get_boolean(cobject, "is_holdout") ||
+                       b_parent.holdout_get(PointerRNA_NULL, b_view_layer);
+  source.visibility = object_ray_visibility(b_ob) & PATH_RAY_ALL_VISIBILITY;
+
+  if (b_parent.ptr.data != b_ob.ptr.data) {
+    source.visibility &= object_ray_visibility(b_parent);
+  }
+
+  /* TODO: make holdout objects on excluded layer invisible for non-camera rays. */
+#if 0
+  if (use_holdout && (layer_flag & view_layer.exclude_layer)) {
+    visibility &= ~(PATH_RAY_ALL_VISIBILITY - PATH_RAY_CAMERA);
+  }
+#endif
+
+  /* Clear camera visibility for indirect only objects. */
+  bool use_indirect_only = !source.use_holdout &&
+                           b_parent.indirect_only_get(PointerRNA_NULL, b_view_layer);
+  if (use_indirect_only) {
+    source.visibility &= ~PATH_RAY_CAMERA;
+  }
+
+  if (source.visibility == 0) {
+    return source;
+  }
+
+  source.is_shadow_catcher = get_boolean(cobject, "is_shadow_catcher");
+  source.shadow_terminator_offset = get_float(cobject, "shadow_terminator_offset");
+
+  /* The asset name for Cryptomatte. */
+  BL::Object parent = b_ob.parent();
+  if (parent) {
+    while (parent.parent()) {
+      parent = parent.parent();
+    }
+    source.asset_name = parent.name();
+  }
+  else {
+    source.asset_name = b_ob.name();
+  }
+
+  source.name = b_ob.name().c_str();
+  source.pass_id = b_ob.pass_index();
+  source.color = get_float3(b_ob.color());
+
+  if (scene->need_motion() == Scene::MOTION_BLUR) {
+    source.motion_steps = object_motion_steps(b_parent, b_ob, Object::MAX_MOTION_STEPS);
+    source.use_deform_motion = source.motion_steps && object_use_deform_motion(b_parent, b_ob);
+  }
+
+  return source;
+}
+
 /* This function mirrors drw_uniform_property_lookup in draw_instance_data.cpp */
 static bool lookup_property(BL::ID b_id, const string &name, float4 *r_value)
 {
@@ -490,12 +657,14 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
     light_map.pre_sync();
     geometry_map.pre_sync();
     object_map.pre_sync();
+    instance_array_map.pre_sync();
     particle_system_map.pre_sync();
     motion_times.clear();
   }
   else {
     geometry_motion_synced.clear();
   }
+  instance_sources.clear();
 
   /* initialize culling */
   BlenderObjectCulling culling(scene, b_scene);
@@ -559,6 +728,11 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
 
   geom_task_pool.wait_work();
 
+  if (!cancel && !motion) {
+    sync_instance_arrays();
+  }
+  instance_sources.clear();
+
   progress.set_sync_status("");
 
   if (!cancel && !motion) {
@@ -569,6 +743,7 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
      * freed before particle systems and geometries. */
     light_map.post_sync();
     object_map.post_sync();
+    instance_array_map.post_sync();
     geometry_map.post_sync();
     particle_system_map.post_sync();
   }
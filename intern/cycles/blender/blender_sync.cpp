@@ -59,6 +59,7 @@ BlenderSync::BlenderSync(BL::RenderEngine &b_engine,
       b_scene(b_scene),
       shader_map(scene),
       object_map(scene),
+      instance_array_map(scene),
       geometry_map(scene),
       light_map(scene),
       particle_system_map(scene),
@@ -165,6 +166,7 @@ void BlenderSync::sync_recalc(BL::Depsgraph &b_depsgraph, BL::SpaceView3D &b_v3d
       if (b_ob.is_instancer() && b_update.is_updated_shading()) {
         /* Needed for e.g. object color updates on instancer. */
         object_map.set_recalc(b_ob);
+        instance_array_map.set_recalc(b_ob);
       }
 
       if (is_geometry || is_light) {
@@ -174,6 +176,7 @@ void BlenderSync::sync_recalc(BL::Depsgraph &b_depsgraph, BL::SpaceView3D &b_v3d
         if (is_geometry) {
           if (b_update.is_updated_transform() || b_update.is_updated_shading()) {
             object_map.set_recalc(b_ob);
+            instance_array_map.set_recalc(b_ob);
           }
 
           if (updated_geometry ||
@@ -149,10 +149,51 @@ class BlenderSync {
                       BlenderObjectCulling &culling,
                       bool *use_portal,
                       TaskPool *geom_task_pool);
-  void sync_object_motion_init(BL::Object &b_parent, BL::Object &b_ob, Object *object);
 
   bool sync_object_attributes(BL::DepsgraphObjectInstance &b_instance, Object *object);
 
+  /* Object settings that are the same for all instances of an object with the same parent. */
+  struct InstanceSourceData {
+    Geometry *geometry;
+    uint visibility;
+    bool use_holdout;
+    bool is_shadow_catcher;
+    float shadow_terminator_offset;
+    ustring asset_name;
+    ustring name;
+    int pass_id;
+    float3 color;
+    /* Motion blur settings, only used when the scene needs motion blur. */
+    uint motion_steps;
+    bool use_deform_motion;
+    /* Object attribute values of the first instance, shared with the following instances unless
+     * they are generated by a particle system. */
+    bool attributes_synced;
+    vector<ParamValue> attributes;
+    /* Object with an instance array for the instances that don't need an object of their own,
+     * and the per instance values gathered for it during the sync. */
+    Object *instance_object;
+    bool instance_object_updated;
+    array<Transform> instance_tfm;
+    array<int> instance_random_id;
+    array<float3> instance_dupli_generated;
+    array<float2> instance_dupli_uv;
+  };
+  InstanceSourceData sync_instance_source(BL::ViewLayer &b_view_layer,
+                                          BL::Object &b_ob,
+                                          BL::Object &b_parent);
+  void sync_object_motion_init(const InstanceSourceData &source, Object *object);
+  Object *sync_object_instance(BL::Depsgraph &b_depsgraph,
+                               BL::DepsgraphObjectInstance &b_instance,
+                               BL::Object &b_ob,
+                               BL::Object &b_parent,
+                               BL::Object &b_ob_instance,
+                               const InstanceSourceKey &source_key,
+                               InstanceSourceData &source,
+                               const Transform &tfm,
+                               bool use_particle_hair);
+  void sync_instance_arrays();
+
   /* Volume */
   void sync_volume(BL::Object &b_ob, Volume *volume);
 
@@ -221,10 +262,14 @@ class BlenderSync {
 
   id_map<void *, Shader> shader_map;
   id_map<ObjectKey, Object> object_map;
+  id_map<InstanceSourceKey, Object> instance_array_map;
   id_map<GeometryKey, Geometry> geometry_map;
   id_map<ObjectKey, Light> light_map;
   id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
   set<Geometry *> geometry_synced;
+  /* Settings of instanced objects during a single `sync_objects()`, so objects instanced many
+   * times don't look them up through RNA for every instance. */
+  map<InstanceSourceKey, InstanceSourceData> instance_sources;
   set<Geometry *> geometry_motion_synced;
   set<float> motion_times;
   void *world_map;
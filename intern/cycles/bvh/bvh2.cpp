@@ -382,7 +382,7 @@ void BVH2::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility
 
     if (pidx == -1) {
       /* Object instance. */
-      bbox.grow(ob->bounds);
+      bbox.grow(ob->get_instance_bounds(tob - ob->get_device_index()));
     }
     else {
       /* Primitives. */
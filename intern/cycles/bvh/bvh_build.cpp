@@ -282,9 +282,11 @@ void BVHBuild::add_reference_geometry(BoundBox &root, BoundBox &center, Geometry
 
 void BVHBuild::add_reference_object(BoundBox &root, BoundBox &center, Object *ob, int i)
 {
-  references.push_back(BVHReference(ob->bounds, -1, i, 0));
-  root.grow(ob->bounds);
-  center.grow(ob->bounds.center2());
+  /* Instances of an instance array follow each other in the object list. */
+  const BoundBox bounds = ob->get_instance_bounds(i - ob->get_device_index());
+  references.push_back(BVHReference(bounds, -1, i, 0));
+  root.grow(bounds);
+  center.grow(bounds.center2());
 }
 
 static size_t count_curve_segments(Hair *hair)
@@ -419,8 +419,9 @@ void BVHEmbree::add_instance(Object *ob, int i)
     }
   }
   else {
-    rtcSetGeometryTransform(
-        geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
+    /* Instances of an instance array follow each other in the object list. */
+    const Transform tfm = ob->get_instance_tfm(i - ob->get_device_index());
+    rtcSetGeometryTransform(geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&tfm);
   }
 
   rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
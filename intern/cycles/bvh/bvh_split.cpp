@@ -453,16 +453,20 @@ void BVHSpatialSplit::split_curve_reference(const BVHReference &ref,
                         right_bounds);
 }
 
-void BVHSpatialSplit::split_object_reference(
-    const Object *object, int dim, float pos, BoundBox &left_bounds, BoundBox &right_bounds)
+void BVHSpatialSplit::split_object_reference(const Object *object,
+                                             int instance,
+                                             int dim,
+                                             float pos,
+                                             BoundBox &left_bounds,
+                                             BoundBox &right_bounds)
 {
   Geometry *geom = object->get_geometry();
+  const Transform tfm = object->get_instance_tfm(instance);
 
   if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
     Mesh *mesh = static_cast<Mesh *>(geom);
     for (int tri_idx = 0; tri_idx < mesh->num_triangles(); ++tri_idx) {
-      split_triangle_primitive(
-          mesh, &object->get_tfm(), tri_idx, dim, pos, left_bounds, right_bounds);
+      split_triangle_primitive(mesh, &tfm, tri_idx, dim, pos, left_bounds, right_bounds);
     }
   }
   else if (geom->geometry_type == Geometry::HAIR) {
@@ -471,7 +475,7 @@ void BVHSpatialSplit::split_object_reference(
       Hair::Curve curve = hair->get_curve(curve_idx);
       for (int segment_idx = 0; segment_idx < curve.num_keys - 1; ++segment_idx) {
         split_curve_primitive(
-            hair, &object->get_tfm(), curve_idx, segment_idx, dim, pos, left_bounds, right_bounds);
+            hair, &tfm, curve_idx, segment_idx, dim, pos, left_bounds, right_bounds);
       }
     }
   }
@@ -500,7 +504,9 @@ void BVHSpatialSplit::split_reference(const BVHBuild &builder,
     split_curve_reference(ref, hair, dim, pos, left_bounds, right_bounds);
   }
   else {
-    split_object_reference(ob, dim, pos, left_bounds, right_bounds);
+    /* Instances of an instance array follow each other in the object list. */
+    const int instance = ref.prim_object() - ob->get_device_index();
+    split_object_reference(ob, instance, dim, pos, left_bounds, right_bounds);
   }
 
   /* intersect with original bounds. */
@@ -1613,22 +1613,27 @@ class OptiXDevice : public CUDADevice {
         bvh_optix->motion_transform_data.alloc_to_device(total_motion_transform_size);
       }
 
-      for (Object *ob : bvh->objects) {
+      for (size_t ob_index = 0; ob_index < bvh->objects.size(); ++ob_index) {
+        Object *ob = bvh->objects[ob_index];
         // Skip non-traceable objects
         if (!ob->is_traceable())
           continue;
 
+        // Instances of an instance array follow each other in the object list
+        const int ob_instance = ob_index - ob->get_device_index();
+
         BVHOptiX *const blas = static_cast<BVHOptiX *>(ob->get_geometry()->bvh);
         OptixTraversableHandle handle = blas->traversable_handle;
 
 #  if OPTIX_ABI_VERSION < 41
+        const BoundBox ob_bounds = ob->get_instance_bounds(ob_instance);
         OptixAabb &aabb = aabbs[num_instances];
-        aabb.minX = ob->bounds.min.x;
-        aabb.minY = ob->bounds.min.y;
-        aabb.minZ = ob->bounds.min.z;
-        aabb.maxX = ob->bounds.max.x;
-        aabb.maxY = ob->bounds.max.y;
-        aabb.maxZ = ob->bounds.max.z;
+        aabb.minX = ob_bounds.min.x;
+        aabb.minY = ob_bounds.min.y;
+        aabb.minZ = ob_bounds.min.z;
+        aabb.maxX = ob_bounds.max.x;
+        aabb.maxY = ob_bounds.max.y;
+        aabb.maxZ = ob_bounds.max.z;
 #  endif
 
         OptixInstance &instance = instances[num_instances++];
@@ -1640,7 +1645,7 @@ class OptiXDevice : public CUDADevice {
         instance.transform[10] = 1.0f;
 
         // Set user instance ID to object index (but leave low bit blank)
-        instance.instanceId = ob->get_device_index() << 1;
+        instance.instanceId = (ob->get_device_index() + ob_instance) << 1;
 
         // Have to have at least one bit in the mask, or else instance would always be culled
         instance.visibilityMask = 1;
@@ -1741,7 +1746,8 @@ class OptiXDevice : public CUDADevice {
 
           if (ob->get_geometry()->is_instanced()) {
             // Set transform matrix
-            memcpy(instance.transform, &ob->get_tfm(), sizeof(instance.transform));
+            const Transform ob_tfm = ob->get_instance_tfm(ob_instance);
+            memcpy(instance.transform, &ob_tfm, sizeof(instance.transform));
           }
           else {
             // Disable instance transform if geometry already has it applied to vertex data
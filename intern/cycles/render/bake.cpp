@@ -139,17 +139,14 @@ void BakeManager::device_update(Device * /*device*/,
   kbake->type = type;
   kbake->pass_filter = pass_filter;
 
-  int object_index = 0;
   foreach (Object *object, scene->objects) {
     const Geometry *geom = object->get_geometry();
     if (object->name == object_name && geom->geometry_type == Geometry::MESH) {
-      kbake->object_index = object_index;
+      kbake->object_index = object->get_device_index();
       kbake->tri_offset = geom->prim_offset;
       kintegrator->aa_samples = aa_samples(scene, object, type);
       break;
     }
-
-    object_index++;
   }
 
   need_update_ = false;
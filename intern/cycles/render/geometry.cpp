@@ -321,13 +321,14 @@ void GeometryManager::update_osl_attributes(Device *device,
   og->attribute_map.clear();
   og->object_names.clear();
 
-  og->attribute_map.resize(scene->objects.size() * ATTR_PRIM_TYPES);
+  og->attribute_map.resize(scene->object_manager->device_objects.size() * ATTR_PRIM_TYPES);
 
   for (size_t i = 0; i < scene->objects.size(); i++) {
     /* set object name to object index map */
     Object *object = scene->objects[i];
-    og->object_name_map[object->name] = i;
-    og->object_names.push_back(object->name);
+    const size_t index = object->get_device_index();
+    og->object_name_map[object->name] = index;
+    og->object_names.insert(og->object_names.end(), object->num_instances(), object->name);
 
     /* set object attributes */
     foreach (ParamValue &attr, object->attributes) {
@@ -339,8 +340,8 @@ void GeometryManager::update_osl_attributes(Device *device,
       osl_attr.desc.offset = 0;
       osl_attr.desc.flags = 0;
 
-      og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][attr.name()] = osl_attr;
-      og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][attr.name()] = osl_attr;
+      og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][attr.name()] = osl_attr;
+      og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][attr.name()] = osl_attr;
     }
 
     /* find geometry attributes */
@@ -370,11 +371,11 @@ void GeometryManager::update_osl_attributes(Device *device,
         if (req.std != ATTR_STD_NONE) {
           /* if standard attribute, add lookup by geom: name convention */
           ustring stdname(string("geom:") + string(Attribute::standard_name(req.std)));
-          og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][stdname] = osl_attr;
+          og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][stdname] = osl_attr;
         }
         else if (req.name != ustring()) {
           /* add lookup by geometry attribute name */
-          og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][req.name] = osl_attr;
+          og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_GEOMETRY][req.name] = osl_attr;
         }
       }
 
@@ -395,14 +396,22 @@ void GeometryManager::update_osl_attributes(Device *device,
         if (req.std != ATTR_STD_NONE) {
           /* if standard attribute, add lookup by geom: name convention */
           ustring stdname(string("geom:") + string(Attribute::standard_name(req.std)));
-          og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][stdname] = osl_attr;
+          og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][stdname] = osl_attr;
         }
         else if (req.name != ustring()) {
           /* add lookup by geometry attribute name */
-          og->attribute_map[i * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][req.name] = osl_attr;
+          og->attribute_map[index * ATTR_PRIM_TYPES + ATTR_PRIM_SUBD][req.name] = osl_attr;
         }
       }
     }
+
+    /* Instances of an instance array share the attribute maps. */
+    for (int instance = 1; instance < object->num_instances(); instance++) {
+      for (int prim_type = 0; prim_type < ATTR_PRIM_TYPES; prim_type++) {
+        og->attribute_map[(index + instance) * ATTR_PRIM_TYPES + prim_type] =
+            og->attribute_map[index * ATTR_PRIM_TYPES + prim_type];
+      }
+    }
   }
 #else
   (void)device;
@@ -1262,7 +1271,8 @@ void GeometryManager::device_update_bvh(Device *device,
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
-    bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
+    bvh = scene->bvh = BVH::create(
+        bparams, scene->geometry, scene->object_manager->device_objects, device);
   }
 
   device->build_bvh(bvh, progress, can_refit);
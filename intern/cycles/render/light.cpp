@@ -319,6 +319,7 @@ void LightManager::device_update_distribution(Device *,
     /* Count triangles. */
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
     size_t mesh_num_triangles = mesh->num_triangles();
+    size_t mesh_num_emissive_triangles = 0;
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->get_shader()[i];
       Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
@@ -326,9 +327,11 @@ void LightManager::device_update_distribution(Device *,
                            scene->default_surface;
 
       if (shader->get_use_mis() && shader->has_surface_emission) {
-        num_triangles++;
+        mesh_num_emissive_triangles++;
       }
     }
+
+    num_triangles += mesh_num_emissive_triangles * object->num_instances();
   }
 
   size_t num_distribution = num_triangles + num_lights;
@@ -340,21 +343,17 @@ void LightManager::device_update_distribution(Device *,
 
   /* triangles */
   size_t offset = 0;
-  int j = 0;
 
   foreach (Object *object, scene->objects) {
     if (progress.get_cancel())
       return;
 
     if (!object_usable_as_light(object)) {
-      j++;
       continue;
     }
     /* Sum area. */
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
     bool transform_applied = mesh->transform_applied;
-    Transform tfm = object->get_tfm();
-    int object_id = j;
     int shader_flag = 0;
 
     if (!(object->get_visibility() & PATH_RAY_DIFFUSE)) {
@@ -375,38 +374,41 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
-    for (size_t i = 0; i < mesh_num_triangles; i++) {
-      int shader_index = mesh->get_shader()[i];
-      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
-                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
-                           scene->default_surface;
+    for (int instance = 0; instance < object->num_instances(); instance++) {
+      Transform tfm = object->get_instance_tfm(instance);
+      int object_id = object->get_device_index() + instance;
+
+      for (size_t i = 0; i < mesh_num_triangles; i++) {
+        int shader_index = mesh->get_shader()[i];
+        Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
+                             static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
+                             scene->default_surface;
+
+        if (shader->get_use_mis() && shader->has_surface_emission) {
+          distribution[offset].totarea = totarea;
+          distribution[offset].prim = i + mesh->prim_offset;
+          distribution[offset].mesh_light.shader_flag = shader_flag;
+          distribution[offset].mesh_light.object_id = object_id;
+          offset++;
+
+          Mesh::Triangle t = mesh->get_triangle(i);
+          if (!t.valid(&mesh->get_verts()[0])) {
+            continue;
+          }
+          float3 p1 = mesh->get_verts()[t.v[0]];
+          float3 p2 = mesh->get_verts()[t.v[1]];
+          float3 p3 = mesh->get_verts()[t.v[2]];
+
+          if (!transform_applied) {
+            p1 = transform_point(&tfm, p1);
+            p2 = transform_point(&tfm, p2);
+            p3 = transform_point(&tfm, p3);
+          }
 
-      if (shader->get_use_mis() && shader->has_surface_emission) {
-        distribution[offset].totarea = totarea;
-        distribution[offset].prim = i + mesh->prim_offset;
-        distribution[offset].mesh_light.shader_flag = shader_flag;
-        distribution[offset].mesh_light.object_id = object_id;
-        offset++;
-
-        Mesh::Triangle t = mesh->get_triangle(i);
-        if (!t.valid(&mesh->get_verts()[0])) {
-          continue;
+          totarea += triangle_area(p1, p2, p3);
         }
-        float3 p1 = mesh->get_verts()[t.v[0]];
-        float3 p2 = mesh->get_verts()[t.v[1]];
-        float3 p3 = mesh->get_verts()[t.v[2]];
-
-        if (!transform_applied) {
-          p1 = transform_point(&tfm, p1);
-          p2 = transform_point(&tfm, p2);
-          p3 = transform_point(&tfm, p3);
-        }
-
-        totarea += triangle_area(p1, p2, p3);
       }
     }
-
-    j++;
   }
 
   float trianglearea = totarea;
@@ -59,7 +59,7 @@ bool GeometryManager::displace(
 
   for (size_t i = 0; i < scene->objects.size(); i++) {
     if (scene->objects[i]->get_geometry() == mesh) {
-      object_index = i;
+      object_index = scene->objects[i]->get_device_index();
       break;
     }
   }
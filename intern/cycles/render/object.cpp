@@ -101,6 +101,11 @@ NODE_DEFINE(Object)
   SOCKET_NODE(particle_system, "Particle System", ParticleSystem::get_node_type());
   SOCKET_INT(particle_index, "Particle Index", 0);
 
+  SOCKET_TRANSFORM_ARRAY(instance_tfm, "Instance Transforms", array<Transform>());
+  SOCKET_INT_ARRAY(instance_random_id, "Instance Random IDs", array<int>());
+  SOCKET_POINT_ARRAY(instance_dupli_generated, "Instance Dupli Generated", array<float3>());
+  SOCKET_POINT2_ARRAY(instance_dupli_uv, "Instance Dupli UVs", array<float2>());
+
   return type;
 }
 
@@ -109,6 +114,7 @@ Object::Object() : Node(get_node_type())
   particle_system = NULL;
   particle_index = 0;
   attr_map_offset = 0;
+  device_num_instances = 0;
   bounds = BoundBox::empty;
 }
 
@@ -173,7 +179,14 @@ void Object::compute_bounds(bool motion_blur)
   }
   else {
     /* No motion blur case. */
-    if (geometry->transform_applied) {
+    if (use_instance_array()) {
+      bounds = BoundBox::empty;
+
+      for (const Transform &itfm : instance_tfm) {
+        bounds.grow(mbounds.transformed(&itfm));
+      }
+    }
+    else if (geometry->transform_applied) {
       bounds = mbounds;
     }
     else {
@@ -216,10 +229,16 @@ void Object::tag_update(Scene *scene)
   }
 
   if (geometry) {
-    if (tfm_is_modified()) {
+    if (tfm_is_modified() || instance_tfm_is_modified()) {
       flag |= ObjectManager::TRANSFORM_MODIFIED;
     }
 
+    /* Instances are consecutive in the device vectors, so adding or removing some moves the
+     * following objects like adding or removing an object does. */
+    if (num_instances() != device_num_instances) {
+      flag |= ObjectManager::OBJECT_ADDED | ObjectManager::OBJECT_REMOVED;
+    }
+
     if (visibility_is_modified()) {
       flag |= ObjectManager::VISIBILITY_MODIFIED;
     }
@@ -237,7 +256,8 @@ void Object::tag_update(Scene *scene)
 
 bool Object::use_motion() const
 {
-  return (motion.size() > 1);
+  /* Instance arrays have no motion blur. */
+  return (motion.size() > 1) && !use_instance_array();
 }
 
 float Object::motion_time(int step) const
@@ -258,6 +278,30 @@ int Object::motion_step(float time) const
   return -1;
 }
 
+bool Object::use_instance_array() const
+{
+  return instance_tfm.size() > 0;
+}
+
+int Object::num_instances() const
+{
+  return use_instance_array() ? instance_tfm.size() : 1;
+}
+
+Transform Object::get_instance_tfm(int instance) const
+{
+  return use_instance_array() ? instance_tfm[instance] : tfm;
+}
+
+BoundBox Object::get_instance_bounds(int instance) const
+{
+  if (!use_instance_array()) {
+    return bounds;
+  }
+
+  return geometry->bounds.transformed(&instance_tfm[instance]);
+}
+
 bool Object::is_traceable() const
 {
   /* Mesh itself can be empty,can skip all such objects. */
@@ -280,7 +324,7 @@ uint Object::visibility_for_tracing() const
   return trace_visibility;
 }
 
-float Object::compute_volume_step_size() const
+float Object::compute_volume_step_size(int instance) const
 {
   if (geometry->geometry_type != Geometry::MESH && geometry->geometry_type != Geometry::VOLUME) {
     return FLT_MAX;
@@ -337,16 +381,17 @@ float Object::compute_volume_step_size() const
             size /= make_float3(metadata.width, metadata.height, metadata.depth);
 
           /* Step size is transformed from voxel to world space. */
-          Transform voxel_tfm = tfm;
+          Transform voxel_tfm = get_instance_tfm(instance);
           if (metadata.use_transform_3d) {
-            voxel_tfm = tfm * transform_inverse(metadata.transform_3d);
+            voxel_tfm = voxel_tfm * transform_inverse(metadata.transform_3d);
           }
           voxel_step_size = min3(fabs(transform_direction(&voxel_tfm, size)));
         }
         else if (volume->get_object_space()) {
           /* User specified step size in object space. */
           float3 size = make_float3(voxel_step_size, voxel_step_size, voxel_step_size);
-          voxel_step_size = min3(fabs(transform_direction(&tfm, size)));
+          Transform object_tfm = get_instance_tfm(instance);
+          voxel_step_size = min3(fabs(transform_direction(&object_tfm, size)));
         }
 
         if (voxel_step_size > 0.0f) {
@@ -358,7 +403,7 @@ float Object::compute_volume_step_size() const
 
   if (step_size == FLT_MAX) {
     /* Fall back to 1/10th of bounds for procedural volumes. */
-    step_size = 0.1f * average(bounds.size());
+    step_size = 0.1f * average(get_instance_bounds(instance).size());
   }
 
   step_size *= step_rate;
@@ -398,21 +443,39 @@ static float object_volume_density(const Transform &tfm, Geometry *geom)
 
 void ObjectManager::device_update_object_transform(UpdateObjectTransformState *state,
                                                    Object *ob,
+                                                   int instance,
                                                    bool update_all)
 {
-  KernelObject &kobject = state->objects[ob->index];
+  const int device_index = ob->index + instance;
+  KernelObject &kobject = state->objects[device_index];
   Transform *object_motion_pass = state->object_motion_pass;
 
   Geometry *geom = ob->geometry;
   uint flag = 0;
 
   /* Compute transformations. */
-  Transform tfm = ob->tfm;
+  Transform tfm = ob->get_instance_tfm(instance);
   Transform itfm = transform_inverse(tfm);
 
+  /* Per instance values, falling back to the object ones. */
+  uint random_id = ob->random_id;
+  float3 dupli_generated = ob->dupli_generated;
+  float2 dupli_uv = ob->dupli_uv;
+  if (ob->use_instance_array()) {
+    if (instance < ob->instance_random_id.size()) {
+      random_id = (uint)ob->instance_random_id[instance];
+    }
+    if (instance < ob->instance_dupli_generated.size()) {
+      dupli_generated = ob->instance_dupli_generated[instance];
+    }
+    if (instance < ob->instance_dupli_uv.size()) {
+      dupli_uv = ob->instance_dupli_uv[instance];
+    }
+  }
+
   float3 color = ob->color;
   float pass_id = ob->pass_id;
-  float random_number = (float)ob->random_id * (1.0f / (float)0xFFFFFFFF);
+  float random_number = (float)random_id * (1.0f / (float)0xFFFFFFFF);
   int particle_index = (ob->particle_system) ?
                            ob->particle_index + state->particle_offset[ob->particle_system] :
                            0;
@@ -463,13 +526,13 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
       tfm_post = tfm_post * itfm;
     }
 
-    int motion_pass_offset = ob->index * OBJECT_MOTION_PASS_SIZE;
+    int motion_pass_offset = device_index * OBJECT_MOTION_PASS_SIZE;
     object_motion_pass[motion_pass_offset + 0] = tfm_pre;
     object_motion_pass[motion_pass_offset + 1] = tfm_post;
   }
   else if (state->need_motion == Scene::MOTION_BLUR) {
     if (ob->use_motion()) {
-      kobject.motion_offset = state->motion_offset[ob->index];
+      kobject.motion_offset = state->motion_offset[device_index];
 
       /* Decompose transforms for interpolation. */
       if (ob->tfm_is_modified() || update_all) {
@@ -483,14 +546,14 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   }
 
   /* Dupli object coords and motion info. */
-  kobject.dupli_generated[0] = ob->dupli_generated[0];
-  kobject.dupli_generated[1] = ob->dupli_generated[1];
-  kobject.dupli_generated[2] = ob->dupli_generated[2];
+  kobject.dupli_generated[0] = dupli_generated[0];
+  kobject.dupli_generated[1] = dupli_generated[1];
+  kobject.dupli_generated[2] = dupli_generated[2];
   kobject.numkeys = (geom->geometry_type == Geometry::HAIR) ?
                         static_cast<Hair *>(geom)->get_curve_keys().size() :
                         0;
-  kobject.dupli_uv[0] = ob->dupli_uv[0];
-  kobject.dupli_uv[1] = ob->dupli_uv[1];
+  kobject.dupli_uv[0] = dupli_uv[0];
+  kobject.dupli_uv[1] = dupli_uv[1];
   int totalsteps = geom->get_motion_steps();
   kobject.numsteps = (totalsteps - 1) / 2;
   kobject.numverts = (geom->geometry_type == Geometry::MESH ||
@@ -513,8 +576,8 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   if (ob->use_holdout) {
     flag |= SD_OBJECT_HOLDOUT_MASK;
   }
-  state->object_flag[ob->index] = flag;
-  state->object_volume_step[ob->index] = FLT_MAX;
+  state->object_flag[device_index] = flag;
+  state->object_volume_step[device_index] = FLT_MAX;
 
   /* Have curves. */
   if (geom->geometry_type == Geometry::HAIR) {
@@ -531,28 +594,30 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   state.scene = scene;
   state.queue_start_object = 0;
 
-  state.objects = dscene->objects.alloc(scene->objects.size());
-  state.object_flag = dscene->object_flag.alloc(scene->objects.size());
-  state.object_volume_step = dscene->object_volume_step.alloc(scene->objects.size());
+  const size_t num_device_objects = device_objects.size();
+  state.objects = dscene->objects.alloc(num_device_objects);
+  state.object_flag = dscene->object_flag.alloc(num_device_objects);
+  state.object_volume_step = dscene->object_volume_step.alloc(num_device_objects);
   state.object_motion = NULL;
   state.object_motion_pass = NULL;
 
   if (state.need_motion == Scene::MOTION_PASS) {
     state.object_motion_pass = dscene->object_motion_pass.alloc(OBJECT_MOTION_PASS_SIZE *
-                                                                scene->objects.size());
+                                                                num_device_objects);
   }
   else if (state.need_motion == Scene::MOTION_BLUR) {
-    /* Set object offsets into global object motion array. */
-    uint *motion_offsets = state.motion_offset.resize(scene->objects.size());
+    /* Set object offsets into global object motion array. Instance arrays have no motion. */
+    state.motion_offset.resize(num_device_objects);
     uint motion_offset = 0;
 
     foreach (Object *ob, scene->objects) {
-      *motion_offsets = motion_offset;
-      motion_offsets++;
+      state.motion_offset[ob->index] = motion_offset;
 
       /* Clear motion array if there is no actual motion. */
       ob->update_motion();
-      motion_offset += ob->motion.size();
+      if (ob->use_motion()) {
+        motion_offset += ob->motion.size();
+      }
     }
 
     state.object_motion = dscene->object_motion.alloc(motion_offset);
@@ -573,11 +638,11 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   /* Parallel object update, with grain size to avoid too much threading overhead
    * for individual objects. */
   static const int OBJECTS_PER_TASK = 32;
-  parallel_for(blocked_range<size_t>(0, scene->objects.size(), OBJECTS_PER_TASK),
+  parallel_for(blocked_range<size_t>(0, num_device_objects, OBJECTS_PER_TASK),
                [&](const blocked_range<size_t> &r) {
                  for (size_t i = r.begin(); i != r.end(); i++) {
-                   Object *ob = state.scene->objects[i];
-                   device_update_object_transform(&state, ob, update_all);
+                   Object *ob = device_objects[i];
+                   device_update_object_transform(&state, ob, i - ob->index, update_all);
                  }
                });
 
@@ -629,8 +694,10 @@ void ObjectManager::device_update(Device *device,
 
   device_free(device, dscene, false);
 
-  if (scene->objects.size() == 0)
+  if (scene->objects.size() == 0) {
+    device_objects.clear();
     return;
+  }
 
   {
     /* Assign object IDs. */
@@ -640,9 +707,11 @@ void ObjectManager::device_update(Device *device,
       }
     });
 
-    int index = 0;
+    device_objects.clear();
     foreach (Object *object, scene->objects) {
-      object->index = index++;
+      object->index = device_objects.size();
+      object->device_num_instances = object->num_instances();
+      device_objects.insert(device_objects.end(), object->device_num_instances, object);
 
       /* this is a bit too broad, however a bigger refactor might be needed to properly separate
        * update each type of data (transform, flags, etc.) */
@@ -722,51 +791,61 @@ void ObjectManager::device_update_flags(
         volume_objects.push_back(object);
       }
       has_volume_objects = true;
-      object_volume_step[object->index] = object->compute_volume_step_size();
+      for (int instance = 0; instance < object->num_instances(); instance++) {
+        object_volume_step[object->index + instance] = object->compute_volume_step_size(instance);
+      }
     }
     else {
-      object_volume_step[object->index] = FLT_MAX;
+      for (int instance = 0; instance < object->num_instances(); instance++) {
+        object_volume_step[object->index + instance] = FLT_MAX;
+      }
     }
   }
 
   foreach (Object *object, scene->objects) {
-    if (object->geometry->has_volume) {
-      object_flag[object->index] |= SD_OBJECT_HAS_VOLUME;
-      object_flag[object->index] &= ~SD_OBJECT_HAS_VOLUME_ATTRIBUTES;
+    for (int instance = 0; instance < object->num_instances(); instance++) {
+      const int device_index = object->index + instance;
 
-      foreach (Attribute &attr, object->geometry->attributes.attributes) {
-        if (attr.element == ATTR_ELEMENT_VOXEL) {
-          object_flag[object->index] |= SD_OBJECT_HAS_VOLUME_ATTRIBUTES;
+      if (object->geometry->has_volume) {
+        object_flag[device_index] |= SD_OBJECT_HAS_VOLUME;
+        object_flag[device_index] &= ~SD_OBJECT_HAS_VOLUME_ATTRIBUTES;
+
+        foreach (Attribute &attr, object->geometry->attributes.attributes) {
+          if (attr.element == ATTR_ELEMENT_VOXEL) {
+            object_flag[device_index] |= SD_OBJECT_HAS_VOLUME_ATTRIBUTES;
+          }
         }
       }
-    }
-    else {
-      object_flag[object->index] &= ~(SD_OBJECT_HAS_VOLUME | SD_OBJECT_HAS_VOLUME_ATTRIBUTES);
-    }
+      else {
+        object_flag[device_index] &= ~(SD_OBJECT_HAS_VOLUME | SD_OBJECT_HAS_VOLUME_ATTRIBUTES);
+      }
 
-    if (object->is_shadow_catcher) {
-      object_flag[object->index] |= SD_OBJECT_SHADOW_CATCHER;
-    }
-    else {
-      object_flag[object->index] &= ~SD_OBJECT_SHADOW_CATCHER;
-    }
+      if (object->is_shadow_catcher) {
+        object_flag[device_index] |= SD_OBJECT_SHADOW_CATCHER;
+      }
+      else {
+        object_flag[device_index] &= ~SD_OBJECT_SHADOW_CATCHER;
+      }
 
-    if (bounds_valid) {
-      foreach (Object *volume_object, volume_objects) {
-        if (object == volume_object) {
-          continue;
-        }
-        if (object->bounds.intersects(volume_object->bounds)) {
-          object_flag[object->index] |= SD_OBJECT_INTERSECTS_VOLUME;
-          break;
+      if (bounds_valid) {
+        BoundBox instance_bounds = object->get_instance_bounds(instance);
+        foreach (Object *volume_object, volume_objects) {
+          /* Instances of an instance array may intersect each other. */
+          if (object == volume_object && !object->use_instance_array()) {
+            continue;
+          }
+          if (instance_bounds.intersects(volume_object->bounds)) {
+            object_flag[device_index] |= SD_OBJECT_INTERSECTS_VOLUME;
+            break;
+          }
         }
       }
-    }
-    else if (has_volume_objects) {
-      /* Not really valid, but can't make more reliable in the case
-       * of bounds not being up to date.
-       */
-      object_flag[object->index] |= SD_OBJECT_INTERSECTS_VOLUME;
+      else if (has_volume_objects) {
+        /* Not really valid, but can't make more reliable in the case
+         * of bounds not being up to date.
+         */
+        object_flag[device_index] |= SD_OBJECT_INTERSECTS_VOLUME;
+      }
     }
   }
 
@@ -798,9 +877,12 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
                                      mesh->patch_table->num_nodes * PATCH_NODE_SIZE) -
                                 mesh->patch_offset;
 
-        if (kobjects[object->index].patch_map_offset != patch_map_offset) {
-          kobjects[object->index].patch_map_offset = patch_map_offset;
-          update = true;
+        for (int instance = 0; instance < object->num_instances(); instance++) {
+          KernelObject &kobject = kobjects[object->index + instance];
+          if (kobject.patch_map_offset != patch_map_offset) {
+            kobject.patch_map_offset = patch_map_offset;
+            update = true;
+          }
         }
       }
     }
@@ -812,9 +894,12 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
       attr_map_offset = geom->attr_map_offset;
     }
 
-    if (kobjects[object->index].attribute_map_offset != attr_map_offset) {
-      kobjects[object->index].attribute_map_offset = attr_map_offset;
-      update = true;
+    for (int instance = 0; instance < object->num_instances(); instance++) {
+      KernelObject &kobject = kobjects[object->index + instance];
+      if (kobject.attribute_map_offset != attr_map_offset) {
+        kobject.attribute_map_offset = attr_map_offset;
+        update = true;
+      }
     }
   }
 
@@ -842,7 +927,6 @@ void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, P
   Scene::MotionType need_motion = scene->need_motion();
   bool motion_blur = need_motion == Scene::MOTION_BLUR;
   bool apply_to_motion = need_motion != Scene::MOTION_PASS;
-  int i = 0;
 
   foreach (Object *object, scene->objects) {
     map<Geometry *, int>::iterator it = geometry_users.find(object->geometry);
@@ -866,8 +950,8 @@ void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, P
      * Could be solved by moving reference counter to Geometry.
      */
     Geometry *geom = object->geometry;
-    bool apply = (geometry_users[geom] == 1) && !geom->has_surface_bssrdf &&
-                 !geom->has_true_displacement();
+    bool apply = (geometry_users[geom] == 1) && !object->use_instance_array() &&
+                 !geom->has_surface_bssrdf && !geom->has_true_displacement();
 
     if (geom->geometry_type == Geometry::MESH) {
       Mesh *mesh = static_cast<Mesh *>(geom);
@@ -890,13 +974,11 @@ void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, P
             return;
         }
 
-        object_flag[i] |= SD_OBJECT_TRANSFORM_APPLIED;
+        object_flag[object->index] |= SD_OBJECT_TRANSFORM_APPLIED;
         if (geom->transform_negative_scaled)
-          object_flag[i] |= SD_OBJECT_NEGATIVE_SCALE_APPLIED;
+          object_flag[object->index] |= SD_OBJECT_NEGATIVE_SCALE_APPLIED;
       }
     }
-
-    i++;
   }
 }
 
@@ -72,6 +72,14 @@ class Object : public Node {
   NODE_SOCKET_API(ParticleSystem *, particle_system);
   NODE_SOCKET_API(int, particle_index);
 
+  /* Instance arrays. When instance transforms are set, the object is instanced once for every
+   * transform and the regular transform is ignored. The other arrays are either empty or hold
+   * one value per instance. */
+  NODE_SOCKET_API_ARRAY(array<Transform>, instance_tfm)
+  NODE_SOCKET_API_ARRAY(array<int>, instance_random_id)
+  NODE_SOCKET_API_ARRAY(array<float3>, instance_dupli_generated)
+  NODE_SOCKET_API_ARRAY(array<float2>, instance_dupli_uv)
+
   Object();
   ~Object();
 
@@ -87,6 +95,13 @@ class Object : public Node {
   int motion_step(float time) const;
   void update_motion();
 
+  /* Instances, a regular object is a single instance using its own transform. Every instance
+   * is a separate object in the kernel. */
+  bool use_instance_array() const;
+  int num_instances() const;
+  Transform get_instance_tfm(int instance) const;
+  BoundBox get_instance_bounds(int instance) const;
+
   /* Maximum number of motion steps supported (due to Embree). */
   static const uint MAX_MOTION_STEPS = 129;
 
@@ -100,17 +115,22 @@ class Object : public Node {
    */
   uint visibility_for_tracing() const;
 
-  /* Returns the index that is used in the kernel for this object. */
+  /* Returns the index that is used in the kernel for this object, instances of an instance
+   * array follow the first one. */
   int get_device_index() const;
 
   /* Compute step size from attributes, shaders, transforms. */
-  float compute_volume_step_size() const;
+  float compute_volume_step_size(int instance) const;
 
  protected:
-  /* Specifies the position of the object in scene->objects and
-   * in the device vectors. Gets set in device_update. */
+  /* Specifies the position of the object in the device vectors.
+   * Gets set in device_update. */
   int index;
 
+  /* Number of instances in the device vectors, to detect when the
+   * index of the following objects changes. */
+  int device_num_instances;
+
   /* Reference to the attribute map with object attributes,
    * or 0 if none. Set in update_svm_attributes. */
   size_t attr_map_offset;
@@ -144,6 +164,10 @@ class ObjectManager {
 
   bool need_flags_update;
 
+  /* Objects in the order of the device vectors, with an entry for every
+   * instance. This is the object list of the scene BVH. */
+  vector<Object *> device_objects;
+
   ObjectManager();
   ~ObjectManager();
 
@@ -171,6 +195,7 @@ class ObjectManager {
  protected:
   void device_update_object_transform(UpdateObjectTransformState *state,
                                       Object *ob,
+                                      int instance,
                                       bool update_all);
   void device_update_object_transform_task(UpdateObjectTransformState *state);
   bool device_update_object_transform_pop_work(UpdateObjectTransformState *state,
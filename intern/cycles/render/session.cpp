@@ -283,7 +283,7 @@ void Session::run_gpu()
       /* update scene */
       scoped_timer update_timer;
       if (update_scene()) {
-        profiler.reset(scene->shaders.size(), scene->objects.size());
+        profiler.reset(scene->shaders.size(), scene->object_manager->device_objects.size());
       }
       progress.add_skip_time(update_timer, params.background);
 
@@ -801,7 +801,7 @@ void Session::run_cpu()
       /* update scene */
       scoped_timer update_timer;
       if (update_scene()) {
-        profiler.reset(scene->shaders.size(), scene->objects.size());
+        profiler.reset(scene->shaders.size(), scene->object_manager->device_objects.size());
       }
       progress.add_skip_time(update_timer, params.background);
 
@@ -322,9 +322,11 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
 
   objects.entries.clear();
   foreach (Object *object, scene->objects) {
-    uint64_t samples, hits;
-    if (prof.get_object(object->get_device_index(), samples, hits)) {
-      objects.add(object->name, samples, hits);
+    for (int instance = 0; instance < object->num_instances(); instance++) {
+      uint64_t samples, hits;
+      if (prof.get_object(object->get_device_index() + instance, samples, hits)) {
+        objects.add(object->name, samples, hits);
+      }
     }
   }
 }
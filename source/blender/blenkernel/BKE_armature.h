@@ -468,6 +468,9 @@ void BKE_armature_deform_coords_with_editmesh(const struct Object *ob_arm,
                                               const char *defgrp_name,
                                               struct BMEditMesh *em_target);
 
+/* Free the compiled vertex group weights of an evaluated object. */
+void BKE_armature_skinning_cache_free(struct Object *ob);
+
 /** \} */
 
 #ifdef __cplusplus
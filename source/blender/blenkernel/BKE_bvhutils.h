@@ -274,6 +274,24 @@ bool bvhcache_has_tree(const struct BVHCache *bvh_cache, const BVHTree *tree);
 struct BVHCache *bvhcache_init(void);
 void bvhcache_free(struct BVHCache *bvh_cache);
 
+/**
+ * Trees of evaluated meshes are shared between meshes with the same content.
+ */
+
+typedef struct BVHCacheStats {
+  /** Trees built from scratch. */
+  int builds;
+  /** Unused trees updated for a mesh with the same topology but new positions. */
+  int refits;
+  /** Requests served by a tree that was already built for a mesh with the same content. */
+  int shares;
+  /** Trees currently in the shared cache, used or not. */
+  int trees;
+} BVHCacheStats;
+
+void BKE_bvhtree_shared_cache_clear(void);
+void BKE_bvhtree_cache_stats_get(BVHCacheStats *r_stats);
+
 #ifdef __cplusplus
 }
 #endif
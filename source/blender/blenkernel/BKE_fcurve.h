@@ -316,6 +316,9 @@ void BKE_fcurve_correct_bezpart(const float v1[2], float v2[2], float v3[2], con
 
 /* evaluate fcurve */
 float evaluate_fcurve(struct FCurve *fcu, float evaltime);
+/* Same as #evaluate_fcurve, \a segment_hint caches the keyframe segment between calls
+ * (initialize to 0). */
+float evaluate_fcurve_with_hint(struct FCurve *fcu, float evaltime, int *segment_hint);
 float evaluate_fcurve_only_curve(struct FCurve *fcu, float evaltime);
 float evaluate_fcurve_driver(struct PathResolvedRNA *anim_rna,
                              struct FCurve *fcu,
@@ -326,6 +329,12 @@ bool BKE_fcurve_is_empty(struct FCurve *fcu);
 float calculate_fcurve(struct PathResolvedRNA *anim_rna,
                        struct FCurve *fcu,
                        const struct AnimationEvalContext *anim_eval_context);
+/* Same as #calculate_fcurve, \a segment_hint caches the keyframe segment between calls
+ * (initialize to 0). */
+float calculate_fcurve_with_hint(struct PathResolvedRNA *anim_rna,
+                                 struct FCurve *fcu,
+                                 const struct AnimationEvalContext *anim_eval_context,
+                                 int *segment_hint);
 
 /* ************* F-Curve Samples API ******************** */
 
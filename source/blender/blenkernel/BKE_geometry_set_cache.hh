@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Files that store a geometry set, used to cache the result of a geometry nodes modifier on disk.
+ *
+ * A file starts with a small description of the components and their attributes, followed by
+ * the attribute arrays. Every array starts at an offset aligned to 64 bytes, so the file can be
+ * memory mapped and every array is copied into its layer with a single read.
+ *
+ * Meshes, point clouds and instances are stored. Data-blocks referenced by the geometry (the
+ * instanced objects and collections, materials) are stored by name and resolved when reading.
+ */
+
+#include "BLI_function_ref.hh"
+#include "BLI_string_ref.hh"
+
+#include "BKE_geometry_set.hh"
+
+struct ID;
+
+namespace blender::bke {
+
+/**
+ * Find the data-block with the given type and name (without the ID code prefix) that is used
+ * when reading a cached geometry. Returns null when there is no such data-block, instances and
+ * material slots that reference it are left empty then.
+ */
+using GeometrySetCacheIDResolver = FunctionRef<ID *(short id_type, StringRefNull name)>;
+
+/**
+ * Write the meshes, point clouds and instances of the geometry set to a file.
+ * Curves and volumes are not stored.
+ * \return false when the file could not be written.
+ */
+bool geometry_set_cache_write(const GeometrySet &geometry_set, const char *filepath);
+
+/**
+ * Read a geometry set written with #geometry_set_cache_write.
+ * \return false when the file does not exist, is not a valid cache file or is incomplete.
+ */
+bool geometry_set_cache_read(const char *filepath,
+                             GeometrySetCacheIDResolver resolve_id,
+                             GeometrySet &r_geometry_set);
+
+}  // namespace blender::bke
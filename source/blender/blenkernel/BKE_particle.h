@@ -27,6 +27,7 @@
  */
 
 #include "BLI_buffer.h"
+#include "BLI_kdopbvh.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_particle_types.h"
@@ -59,6 +60,7 @@ struct Main;
 struct ModifierData;
 struct Object;
 struct RNG;
+struct SPHGrid;
 struct Scene;
 
 #define PARTICLE_COLLISION_MAX_COLLISIONS 10
@@ -431,7 +433,17 @@ void psys_apply_child_modifiers(struct ParticleThreadContext *ctx,
 
 void psys_sph_init(struct ParticleSimulationData *sim, struct SPHData *sphdata);
 void psys_sph_finalize(struct SPHData *sphdata);
-void psys_sph_density(struct BVHTree *tree, struct SPHData *data, float co[3], float vars[2]);
+void psys_sph_density(struct SPHData *data, float co[3], float vars[2]);
+struct SPHGrid *psys_sph_grid_build(const int *index,
+                                    const float (*co)[3],
+                                    const int totpoint,
+                                    const float cell_size);
+void psys_sph_grid_range_query(const struct SPHGrid *grid,
+                               const float co[3],
+                               const float radius,
+                               BVHTree_RangeQuery callback,
+                               void *userdata);
+void psys_sph_grid_free(struct SPHGrid *grid);
 
 /* for anim.c */
 void psys_get_dupli_texture(struct ParticleSystem *psys,
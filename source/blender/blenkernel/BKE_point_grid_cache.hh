@@ -0,0 +1,41 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Grids of point positions for nearest point lookups, cached in the runtime data of meshes and
+ * point clouds. Like the BVH cache of meshes, the grids are freed when the geometry changes, so
+ * repeated lookups on an unchanged geometry (e.g. in every evaluation of a node tree that uses
+ * another object as target) don't rebuild them.
+ */
+
+#include "BLI_point_grid.hh"
+
+struct Mesh;
+struct PointCloud;
+
+namespace blender::bke {
+
+/** Get the grid of the mesh vertex positions, it is built when it does not exist yet. */
+const PointGrid &mesh_vert_point_grid_ensure(const Mesh &mesh);
+
+/** Get the grid of the point cloud positions, it is built when it does not exist yet. */
+const PointGrid &pointcloud_point_grid_ensure(const PointCloud &pointcloud);
+
+}  // namespace blender::bke
@@ -67,6 +67,8 @@ extern "C" {
 /* high bits reserved for flags that need to be stored in file */
 #define PTCACHE_TYPEFLAG_COMPRESS (1 << 16)
 #define PTCACHE_TYPEFLAG_EXTRADATA (1 << 17)
+/* Data types are stored in separate aligned columns, located by a table after the header. */
+#define PTCACHE_TYPEFLAG_COLUMNS (1 << 18)
 
 #define PTCACHE_TYPEFLAG_TYPEMASK 0x0000FFFF
 #define PTCACHE_TYPEFLAG_FLAGMASK 0xFFFF0000
@@ -42,6 +42,8 @@ struct PointCloud *BKE_pointcloud_new_nomain(const int totpoint);
 
 struct BoundBox *BKE_pointcloud_boundbox_get(struct Object *ob);
 void BKE_pointcloud_minmax(const struct PointCloud *pointcloud, float r_min[3], float r_max[3]);
+void BKE_pointcloud_transform(struct PointCloud *pointcloud, const float mat[4][4]);
+void BKE_pointcloud_translate(struct PointCloud *pointcloud, const float offset[3]);
 
 void BKE_pointcloud_update_customdata_pointers(struct PointCloud *pointcloud);
 bool BKE_pointcloud_customdata_required(struct PointCloud *pointcloud,
@@ -69,6 +71,10 @@ void BKE_pointcloud_batch_cache_free(struct PointCloud *pointcloud);
 extern void (*BKE_pointcloud_batch_cache_dirty_tag_cb)(struct PointCloud *pointcloud, int mode);
 extern void (*BKE_pointcloud_batch_cache_free_cb)(struct PointCloud *pointcloud);
 
+/* Point Grid Cache */
+
+void BKE_pointcloud_point_grid_free(struct PointCloud *pointcloud);
+
 #ifdef __cplusplus
 }
 #endif
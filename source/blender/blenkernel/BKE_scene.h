@@ -154,6 +154,13 @@ void BKE_scene_graph_evaluated_ensure(struct Depsgraph *depsgraph, struct Main *
 void BKE_scene_graph_update_for_newframe(struct Depsgraph *depsgraph);
 void BKE_scene_graph_update_for_newframe_ex(struct Depsgraph *depsgraph, const bool clear_recalc);
 
+/* Frame change split in two parts, so the dependency graph can be evaluated on a background
+ * thread. The evaluation is scheduled for the given frame and started with
+ * #BKE_scene_start_playback_depsgraphs. Finishing it runs the frame change handlers and informs
+ * editors on the main thread, once the scene is at that frame. */
+void BKE_scene_graph_update_for_newframe_background(struct Depsgraph *depsgraph, float ctime);
+void BKE_scene_graph_update_for_newframe_background_finish(struct Depsgraph *depsgraph);
+
 void BKE_scene_view_layer_graph_evaluated_ensure(struct Main *bmain,
                                                  struct Scene *scene,
                                                  struct ViewLayer *view_layer);
@@ -233,6 +240,24 @@ struct Depsgraph *BKE_scene_ensure_depsgraph(struct Main *bmain,
                                              struct Scene *scene,
                                              struct ViewLayer *view_layer);
 
+/* Second depsgraph of a view layer, used to evaluate the next frame in the background while the
+ * current one is drawn during playback. It is swapped with the depsgraph of the view layer when
+ * the playback reaches its frame. */
+struct Depsgraph *BKE_scene_get_playback_depsgraph(const struct Scene *scene,
+                                                   const struct ViewLayer *view_layer);
+struct Depsgraph *BKE_scene_ensure_playback_depsgraph(struct Main *bmain,
+                                                      struct Scene *scene,
+                                                      struct ViewLayer *view_layer);
+void BKE_scene_swap_playback_depsgraph(struct Scene *scene, struct ViewLayer *view_layer);
+/* Start the scheduled background evaluation of the playback depsgraphs of all scenes. Nothing may
+ * modify the original data-blocks until #BKE_scene_wait_playback_depsgraphs is called. */
+void BKE_scene_start_playback_depsgraphs(struct Main *bmain);
+/* Wait until the background evaluation of the playback depsgraphs of all scenes is done. Needed
+ * before the original data-blocks are modified or freed, as the evaluation reads them. */
+void BKE_scene_wait_playback_depsgraphs(struct Main *bmain);
+/* Free the playback depsgraphs of all scenes, returns true if there were any. */
+bool BKE_scene_free_playback_depsgraphs(struct Main *bmain);
+
 struct GHash *BKE_scene_undo_depsgraphs_extract(struct Main *bmain);
 void BKE_scene_undo_depsgraphs_restore(struct Main *bmain, struct GHash *depsgraph_extract);
 
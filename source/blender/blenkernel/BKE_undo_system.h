@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 struct Main;
+struct TaskPool;
 struct UndoStep;
 struct bContext;
 
@@ -76,6 +77,14 @@ typedef struct UndoStack {
    * within which all but the last undo-step is marked for skipping.
    */
   int group_level;
+
+  /**
+   * Steps that aren't active are compressed in the background, see #UndoType.step_compress.
+   * Created on first use.
+   */
+  struct TaskPool *compress_pool;
+  /** Compression jobs, the sizes they calculate are applied once the pool is done. */
+  ListBase compress_jobs;
 } UndoStack;
 
 typedef struct UndoStep {
@@ -93,6 +102,8 @@ typedef struct UndoStep {
   bool use_old_bmain_data;
   /** For use by undo systems that accumulate changes (text editor, painting). */
   bool is_applied;
+  /** The data has been compressed by #UndoType.step_compress. */
+  bool is_compressed;
   /* Over alloc 'type->struct_size'. */
 } UndoStep;
 
@@ -146,6 +157,20 @@ typedef struct UndoType {
                               UndoTypeForEachIDRefFn foreach_ID_ref_fn,
                               void *user_data);
 
+  /**
+   * Optional, reduce the memory used by a step that isn't active anymore.
+   * Runs in a background thread, so only data of the step and of \a us_next
+   * (the next step of the same type) may be accessed.
+   *
+   * \return the new #UndoStep.data_size.
+   */
+  size_t (*step_compress)(UndoStep *us, UndoStep *us_next);
+  /**
+   * Restore data compressed by #step_compress, called before the step is decoded,
+   * see #BKE_undosys_step_decompress.
+   */
+  void (*step_decompress)(UndoStep *us);
+
   /** Information for the generic undo system to refine handling of this specific undo type. */
   uint flags;
 
@@ -209,6 +234,8 @@ UndoStep *BKE_undosys_step_find_by_name_with_type(UndoStack *ustack,
 UndoStep *BKE_undosys_step_find_by_type(UndoStack *ustack, const UndoType *ut);
 UndoStep *BKE_undosys_step_find_by_name(UndoStack *ustack, const char *name);
 
+void BKE_undosys_step_decompress(UndoStack *ustack, UndoStep *us);
+
 eUndoStepDir BKE_undosys_step_calc_direction(const UndoStack *ustack,
                                              const UndoStep *us_target,
                                              const UndoStep *us_reference);
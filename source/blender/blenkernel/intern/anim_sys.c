@@ -769,6 +769,251 @@ void animsys_evaluate_action(PointerRNA *ptr,
   animsys_evaluate_fcurves(ptr, &act->curves, anim_eval_context, flush_to_original);
 }
 
+/* ----------------------------------------- */
+
+/* Pre-Resolved Action Evaluation
+ *
+ * Resolving RNA paths parses strings and looks up properties and collection items, which
+ * dominates evaluation time of actions with many F-Curves (character rigs). When evaluating
+ * copy-on-write data-blocks in the depsgraph, paths of the active action are resolved once and
+ * kept in #AnimData.eval_bindings, which is freed along with the animation data whenever the
+ * depsgraph copies the data-block again (on changes to it, or when relations are rebuilt).
+ *
+ * The action can be copied again on its own, so each binding keeps a copy of the path it was
+ * resolved for and is updated when the F-Curve doesn't match anymore.
+ *
+ * Actions evaluated by NLA strips only keep the keyframe segment of every F-Curve, the paths are
+ * resolved through the NLA channels. */
+
+typedef enum eAnimEvalBindingState {
+  ANIM_BINDING_UNRESOLVED = 0,
+  /** The path can't be resolved, the F-Curve is skipped. */
+  ANIM_BINDING_INVALID,
+  /** The resolved property is used directly. */
+  ANIM_BINDING_RESOLVED,
+  /** The path leads to data of another data-block, which can be reallocated without this
+   * data-block being copied again. It's resolved on every evaluation. */
+  ANIM_BINDING_DYNAMIC,
+} eAnimEvalBindingState;
+
+typedef struct AnimationEvalBinding {
+  /** Path and index of the F-Curve the binding was resolved for. */
+  char *rna_path;
+  int array_index;
+
+  char state;
+  /** Binding to the original data-block, resolved on first use when flushing to original. */
+  char orig_state;
+
+  /** Keyframe segment used by the previous evaluation, see #calculate_fcurve_with_hint. */
+  int segment_hint;
+
+  PathResolvedRNA anim_rna;
+  PathResolvedRNA orig_anim_rna;
+} AnimationEvalBinding;
+
+/** Keyframe segments of the F-Curves of an action evaluated by the NLA. */
+typedef struct NlaActionSegmentHints {
+  int curves_num;
+  int *hints;
+} NlaActionSegmentHints;
+
+typedef struct AnimationEvalBindings {
+  /** The action the bindings were created for, one binding per F-Curve. */
+  bAction *action;
+  int bindings_num;
+  AnimationEvalBinding *bindings;
+
+  /** #NlaActionSegmentHints of actions evaluated by the NLA, keyed by the action. */
+  GHash *nla_segment_hints;
+} AnimationEvalBindings;
+
+static void animsys_eval_bindings_clear(AnimationEvalBindings *bindings)
+{
+  for (int i = 0; i < bindings->bindings_num; i++) {
+    MEM_SAFE_FREE(bindings->bindings[i].rna_path);
+  }
+  MEM_SAFE_FREE(bindings->bindings);
+  bindings->bindings_num = 0;
+  bindings->action = NULL;
+}
+
+static void nla_action_segment_hints_free(void *hints_v)
+{
+  NlaActionSegmentHints *hints = hints_v;
+  MEM_SAFE_FREE(hints->hints);
+  MEM_freeN(hints);
+}
+
+void BKE_animsys_free_eval_bindings(AnimData *adt)
+{
+  if (adt->eval_bindings != NULL) {
+    animsys_eval_bindings_clear(adt->eval_bindings);
+    if (adt->eval_bindings->nla_segment_hints != NULL) {
+      BLI_ghash_free(adt->eval_bindings->nla_segment_hints, NULL, nla_action_segment_hints_free);
+    }
+    MEM_freeN(adt->eval_bindings);
+    adt->eval_bindings = NULL;
+  }
+}
+
+static AnimationEvalBindings *animsys_eval_bindings_get(AnimData *adt)
+{
+  if (adt->eval_bindings == NULL) {
+    adt->eval_bindings = MEM_callocN(sizeof(AnimationEvalBindings), __func__);
+  }
+  return adt->eval_bindings;
+}
+
+static AnimationEvalBindings *animsys_eval_bindings_ensure(AnimData *adt, bAction *act)
+{
+  AnimationEvalBindings *bindings = animsys_eval_bindings_get(adt);
+  const int curves_num = BLI_listbase_count(&act->curves);
+  if (bindings->action != act || bindings->bindings_num != curves_num) {
+    animsys_eval_bindings_clear(bindings);
+    bindings->action = act;
+    bindings->bindings_num = curves_num;
+    bindings->bindings = MEM_calloc_arrayN(
+        curves_num, sizeof(AnimationEvalBinding), "AnimationEvalBinding");
+  }
+  return bindings;
+}
+
+static GHash *animsys_eval_bindings_nla_segment_hints(AnimData *adt)
+{
+  AnimationEvalBindings *bindings = animsys_eval_bindings_get(adt);
+  if (bindings->nla_segment_hints == NULL) {
+    bindings->nla_segment_hints = BLI_ghash_ptr_new(__func__);
+  }
+  return bindings->nla_segment_hints;
+}
+
+/* Get the segment hints of the F-Curves of the action, reset when the action changed. */
+static int *nla_action_segment_hints_ensure(GHash *segment_hints, bAction *act)
+{
+  const int curves_num = BLI_listbase_count(&act->curves);
+  void **hints_p;
+  if (!BLI_ghash_ensure_p(segment_hints, act, &hints_p)) {
+    *hints_p = MEM_callocN(sizeof(NlaActionSegmentHints), __func__);
+  }
+  NlaActionSegmentHints *hints = *hints_p;
+  if (hints->curves_num != curves_num) {
+    MEM_SAFE_FREE(hints->hints);
+    hints->curves_num = curves_num;
+    hints->hints = MEM_calloc_arrayN(curves_num, sizeof(int), __func__);
+  }
+  return hints->hints;
+}
+
+static char animsys_eval_binding_resolve(PointerRNA *ptr,
+                                         const FCurve *fcu,
+                                         PathResolvedRNA *r_anim_rna)
+{
+  if (!BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, r_anim_rna)) {
+    return ANIM_BINDING_INVALID;
+  }
+  if (r_anim_rna->ptr.owner_id != ptr->owner_id) {
+    return ANIM_BINDING_DYNAMIC;
+  }
+  return ANIM_BINDING_RESOLVED;
+}
+
+/* Make sure the binding matches the F-Curve, resolving it again if needed. */
+static void animsys_eval_binding_update(PointerRNA *ptr,
+                                        AnimationEvalBinding *binding,
+                                        const FCurve *fcu)
+{
+  if (binding->state != ANIM_BINDING_UNRESOLVED) {
+    if (binding->array_index == fcu->array_index && fcu->rna_path != NULL &&
+        STREQ(binding->rna_path, fcu->rna_path)) {
+      return;
+    }
+    MEM_SAFE_FREE(binding->rna_path);
+  }
+
+  binding->rna_path = BLI_strdup(fcu->rna_path ? fcu->rna_path : "");
+  binding->array_index = fcu->array_index;
+  binding->state = animsys_eval_binding_resolve(ptr, fcu, &binding->anim_rna);
+  binding->orig_state = ANIM_BINDING_UNRESOLVED;
+  binding->segment_hint = 0;
+}
+
+static void animsys_eval_binding_write_orig(PointerRNA *ptr,
+                                            AnimationEvalBinding *binding,
+                                            const FCurve *fcu,
+                                            const float value)
+{
+  if (binding->orig_state == ANIM_BINDING_UNRESOLVED) {
+    PointerRNA ptr_orig;
+    binding->orig_state = animsys_construct_orig_pointer_rna(ptr, &ptr_orig) ?
+                              animsys_eval_binding_resolve(
+                                  &ptr_orig, fcu, &binding->orig_anim_rna) :
+                              ANIM_BINDING_INVALID;
+  }
+
+  switch (binding->orig_state) {
+    case ANIM_BINDING_RESOLVED:
+      BKE_animsys_write_to_rna_path(&binding->orig_anim_rna, value);
+      break;
+    case ANIM_BINDING_DYNAMIC:
+      animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, value);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Same as #animsys_evaluate_action, using paths resolved on previous evaluations.
+ * Only valid for evaluated copies of data-blocks, see #AnimationEvalBindings.
+ */
+static void animsys_evaluate_action_bound(PointerRNA *ptr,
+                                          AnimData *adt,
+                                          bAction *act,
+                                          const AnimationEvalContext *anim_eval_context,
+                                          const bool flush_to_original)
+{
+  action_idcode_patch_check(ptr->owner_id, act);
+
+  AnimationEvalBindings *bindings = animsys_eval_bindings_ensure(adt, act);
+
+  int i;
+  LISTBASE_FOREACH_INDEX (FCurve *, fcu, &act->curves, i) {
+    if (!is_fcurve_evaluatable(fcu)) {
+      continue;
+    }
+
+    AnimationEvalBinding *binding = &bindings->bindings[i];
+    animsys_eval_binding_update(ptr, binding, fcu);
+
+    float curval;
+    switch (binding->state) {
+      case ANIM_BINDING_RESOLVED: {
+        curval = calculate_fcurve_with_hint(
+            &binding->anim_rna, fcu, anim_eval_context, &binding->segment_hint);
+        BKE_animsys_write_to_rna_path(&binding->anim_rna, curval);
+        break;
+      }
+      case ANIM_BINDING_DYNAMIC: {
+        PathResolvedRNA anim_rna;
+        if (!BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
+          continue;
+        }
+        curval = calculate_fcurve_with_hint(
+            &anim_rna, fcu, anim_eval_context, &binding->segment_hint);
+        BKE_animsys_write_to_rna_path(&anim_rna, curval);
+        break;
+      }
+      default:
+        continue;
+    }
+
+    if (flush_to_original) {
+      animsys_eval_binding_write_orig(ptr, binding, fcu, curval);
+    }
+  }
+}
+
 /* ***************************************** */
 /* NLA System - Evaluation */
 
@@ -2077,8 +2322,6 @@ static void nlasnapshot_from_action(PointerRNA *ptr,
                                     const float evaltime,
                                     NlaEvalSnapshot *r_snapshot)
 {
-  FCurve *fcu;
-
   action_idcode_patch_check(ptr->owner_id, action);
 
   /* Evaluate modifiers which modify time to evaluate the base curves at. */
@@ -2090,7 +2333,13 @@ static void nlasnapshot_from_action(PointerRNA *ptr,
   const float modified_evaltime = evaluate_time_fmodifiers(
       &storage, modifiers, NULL, 0.0f, evaltime);
 
-  for (fcu = action->curves.first; fcu; fcu = fcu->next) {
+  int *segment_hints = NULL;
+  if (channels->segment_hints != NULL) {
+    segment_hints = nla_action_segment_hints_ensure(channels->segment_hints, action);
+  }
+
+  int i;
+  LISTBASE_FOREACH_INDEX (FCurve *, fcu, &action->curves, i) {
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
@@ -2108,7 +2357,9 @@ static void nlasnapshot_from_action(PointerRNA *ptr,
 
     NlaEvalChannelSnapshot *necs = nlaeval_snapshot_ensure_channel(r_snapshot, nec);
 
-    float value = evaluate_fcurve(fcu, modified_evaltime);
+    float value = (segment_hints != NULL) ?
+                      evaluate_fcurve_with_hint(fcu, modified_evaltime, &segment_hints[i]) :
+                      evaluate_fcurve(fcu, modified_evaltime);
     evaluate_value_fmodifiers(&storage, modifiers, fcu, &value, evaltime);
     necs->values[fcu->array_index] = value;
 
@@ -2806,11 +3057,15 @@ static void animsys_evaluate_nla_for_keyframing(PointerRNA *ptr,
 static void animsys_calculate_nla(PointerRNA *ptr,
                                   AnimData *adt,
                                   const AnimationEvalContext *anim_eval_context,
-                                  const bool flush_to_original)
+                                  const bool flush_to_original,
+                                  const bool use_bindings)
 {
   NlaEvalData echannels;
 
   nlaeval_init(&echannels);
+  if (use_bindings) {
+    echannels.segment_hints = animsys_eval_bindings_nla_segment_hints(adt);
+  }
 
   /* evaluate the NLA stack, obtaining a set of values to flush */
   if (animsys_evaluate_nla_for_flush(&echannels, ptr, adt, anim_eval_context, flush_to_original)) {
@@ -2827,7 +3082,12 @@ static void animsys_calculate_nla(PointerRNA *ptr,
       CLOG_WARN(&LOG, "NLA Eval: Stopgap for active action on NLA Stack - no strips case");
     }
 
-    animsys_evaluate_action(ptr, adt->action, anim_eval_context, flush_to_original);
+    if (use_bindings) {
+      animsys_evaluate_action_bound(ptr, adt, adt->action, anim_eval_context, flush_to_original);
+    }
+    else {
+      animsys_evaluate_action(ptr, adt->action, anim_eval_context, flush_to_original);
+    }
   }
 
   /* free temp data */
@@ -3154,11 +3414,12 @@ static void animsys_evaluate_overrides(PointerRNA *ptr, AnimData *adt)
  * and that the flags for which parts of the anim-data settings need to be recalculated
  * have been set already by the depsgraph. Now, we use the recalc
  */
-void BKE_animsys_evaluate_animdata(ID *id,
-                                   AnimData *adt,
-                                   const AnimationEvalContext *anim_eval_context,
-                                   eAnimData_Recalc recalc,
-                                   const bool flush_to_original)
+static void animsys_evaluate_animdata_ex(ID *id,
+                                        AnimData *adt,
+                                        const AnimationEvalContext *anim_eval_context,
+                                        eAnimData_Recalc recalc,
+                                        const bool flush_to_original,
+                                        const bool use_bindings)
 {
   PointerRNA id_ptr;
 
@@ -3181,11 +3442,17 @@ void BKE_animsys_evaluate_animdata(ID *id,
       /* evaluate NLA-stack
        * - active action is evaluated as part of the NLA stack as the last item
        */
-      animsys_calculate_nla(&id_ptr, adt, anim_eval_context, flush_to_original);
+      animsys_calculate_nla(&id_ptr, adt, anim_eval_context, flush_to_original, use_bindings);
     }
     /* evaluate Active Action only */
     else if (adt->action) {
-      animsys_evaluate_action(&id_ptr, adt->action, anim_eval_context, flush_to_original);
+      if (use_bindings) {
+        animsys_evaluate_action_bound(
+            &id_ptr, adt, adt->action, anim_eval_context, flush_to_original);
+      }
+      else {
+        animsys_evaluate_action(&id_ptr, adt->action, anim_eval_context, flush_to_original);
+      }
     }
   }
 
@@ -3207,6 +3474,15 @@ void BKE_animsys_evaluate_animdata(ID *id,
   animsys_evaluate_overrides(&id_ptr, adt);
 }
 
+void BKE_animsys_evaluate_animdata(ID *id,
+                                   AnimData *adt,
+                                   const AnimationEvalContext *anim_eval_context,
+                                   eAnimData_Recalc recalc,
+                                   const bool flush_to_original)
+{
+  animsys_evaluate_animdata_ex(id, adt, anim_eval_context, recalc, flush_to_original, false);
+}
+
 /* Evaluation of all ID-blocks with Animation Data blocks - Animation Data Only
  *
  * This will evaluate only the animation info available in the animation data-blocks
@@ -3376,7 +3652,10 @@ void BKE_animsys_eval_animdata(Depsgraph *depsgraph, ID *id)
 
   const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(depsgraph,
                                                                                     ctime);
-  BKE_animsys_evaluate_animdata(id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original);
+  /* Evaluated copies are only modified by the depsgraph, resolved paths can be kept. */
+  const bool use_bindings = DEG_is_evaluated_id(id);
+  animsys_evaluate_animdata_ex(
+      id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original, use_bindings);
 }
 
 void BKE_animsys_update_driver_array(ID *id)
@@ -34,6 +34,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_simd.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
@@ -231,6 +232,465 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Skinning Table
+ *
+ * Vertex group weights compiled into flat arrays of bone indices and weights per vertex,
+ * so deforming a vertex doesn't need to look up bones or check their settings for every
+ * weight. The bone matrices or dual quaternions are blended before transforming the vertex.
+ *
+ * Vertices influenced by B-Bones or bones that multiply their weights with the envelope,
+ * or that fall back to envelopes, use the generic code path.
+ *
+ * Evaluated mesh objects keep a table per armature in #Object_Runtime.armature_skinning_cache.
+ * It's built again when the mesh is updated, when the weights don't come from the mesh
+ * data-block anymore, or when vertex groups map to other kinds of bones.
+ * \{ */
+
+/** How the weights of a vertex group are used by the skinning table. */
+enum {
+  /** No deforming bone for the vertex group. */
+  SKINNING_GROUP_UNUSED = 0,
+  SKINNING_GROUP_BONE = 1,
+  /** The bone needs the generic code path. */
+  SKINNING_GROUP_GENERIC = 2,
+};
+
+typedef struct ArmatureSkinningTable {
+  struct ArmatureSkinningTable *next, *prev;
+
+  /** Armature the table is cached for, only used as key. */
+  const Object *ob_arm;
+  /** Weights and bone mapping the table was built for. */
+  const MDeformVert *dverts;
+  int verts_len;
+  int defbase_len;
+  bool use_envelope;
+  /** `SKINNING_GROUP_*` of every vertex group. */
+  char *group_states;
+
+  /** Vertex `i` uses the influences `vert_offsets[i]` to `vert_offsets[i + 1]`. */
+  int *vert_offsets;
+  bool *vert_is_generic;
+  /** Index into the bone arrays (same as the vertex group index) and weight of influences. */
+  int *bone_indices;
+  float *weights;
+
+  /**
+   * Rows of the 3x4 deform matrix of each bone, used for linear blend skinning.
+   * Bones are updated before every deformation, see #armature_skinning_table_update_bones.
+   */
+  float (*bone_rows)[3][4];
+  const DualQuat **bone_dquats;
+} ArmatureSkinningTable;
+
+typedef struct ArmatureSkinningCache {
+  ListBase tables;
+} ArmatureSkinningCache;
+
+typedef struct ArmatureSkinningBuildData {
+  ArmatureSkinningTable *table;
+  const MDeformVert *dverts;
+  const char *group_states;
+  int defbase_len;
+  bool use_envelope;
+} ArmatureSkinningBuildData;
+
+static char armature_skinning_weight_state(const ArmatureSkinningBuildData *data,
+                                           const MDeformWeight *dw)
+{
+  return (dw->def_nr < data->defbase_len) ? data->group_states[dw->def_nr] :
+                                            SKINNING_GROUP_UNUSED;
+}
+
+static void armature_skinning_count_task(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ArmatureSkinningBuildData *data = userdata;
+  ArmatureSkinningTable *table = data->table;
+  const MDeformVert *dvert = &data->dverts[i];
+
+  bool is_generic = false;
+  int influences_len = 0;
+  bool deformed = false;
+  for (int j = 0; j < dvert->totweight; j++) {
+    const MDeformWeight *dw = &dvert->dw[j];
+    const char state = armature_skinning_weight_state(data, dw);
+    if (state == SKINNING_GROUP_UNUSED) {
+      continue;
+    }
+    deformed = true;
+    if (state == SKINNING_GROUP_GENERIC) {
+      is_generic = true;
+    }
+    else if (dw->weight != 0.0f) {
+      influences_len++;
+    }
+  }
+  /* Without vertex groups for bones envelopes are used instead. */
+  if (!deformed && data->use_envelope) {
+    is_generic = true;
+  }
+
+  table->vert_is_generic[i] = is_generic;
+  table->vert_offsets[i + 1] = is_generic ? 0 : influences_len;
+}
+
+static void armature_skinning_fill_task(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ArmatureSkinningBuildData *data = userdata;
+  ArmatureSkinningTable *table = data->table;
+  const MDeformVert *dvert = &data->dverts[i];
+
+  if (table->vert_is_generic[i]) {
+    return;
+  }
+  int influence = table->vert_offsets[i];
+  for (int j = 0; j < dvert->totweight; j++) {
+    const MDeformWeight *dw = &dvert->dw[j];
+    if (armature_skinning_weight_state(data, dw) == SKINNING_GROUP_BONE &&
+        dw->weight != 0.0f) {
+      table->bone_indices[influence] = (int)dw->def_nr;
+      table->weights[influence] = dw->weight;
+      influence++;
+    }
+  }
+  BLI_assert(influence == table->vert_offsets[i + 1]);
+}
+
+static char *armature_skinning_group_states(bPoseChannel **pchan_from_defbase,
+                                            const int defbase_len)
+{
+  char *group_states = MEM_calloc_arrayN(defbase_len, sizeof(char), __func__);
+  for (int i = 0; i < defbase_len; i++) {
+    const bPoseChannel *pchan = pchan_from_defbase[i];
+    if (pchan == NULL) {
+      continue;
+    }
+    const Bone *bone = pchan->bone;
+    const bool is_generic = (bone->flag & BONE_MULT_VG_ENV) ||
+                            (bone->segments > 1 &&
+                             pchan->runtime.bbone_segments == bone->segments);
+    group_states[i] = is_generic ? SKINNING_GROUP_GENERIC : SKINNING_GROUP_BONE;
+  }
+  return group_states;
+}
+
+/** Build a table for the weights, taking ownership of \a group_states. */
+static ArmatureSkinningTable *armature_skinning_table_create(const MDeformVert *dverts,
+                                                             const int verts_len,
+                                                             char *group_states,
+                                                             const int defbase_len,
+                                                             const bool use_envelope)
+{
+  ArmatureSkinningTable *table = MEM_callocN(sizeof(*table), __func__);
+  table->dverts = dverts;
+  table->verts_len = verts_len;
+  table->defbase_len = defbase_len;
+  table->use_envelope = use_envelope;
+  table->group_states = group_states;
+  table->vert_offsets = MEM_malloc_arrayN(verts_len + 1, sizeof(int), __func__);
+  table->vert_is_generic = MEM_malloc_arrayN(verts_len, sizeof(bool), __func__);
+  table->bone_rows = MEM_calloc_arrayN(defbase_len, sizeof(*table->bone_rows), __func__);
+  table->bone_dquats = MEM_calloc_arrayN(defbase_len, sizeof(*table->bone_dquats), __func__);
+
+  ArmatureSkinningBuildData data = {
+      .table = table,
+      .dverts = dverts,
+      .group_states = group_states,
+      .defbase_len = defbase_len,
+      .use_envelope = use_envelope,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  BLI_task_parallel_range(0, verts_len, &data, armature_skinning_count_task, &settings);
+  table->vert_offsets[0] = 0;
+  for (int i = 0; i < verts_len; i++) {
+    table->vert_offsets[i + 1] += table->vert_offsets[i];
+  }
+  const int influences_len = table->vert_offsets[verts_len];
+  table->bone_indices = MEM_malloc_arrayN(influences_len, sizeof(int), __func__);
+  table->weights = MEM_malloc_arrayN(influences_len, sizeof(float), __func__);
+  BLI_task_parallel_range(0, verts_len, &data, armature_skinning_fill_task, &settings);
+
+  return table;
+}
+
+static void armature_skinning_table_free(ArmatureSkinningTable *table)
+{
+  MEM_freeN(table->group_states);
+  MEM_freeN(table->vert_offsets);
+  MEM_freeN(table->vert_is_generic);
+  MEM_freeN(table->bone_indices);
+  MEM_freeN(table->weights);
+  MEM_freeN(table->bone_rows);
+  MEM_freeN(table->bone_dquats);
+  MEM_freeN(table);
+}
+
+static bool armature_skinning_table_matches(const ArmatureSkinningTable *table,
+                                            const MDeformVert *dverts,
+                                            const int verts_len,
+                                            const char *group_states,
+                                            const int defbase_len,
+                                            const bool use_envelope)
+{
+  return (table->dverts == dverts) && (table->verts_len == verts_len) &&
+         (table->defbase_len == defbase_len) && (table->use_envelope == use_envelope) &&
+         (memcmp(table->group_states, group_states, defbase_len) == 0);
+}
+
+/**
+ * Get the mesh data-block owning \a dverts when the table for them can be cached in the
+ * evaluated object. Weights added or changed by modifiers before the armature are created
+ * again on every evaluation, so they are not cached.
+ */
+static const Mesh *armature_skinning_cache_mesh(const Object *ob_target,
+                                                const MDeformVert *dverts)
+{
+  if (ob_target->type != OB_MESH || (ob_target->id.tag & LIB_TAG_COPIED_ON_WRITE) == 0) {
+    return NULL;
+  }
+  const Mesh *me = (const Mesh *)(ob_target->runtime.data_orig ? ob_target->runtime.data_orig :
+                                                                 ob_target->data);
+  return (me->dvert == dverts) ? me : NULL;
+}
+
+/**
+ * Get a skinning table for the weights, from the cache of the evaluated object when possible.
+ * \param r_is_cached: When false, the table has to be freed by the caller.
+ */
+static ArmatureSkinningTable *armature_skinning_table_ensure(const Object *ob_arm,
+                                                             const Object *ob_target,
+                                                             const MDeformVert *dverts,
+                                                             const int verts_len,
+                                                             bPoseChannel **pchan_from_defbase,
+                                                             const int defbase_len,
+                                                             const bool use_envelope,
+                                                             bool *r_is_cached)
+{
+  char *group_states = armature_skinning_group_states(pchan_from_defbase, defbase_len);
+  const Mesh *me = armature_skinning_cache_mesh(ob_target, dverts);
+  *r_is_cached = (me != NULL);
+  if (me == NULL) {
+    return armature_skinning_table_create(
+        dverts, verts_len, group_states, defbase_len, use_envelope);
+  }
+
+  /* The object is only deformed by its own evaluation, so the cache is not shared between
+   * threads. */
+  Object *ob_target_eval = (Object *)ob_target;
+  ArmatureSkinningCache *cache = ob_target_eval->runtime.armature_skinning_cache;
+  if (cache == NULL) {
+    cache = MEM_callocN(sizeof(*cache), __func__);
+    ob_target_eval->runtime.armature_skinning_cache = cache;
+  }
+
+  ArmatureSkinningTable *table = NULL;
+  LISTBASE_FOREACH (ArmatureSkinningTable *, cached_table, &cache->tables) {
+    if (cached_table->ob_arm == ob_arm) {
+      table = cached_table;
+      break;
+    }
+  }
+
+  /* Weights of the mesh data-block only change with an update of the mesh. That includes the
+   * mesh being copied again, which can reallocate the weights at the same address. */
+  const bool mesh_updated = (me->id.recalc & (ID_RECALC_GEOMETRY | ID_RECALC_COPY_ON_WRITE)) !=
+                            0;
+  if (table != NULL &&
+      (mesh_updated ||
+       !armature_skinning_table_matches(
+           table, dverts, verts_len, group_states, defbase_len, use_envelope))) {
+    BLI_remlink(&cache->tables, table);
+    armature_skinning_table_free(table);
+    table = NULL;
+  }
+
+  if (table == NULL) {
+    table = armature_skinning_table_create(
+        dverts, verts_len, group_states, defbase_len, use_envelope);
+    table->ob_arm = ob_arm;
+    BLI_addtail(&cache->tables, table);
+  }
+  else {
+    MEM_freeN(group_states);
+  }
+  return table;
+}
+
+/** Copy the current deformation of the bones used by the table. */
+static void armature_skinning_table_update_bones(ArmatureSkinningTable *table,
+                                                 bPoseChannel **pchan_from_defbase)
+{
+  for (int i = 0; i < table->defbase_len; i++) {
+    if (table->group_states[i] != SKINNING_GROUP_BONE) {
+      continue;
+    }
+    const bPoseChannel *pchan = pchan_from_defbase[i];
+    for (int row = 0; row < 3; row++) {
+      for (int col = 0; col < 4; col++) {
+        table->bone_rows[i][row][col] = pchan->chan_mat[col][row];
+      }
+    }
+    table->bone_dquats[i] = &pchan->runtime.deform_dual_quat;
+  }
+}
+
+void BKE_armature_skinning_cache_free(Object *ob)
+{
+  ArmatureSkinningCache *cache = ob->runtime.armature_skinning_cache;
+  if (cache == NULL) {
+    return;
+  }
+  LISTBASE_FOREACH_MUTABLE (ArmatureSkinningTable *, table, &cache->tables) {
+    armature_skinning_table_free(table);
+  }
+  MEM_freeN(cache);
+  ob->runtime.armature_skinning_cache = NULL;
+}
+
+static bool armature_skinning_vert_is_compiled(const ArmatureSkinningTable *table, const int i)
+{
+  return (i < table->verts_len) && !table->vert_is_generic[i];
+}
+
+#ifdef BLI_HAVE_SSE2
+BLI_INLINE float armature_skinning_dot_v4(const __m128 a, const __m128 b)
+{
+  __m128 sum = _mm_mul_ps(a, b);
+  sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtss_f32(sum);
+}
+#endif
+
+/** Same as calling #add_weighted_dq_dq for all bones influencing vertex \a i. */
+static float armature_skinning_vert_accumulate_dq(const ArmatureSkinningTable *table,
+                                                  const int i,
+                                                  DualQuat *dq)
+{
+  const int start = table->vert_offsets[i];
+  const int end = table->vert_offsets[i + 1];
+  float contrib = 0.0f;
+
+#ifdef BLI_HAVE_SSE2
+  __m128 quat = _mm_loadu_ps(dq->quat);
+  __m128 trans = _mm_loadu_ps(dq->trans);
+  __m128 scale[4];
+  for (int row = 0; row < 4; row++) {
+    scale[row] = _mm_loadu_ps(dq->scale[row]);
+  }
+  float scale_weight = dq->scale_weight;
+
+  for (int j = start; j < end; j++) {
+    const DualQuat *bone_dq = table->bone_dquats[table->bone_indices[j]];
+    const float weight = table->weights[j];
+    const __m128 bone_quat = _mm_loadu_ps(bone_dq->quat);
+
+    /* Make sure we interpolate quaternions in the right direction. */
+    const __m128 signed_weight = _mm_set1_ps(
+        (armature_skinning_dot_v4(bone_quat, quat) < 0.0f) ? -weight : weight);
+    quat = _mm_add_ps(quat, _mm_mul_ps(signed_weight, bone_quat));
+    trans = _mm_add_ps(trans, _mm_mul_ps(signed_weight, _mm_loadu_ps(bone_dq->trans)));
+
+    /* Scale is only interpolated when present, with a positive weight. */
+    if (bone_dq->scale_weight) {
+      const __m128 scale_fac = _mm_set1_ps(weight);
+      for (int row = 0; row < 4; row++) {
+        scale[row] = _mm_add_ps(scale[row],
+                                _mm_mul_ps(scale_fac, _mm_loadu_ps(bone_dq->scale[row])));
+      }
+      scale_weight += weight;
+    }
+    contrib += weight;
+  }
+
+  _mm_storeu_ps(dq->quat, quat);
+  _mm_storeu_ps(dq->trans, trans);
+  for (int row = 0; row < 4; row++) {
+    _mm_storeu_ps(dq->scale[row], scale[row]);
+  }
+  dq->scale_weight = scale_weight;
+#else
+  for (int j = start; j < end; j++) {
+    add_weighted_dq_dq(dq, table->bone_dquats[table->bone_indices[j]], table->weights[j]);
+    contrib += table->weights[j];
+  }
+#endif
+
+  return contrib;
+}
+
+/**
+ * Same as calling #pchan_bone_deform for all bones influencing vertex \a i.
+ * Returns the sum of the weights.
+ */
+static float armature_skinning_vert_deform(const ArmatureSkinningTable *table,
+                                           const int i,
+                                           const float co[3],
+                                           float vec[3],
+                                           DualQuat *dq,
+                                           float mat[3][3])
+{
+  if (dq) {
+    return armature_skinning_vert_accumulate_dq(table, i, dq);
+  }
+
+  const int start = table->vert_offsets[i];
+  const int end = table->vert_offsets[i + 1];
+  float contrib = 0.0f;
+
+  /* Blend the deform matrices, then apply them once. */
+  float rows[3][4];
+#ifdef BLI_HAVE_SSE2
+  __m128 row_x = _mm_setzero_ps();
+  __m128 row_y = _mm_setzero_ps();
+  __m128 row_z = _mm_setzero_ps();
+  for (int j = start; j < end; j++) {
+    const float(*bone_rows)[4] = table->bone_rows[table->bone_indices[j]];
+    const __m128 weight = _mm_set1_ps(table->weights[j]);
+    row_x = _mm_add_ps(row_x, _mm_mul_ps(weight, _mm_loadu_ps(bone_rows[0])));
+    row_y = _mm_add_ps(row_y, _mm_mul_ps(weight, _mm_loadu_ps(bone_rows[1])));
+    row_z = _mm_add_ps(row_z, _mm_mul_ps(weight, _mm_loadu_ps(bone_rows[2])));
+    contrib += table->weights[j];
+  }
+  _mm_storeu_ps(rows[0], row_x);
+  _mm_storeu_ps(rows[1], row_y);
+  _mm_storeu_ps(rows[2], row_z);
+#else
+  memset(rows, 0, sizeof(rows));
+  for (int j = start; j < end; j++) {
+    const float(*bone_rows)[4] = table->bone_rows[table->bone_indices[j]];
+    const float weight = table->weights[j];
+    for (int row = 0; row < 3; row++) {
+      madd_v4_v4fl(rows[row], bone_rows[row], weight);
+    }
+    contrib += weight;
+  }
+#endif
+
+  for (int row = 0; row < 3; row++) {
+    vec[row] += dot_v3v3(rows[row], co) + rows[row][3] - contrib * co[row];
+  }
+  if (mat) {
+    for (int row = 0; row < 3; row++) {
+      for (int col = 0; col < 3; col++) {
+        mat[col][row] += rows[row][col];
+      }
+    }
+  }
+  return contrib;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -258,6 +718,9 @@ typedef struct ArmatureUserdata {
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
+  /** Compiled vertex group weights, only when deforming an array of vertices. */
+  const ArmatureSkinningTable *skinning;
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -327,7 +790,10 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   /* Apply the object's matrix */
   mul_m4_v3(data->premat, co);
 
-  if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
+  if (data->skinning && armature_skinning_vert_is_compiled(data->skinning, i)) {
+    contrib = armature_skinning_vert_deform(data->skinning, i, co, vec, dq, smat);
+  }
+  else if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
     const MDeformWeight *dw = dvert->dw;
     int deformed = 0;
     unsigned int j;
@@ -610,10 +1076,31 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     }
   }
   else {
+    ArmatureSkinningTable *skinning = NULL;
+    bool skinning_is_cached = false;
+    if (use_dverts) {
+      const MDeformVert *skinning_dverts = me_target ? me_target->dvert : dverts;
+      const int skinning_dverts_len = me_target ? me_target->totvert : dverts_len;
+      skinning = armature_skinning_table_ensure(ob_arm,
+                                                ob_target,
+                                                skinning_dverts,
+                                                min_ii(skinning_dverts_len, vert_coords_len),
+                                                pchan_from_defbase,
+                                                defbase_len,
+                                                use_envelope,
+                                                &skinning_is_cached);
+      armature_skinning_table_update_bones(skinning, pchan_from_defbase);
+      data.skinning = skinning;
+    }
+
     TaskParallelSettings settings;
     BLI_parallel_range_settings_defaults(&settings);
     settings.min_iter_per_thread = 32;
     BLI_task_parallel_range(0, vert_coords_len, &data, armature_vert_task, &settings);
+
+    if (skinning && !skinning_is_cached) {
+      armature_skinning_table_free(skinning);
+    }
   }
 
   if (pchan_from_defbase) {
@@ -18,8 +18,28 @@
  */
 
 #include "BKE_armature.h"
+#include "BKE_customdata.h"
+#include "BKE_deform.h"
+#include "BKE_editmesh.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
 
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "bmesh.h"
 
 #include "testing/testing.h"
 
@@ -157,4 +177,205 @@ TEST(vec_roll_to_mat3_normalized, Rotationmatrix)
   }
 }
 
+/* A mesh object deformed by a few bones. Vertices deformed through the compiled skinning table
+ * are compared with the generic code path, which is used for edit-meshes. */
+class ArmatureDeformTest : public testing::Test {
+ protected:
+  static const int bones_num = 4;
+  static const int verts_num = 500;
+
+  bArmature arm = {};
+  Bone bones[bones_num] = {};
+  bPoseChannel pchans[bones_num] = {};
+  bPose pose = {};
+  Object ob_arm = {};
+  /* One more group that isn't used by a bone. */
+  bDeformGroup groups[bones_num + 1] = {};
+  Object ob_target = {};
+  Mesh *mesh = nullptr;
+
+  void SetUp() override
+  {
+    BKE_idtype_init();
+    RandomNumberGenerator rng(0);
+
+    ob_arm.type = OB_ARMATURE;
+    ob_arm.data = &arm;
+    ob_arm.pose = &pose;
+    unit_m4(ob_arm.obmat);
+    for (const int i : IndexRange(bones_num)) {
+      Bone &bone = bones[i];
+      BLI_snprintf(bone.name, sizeof(bone.name), "Bone%d", i);
+      bone.segments = 1;
+      bone.weight = 1.0f;
+      bone.dist = 0.5f;
+      bone.rad_head = bone.rad_tail = 0.5f;
+      copy_v3_v3(bone.arm_head, float3(float(i) - 1.5f, 0.0f, 0.0f));
+      copy_v3_v3(bone.arm_tail, float3(float(i) - 1.5f, 1.0f, 0.0f));
+      unit_m4(bone.arm_mat);
+      copy_v3_v3(bone.arm_mat[3], bone.arm_head);
+
+      bPoseChannel &pchan = pchans[i];
+      STRNCPY(pchan.name, bone.name);
+      pchan.bone = &bone;
+      BLI_addtail(&pose.chanbase, &pchan);
+
+      STRNCPY(groups[i].name, bone.name);
+      BLI_addtail(&ob_target.defbase, &groups[i]);
+    }
+    STRNCPY(groups[bones_num].name, "NoBone");
+    BLI_addtail(&ob_target.defbase, &groups[bones_num]);
+    this->pose_bones(rng);
+
+    mesh = BKE_mesh_new_nomain(verts_num, 0, 0, 0, 0);
+    mesh->dvert = (MDeformVert *)CustomData_add_layer(
+        &mesh->vdata, CD_MDEFORMVERT, CD_CALLOC, nullptr, verts_num);
+    for (const int i : IndexRange(verts_num)) {
+      const float3 co = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 4.0f -
+                        float3(2.0f);
+      copy_v3_v3(mesh->mvert[i].co, co);
+      /* Leave some vertices without weights, these use the envelopes when enabled. */
+      if (i % 10 == 0) {
+        continue;
+      }
+      for (const int group : IndexRange(bones_num + 1)) {
+        if (rng.get_float() < 0.5f) {
+          /* Include zero weights. */
+          const float weight = (rng.get_float() < 0.1f) ? 0.0f : rng.get_float();
+          BKE_defvert_add_index_notest(&mesh->dvert[i], group, weight);
+        }
+      }
+    }
+
+    ob_target.type = OB_MESH;
+    ob_target.data = mesh;
+    unit_m4(ob_target.obmat);
+  }
+
+  void TearDown() override
+  {
+    BKE_armature_skinning_cache_free(&ob_target);
+    BKE_id_free(nullptr, mesh);
+  }
+
+  /* Give every bone a random rotation, scale and translation. */
+  void pose_bones(RandomNumberGenerator &rng)
+  {
+    for (const int i : IndexRange(bones_num)) {
+      const float3 loc = float3(rng.get_float(), rng.get_float(), rng.get_float()) -
+                         float3(0.5f);
+      const float3 eul = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 2.0f;
+      const float3 size = float3(rng.get_float(), rng.get_float(), rng.get_float()) +
+                          float3(0.5f);
+      loc_eul_size_to_mat4(pchans[i].chan_mat, loc, eul, size);
+      mat4_to_dquat(&pchans[i].runtime.deform_dual_quat, bones[i].arm_mat, pchans[i].chan_mat);
+    }
+  }
+
+  void deform_mesh(const int deformflag, float (*coords)[3], float (*mats)[3][3])
+  {
+    this->init_coords(coords, mats);
+    BKE_armature_deform_coords_with_mesh(
+        &ob_arm, &ob_target, coords, mats, verts_num, deformflag, nullptr, nullptr, mesh);
+  }
+
+  void deform_editmesh(const int deformflag, float (*coords)[3], float (*mats)[3][3])
+  {
+    BMeshCreateParams create_params = {};
+    BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &create_params);
+    BMeshFromMeshParams convert_params = {};
+    BM_mesh_bm_from_me(bm, mesh, &convert_params);
+    BMEditMesh *em = BKE_editmesh_create(bm, false);
+
+    this->init_coords(coords, mats);
+    BKE_armature_deform_coords_with_editmesh(
+        &ob_arm, &ob_target, coords, mats, verts_num, deformflag, nullptr, nullptr, em);
+
+    BKE_editmesh_free(em);
+    MEM_freeN(em);
+  }
+
+  void init_coords(float (*coords)[3], float (*mats)[3][3])
+  {
+    for (const int i : IndexRange(verts_num)) {
+      copy_v3_v3(coords[i], mesh->mvert[i].co);
+      unit_m3(mats[i]);
+    }
+  }
+
+  void expect_matches_generic(const int deformflag)
+  {
+    Array<float3> coords(verts_num);
+    Array<float3> coords_generic(verts_num);
+    float(*mats)[3][3] = (float(*)[3][3])MEM_malloc_arrayN(verts_num, sizeof(*mats), __func__);
+    float(*mats_generic)[3][3] = (float(*)[3][3])MEM_malloc_arrayN(
+        verts_num, sizeof(*mats_generic), __func__);
+
+    this->deform_mesh(deformflag, (float(*)[3])coords.data(), mats);
+    this->deform_editmesh(deformflag, (float(*)[3])coords_generic.data(), mats_generic);
+    for (const int i : IndexRange(verts_num)) {
+      EXPECT_V3_NEAR(coords[i], coords_generic[i], 1e-5f);
+      EXPECT_M3_NEAR(mats[i], mats_generic[i], 1e-5f);
+    }
+
+    MEM_freeN(mats);
+    MEM_freeN(mats_generic);
+  }
+};
+
+TEST_F(ArmatureDeformTest, LinearBlendMatchesGeneric)
+{
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE);
+}
+
+TEST_F(ArmatureDeformTest, DualQuaternionMatchesGeneric)
+{
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_QUATERNION);
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_QUATERNION | ARM_DEF_ENVELOPE);
+}
+
+TEST_F(ArmatureDeformTest, GenericBones)
+{
+  /* Vertices influenced by these bones use the generic code path. */
+  bones[1].flag |= BONE_MULT_VG_ENV;
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_QUATERNION);
+}
+
+TEST_F(ArmatureDeformTest, CachedTable)
+{
+  /* Tables are only cached for evaluated objects. */
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  EXPECT_EQ(ob_target.runtime.armature_skinning_cache, nullptr);
+
+  ob_target.id.tag |= LIB_TAG_COPIED_ON_WRITE;
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  EXPECT_NE(ob_target.runtime.armature_skinning_cache, nullptr);
+
+  /* The cached table uses the current pose. */
+  RandomNumberGenerator rng(1);
+  this->pose_bones(rng);
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_QUATERNION);
+
+  /* Weights changed with an update of the mesh. */
+  for (const int i : IndexRange(verts_num)) {
+    if (mesh->dvert[i].totweight > 0) {
+      mesh->dvert[i].dw[0].weight = 1.0f - mesh->dvert[i].dw[0].weight;
+    }
+  }
+  mesh->id.recalc |= ID_RECALC_GEOMETRY;
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  mesh->id.recalc = 0;
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+
+  /* Vertex groups mapped to other bones. */
+  bones[2].flag |= BONE_NO_DEFORM;
+  this->expect_matches_generic(ARM_DEF_VGROUP);
+  bones[2].flag &= ~BONE_NO_DEFORM;
+  bones[3].flag |= BONE_MULT_VG_ENV;
+  this->expect_matches_generic(ARM_DEF_VGROUP | ARM_DEF_QUATERNION);
+}
+
 }  // namespace blender::bke::tests
@@ -14,6 +14,7 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_span.hh"
 #include "BLI_string_ref.hh"
@@ -339,4 +340,87 @@ class ComponentAttributeProviders {
   }
 };
 
+
+/**
+ * A virtual array for attribute values that are interpolated from another domain. Instead of
+ * computing the values for the entire domain up front, they are only computed for the indices
+ * that are accessed. Materializing is done in chunks, so that the temporary memory used for mixing
+ * stays small, even when all values are requested.
+ *
+ * The #ComputeFn is called with the original values, a list of indices in the new domain and a
+ * buffer that has to be filled with the new values at these indices.
+ */
+template<typename T, typename ComputeFn>
+class VArray_For_LazyAdaptedDomain final : public VArray<T> {
+ private:
+  fn::GVArray_Typed<T> original_values_;
+  ComputeFn compute_fn_;
+
+  static constexpr int64_t chunk_size_ = 1024;
+
+ public:
+  VArray_For_LazyAdaptedDomain(const int64_t size,
+                               GVArrayPtr original_varray,
+                               ComputeFn compute_fn)
+      : VArray<T>(size),
+        original_values_(std::move(original_varray)),
+        compute_fn_(std::move(compute_fn))
+  {
+  }
+
+ private:
+  T get_impl(const int64_t index) const final
+  {
+    T value;
+    compute_fn_(*original_values_, Span<int64_t>(&index, 1), MutableSpan<T>(&value, 1));
+    return value;
+  }
+
+  void materialize_impl(const IndexMask mask, MutableSpan<T> r_span) const final
+  {
+    T *dst = r_span.data();
+    this->materialize_in_chunks(mask, [&](const int64_t index, T &value) {
+      dst[index] = std::move(value);
+    });
+  }
+
+  void materialize_to_uninitialized_impl(const IndexMask mask, MutableSpan<T> r_span) const final
+  {
+    T *dst = r_span.data();
+    this->materialize_in_chunks(mask, [&](const int64_t index, T &value) {
+      new (dst + index) T(std::move(value));
+    });
+  }
+
+  template<typename StoreFn>
+  void materialize_in_chunks(const IndexMask mask, const StoreFn &store_fn) const
+  {
+    const Span<int64_t> indices = mask.indices();
+    Array<T> buffer(std::min(chunk_size_, indices.size()));
+    for (int64_t start = 0; start < indices.size(); start += chunk_size_) {
+      const Span<int64_t> chunk_indices = indices.slice(
+          start, std::min(chunk_size_, indices.size() - start));
+      MutableSpan<T> chunk_values = buffer.as_mutable_span().take_front(chunk_indices.size());
+      compute_fn_(*original_values_, chunk_indices, chunk_values);
+      for (const int64_t i : chunk_indices.index_range()) {
+        store_fn(chunk_indices[i], chunk_values[i]);
+      }
+    }
+  }
+};
+
+/**
+ * Create a generic virtual array that computes the adapted values lazily, see
+ * #VArray_For_LazyAdaptedDomain.
+ */
+template<typename T, typename ComputeFn>
+inline GVArrayPtr make_lazy_adapted_domain_varray(const int64_t size,
+                                                  GVArrayPtr original_varray,
+                                                  ComputeFn compute_fn)
+{
+  return std::make_unique<
+      fn::GVArray_For_EmbeddedVArray<T, VArray_For_LazyAdaptedDomain<T, ComputeFn>>>(
+      size, size, std::move(original_varray), std::move(compute_fn));
+}
+
 }  // namespace blender::bke
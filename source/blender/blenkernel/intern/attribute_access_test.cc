@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_attribute_math.hh"
+
+#include "BLI_array.hh"
+#include "BLI_vector.hh"
+
+#include "attribute_access_intern.hh"
+
+namespace blender::bke::tests {
+
+/* Creates a virtual array that mixes every value with the next one, similar to interpolating point
+ * values to edges. The number of computed values is counted in #r_computed_len. */
+static GVArrayPtr create_lazy_mix_varray(Span<float> original_values, int *r_computed_len)
+{
+  GVArrayPtr original_varray = std::make_unique<fn::GVArray_For_Span<float>>(original_values);
+  return make_lazy_adapted_domain_varray<float>(
+      original_values.size() - 1,
+      std::move(original_varray),
+      [r_computed_len](const VArray<float> &old_values,
+                       Span<int64_t> indices,
+                       MutableSpan<float> r_values) {
+        attribute_math::DefaultMixer<float> mixer(r_values);
+        for (const int64_t i : indices.index_range()) {
+          mixer.mix_in(i, old_values[indices[i]]);
+          mixer.mix_in(i, old_values[indices[i] + 1]);
+        }
+        mixer.finalize();
+        *r_computed_len += indices.size();
+      });
+}
+
+TEST(attribute_access, LazyAdaptedDomainGet)
+{
+  Array<float> original_values = {0.0f, 2.0f, 6.0f, 10.0f};
+  int computed_len = 0;
+  GVArrayPtr varray = create_lazy_mix_varray(original_values, &computed_len);
+  fn::GVArray_Typed<float> values{*varray};
+
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_EQ(computed_len, 0);
+  EXPECT_FLOAT_EQ(values[0], 1.0f);
+  EXPECT_FLOAT_EQ(values[2], 8.0f);
+  EXPECT_EQ(computed_len, 2);
+}
+
+TEST(attribute_access, LazyAdaptedDomainMaterializeMask)
+{
+  Array<float> original_values(5000);
+  for (const int i : original_values.index_range()) {
+    original_values[i] = i * 2.0f;
+  }
+  int computed_len = 0;
+  GVArrayPtr varray = create_lazy_mix_varray(original_values, &computed_len);
+
+  Vector<int64_t> indices;
+  for (int64_t i = 3; i < varray->size(); i += 3) {
+    indices.append(i);
+  }
+  Array<float> result(varray->size(), -1.0f);
+  varray->materialize(indices.as_span(), result.data());
+
+  /* Only the indices in the mask are computed and written. */
+  EXPECT_EQ(computed_len, indices.size());
+  for (const int64_t i : result.index_range()) {
+    if (i > 0 && i % 3 == 0) {
+      EXPECT_FLOAT_EQ(result[i], i * 2.0f + 1.0f);
+    }
+    else {
+      EXPECT_FLOAT_EQ(result[i], -1.0f);
+    }
+  }
+}
+
+TEST(attribute_access, LazyAdaptedDomainMaterializeAll)
+{
+  Array<float> original_values(3001);
+  for (const int i : original_values.index_range()) {
+    original_values[i] = i * 2.0f;
+  }
+  int computed_len = 0;
+  GVArrayPtr varray = create_lazy_mix_varray(original_values, &computed_len);
+
+  /* The values are computed in multiple chunks. */
+  Array<float> result(varray->size());
+  varray->materialize_to_uninitialized(result.data());
+
+  EXPECT_EQ(computed_len, 3000);
+  for (const int64_t i : result.index_range()) {
+    EXPECT_FLOAT_EQ(result[i], i * 2.0f + 1.0f);
+  }
+}
+
+}  // namespace blender::bke::tests
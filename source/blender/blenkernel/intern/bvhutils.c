@@ -29,7 +29,9 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_pointcloud_types.h"
 
+#include "BLI_hash_mm2a.h"
 #include "BLI_linklist.h"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_task.h"
 #include "BLI_threads.h"
@@ -49,6 +51,8 @@
 typedef struct BVHCacheItem {
   bool is_filled;
   BVHTree *tree;
+  /* Set when the tree is owned by the shared cache instead of this item. */
+  struct BVHSharedTree *shared;
 } BVHCacheItem;
 
 typedef struct BVHCache {
@@ -147,6 +151,8 @@ static void bvhcache_insert(BVHCache *bvh_cache, BVHTree *tree, BVHCacheType typ
   item->is_filled = true;
 }
 
+static void bvhtree_shared_release(struct BVHSharedTree *shared);
+
 /**
  * frees a bvhcache
  */
@@ -154,7 +160,13 @@ void bvhcache_free(BVHCache *bvh_cache)
 {
   for (BVHCacheType index = 0; index < BVHTREE_MAX_ITEM; index++) {
     BVHCacheItem *item = &bvh_cache->items[index];
-    BLI_bvhtree_free(item->tree);
+    if (item->shared) {
+      bvhtree_shared_release(item->shared);
+      item->shared = NULL;
+    }
+    else {
+      BLI_bvhtree_free(item->tree);
+    }
     item->tree = NULL;
   }
   BLI_mutex_end(&bvh_cache->mutex);
@@ -182,6 +194,107 @@ static void bvhtree_balance(BVHTree *tree, const bool isolate)
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Shared BVH Trees
+ *
+ * Trees of evaluated meshes are shared by all meshes with the same content, found by hashing
+ * the mesh arrays used by the tree. Evaluated meshes are often freed and evaluated again with
+ * the same result (for example on frame changes without deformation), so trees are kept for a
+ * while after their last user is gone. When only the positions changed, such an unused tree is
+ * refit to the new positions instead of being built again.
+ * \{ */
+
+/* Number of trees kept without users. */
+#define BVH_SHARED_UNUSED_MAX 16
+
+typedef struct BVHSharedKey {
+  BVHCacheType type;
+  int tree_type;
+  /* Number of elements in each array used by the tree. */
+  int lens[4];
+  /* Hashes of the arrays other than the positions. */
+  uint64_t topology_hash;
+  uint64_t positions_hash;
+} BVHSharedKey;
+
+typedef struct BVHSharedTree {
+  struct BVHSharedTree *next, *prev;
+  BVHTree *tree;
+  BVHSharedKey key;
+  /* Packed copies of the hashed arrays, compared on hash matches so that a collision never
+   * returns the tree of another mesh. */
+  char *topology;
+  float (*positions)[3];
+  int users;
+  int refit_count;
+} BVHSharedTree;
+
+static struct {
+  /* Trees in order of last use, most recent first. */
+  ListBase trees;
+  int unused_len;
+  BVHCacheStats stats;
+  ThreadMutex mutex;
+} bvh_shared = {{NULL, NULL}, 0, {0}, BLI_MUTEX_INITIALIZER};
+
+static void bvhtree_shared_free(BVHSharedTree *shared)
+{
+  BLI_bvhtree_free(shared->tree);
+  MEM_SAFE_FREE(shared->topology);
+  MEM_SAFE_FREE(shared->positions);
+  MEM_freeN(shared);
+}
+
+static void bvhtree_shared_free_unused(const int keep_len)
+{
+  BVHSharedTree *shared = bvh_shared.trees.last;
+  while (shared && bvh_shared.unused_len > keep_len) {
+    BVHSharedTree *prev = shared->prev;
+    if (shared->users == 0) {
+      BLI_remlink(&bvh_shared.trees, shared);
+      bvhtree_shared_free(shared);
+      bvh_shared.unused_len--;
+    }
+    shared = prev;
+  }
+}
+
+static void bvhtree_shared_release(BVHSharedTree *shared)
+{
+  BLI_mutex_lock(&bvh_shared.mutex);
+  BLI_assert(shared->users > 0);
+  shared->users--;
+  if (shared->users == 0) {
+    bvh_shared.unused_len++;
+    bvhtree_shared_free_unused(BVH_SHARED_UNUSED_MAX);
+  }
+  BLI_mutex_unlock(&bvh_shared.mutex);
+}
+
+/**
+ * Free the trees of the shared cache that are not used anymore.
+ */
+void BKE_bvhtree_shared_cache_clear(void)
+{
+  BLI_mutex_lock(&bvh_shared.mutex);
+  bvhtree_shared_free_unused(0);
+  BLI_mutex_unlock(&bvh_shared.mutex);
+}
+
+/**
+ * Counters of the shared cache since startup, for profiling.
+ */
+void BKE_bvhtree_cache_stats_get(BVHCacheStats *r_stats)
+{
+  BLI_mutex_lock(&bvh_shared.mutex);
+  *r_stats = bvh_shared.stats;
+  r_stats->trees = BLI_listbase_count(&bvh_shared.trees);
+  BLI_mutex_unlock(&bvh_shared.mutex);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Local Callbacks
  * \{ */
@@ -1435,6 +1548,535 @@ static BLI_bitmap *looptri_no_hidden_map_get(const MPoly *mpoly,
   return looptri_mask;
 }
 
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Shared Tree Building
+ * \{ */
+
+#define BVH_HASH_CHUNK_SIZE 4096
+
+/* Refitting keeps the hierarchy of the first build, which gets worse the more the positions
+ * move. Trees are built again after this many refits. */
+#define BVH_SHARED_REFIT_MAX 32
+
+typedef struct BVHHashData {
+  const char *data;
+  size_t stride;
+  size_t size;
+  int len;
+  uint32_t (*chunk_hashes)[2];
+} BVHHashData;
+
+static void bvhtree_hash_chunk_cb(void *__restrict userdata,
+                                  const int chunk,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHHashData *data = userdata;
+  const int start = chunk * BVH_HASH_CHUNK_SIZE;
+  const int end = min_ii(start + BVH_HASH_CHUNK_SIZE, data->len);
+
+  for (uint32_t seed = 0; seed < 2; seed++) {
+    BLI_HashMurmur2A mm2;
+    BLI_hash_mm2a_init(&mm2, seed);
+    if (data->stride == data->size) {
+      BLI_hash_mm2a_add(&mm2,
+                        (const unsigned char *)data->data + (size_t)start * data->stride,
+                        (size_t)(end - start) * data->size);
+    }
+    else {
+      for (int i = start; i < end; i++) {
+        BLI_hash_mm2a_add(
+            &mm2, (const unsigned char *)data->data + (size_t)i * data->stride, data->size);
+      }
+    }
+    data->chunk_hashes[chunk][seed] = BLI_hash_mm2a_end(&mm2);
+  }
+}
+
+/**
+ * Hash the first \a size bytes of \a len elements that are \a stride bytes apart. Chunks are
+ * hashed in parallel, the result doesn't depend on threading.
+ */
+static uint64_t bvhtree_hash_array(const void *data,
+                                   const size_t stride,
+                                   const size_t size,
+                                   const int len)
+{
+  if (data == NULL || len == 0) {
+    return 0;
+  }
+
+  const int chunks_len = (len + BVH_HASH_CHUNK_SIZE - 1) / BVH_HASH_CHUNK_SIZE;
+  uint32_t(*chunk_hashes)[2] = MEM_malloc_arrayN(chunks_len, sizeof(*chunk_hashes), __func__);
+
+  BVHHashData hash_data = {
+      .data = data,
+      .stride = stride,
+      .size = size,
+      .len = len,
+      .chunk_hashes = chunk_hashes,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (chunks_len > 1);
+  BLI_task_parallel_range(0, chunks_len, &hash_data, bvhtree_hash_chunk_cb, &settings);
+
+  const size_t hashes_size = sizeof(*chunk_hashes) * (size_t)chunks_len;
+  const uint64_t hash = ((uint64_t)BLI_hash_mm2((const unsigned char *)chunk_hashes,
+                                                hashes_size,
+                                                0)
+                         << 32) |
+                        BLI_hash_mm2((const unsigned char *)chunk_hashes, hashes_size, 1);
+
+  MEM_freeN(chunk_hashes);
+
+  return hash;
+}
+
+BLI_INLINE uint64_t bvhtree_hash_combine(const uint64_t hash, const uint64_t value)
+{
+  return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+}
+
+static bool bvhtree_shared_type_supported(const BVHCacheType type)
+{
+  return ELEM(type,
+              BVHTREE_FROM_VERTS,
+              BVHTREE_FROM_LOOSEVERTS,
+              BVHTREE_FROM_EDGES,
+              BVHTREE_FROM_LOOSEEDGES,
+              BVHTREE_FROM_LOOPTRI,
+              BVHTREE_FROM_LOOPTRI_NO_HIDDEN);
+}
+
+/* Mesh array that a tree is built from, only the first \a size bytes of each element are used. */
+typedef struct BVHSharedArray {
+  const void *data;
+  size_t stride;
+  size_t size;
+  int len;
+} BVHSharedArray;
+
+#define BVH_SHARED_TOPOLOGY_ARRAYS_MAX 3
+
+static BVHSharedArray bvhtree_shared_positions_array(Mesh *mesh)
+{
+  BVHSharedArray array = {mesh->mvert, sizeof(MVert), sizeof(float[3]), mesh->totvert};
+  return array;
+}
+
+/* Get the arrays other than the positions that a tree of the given type is built from. */
+static int bvhtree_shared_topology_arrays(Mesh *mesh,
+                                          const BVHCacheType type,
+                                          BVHSharedArray r_arrays[BVH_SHARED_TOPOLOGY_ARRAYS_MAX])
+{
+  int arrays_len = 0;
+  switch (type) {
+    case BVHTREE_FROM_VERTS:
+      break;
+    case BVHTREE_FROM_LOOSEVERTS:
+    case BVHTREE_FROM_EDGES:
+    case BVHTREE_FROM_LOOSEEDGES:
+      r_arrays[arrays_len++] = (BVHSharedArray){
+          mesh->medge, sizeof(MEdge), sizeof(MEdge), mesh->totedge};
+      break;
+    case BVHTREE_FROM_LOOPTRI:
+    case BVHTREE_FROM_LOOPTRI_NO_HIDDEN:
+      r_arrays[arrays_len++] = (BVHSharedArray){
+          mesh->mloop, sizeof(MLoop), sizeof(MLoop), mesh->totloop};
+      r_arrays[arrays_len++] = (BVHSharedArray){BKE_mesh_runtime_looptri_ensure(mesh),
+                                                sizeof(MLoopTri),
+                                                sizeof(MLoopTri),
+                                                BKE_mesh_runtime_looptri_len(mesh)};
+      if (type == BVHTREE_FROM_LOOPTRI_NO_HIDDEN) {
+        r_arrays[arrays_len++] = (BVHSharedArray){
+            mesh->mpoly, sizeof(MPoly), sizeof(MPoly), mesh->totpoly};
+      }
+      break;
+    default:
+      BLI_assert_unreachable();
+      break;
+  }
+  return arrays_len;
+}
+
+static size_t bvhtree_shared_array_packed_size(const BVHSharedArray *array)
+{
+  return (array->data) ? array->size * (size_t)array->len : 0;
+}
+
+/* Copy the used bytes of the elements of an array next to each other, returns the end. */
+static char *bvhtree_shared_array_pack(const BVHSharedArray *array, char *dst)
+{
+  if (array->data == NULL) {
+    return dst;
+  }
+  if (array->stride == array->size) {
+    memcpy(dst, array->data, array->size * (size_t)array->len);
+    return dst + array->size * (size_t)array->len;
+  }
+  const char *src = array->data;
+  for (int i = 0; i < array->len; i++, src += array->stride, dst += array->size) {
+    memcpy(dst, src, array->size);
+  }
+  return dst;
+}
+
+/* Compare an array with a packed copy, \a r_packed is moved to the end of the copy. */
+static bool bvhtree_shared_array_eq(const BVHSharedArray *array, const char **r_packed)
+{
+  const char *packed = *r_packed;
+  *r_packed += bvhtree_shared_array_packed_size(array);
+  if (array->data == NULL) {
+    return true;
+  }
+  if (array->stride == array->size) {
+    return memcmp(packed, array->data, array->size * (size_t)array->len) == 0;
+  }
+  const char *src = array->data;
+  for (int i = 0; i < array->len; i++, src += array->stride, packed += array->size) {
+    if (memcmp(packed, src, array->size) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Hash the mesh arrays that a tree of the given type is built from.
+ * Runs without locks, since hashing is multi-threaded.
+ */
+static void bvhtree_shared_key_from_mesh(Mesh *mesh,
+                                         const BVHCacheType type,
+                                         const int tree_type,
+                                         BVHSharedKey *r_key)
+{
+  memset(r_key, 0, sizeof(*r_key));
+  r_key->type = type;
+  r_key->tree_type = tree_type;
+  r_key->lens[0] = mesh->totvert;
+
+  const BVHSharedArray positions = bvhtree_shared_positions_array(mesh);
+  r_key->positions_hash = bvhtree_hash_array(
+      positions.data, positions.stride, positions.size, positions.len);
+
+  BVHSharedArray arrays[BVH_SHARED_TOPOLOGY_ARRAYS_MAX];
+  const int arrays_len = bvhtree_shared_topology_arrays(mesh, type, arrays);
+  for (int i = 0; i < arrays_len; i++) {
+    const uint64_t hash = bvhtree_hash_array(
+        arrays[i].data, arrays[i].stride, arrays[i].size, arrays[i].len);
+    r_key->lens[i + 1] = arrays[i].len;
+    r_key->topology_hash = (i == 0) ? hash : bvhtree_hash_combine(r_key->topology_hash, hash);
+  }
+}
+
+/* Store copies of the arrays of the mesh a tree was built or refit for. Runs without locks. */
+static void bvhtree_shared_key_data_store(BVHSharedTree *shared, Mesh *mesh)
+{
+  const BVHSharedArray positions = bvhtree_shared_positions_array(mesh);
+  if (shared->positions == NULL) {
+    shared->positions = MEM_malloc_arrayN(
+        max_ii(positions.len, 1), sizeof(float[3]), "BVHSharedTree positions");
+  }
+  bvhtree_shared_array_pack(&positions, (char *)shared->positions);
+
+  if (shared->topology == NULL) {
+    BVHSharedArray arrays[BVH_SHARED_TOPOLOGY_ARRAYS_MAX];
+    const int arrays_len = bvhtree_shared_topology_arrays(mesh, shared->key.type, arrays);
+    size_t topology_size = 0;
+    for (int i = 0; i < arrays_len; i++) {
+      topology_size += bvhtree_shared_array_packed_size(&arrays[i]);
+    }
+    shared->topology = MEM_mallocN(max_zz(topology_size, 1), "BVHSharedTree topology");
+    char *dst = shared->topology;
+    for (int i = 0; i < arrays_len; i++) {
+      dst = bvhtree_shared_array_pack(&arrays[i], dst);
+    }
+  }
+}
+
+static bool bvhtree_shared_key_topology_eq(const BVHSharedKey *a, const BVHSharedKey *b)
+{
+  return a->type == b->type && a->tree_type == b->tree_type &&
+         memcmp(a->lens, b->lens, sizeof(a->lens)) == 0 && a->topology_hash == b->topology_hash;
+}
+
+/* Exact comparison of the mesh with the arrays a tree was built from, after the hashes match. */
+static bool bvhtree_shared_mesh_topology_eq(const BVHSharedTree *shared, Mesh *mesh)
+{
+  BVHSharedArray arrays[BVH_SHARED_TOPOLOGY_ARRAYS_MAX];
+  const int arrays_len = bvhtree_shared_topology_arrays(mesh, shared->key.type, arrays);
+  const char *packed = shared->topology;
+  for (int i = 0; i < arrays_len; i++) {
+    if (!bvhtree_shared_array_eq(&arrays[i], &packed)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool bvhtree_shared_mesh_positions_eq(const BVHSharedTree *shared, Mesh *mesh)
+{
+  const BVHSharedArray positions = bvhtree_shared_positions_array(mesh);
+  const char *packed = (const char *)shared->positions;
+  return bvhtree_shared_array_eq(&positions, &packed);
+}
+
+static BLI_bitmap *bvhtree_shared_mask_get(Mesh *mesh,
+                                           const BVHCacheType type,
+                                           int *r_mask_active_len)
+{
+  *r_mask_active_len = -1;
+  switch (type) {
+    case BVHTREE_FROM_LOOSEVERTS:
+      return loose_verts_map_get(
+          mesh->medge, mesh->totedge, mesh->mvert, mesh->totvert, r_mask_active_len);
+    case BVHTREE_FROM_LOOSEEDGES:
+      return loose_edges_map_get(mesh->medge, mesh->totedge, r_mask_active_len);
+    case BVHTREE_FROM_LOOPTRI_NO_HIDDEN:
+      return looptri_no_hidden_map_get(
+          mesh->mpoly, BKE_mesh_runtime_looptri_len(mesh), r_mask_active_len);
+    default:
+      return NULL;
+  }
+}
+
+static BVHTree *bvhtree_shared_build(Mesh *mesh, const BVHCacheType type, const int tree_type)
+{
+  BVHTree *tree = NULL;
+  int mask_active_len;
+  BLI_bitmap *mask = bvhtree_shared_mask_get(mesh, type, &mask_active_len);
+
+  switch (type) {
+    case BVHTREE_FROM_VERTS:
+    case BVHTREE_FROM_LOOSEVERTS:
+      tree = bvhtree_from_mesh_verts_create_tree(
+          0.0f, tree_type, 6, mesh->mvert, mesh->totvert, mask, mask_active_len);
+      break;
+    case BVHTREE_FROM_EDGES:
+    case BVHTREE_FROM_LOOSEEDGES:
+      tree = bvhtree_from_mesh_edges_create_tree(
+          mesh->mvert, mesh->medge, mesh->totedge, mask, mask_active_len, 0.0f, tree_type, 6);
+      break;
+    case BVHTREE_FROM_LOOPTRI:
+    case BVHTREE_FROM_LOOPTRI_NO_HIDDEN:
+      tree = bvhtree_from_mesh_looptri_create_tree(0.0f,
+                                                   tree_type,
+                                                   6,
+                                                   mesh->mvert,
+                                                   mesh->mloop,
+                                                   BKE_mesh_runtime_looptri_ensure(mesh),
+                                                   BKE_mesh_runtime_looptri_len(mesh),
+                                                   mask,
+                                                   mask_active_len);
+      break;
+    default:
+      BLI_assert_unreachable();
+      break;
+  }
+
+  if (mask) {
+    MEM_freeN(mask);
+  }
+
+  bvhtree_balance(tree, true);
+  return tree;
+}
+
+/**
+ * Update the leaves of a tree built by #bvhtree_shared_build for a mesh with the same topology,
+ * visiting the elements in the order they were inserted.
+ */
+static void bvhtree_shared_refit(BVHTree *tree, Mesh *mesh, const BVHCacheType type)
+{
+  const MVert *mvert = mesh->mvert;
+  int mask_active_len;
+  BLI_bitmap *mask = bvhtree_shared_mask_get(mesh, type, &mask_active_len);
+  int leaf = 0;
+
+  switch (type) {
+    case BVHTREE_FROM_VERTS:
+    case BVHTREE_FROM_LOOSEVERTS:
+      for (int i = 0; i < mesh->totvert; i++) {
+        if (mask && !BLI_BITMAP_TEST_BOOL(mask, i)) {
+          continue;
+        }
+        BLI_bvhtree_update_node(tree, leaf++, mvert[i].co, NULL, 1);
+      }
+      break;
+    case BVHTREE_FROM_EDGES:
+    case BVHTREE_FROM_LOOSEEDGES:
+      for (int i = 0; i < mesh->totedge; i++) {
+        if (mask && !BLI_BITMAP_TEST_BOOL(mask, i)) {
+          continue;
+        }
+        float co[2][3];
+        copy_v3_v3(co[0], mvert[mesh->medge[i].v1].co);
+        copy_v3_v3(co[1], mvert[mesh->medge[i].v2].co);
+        BLI_bvhtree_update_node(tree, leaf++, co[0], NULL, 2);
+      }
+      break;
+    case BVHTREE_FROM_LOOPTRI:
+    case BVHTREE_FROM_LOOPTRI_NO_HIDDEN: {
+      const MLoop *mloop = mesh->mloop;
+      const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(mesh);
+      const int looptri_len = BKE_mesh_runtime_looptri_len(mesh);
+      for (int i = 0; i < looptri_len; i++) {
+        if (mask && !BLI_BITMAP_TEST_BOOL(mask, i)) {
+          continue;
+        }
+        float co[3][3];
+        copy_v3_v3(co[0], mvert[mloop[looptri[i].tri[0]].v].co);
+        copy_v3_v3(co[1], mvert[mloop[looptri[i].tri[1]].v].co);
+        copy_v3_v3(co[2], mvert[mloop[looptri[i].tri[2]].v].co);
+        BLI_bvhtree_update_node(tree, leaf++, co[0], NULL, 3);
+      }
+      break;
+    }
+    default:
+      BLI_assert_unreachable();
+      break;
+  }
+
+  BLI_assert(leaf == BLI_bvhtree_get_len(tree));
+  BLI_bvhtree_update_tree(tree);
+
+  if (mask) {
+    MEM_freeN(mask);
+  }
+}
+
+/* Call with the shared cache locked. */
+static BVHSharedTree *bvhtree_shared_find(Mesh *mesh,
+                                          const BVHSharedKey *key,
+                                          const bool match_positions)
+{
+  LISTBASE_FOREACH (BVHSharedTree *, shared, &bvh_shared.trees) {
+    if (!bvhtree_shared_key_topology_eq(&shared->key, key)) {
+      continue;
+    }
+    if (match_positions ? (shared->key.positions_hash != key->positions_hash) :
+                          (shared->users != 0)) {
+      continue;
+    }
+    if (!bvhtree_shared_mesh_topology_eq(shared, mesh)) {
+      continue;
+    }
+    if (match_positions && !bvhtree_shared_mesh_positions_eq(shared, mesh)) {
+      continue;
+    }
+    return shared;
+  }
+  return NULL;
+}
+
+/* Call with the shared cache locked. */
+static void bvhtree_shared_use(BVHSharedTree *shared)
+{
+  if (shared->users == 0) {
+    bvh_shared.unused_len--;
+  }
+  shared->users++;
+  BLI_remlink(&bvh_shared.trees, shared);
+  BLI_addhead(&bvh_shared.trees, shared);
+}
+
+/**
+ * Get a tree for the mesh from the shared cache, reusing a tree of a mesh with the same content,
+ * refitting an unused tree of a mesh with the same topology, or building a new one.
+ * Returns NULL when the mesh has no elements of the given type.
+ */
+static BVHSharedTree *bvhtree_shared_ensure(Mesh *mesh, const BVHSharedKey *key)
+{
+  BVHSharedTree *shared;
+
+  BLI_mutex_lock(&bvh_shared.mutex);
+
+  shared = bvhtree_shared_find(mesh, key, true);
+  if (shared) {
+    bvhtree_shared_use(shared);
+    bvh_shared.stats.shares++;
+    BLI_mutex_unlock(&bvh_shared.mutex);
+    return shared;
+  }
+
+  /* Take an unused tree with the same topology out of the cache, so that it can be refit
+   * without holding the lock. While it is not in the list, no other thread can find it. */
+  BVHSharedTree *refit = bvhtree_shared_find(mesh, key, false);
+  if (refit) {
+    BLI_remlink(&bvh_shared.trees, refit);
+    bvh_shared.unused_len--;
+    if (refit->refit_count >= BVH_SHARED_REFIT_MAX) {
+      bvhtree_shared_free(refit);
+      refit = NULL;
+    }
+  }
+
+  BLI_mutex_unlock(&bvh_shared.mutex);
+
+  /* Refit or build without holding the lock, so other meshes don't have to wait. */
+  BVHSharedTree *result;
+  if (refit) {
+    bvhtree_shared_refit(refit->tree, mesh, key->type);
+    refit->key.positions_hash = key->positions_hash;
+    refit->refit_count++;
+    result = refit;
+  }
+  else {
+    BVHTree *tree = bvhtree_shared_build(mesh, key->type, key->tree_type);
+    if (tree == NULL) {
+      return NULL;
+    }
+    result = MEM_callocN(sizeof(BVHSharedTree), __func__);
+    result->tree = tree;
+    result->key = *key;
+  }
+  bvhtree_shared_key_data_store(result, mesh);
+
+  BLI_mutex_lock(&bvh_shared.mutex);
+
+  /* Another thread may have built the same tree in the meantime. */
+  shared = bvhtree_shared_find(mesh, key, true);
+  if (shared) {
+    bvhtree_shared_use(shared);
+    bvh_shared.stats.shares++;
+    if (refit) {
+      /* Keep the refit tree for another mesh with the same topology. */
+      refit->users = 0;
+      BLI_addtail(&bvh_shared.trees, refit);
+      bvh_shared.unused_len++;
+      bvhtree_shared_free_unused(BVH_SHARED_UNUSED_MAX);
+    }
+    BLI_mutex_unlock(&bvh_shared.mutex);
+    if (refit == NULL) {
+      bvhtree_shared_free(result);
+    }
+    return shared;
+  }
+
+  shared = result;
+  if (refit) {
+    bvh_shared.stats.refits++;
+  }
+  else {
+    bvh_shared.stats.builds++;
+  }
+  shared->users = 1;
+  BLI_addhead(&bvh_shared.trees, shared);
+
+  BLI_mutex_unlock(&bvh_shared.mutex);
+
+  return shared;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh BVH Cache Access
+ * \{ */
+
 /**
  * Builds or queries a bvhcache for the cache bvhtree of the request type.
  */
@@ -1449,6 +2091,23 @@ BVHTree *BKE_bvhtree_from_mesh_get(struct BVHTreeFromMesh *data,
 
   bool is_cached = bvhcache_find(bvh_cache_p, bvh_cache_type, &tree, NULL, NULL);
 
+  if (is_cached == false && bvhtree_shared_type_supported(bvh_cache_type)) {
+    BVHSharedKey key;
+    bvhtree_shared_key_from_mesh(mesh, bvh_cache_type, tree_type, &key);
+
+    bool lock_started = false;
+    is_cached = bvhcache_find(
+        bvh_cache_p, bvh_cache_type, &tree, &lock_started, mesh_eval_mutex);
+    if (is_cached == false) {
+      BVHSharedTree *shared = bvhtree_shared_ensure(mesh, &key);
+      tree = shared ? shared->tree : NULL;
+      bvhcache_insert(*bvh_cache_p, tree, bvh_cache_type);
+      (*bvh_cache_p)->items[bvh_cache_type].shared = shared;
+      is_cached = true;
+    }
+    bvhcache_unlock(*bvh_cache_p, lock_started);
+  }
+
   if (is_cached && tree == NULL) {
     memset(data, 0, sizeof(*data));
     return tree;
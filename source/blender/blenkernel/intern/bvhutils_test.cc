@@ -0,0 +1,221 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_kdopbvh.h"
+#include "BLI_task.hh"
+
+#include "BKE_bvhutils.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+class BVHSharedCacheTest : public testing::Test {
+ protected:
+  BVHCacheStats stats_start;
+
+  void SetUp() override
+  {
+    BKE_idtype_init();
+    BKE_bvhtree_shared_cache_clear();
+    BKE_bvhtree_cache_stats_get(&stats_start);
+  }
+
+  void TearDown() override
+  {
+    BKE_bvhtree_shared_cache_clear();
+  }
+
+  /* Counters since the start of the test. */
+  BVHCacheStats stats_get()
+  {
+    BVHCacheStats stats;
+    BKE_bvhtree_cache_stats_get(&stats);
+    stats.builds -= stats_start.builds;
+    stats.refits -= stats_start.refits;
+    stats.shares -= stats_start.shares;
+    return stats;
+  }
+};
+
+/* A row of vertices connected by edges, moved by the given offset. */
+static Mesh *create_line_mesh(const int verts_num, const float3 &offset)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num, verts_num - 1, 0, 0, 0);
+  for (const int i : IndexRange(verts_num)) {
+    const float3 co = float3(float(i), 0.0f, 0.0f) + offset;
+    copy_v3_v3(mesh->mvert[i].co, co);
+  }
+  for (const int i : IndexRange(verts_num - 1)) {
+    mesh->medge[i].v1 = i;
+    mesh->medge[i].v2 = i + 1;
+  }
+  return mesh;
+}
+
+static float3 find_nearest(BVHTreeFromMesh &data, const float3 &co)
+{
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  BLI_bvhtree_find_nearest(data.tree, co, &nearest, data.nearest_callback, &data);
+  EXPECT_NE(nearest.index, -1);
+  return nearest.co;
+}
+
+TEST_F(BVHSharedCacheTest, ShareSameContent)
+{
+  Mesh *mesh_a = create_line_mesh(100, float3(0.0f));
+  Mesh *mesh_b = create_line_mesh(100, float3(0.0f));
+
+  BVHTreeFromMesh data_a, data_b;
+  BKE_bvhtree_from_mesh_get(&data_a, mesh_a, BVHTREE_FROM_VERTS, 2);
+  BKE_bvhtree_from_mesh_get(&data_b, mesh_b, BVHTREE_FROM_VERTS, 2);
+  EXPECT_EQ(data_a.tree, data_b.tree);
+
+  BVHCacheStats stats = stats_get();
+  EXPECT_EQ(stats.builds, 1);
+  EXPECT_EQ(stats.shares, 1);
+  EXPECT_EQ(stats.refits, 0);
+  EXPECT_EQ(stats.trees, 1);
+
+  /* A tree of another type is not shared. */
+  BVHTreeFromMesh data_edges;
+  BKE_bvhtree_from_mesh_get(&data_edges, mesh_b, BVHTREE_FROM_EDGES, 2);
+  EXPECT_NE(data_edges.tree, data_a.tree);
+  EXPECT_EQ(stats_get().builds, 2);
+
+  free_bvhtree_from_mesh(&data_a);
+  free_bvhtree_from_mesh(&data_b);
+  free_bvhtree_from_mesh(&data_edges);
+  BKE_id_free(nullptr, mesh_a);
+  /* The tree is still used by the other mesh. */
+  EXPECT_EQ(find_nearest(data_b, float3(10.2f, 1.0f, 0.0f)), float3(10.0f, 0.0f, 0.0f));
+  BKE_id_free(nullptr, mesh_b);
+}
+
+TEST_F(BVHSharedCacheTest, RefitUnusedTree)
+{
+  Mesh *mesh_a = create_line_mesh(100, float3(0.0f));
+  BVHTreeFromMesh data_a;
+  BKE_bvhtree_from_mesh_get(&data_a, mesh_a, BVHTREE_FROM_EDGES, 2);
+  const BVHTree *tree_a = data_a.tree;
+  free_bvhtree_from_mesh(&data_a);
+  BKE_id_free(nullptr, mesh_a);
+
+  /* The unused tree is kept and refit for a mesh with the same topology. */
+  Mesh *mesh_b = create_line_mesh(100, float3(0.0f, 5.0f, 0.0f));
+  BVHTreeFromMesh data_b;
+  BKE_bvhtree_from_mesh_get(&data_b, mesh_b, BVHTREE_FROM_EDGES, 2);
+  EXPECT_EQ(data_b.tree, tree_a);
+  EXPECT_EQ(stats_get().builds, 1);
+  EXPECT_EQ(stats_get().refits, 1);
+  EXPECT_EQ(stats_get().trees, 1);
+
+  /* Queries use the new positions. */
+  const float3 nearest = find_nearest(data_b, float3(50.5f, 6.0f, 0.0f));
+  EXPECT_FLOAT_EQ(nearest.x, 50.5f);
+  EXPECT_FLOAT_EQ(nearest.y, 5.0f);
+
+  /* A used tree is not refit, another mesh with new positions gets a new tree. */
+  Mesh *mesh_c = create_line_mesh(100, float3(0.0f, -5.0f, 0.0f));
+  BVHTreeFromMesh data_c;
+  BKE_bvhtree_from_mesh_get(&data_c, mesh_c, BVHTREE_FROM_EDGES, 2);
+  EXPECT_NE(data_c.tree, data_b.tree);
+  EXPECT_EQ(stats_get().builds, 2);
+  EXPECT_FLOAT_EQ(find_nearest(data_c, float3(20.0f, -6.0f, 0.0f)).y, -5.0f);
+  EXPECT_FLOAT_EQ(find_nearest(data_b, float3(20.0f, 6.0f, 0.0f)).y, 5.0f);
+
+  free_bvhtree_from_mesh(&data_b);
+  free_bvhtree_from_mesh(&data_c);
+  BKE_id_free(nullptr, mesh_b);
+  BKE_id_free(nullptr, mesh_c);
+}
+
+TEST_F(BVHSharedCacheTest, DifferentTopology)
+{
+  Mesh *mesh_a = create_line_mesh(100, float3(0.0f));
+  BVHTreeFromMesh data_a;
+  BKE_bvhtree_from_mesh_get(&data_a, mesh_a, BVHTREE_FROM_EDGES, 2);
+  free_bvhtree_from_mesh(&data_a);
+  BKE_id_free(nullptr, mesh_a);
+
+  Mesh *mesh_b = create_line_mesh(100, float3(0.0f));
+  /* Same lengths and positions, but different edges. */
+  mesh_b->medge[10].v2 = 50;
+  BVHTreeFromMesh data_b;
+  BKE_bvhtree_from_mesh_get(&data_b, mesh_b, BVHTREE_FROM_EDGES, 2);
+  EXPECT_EQ(stats_get().builds, 2);
+  EXPECT_EQ(stats_get().refits, 0);
+  EXPECT_EQ(stats_get().shares, 0);
+
+  free_bvhtree_from_mesh(&data_b);
+  BKE_id_free(nullptr, mesh_b);
+
+  /* Unused trees are freed when the cache is cleared. */
+  BKE_bvhtree_shared_cache_clear();
+  EXPECT_EQ(stats_get().trees, 0);
+}
+
+TEST_F(BVHSharedCacheTest, ParallelRefit)
+{
+  /* Leave unused trees to be refit by the threads. */
+  for (int i = 0; i < 4; i++) {
+    Mesh *mesh = create_line_mesh(1000, float3(0.0f, float(i), 0.0f));
+    BVHTreeFromMesh data;
+    BKE_bvhtree_from_mesh_get(&data, mesh, BVHTREE_FROM_VERTS, 2);
+    free_bvhtree_from_mesh(&data);
+    BKE_id_free(nullptr, mesh);
+  }
+
+  const int meshes_num = 64;
+  Array<Mesh *> meshes(meshes_num);
+  for (const int i : meshes.index_range()) {
+    /* Some meshes have the same positions. */
+    meshes[i] = create_line_mesh(1000, float3(0.0f, 0.0f, float(i % 16) + 10.0f));
+  }
+
+  Array<BVHTreeFromMesh> datas(meshes_num);
+  threading::parallel_for(meshes.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      BKE_bvhtree_from_mesh_get(&datas[i], meshes[i], BVHTREE_FROM_VERTS, 2);
+    }
+  });
+
+  for (const int i : meshes.index_range()) {
+    const float3 co = float3(500.2f, 0.0f, float(i % 16) + 10.1f);
+    EXPECT_EQ(find_nearest(datas[i], co), float3(500.0f, 0.0f, float(i % 16) + 10.0f));
+  }
+  const BVHCacheStats stats = stats_get();
+  EXPECT_EQ(stats.builds + stats.refits + stats.shares, 4 + meshes_num);
+  EXPECT_LE(stats.refits, 4);
+
+  for (const int i : meshes.index_range()) {
+    free_bvhtree_from_mesh(&datas[i]);
+    BKE_id_free(nullptr, meshes[i]);
+  }
+}
+
+}  // namespace blender::bke::tests
@@ -1824,7 +1824,26 @@ static float fcurve_eval_keyframes_extrapolate(
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
-static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, float evaltime)
+/**
+ * Check whether \a evaltime lies strictly inside the segment ending at keyframe \a index, far
+ * enough from both of its keys that the binary search would find the same segment.
+ */
+static bool fcurve_eval_keyframes_segment_contains(
+    FCurve *fcu, BezTriple *bezts, int index, float evaltime, float threshold)
+{
+  if (index < 1 || index >= fcu->totvert) {
+    return false;
+  }
+  const float prevframe = bezts[index - 1].vec[1][0];
+  const float frame = bezts[index].vec[1][0];
+  return (prevframe < evaltime) && (evaltime < frame) &&
+         !IS_EQT(evaltime, prevframe, threshold) && !IS_EQT(evaltime, frame, threshold);
+}
+
+static float fcurve_eval_keyframes_interpolate(FCurve *fcu,
+                                               BezTriple *bezts,
+                                               float evaltime,
+                                               int *segment_hint)
 {
   const float eps = 1.e-8f;
   BezTriple *bezt, *prevbezt;
@@ -1833,9 +1852,7 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
   /* Evaltime occurs somewhere in the middle of the curve. */
   bool exact = false;
 
-  /* Use binary search to find appropriate keyframes...
-   *
-   * The threshold here has the following constraints:
+  /* The threshold used to find keyframes has the following constraints:
    * - 0.001 is too coarse:
    *   We get artifacts with 2cm driver movements at 1BU = 1m (see T40332).
    *
@@ -1843,7 +1860,24 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
    *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
    *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
    */
-  a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  const float threshold = 0.0001f;
+
+  /* During playback the time usually stays within the previously used segment or moves on to
+   * the next one, check those before falling back to a binary search. */
+  if (segment_hint &&
+      fcurve_eval_keyframes_segment_contains(fcu, bezts, *segment_hint, evaltime, threshold)) {
+    a = *segment_hint;
+  }
+  else if (segment_hint && fcurve_eval_keyframes_segment_contains(
+                               fcu, bezts, *segment_hint + 1, evaltime, threshold)) {
+    a = *segment_hint + 1;
+  }
+  else {
+    a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, threshold, &exact);
+  }
+  if (segment_hint) {
+    *segment_hint = (int)a;
+  }
   bezt = bezts + a;
 
   if (exact) {
@@ -2086,7 +2120,10 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
 }
 
 /* Calculate F-Curve value for 'evaltime' using #BezTriple keyframes. */
-static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime)
+static float fcurve_eval_keyframes(FCurve *fcu,
+                                   BezTriple *bezts,
+                                   float evaltime,
+                                   int *segment_hint)
 {
   if (evaltime <= bezts->vec[1][0]) {
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, 0, +1);
@@ -2097,7 +2134,7 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, fcu->totvert - 1, -1);
   }
 
-  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime);
+  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime, segment_hint);
 }
 
 /* Calculate F-Curve value for 'evaltime' using #FPoint samples. */
@@ -2145,8 +2182,11 @@ static float fcurve_eval_samples(FCurve *fcu, FPoint *fpts, float evaltime)
 
 /* Evaluate and return the value of the given F-Curve at the specified frame ("evaltime")
  * Note: this is also used for drivers.
+ *
+ * \param segment_hint: Optional index of the keyframe segment found by the previous evaluation,
+ * speeds up evaluating the curve at times close to each other. Updated to the segment used.
  */
-static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
+static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue, int *segment_hint)
 {
   float devaltime;
 
@@ -2163,7 +2203,7 @@ static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
    *   F-Curve modifier on the stack requested the curve to be evaluated at.
    */
   if (fcu->bezt) {
-    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime);
+    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime, segment_hint);
   }
   else if (fcu->fpt) {
     cvalue = fcurve_eval_samples(fcu, fcu->fpt, devaltime);
@@ -2186,7 +2226,14 @@ float evaluate_fcurve(FCurve *fcu, float evaltime)
 {
   BLI_assert(fcu->driver == NULL);
 
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, NULL);
+}
+
+float evaluate_fcurve_with_hint(FCurve *fcu, float evaltime, int *segment_hint)
+{
+  BLI_assert(fcu->driver == NULL);
+
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, segment_hint);
 }
 
 float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
@@ -2194,7 +2241,7 @@ float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
   /* Can be used to evaluate the (keyframed) fcurve only.
    * Also works for driver-fcurves when the driver itself is not relevant.
    * E.g. when inserting a keyframe in a driver fcurve. */
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, NULL);
 }
 
 float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
@@ -2242,7 +2289,9 @@ float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
     }
   }
 
-  return evaluate_fcurve_ex(fcu, evaltime, cvalue);
+  /* Each driver is evaluated by a single depsgraph operation, so the hint stored in the
+   * (evaluated) driver is not shared between threads. */
+  return evaluate_fcurve_ex(fcu, evaltime, cvalue, &fcu->driver->segment_hint);
 }
 
 /* Checks if the curve has valid keys, drivers or modifiers that produce an actual curve. */
@@ -2252,10 +2301,13 @@ bool BKE_fcurve_is_empty(FCurve *fcu)
          !list_has_suitable_fmodifier(&fcu->modifiers, 0, FMI_TYPE_GENERATE_CURVE);
 }
 
-/* Calculate the value of the given F-Curve at the given frame, and set its curval. */
-float calculate_fcurve(PathResolvedRNA *anim_rna,
-                       FCurve *fcu,
-                       const AnimationEvalContext *anim_eval_context)
+/* Calculate the value of the given F-Curve at the given frame, and set its curval.
+ * The segment hint is only used for keyframed curves without a driver,
+ * see #evaluate_fcurve_ex. */
+float calculate_fcurve_with_hint(PathResolvedRNA *anim_rna,
+                                 FCurve *fcu,
+                                 const AnimationEvalContext *anim_eval_context,
+                                 int *segment_hint)
 {
   /* Only calculate + set curval (overriding the existing value) if curve has
    * any data which warrants this...
@@ -2270,12 +2322,19 @@ float calculate_fcurve(PathResolvedRNA *anim_rna,
     curval = evaluate_fcurve_driver(anim_rna, fcu, fcu->driver, anim_eval_context);
   }
   else {
-    curval = evaluate_fcurve(fcu, anim_eval_context->eval_time);
+    curval = evaluate_fcurve_ex(fcu, anim_eval_context->eval_time, 0.0f, segment_hint);
   }
   fcu->curval = curval; /* Debug display only, not thread safe! */
   return curval;
 }
 
+float calculate_fcurve(PathResolvedRNA *anim_rna,
+                       FCurve *fcu,
+                       const AnimationEvalContext *anim_eval_context)
+{
+  return calculate_fcurve_with_hint(anim_rna, fcu, anim_eval_context, NULL);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -2460,6 +2519,7 @@ void BKE_fcurve_blend_read_data(BlendDataReader *reader, ListBase *fcurves)
        * (old pointer may still be set here). */
       driver->expr_comp = NULL;
       driver->expr_simple = NULL;
+      driver->segment_hint = 0;
 
       /* Give the driver a fresh chance - the operating environment may be different now
        * (addons, etc. may be different) so the driver namespace may be sane now T32155. */
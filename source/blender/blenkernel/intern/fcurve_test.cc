@@ -19,6 +19,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BKE_animsys.h"
 #include "BKE_fcurve.h"
 
 #include "ED_keyframing.h"
@@ -26,6 +27,8 @@
 
 #include "DNA_anim_types.h"
 
+#include "BLI_rand.hh"
+
 namespace blender::bke::tests {
 
 /* Epsilon for floating point comparisons. */
@@ -212,6 +215,61 @@ TEST(evaluate_fcurve, ExtrapolationBezierKeys)
   BKE_fcurve_free(fcu);
 }
 
+TEST(evaluate_fcurve, SegmentHint)
+{
+  FCurve *fcu = BKE_fcurve_create();
+
+  for (int i = 0; i < 10; i++) {
+    insert_vert_fcurve(
+        fcu, (float)(i * 2), (float)((i * 7) % 5), BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  }
+  fcu->bezt[4].ipo = BEZT_IPO_LIN;
+  fcu->bezt[6].ipo = BEZT_IPO_CONST;
+
+  /* Hinted evaluation must match the binary search, no matter in which order times are visited.
+   * Times close to keys are included, which must be treated as being on the key. */
+  auto test_time = [&](const float evaltime, int *segment_hint) {
+    AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(nullptr,
+                                                                                evaltime);
+    EXPECT_EQ(calculate_fcurve_with_hint(nullptr, fcu, &anim_eval_context, segment_hint),
+              evaluate_fcurve(fcu, evaltime));
+  };
+
+  int segment_hint = 0;
+  for (float evaltime = -1.0f; evaltime < 20.0f; evaltime += 0.1f) {
+    test_time(evaltime, &segment_hint);
+  }
+  for (float evaltime = 20.0f; evaltime > -1.0f; evaltime -= 0.25f) {
+    test_time(evaltime, &segment_hint);
+  }
+  for (int i = 0; i < 10; i++) {
+    test_time(i * 2.0f - 0.00005f, &segment_hint);
+    test_time(i * 2.0f + 0.00005f, &segment_hint);
+    test_time(i * 2.0f + 0.0002f, &segment_hint);
+  }
+
+  RandomNumberGenerator rng(1);
+  for (int i = 0; i < 1000; i++) {
+    test_time(rng.get_float() * 22.0f - 1.0f, &segment_hint);
+  }
+
+  /* Hints that are out of range are ignored. */
+  segment_hint = 100;
+  test_time(5.0f, &segment_hint);
+  EXPECT_EQ(segment_hint, 3);
+  segment_hint = -1;
+  test_time(5.0f, &segment_hint);
+
+  /* Same for the evaluation used by NLA strips. */
+  segment_hint = 0;
+  for (float evaltime = -1.0f; evaltime < 20.0f; evaltime += 0.3f) {
+    EXPECT_EQ(evaluate_fcurve_with_hint(fcu, evaltime, &segment_hint),
+              evaluate_fcurve(fcu, evaltime));
+  }
+
+  BKE_fcurve_free(fcu);
+}
+
 TEST(fcurve_subdivide, BKE_fcurve_bezt_subdivide_handles)
 {
   FCurve *fcu = BKE_fcurve_create();
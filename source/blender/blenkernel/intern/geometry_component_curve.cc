@@ -193,27 +193,23 @@ static PointIndices lookup_point_indices(Span<int> offsets, const int index)
 
 /**
  * Mix together all of a spline's control point values.
- *
- * \note Theoretically this interpolation does not need to compute all values at once.
- * However, doing that makes the implementation simpler, and this can be optimized in the future if
- * only some values are required.
  */
 template<typename T>
-static void adapt_curve_domain_point_to_spline_impl(const CurveEval &curve,
+static void adapt_curve_domain_point_to_spline_impl(Span<int> offsets,
                                                     const VArray<T> &old_values,
+                                                    const Span<int64_t> spline_indices,
                                                     MutableSpan<T> r_values)
 {
-  const int splines_len = curve.splines().size();
-  Array<int> offsets = curve.control_point_offsets();
-  BLI_assert(r_values.size() == splines_len);
+  BLI_assert(r_values.size() == spline_indices.size());
   attribute_math::DefaultMixer<T> mixer(r_values);
 
-  for (const int i_spline : IndexRange(splines_len)) {
+  for (const int64_t i : spline_indices.index_range()) {
+    const int64_t i_spline = spline_indices[i];
     const int spline_offset = offsets[i_spline];
     const int spline_point_len = offsets[i_spline + 1] - spline_offset;
     for (const int i_point : IndexRange(spline_point_len)) {
       const T value = old_values[spline_offset + i_point];
-      mixer.mix_in(i_spline, value);
+      mixer.mix_in(i, value);
     }
   }
 
@@ -226,9 +222,14 @@ static GVArrayPtr adapt_curve_domain_point_to_spline(const CurveEval &curve, GVA
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
-      Array<T> values(curve.splines().size());
-      adapt_curve_domain_point_to_spline_impl<T>(curve, varray->typed<T>(), values);
-      new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+      /* The spline values are only mixed when they are accessed. */
+      new_varray = make_lazy_adapted_domain_varray<T>(
+          curve.splines().size(),
+          std::move(varray),
+          [offsets = curve.control_point_offsets()](
+              const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+            adapt_curve_domain_point_to_spline_impl<T>(offsets, old_values, indices, r_values);
+          });
     }
   });
   return new_varray;
@@ -274,7 +275,7 @@ template<typename T> class VArray_For_SplineToPoint final : public VArray<T> {
     else {
       int spline_index = 0;
       for (const int dst_index : mask) {
-        while (offsets_[spline_index] < dst_index) {
+        while (offsets_[spline_index + 1] <= dst_index) {
           spline_index++;
         }
         r_span[dst_index] = original_data_[spline_index];
@@ -296,7 +297,7 @@ template<typename T> class VArray_For_SplineToPoint final : public VArray<T> {
     else {
       int spline_index = 0;
       for (const int dst_index : mask) {
-        while (offsets_[spline_index] < dst_index) {
+        while (offsets_[spline_index + 1] <= dst_index) {
           spline_index++;
         }
         new (dst + dst_index) T(original_data_[spline_index]);
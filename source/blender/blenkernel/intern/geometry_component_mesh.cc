@@ -26,6 +26,7 @@
 #include "BKE_geometry_set.hh"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
 
 #include "attribute_access_intern.hh"
 
@@ -235,13 +236,14 @@ static GVArrayPtr adapt_mesh_domain_corner_to_point(const Mesh &mesh, GVArrayPtr
 template<typename T>
 static void adapt_mesh_domain_point_to_corner_impl(const Mesh &mesh,
                                                    const VArray<T> &old_values,
+                                                   const Span<int64_t> loop_indices,
                                                    MutableSpan<T> r_values)
 {
-  BLI_assert(r_values.size() == mesh.totloop);
+  BLI_assert(r_values.size() == loop_indices.size());
 
-  for (const int loop_index : IndexRange(mesh.totloop)) {
-    const int vertex_index = mesh.mloop[loop_index].v;
-    r_values[loop_index] = old_values[vertex_index];
+  for (const int64_t i : loop_indices.index_range()) {
+    const int vertex_index = mesh.mloop[loop_indices[i]].v;
+    r_values[i] = old_values[vertex_index];
   }
 }
 
@@ -250,35 +252,31 @@ static GVArrayPtr adapt_mesh_domain_point_to_corner(const Mesh &mesh, GVArrayPtr
   GVArrayPtr new_varray;
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
-    /* It is not strictly necessary to compute the value for all corners here. Instead one could
-     * lazily lookup the mesh topology when a specific index accessed. This can be more efficient
-     * when an algorithm only accesses very few of the corner values. However, for the algorithms
-     * we currently have, precomputing the array is fine. Also, it is easier to implement. */
-    Array<T> values(mesh.totloop);
-    adapt_mesh_domain_point_to_corner_impl<T>(mesh, varray->typed<T>(), values);
-    new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+    /* The corner values are looked up lazily, which avoids a copy of the attribute when an
+     * algorithm only accesses some of the corners or streams through them once. */
+    new_varray = make_lazy_adapted_domain_varray<T>(
+        mesh.totloop,
+        std::move(varray),
+        [&mesh](const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+          adapt_mesh_domain_point_to_corner_impl<T>(mesh, old_values, indices, r_values);
+        });
   });
   return new_varray;
 }
 
-/**
- * \note Theoretically this interpolation does not need to compute all values at once.
- * However, doing that makes the implementation simpler, and this can be optimized in the future if
- * only some values are required.
- */
 template<typename T>
 static void adapt_mesh_domain_corner_to_face_impl(const Mesh &mesh,
                                                   const VArray<T> &old_values,
+                                                  const Span<int64_t> poly_indices,
                                                   MutableSpan<T> r_values)
 {
-  BLI_assert(r_values.size() == mesh.totpoly);
+  BLI_assert(r_values.size() == poly_indices.size());
   attribute_math::DefaultMixer<T> mixer(r_values);
 
-  for (const int poly_index : IndexRange(mesh.totpoly)) {
-    const MPoly &poly = mesh.mpoly[poly_index];
+  for (const int64_t i : poly_indices.index_range()) {
+    const MPoly &poly = mesh.mpoly[poly_indices[i]];
     for (const int loop_index : IndexRange(poly.loopstart, poly.totloop)) {
-      const T value = old_values[loop_index];
-      mixer.mix_in(poly_index, value);
+      mixer.mix_in(i, old_values[loop_index]);
     }
   }
 
@@ -291,9 +289,12 @@ static GVArrayPtr adapt_mesh_domain_corner_to_face(const Mesh &mesh, GVArrayPtr
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
-      Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_corner_to_face_impl<T>(mesh, varray->typed<T>(), values);
-      new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+      new_varray = make_lazy_adapted_domain_varray<T>(
+          mesh.totpoly,
+          std::move(varray),
+          [&mesh](const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+            adapt_mesh_domain_corner_to_face_impl<T>(mesh, old_values, indices, r_values);
+          });
     }
   });
   return new_varray;
@@ -433,27 +434,23 @@ static GVArrayPtr adapt_mesh_domain_face_to_edge(const Mesh &mesh, GVArrayPtr va
   return new_varray;
 }
 
-/**
- * \note Theoretically this interpolation does not need to compute all values at once.
- * However, doing that makes the implementation simpler, and this can be optimized in the future if
- * only some values are required.
- */
 template<typename T>
 static void adapt_mesh_domain_point_to_face_impl(const Mesh &mesh,
                                                  const VArray<T> &old_values,
+                                                 const Span<int64_t> poly_indices,
                                                  MutableSpan<T> r_values)
 {
-  BLI_assert(r_values.size() == mesh.totpoly);
+  BLI_assert(r_values.size() == poly_indices.size());
   attribute_math::DefaultMixer<T> mixer(r_values);
 
-  for (const int poly_index : IndexRange(mesh.totpoly)) {
-    const MPoly &poly = mesh.mpoly[poly_index];
+  for (const int64_t i : poly_indices.index_range()) {
+    const MPoly &poly = mesh.mpoly[poly_indices[i]];
     for (const int loop_index : IndexRange(poly.loopstart, poly.totloop)) {
-      MLoop &loop = mesh.mloop[loop_index];
-      const int point_index = loop.v;
-      mixer.mix_in(poly_index, old_values[point_index]);
+      const MLoop &loop = mesh.mloop[loop_index];
+      mixer.mix_in(i, old_values[loop.v]);
     }
   }
+
   mixer.finalize();
 }
 
@@ -463,31 +460,30 @@ static GVArrayPtr adapt_mesh_domain_point_to_face(const Mesh &mesh, GVArrayPtr v
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
-      Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_point_to_face_impl<T>(mesh, varray->typed<T>(), values);
-      new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+      new_varray = make_lazy_adapted_domain_varray<T>(
+          mesh.totpoly,
+          std::move(varray),
+          [&mesh](const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+            adapt_mesh_domain_point_to_face_impl<T>(mesh, old_values, indices, r_values);
+          });
     }
   });
   return new_varray;
 }
 
-/**
- * \note Theoretically this interpolation does not need to compute all values at once.
- * However, doing that makes the implementation simpler, and this can be optimized in the future if
- * only some values are required.
- */
 template<typename T>
 static void adapt_mesh_domain_point_to_edge_impl(const Mesh &mesh,
                                                  const VArray<T> &old_values,
+                                                 const Span<int64_t> edge_indices,
                                                  MutableSpan<T> r_values)
 {
-  BLI_assert(r_values.size() == mesh.totedge);
+  BLI_assert(r_values.size() == edge_indices.size());
   attribute_math::DefaultMixer<T> mixer(r_values);
 
-  for (const int edge_index : IndexRange(mesh.totedge)) {
-    const MEdge &edge = mesh.medge[edge_index];
-    mixer.mix_in(edge_index, old_values[edge.v1]);
-    mixer.mix_in(edge_index, old_values[edge.v2]);
+  for (const int64_t i : edge_indices.index_range()) {
+    const MEdge &edge = mesh.medge[edge_indices[i]];
+    mixer.mix_in(i, old_values[edge.v1]);
+    mixer.mix_in(i, old_values[edge.v2]);
   }
 
   mixer.finalize();
@@ -499,9 +495,12 @@ static GVArrayPtr adapt_mesh_domain_point_to_edge(const Mesh &mesh, GVArrayPtr v
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
-      Array<T> values(mesh.totedge);
-      adapt_mesh_domain_point_to_edge_impl<T>(mesh, varray->typed<T>(), values);
-      new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+      new_varray = make_lazy_adapted_domain_varray<T>(
+          mesh.totedge,
+          std::move(varray),
+          [&mesh](const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+            adapt_mesh_domain_point_to_edge_impl<T>(mesh, old_values, indices, r_values);
+          });
     }
   });
   return new_varray;
@@ -577,24 +576,20 @@ static GVArrayPtr adapt_mesh_domain_edge_to_point(const Mesh &mesh, GVArrayPtr v
   return new_varray;
 }
 
-/**
- * \note Theoretically this interpolation does not need to compute all values at once.
- * However, doing that makes the implementation simpler, and this can be optimized in the future if
- * only some values are required.
- */
 template<typename T>
 static void adapt_mesh_domain_edge_to_face_impl(const Mesh &mesh,
                                                 const VArray<T> &old_values,
+                                                const Span<int64_t> poly_indices,
                                                 MutableSpan<T> r_values)
 {
-  BLI_assert(r_values.size() == mesh.totpoly);
+  BLI_assert(r_values.size() == poly_indices.size());
   attribute_math::DefaultMixer<T> mixer(r_values);
 
-  for (const int poly_index : IndexRange(mesh.totpoly)) {
-    const MPoly &poly = mesh.mpoly[poly_index];
+  for (const int64_t i : poly_indices.index_range()) {
+    const MPoly &poly = mesh.mpoly[poly_indices[i]];
     for (const int loop_index : IndexRange(poly.loopstart, poly.totloop)) {
       const MLoop &loop = mesh.mloop[loop_index];
-      mixer.mix_in(poly_index, old_values[loop.e]);
+      mixer.mix_in(i, old_values[loop.e]);
     }
   }
 
@@ -607,9 +602,12 @@ static GVArrayPtr adapt_mesh_domain_edge_to_face(const Mesh &mesh, GVArrayPtr va
   attribute_math::convert_to_static_type(varray->type(), [&](auto dummy) {
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
-      Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_edge_to_face_impl<T>(mesh, varray->typed<T>(), values);
-      new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
+      new_varray = make_lazy_adapted_domain_varray<T>(
+          mesh.totpoly,
+          std::move(varray),
+          [&mesh](const VArray<T> &old_values, Span<int64_t> indices, MutableSpan<T> r_values) {
+            adapt_mesh_domain_edge_to_face_impl<T>(mesh, old_values, indices, r_values);
+          });
     }
   });
   return new_varray;
@@ -735,11 +733,12 @@ static void set_vertex_position(MVert &vert, float3 position)
   copy_v3_v3(vert.co, position);
 }
 
-static void tag_normals_dirty_when_writing_position(GeometryComponent &component)
+static void tag_component_positions_changed(GeometryComponent &component)
 {
   Mesh *mesh = get_mesh_from_component_for_write(component);
   if (mesh != nullptr) {
     mesh->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+    BKE_mesh_runtime_clear_vert_point_grid(mesh);
   }
 }
 
@@ -1067,7 +1066,7 @@ static ComponentAttributeProviders create_attribute_providers_for_mesh()
       point_access,
       make_derived_read_attribute<MVert, float3, get_vertex_position>,
       make_derived_write_attribute<MVert, float3, get_vertex_position, set_vertex_position>,
-      tag_normals_dirty_when_writing_position);
+      tag_component_positions_changed);
 
   static NormalAttributeProvider normal;
 
@@ -153,6 +153,14 @@ static GVMutableArrayPtr make_array_write_attribute(void *data, const int domain
       MutableSpan<T>((T *)data, domain_size));
 }
 
+static void tag_component_positions_changed(GeometryComponent &component)
+{
+  PointCloud *pointcloud = static_cast<PointCloudComponent &>(component).get_for_write();
+  if (pointcloud != nullptr) {
+    BKE_pointcloud_point_grid_free(pointcloud);
+  }
+}
+
 /**
  * In this function all the attribute providers for a point cloud component are created. Most data
  * in this function is statically allocated, because it does not change over time.
@@ -190,7 +198,7 @@ static ComponentAttributeProviders create_attribute_providers_for_point_cloud()
                                                  point_access,
                                                  make_array_read_attribute<float3>,
                                                  make_array_write_attribute<float3>,
-                                                 nullptr);
+                                                 tag_component_positions_changed);
   static BuiltinCustomDataLayerProvider radius("radius",
                                                ATTR_DOMAIN_POINT,
                                                CD_PROP_FLOAT,
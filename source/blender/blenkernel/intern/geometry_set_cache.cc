@@ -0,0 +1,551 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+#include "BLI_vector.hh"
+
+#include "DNA_collection_types.h"
+#include "DNA_material_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_geometry_set_cache.hh"
+#include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
+
+namespace blender::bke {
+
+static const char cache_file_magic[8] = {'B', 'G', 'E', 'O', 'S', 'E', 'T', '\0'};
+static const uint32_t cache_file_version = 1;
+static const int64_t cache_file_alignment = 64;
+
+enum class CacheComponentType : uint32_t {
+  Mesh = 0,
+  PointCloud = 1,
+  Instances = 2,
+};
+
+struct CacheFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t components_num;
+  /** Size of the description that follows the header. */
+  uint64_t description_size;
+  /** Start of the arrays, relative to the start of the file. */
+  uint64_t arrays_offset;
+};
+
+static int64_t cache_file_align(const int64_t size)
+{
+  return (size + cache_file_alignment - 1) / cache_file_alignment * cache_file_alignment;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Writing
+ * \{ */
+
+class CacheFileWriter {
+ private:
+  struct Array {
+    const void *data;
+    int64_t size;
+  };
+
+  Vector<char> description_;
+  Vector<Array> arrays_;
+  /** Size of the arrays added so far, including the padding between them. */
+  int64_t arrays_size_ = 0;
+
+ public:
+  template<typename T> void write_value(const T &value)
+  {
+    description_.extend(Span<char>(reinterpret_cast<const char *>(&value), sizeof(T)));
+  }
+
+  void write_string(StringRef str)
+  {
+    this->write_value<uint32_t>(str.size());
+    description_.extend(Span<char>(str.data(), str.size()));
+  }
+
+  /* The data is only referenced, it has to stay alive until the file is written. */
+  void write_array(const void *data, const int64_t size)
+  {
+    this->write_value<uint64_t>(arrays_size_);
+    this->write_value<uint64_t>(size);
+    arrays_.append({data, size});
+    arrays_size_ += cache_file_align(size);
+  }
+
+  bool write_file(const char *filepath, const int components_num)
+  {
+    CacheFileHeader header;
+    memcpy(header.magic, cache_file_magic, sizeof(header.magic));
+    header.version = cache_file_version;
+    header.components_num = components_num;
+    header.description_size = description_.size();
+    header.arrays_offset = cache_file_align(sizeof(CacheFileHeader) + description_.size());
+
+    FILE *file = BLI_fopen(filepath, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+
+    static const char padding[cache_file_alignment] = {0};
+    const size_t description_size = description_.size();
+    const size_t description_padding = header.arrays_offset - sizeof(header) - description_size;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(description_.data(), 1, description_size, file) == description_size;
+    ok = ok && fwrite(padding, 1, description_padding, file) == description_padding;
+    for (const Array &array : arrays_) {
+      if (!ok) {
+        break;
+      }
+      const size_t array_size = array.size;
+      const size_t array_padding = cache_file_align(array.size) - array.size;
+      ok = fwrite(array.data, 1, array_size, file) == array_size;
+      ok = ok && fwrite(padding, 1, array_padding, file) == array_padding;
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+      BLI_delete(filepath, false, false);
+    }
+    return ok;
+  }
+};
+
+static bool is_cached_layer_type(const int type)
+{
+  return ELEM(type, CD_MVERT, CD_MEDGE, CD_MLOOP, CD_MPOLY, CD_MLOOPUV) ||
+         (CD_TYPE_AS_MASK(type) & CD_MASK_PROP_ALL);
+}
+
+static void write_custom_data(CacheFileWriter &writer, const CustomData &data, const int size)
+{
+  Vector<const CustomDataLayer *> layers;
+  for (const int i : IndexRange(data.totlayer)) {
+    const CustomDataLayer &layer = data.layers[i];
+    if (is_cached_layer_type(layer.type) && !(layer.flag & CD_FLAG_NOCOPY)) {
+      layers.append(&layer);
+    }
+  }
+
+  writer.write_value<uint32_t>(layers.size());
+  for (const CustomDataLayer *layer : layers) {
+    writer.write_value<int32_t>(layer->type);
+    writer.write_string(layer->name);
+    writer.write_array(layer->data, int64_t(CustomData_sizeof(layer->type)) * size);
+  }
+}
+
+static void write_materials(CacheFileWriter &writer, Span<const Material *> materials)
+{
+  writer.write_value<uint32_t>(materials.size());
+  for (const Material *material : materials) {
+    writer.write_string(material ? material->id.name + 2 : "");
+  }
+}
+
+static void write_mesh(CacheFileWriter &writer, const Mesh &mesh)
+{
+  writer.write_value<uint32_t>(mesh.totvert);
+  writer.write_value<uint32_t>(mesh.totedge);
+  writer.write_value<uint32_t>(mesh.totloop);
+  writer.write_value<uint32_t>(mesh.totpoly);
+  writer.write_value<int16_t>(mesh.flag);
+  writer.write_value<float>(mesh.smoothresh);
+  writer.write_value<int8_t>(mesh.cd_flag);
+  write_custom_data(writer, mesh.vdata, mesh.totvert);
+  write_custom_data(writer, mesh.edata, mesh.totedge);
+  write_custom_data(writer, mesh.ldata, mesh.totloop);
+  write_custom_data(writer, mesh.pdata, mesh.totpoly);
+  write_materials(writer, {mesh.mat, mesh.totcol});
+}
+
+static void write_pointcloud(CacheFileWriter &writer, const PointCloud &pointcloud)
+{
+  writer.write_value<uint32_t>(pointcloud.totpoint);
+  write_custom_data(writer, pointcloud.pdata, pointcloud.totpoint);
+  write_materials(writer, {pointcloud.mat, pointcloud.totcol});
+}
+
+static void write_instances(CacheFileWriter &writer, const InstancesComponent &component)
+{
+  Span<InstanceReference> references = component.references();
+  writer.write_value<uint32_t>(references.size());
+  for (const InstanceReference &reference : references) {
+    const ID *id = nullptr;
+    switch (reference.type()) {
+      case InstanceReference::Type::Object:
+        id = &reference.object().id;
+        break;
+      case InstanceReference::Type::Collection:
+        id = &reference.collection().id;
+        break;
+      case InstanceReference::Type::None:
+        break;
+    }
+    writer.write_value<int16_t>(id ? GS(id->name) : 0);
+    writer.write_string(id ? id->name + 2 : "");
+  }
+
+  const int64_t instances_num = component.instances_amount();
+  writer.write_value<uint32_t>(instances_num);
+  writer.write_array(component.instance_reference_handles().data(), sizeof(int) * instances_num);
+  writer.write_array(component.instance_transforms().data(),
+                     sizeof(float4x4) * instances_num);
+  writer.write_array(component.instance_ids().data(), sizeof(int) * instances_num);
+}
+
+bool geometry_set_cache_write(const GeometrySet &geometry_set, const char *filepath)
+{
+  CacheFileWriter writer;
+  int components_num = 0;
+
+  if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+    writer.write_value(CacheComponentType::Mesh);
+    write_mesh(writer, *mesh);
+    components_num++;
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+    writer.write_value(CacheComponentType::PointCloud);
+    write_pointcloud(writer, *pointcloud);
+    components_num++;
+  }
+  if (geometry_set.has_instances()) {
+    writer.write_value(CacheComponentType::Instances);
+    write_instances(writer, *geometry_set.get_component_for_read<InstancesComponent>());
+    components_num++;
+  }
+
+  return writer.write_file(filepath, components_num);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Reading
+ * \{ */
+
+class CacheFileReader {
+ private:
+  BLI_mmap_file *mmap_file_ = nullptr;
+  Vector<char> description_;
+  int64_t description_pos_ = 0;
+  int64_t arrays_offset_ = 0;
+
+ public:
+  ~CacheFileReader()
+  {
+    if (mmap_file_) {
+      BLI_mmap_free(mmap_file_);
+    }
+  }
+
+  bool open(const char *filepath, int *r_components_num)
+  {
+    const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+    if (file == -1) {
+      return false;
+    }
+    mmap_file_ = BLI_mmap_open(file);
+    close(file);
+    if (mmap_file_ == nullptr) {
+      return false;
+    }
+
+    CacheFileHeader header;
+    if (!BLI_mmap_read(mmap_file_, &header, 0, sizeof(header))) {
+      return false;
+    }
+    if (memcmp(header.magic, cache_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != cache_file_version) {
+      return false;
+    }
+    if (header.description_size > header.arrays_offset) {
+      return false;
+    }
+
+    description_.resize(header.description_size);
+    if (!BLI_mmap_read(
+            mmap_file_, description_.data(), sizeof(header), header.description_size)) {
+      return false;
+    }
+    arrays_offset_ = header.arrays_offset;
+    *r_components_num = header.components_num;
+    return true;
+  }
+
+  template<typename T> bool read_value(T &r_value)
+  {
+    if (description_pos_ + int64_t(sizeof(T)) > description_.size()) {
+      return false;
+    }
+    memcpy(&r_value, description_.data() + description_pos_, sizeof(T));
+    description_pos_ += sizeof(T);
+    return true;
+  }
+
+  bool read_string(std::string &r_str)
+  {
+    uint32_t size;
+    if (!this->read_value(size) || description_pos_ + size > description_.size()) {
+      return false;
+    }
+    r_str.assign(description_.data() + description_pos_, size);
+    description_pos_ += size;
+    return true;
+  }
+
+  /* Read an array written with #CacheFileWriter::write_array directly from the mapped file. */
+  bool read_array(void *r_data, const int64_t size)
+  {
+    uint64_t offset, stored_size;
+    if (!this->read_value(offset) || !this->read_value(stored_size) || stored_size != size) {
+      return false;
+    }
+    if (size == 0) {
+      return true;
+    }
+    return BLI_mmap_read(mmap_file_, r_data, arrays_offset_ + offset, size);
+  }
+};
+
+static bool read_custom_data(CacheFileReader &reader, CustomData &data, const int size)
+{
+  uint32_t layers_num;
+  if (!reader.read_value(layers_num)) {
+    return false;
+  }
+  for ([[maybe_unused]] const int i : IndexRange(layers_num)) {
+    int32_t type;
+    std::string name;
+    if (!reader.read_value(type) || !reader.read_string(name)) {
+      return false;
+    }
+    if (type < 0 || type >= CD_NUMTYPES || !is_cached_layer_type(type)) {
+      return false;
+    }
+
+    /* Layers that are created with the geometry, like the vertex positions, are filled. */
+    void *layer_data = CustomData_layertype_is_singleton(type) ?
+                           CustomData_get_layer(&data, type) :
+                           CustomData_get_layer_named(&data, type, name.c_str());
+    if (layer_data == nullptr) {
+      layer_data = CustomData_add_layer_named(
+          &data, type, CD_CALLOC, nullptr, size, name.c_str());
+    }
+    if (!reader.read_array(layer_data, int64_t(CustomData_sizeof(type)) * size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool read_materials(CacheFileReader &reader,
+                           GeometrySetCacheIDResolver resolve_id,
+                           Material ***r_materials,
+                           short *r_materials_num)
+{
+  uint32_t materials_num;
+  if (!reader.read_value(materials_num) || materials_num > MAXMAT) {
+    return false;
+  }
+  if (materials_num == 0) {
+    return true;
+  }
+
+  Material **materials = (Material **)MEM_calloc_arrayN(
+      materials_num, sizeof(Material *), __func__);
+  *r_materials = materials;
+  *r_materials_num = materials_num;
+  for (const int i : IndexRange(materials_num)) {
+    std::string name;
+    if (!reader.read_string(name)) {
+      return false;
+    }
+    if (!name.empty()) {
+      materials[i] = (Material *)resolve_id(ID_MA, name);
+    }
+  }
+  return true;
+}
+
+static bool read_mesh(CacheFileReader &reader,
+                      GeometrySetCacheIDResolver resolve_id,
+                      GeometrySet &r_geometry_set)
+{
+  uint32_t totvert, totedge, totloop, totpoly;
+  int16_t flag;
+  float smoothresh;
+  int8_t cd_flag;
+  if (!reader.read_value(totvert) || !reader.read_value(totedge) ||
+      !reader.read_value(totloop) || !reader.read_value(totpoly) || !reader.read_value(flag) ||
+      !reader.read_value(smoothresh) || !reader.read_value(cd_flag)) {
+    return false;
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(totvert, totedge, 0, totloop, totpoly);
+  /* Owned by the geometry set, so it is freed when reading fails. */
+  r_geometry_set.replace_mesh(mesh);
+  mesh->flag = flag;
+  mesh->smoothresh = smoothresh;
+  mesh->cd_flag = cd_flag;
+
+  if (!read_custom_data(reader, mesh->vdata, totvert) ||
+      !read_custom_data(reader, mesh->edata, totedge) ||
+      !read_custom_data(reader, mesh->ldata, totloop) ||
+      !read_custom_data(reader, mesh->pdata, totpoly) ||
+      !read_materials(reader, resolve_id, &mesh->mat, &mesh->totcol)) {
+    return false;
+  }
+  BKE_mesh_update_customdata_pointers(mesh, false);
+  return true;
+}
+
+static bool read_pointcloud(CacheFileReader &reader,
+                            GeometrySetCacheIDResolver resolve_id,
+                            GeometrySet &r_geometry_set)
+{
+  uint32_t totpoint;
+  if (!reader.read_value(totpoint)) {
+    return false;
+  }
+
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(totpoint);
+  r_geometry_set.replace_pointcloud(pointcloud);
+
+  if (!read_custom_data(reader, pointcloud->pdata, totpoint) ||
+      !read_materials(reader, resolve_id, &pointcloud->mat, &pointcloud->totcol)) {
+    return false;
+  }
+  BKE_pointcloud_update_customdata_pointers(pointcloud);
+  return true;
+}
+
+static bool read_instances(CacheFileReader &reader,
+                           GeometrySetCacheIDResolver resolve_id,
+                           GeometrySet &r_geometry_set)
+{
+  InstancesComponent &component = r_geometry_set.get_component_for_write<InstancesComponent>();
+
+  uint32_t references_num;
+  if (!reader.read_value(references_num)) {
+    return false;
+  }
+  /* Adding references removes duplicates, e.g. when multiple references could not be resolved,
+   * so the stored handles are mapped to the new ones. */
+  Vector<int> handle_map(references_num);
+  for (const int i : IndexRange(references_num)) {
+    int16_t id_type;
+    std::string name;
+    if (!reader.read_value(id_type) || !reader.read_string(name)) {
+      return false;
+    }
+    ID *id = name.empty() ? nullptr : resolve_id(id_type, name);
+    if (id != nullptr && GS(id->name) == ID_OB) {
+      handle_map[i] = component.add_reference(*(Object *)id);
+    }
+    else if (id != nullptr && GS(id->name) == ID_GR) {
+      handle_map[i] = component.add_reference(*(Collection *)id);
+    }
+    else {
+      handle_map[i] = component.add_reference(InstanceReference());
+    }
+  }
+
+  uint32_t instances_num;
+  if (!reader.read_value(instances_num)) {
+    return false;
+  }
+  component.resize(instances_num);
+  MutableSpan<int> handles = component.instance_reference_handles();
+  if (!reader.read_array(handles.data(), sizeof(int) * instances_num) ||
+      !reader.read_array(component.instance_transforms().data(),
+                         sizeof(float4x4) * instances_num) ||
+      !reader.read_array(component.instance_ids().data(), sizeof(int) * instances_num)) {
+    return false;
+  }
+  for (int &handle : handles) {
+    if (handle < 0 || handle >= handle_map.size()) {
+      return false;
+    }
+    handle = handle_map[handle];
+  }
+  return true;
+}
+
+bool geometry_set_cache_read(const char *filepath,
+                             GeometrySetCacheIDResolver resolve_id,
+                             GeometrySet &r_geometry_set)
+{
+  CacheFileReader reader;
+  int components_num;
+  if (!reader.open(filepath, &components_num)) {
+    return false;
+  }
+
+  GeometrySet geometry_set;
+  for ([[maybe_unused]] const int i : IndexRange(components_num)) {
+    CacheComponentType type;
+    if (!reader.read_value(type)) {
+      return false;
+    }
+    bool ok = false;
+    switch (type) {
+      case CacheComponentType::Mesh:
+        ok = read_mesh(reader, resolve_id, geometry_set);
+        break;
+      case CacheComponentType::PointCloud:
+        ok = read_pointcloud(reader, resolve_id, geometry_set);
+        break;
+      case CacheComponentType::Instances:
+        ok = read_instances(reader, resolve_id, geometry_set);
+        break;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+
+  r_geometry_set = std::move(geometry_set);
+  return true;
+}
+
+/** \} */
+
+}  // namespace blender::bke
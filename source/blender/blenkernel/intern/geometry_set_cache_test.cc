@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <cstring>
+#include <string>
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "BKE_customdata.h"
+#include "BKE_geometry_set_cache.hh"
+#include "BKE_idtype.h"
+#include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+namespace blender::bke::tests {
+
+class GeometrySetCacheTest : public testing::Test {
+ protected:
+  std::string filepath;
+
+  void SetUp() override
+  {
+    BKE_idtype_init();
+    filepath = testing::TempDir() + "geometry_set_cache_test.bgeo";
+  }
+
+  void TearDown() override
+  {
+    BLI_delete(filepath.c_str(), false, false);
+  }
+};
+
+static ID *resolve_no_id(short UNUSED(id_type), StringRefNull UNUSED(name))
+{
+  return nullptr;
+}
+
+TEST_F(GeometrySetCacheTest, MeshAttributes)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(4, 4, 0, 4, 1);
+  for (const int i : IndexRange(4)) {
+    mesh->mvert[i].co[0] = i;
+    mesh->medge[i].v1 = i;
+    mesh->medge[i].v2 = (i + 1) % 4;
+    mesh->mloop[i].v = i;
+    mesh->mloop[i].e = i;
+  }
+  mesh->mpoly[0].totloop = 4;
+  float *weights = (float *)CustomData_add_layer_named(
+      &mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, 4, "weight");
+  for (const int i : IndexRange(4)) {
+    weights[i] = i * 0.5f;
+  }
+
+  GeometrySet geometry_set = GeometrySet::create_with_mesh(mesh);
+  ASSERT_TRUE(geometry_set_cache_write(geometry_set, filepath.c_str()));
+
+  GeometrySet result;
+  ASSERT_TRUE(geometry_set_cache_read(filepath.c_str(), resolve_no_id, result));
+  const Mesh *result_mesh = result.get_mesh_for_read();
+  ASSERT_NE(result_mesh, nullptr);
+  EXPECT_FALSE(result.has_pointcloud());
+  EXPECT_FALSE(result.has_instances());
+  ASSERT_EQ(result_mesh->totvert, 4);
+  ASSERT_EQ(result_mesh->totedge, 4);
+  ASSERT_EQ(result_mesh->totloop, 4);
+  ASSERT_EQ(result_mesh->totpoly, 1);
+  EXPECT_EQ(result_mesh->mpoly[0].totloop, 4);
+  const float *result_weights = (const float *)CustomData_get_layer_named(
+      &result_mesh->vdata, CD_PROP_FLOAT, "weight");
+  ASSERT_NE(result_weights, nullptr);
+  for (const int i : IndexRange(4)) {
+    EXPECT_EQ(result_mesh->mvert[i].co[0], float(i));
+    EXPECT_EQ(result_mesh->medge[i].v2, (i + 1) % 4);
+    EXPECT_EQ(result_mesh->mloop[i].v, i);
+    EXPECT_EQ(result_weights[i], i * 0.5f);
+  }
+}
+
+TEST_F(GeometrySetCacheTest, PointCloudAndInstances)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(1000);
+  for (const int i : IndexRange(1000)) {
+    pointcloud->co[i][2] = i;
+    pointcloud->radius[i] = 0.1f;
+  }
+  GeometrySet geometry_set = GeometrySet::create_with_pointcloud(pointcloud);
+
+  Object object = {};
+  STRNCPY(object.id.name, "OBCube");
+  InstancesComponent &instances = geometry_set.get_component_for_write<InstancesComponent>();
+  const int none_handle = instances.add_reference(InstanceReference());
+  const int object_handle = instances.add_reference(object);
+  for (const int i : IndexRange(10)) {
+    float4x4 transform = float4x4::identity();
+    transform.values[3][0] = i;
+    instances.add_instance((i % 2) ? object_handle : none_handle, transform, i);
+  }
+  ASSERT_TRUE(geometry_set_cache_write(geometry_set, filepath.c_str()));
+
+  GeometrySet result;
+  ASSERT_TRUE(geometry_set_cache_read(
+      filepath.c_str(),
+      [&](const short id_type, StringRefNull name) -> ID * {
+        return (id_type == ID_OB && name == "Cube") ? &object.id : nullptr;
+      },
+      result));
+
+  const PointCloud *result_pointcloud = result.get_pointcloud_for_read();
+  ASSERT_NE(result_pointcloud, nullptr);
+  ASSERT_EQ(result_pointcloud->totpoint, 1000);
+  for (const int i : IndexRange(1000)) {
+    EXPECT_EQ(result_pointcloud->co[i][2], float(i));
+    EXPECT_EQ(result_pointcloud->radius[i], 0.1f);
+  }
+
+  const InstancesComponent *result_instances = result.get_component_for_read<InstancesComponent>();
+  ASSERT_NE(result_instances, nullptr);
+  ASSERT_EQ(result_instances->instances_amount(), 10);
+  for (const int i : IndexRange(10)) {
+    const int handle = result_instances->instance_reference_handles()[i];
+    const InstanceReference &reference = result_instances->references()[handle];
+    if (i % 2) {
+      ASSERT_EQ(reference.type(), InstanceReference::Type::Object);
+      EXPECT_EQ(&reference.object(), &object);
+    }
+    else {
+      EXPECT_EQ(reference.type(), InstanceReference::Type::None);
+    }
+    EXPECT_EQ(result_instances->instance_transforms()[i].values[3][0], float(i));
+    EXPECT_EQ(result_instances->instance_ids()[i], i);
+  }
+}
+
+TEST_F(GeometrySetCacheTest, InvalidFile)
+{
+  GeometrySet result;
+  EXPECT_FALSE(geometry_set_cache_read(filepath.c_str(), resolve_no_id, result));
+
+  FILE *file = BLI_fopen(filepath.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fputs("not a geometry cache", file);
+  fclose(file);
+  EXPECT_FALSE(geometry_set_cache_read(filepath.c_str(), resolve_no_id, result));
+}
+
+}  // namespace blender::bke::tests
@@ -22,6 +22,8 @@
 #include "BKE_pointcloud.h"
 #include "BKE_spline.hh"
 
+#include "BLI_task.hh"
+
 #include "DNA_collection_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -351,28 +353,121 @@ void geometry_set_gather_instances_attribute_info(Span<GeometryInstanceGroup> se
   }
 }
 
+/**
+ * Grain size for copying instances with the given number of elements each, so that every task
+ * copies enough data to be worth scheduling.
+ */
+static int64_t instances_grain_size(const int64_t elements_num)
+{
+  return std::max<int64_t>(1, 4096 / std::max<int64_t>(1, elements_num));
+}
+
+/** Indices of the first elements of an instance in the realized mesh. */
+struct MeshElementOffsets {
+  int vert = 0;
+  int edge = 0;
+  int loop = 0;
+  int poly = 0;
+};
+
+static void copy_transformed_mesh(const Mesh &mesh,
+                                  const float4x4 &transform,
+                                  Span<int> material_index_map,
+                                  const MeshElementOffsets &offsets,
+                                  Mesh &r_mesh)
+{
+  threading::parallel_for(IndexRange(mesh.totvert), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const MVert &old_vert = mesh.mvert[i];
+      MVert &new_vert = r_mesh.mvert[offsets.vert + i];
+
+      new_vert = old_vert;
+
+      const float3 new_position = transform * float3(old_vert.co);
+      copy_v3_v3(new_vert.co, new_position);
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totedge), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const MEdge &old_edge = mesh.medge[i];
+      MEdge &new_edge = r_mesh.medge[offsets.edge + i];
+      new_edge = old_edge;
+      new_edge.v1 += offsets.vert;
+      new_edge.v2 += offsets.vert;
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totloop), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const MLoop &old_loop = mesh.mloop[i];
+      MLoop &new_loop = r_mesh.mloop[offsets.loop + i];
+      new_loop = old_loop;
+      new_loop.v += offsets.vert;
+      new_loop.e += offsets.edge;
+    }
+  });
+  threading::parallel_for(IndexRange(mesh.totpoly), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const MPoly &old_poly = mesh.mpoly[i];
+      MPoly &new_poly = r_mesh.mpoly[offsets.poly + i];
+      new_poly = old_poly;
+      new_poly.loopstart += offsets.loop;
+      if (old_poly.mat_nr >= 0 && old_poly.mat_nr < mesh.totcol) {
+        new_poly.mat_nr = material_index_map[new_poly.mat_nr];
+      }
+      else {
+        /* The material index was invalid before. */
+        new_poly.mat_nr = 0;
+      }
+    }
+  });
+}
+
+static void copy_transformed_points(const PointCloud &pointcloud,
+                                    const float4x4 &transform,
+                                    const int vert_offset,
+                                    Mesh &r_mesh)
+{
+  const float3 point_normal{0.0f, 0.0f, 1.0f};
+  short point_normal_short[3];
+  normal_float_to_short_v3(point_normal_short, point_normal);
+
+  threading::parallel_for(IndexRange(pointcloud.totpoint), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      MVert &new_vert = r_mesh.mvert[vert_offset + i];
+      const float3 old_position = pointcloud.co[i];
+      const float3 new_position = transform * old_position;
+      copy_v3_v3(new_vert.co, new_position);
+      memcpy(&new_vert.no, point_normal_short, sizeof(point_normal_short));
+    }
+  });
+}
+
 static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGroup> set_groups,
                                                        const bool convert_points_to_vertices)
 {
-  int totverts = 0;
-  int totloops = 0;
-  int totedges = 0;
-  int totpolys = 0;
   int64_t cd_dirty_vert = 0;
   int64_t cd_dirty_poly = 0;
   int64_t cd_dirty_edge = 0;
   int64_t cd_dirty_loop = 0;
   VectorSet<Material *> materials;
 
-  for (const GeometryInstanceGroup &set_group : set_groups) {
+  /* Offsets of the first instance of every group. The elements of a group's mesh instances are
+   * followed by the vertices of its point cloud instances. The offsets of the other instances
+   * follow from the sizes of the instanced geometry, so all instances can be copied in parallel
+   * directly into the new mesh. */
+  Array<MeshElementOffsets> group_offsets(set_groups.size());
+  MeshElementOffsets totals;
+  for (const int group_index : set_groups.index_range()) {
+    const GeometryInstanceGroup &set_group = set_groups[group_index];
     const GeometrySet &set = set_group.geometry_set;
     const int tot_transforms = set_group.transforms.size();
+    group_offsets[group_index] = totals;
     if (set.has_mesh()) {
       const Mesh &mesh = *set.get_mesh_for_read();
-      totverts += mesh.totvert * tot_transforms;
-      totloops += mesh.totloop * tot_transforms;
-      totedges += mesh.totedge * tot_transforms;
-      totpolys += mesh.totpoly * tot_transforms;
+      totals.vert += mesh.totvert * tot_transforms;
+      totals.loop += mesh.totloop * tot_transforms;
+      totals.edge += mesh.totedge * tot_transforms;
+      totals.poly += mesh.totpoly * tot_transforms;
       cd_dirty_vert |= mesh.runtime.cd_dirty_vert;
       cd_dirty_poly |= mesh.runtime.cd_dirty_poly;
       cd_dirty_edge |= mesh.runtime.cd_dirty_edge;
@@ -384,16 +479,16 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
     }
     if (convert_points_to_vertices && set.has_pointcloud()) {
       const PointCloud &pointcloud = *set.get_pointcloud_for_read();
-      totverts += pointcloud.totpoint * tot_transforms;
+      totals.vert += pointcloud.totpoint * tot_transforms;
     }
   }
 
   /* Don't create an empty mesh. */
-  if ((totverts + totloops + totedges + totpolys) == 0) {
+  if ((totals.vert + totals.loop + totals.edge + totals.poly) == 0) {
     return nullptr;
   }
 
-  Mesh *new_mesh = BKE_mesh_new_nomain(totverts, totedges, 0, totloops, totpolys);
+  Mesh *new_mesh = BKE_mesh_new_nomain(totals.vert, totals.edge, 0, totals.loop, totals.poly);
   /* Copy settings from the first input geometry set with a mesh. */
   for (const GeometryInstanceGroup &set_group : set_groups) {
     const GeometrySet &set = set_group.geometry_set;
@@ -412,87 +507,137 @@ static Mesh *join_mesh_topology_and_builtin_attributes(Span<GeometryInstanceGrou
   new_mesh->runtime.cd_dirty_edge = cd_dirty_edge;
   new_mesh->runtime.cd_dirty_loop = cd_dirty_loop;
 
-  int vert_offset = 0;
-  int loop_offset = 0;
-  int edge_offset = 0;
-  int poly_offset = 0;
-  for (const GeometryInstanceGroup &set_group : set_groups) {
-    const GeometrySet &set = set_group.geometry_set;
-    if (set.has_mesh()) {
-      const Mesh &mesh = *set.get_mesh_for_read();
-
-      Array<int> material_index_map(mesh.totcol);
-      for (const int i : IndexRange(mesh.totcol)) {
-        Material *material = mesh.mat[i];
-        const int new_material_index = materials.index_of(material);
-        material_index_map[i] = new_material_index;
-      }
-
-      for (const float4x4 &transform : set_group.transforms) {
-        for (const int i : IndexRange(mesh.totvert)) {
-          const MVert &old_vert = mesh.mvert[i];
-          MVert &new_vert = new_mesh->mvert[vert_offset + i];
+  threading::parallel_for(set_groups.index_range(), 1, [&](IndexRange group_range) {
+    for (const int group_index : group_range) {
+      const GeometryInstanceGroup &set_group = set_groups[group_index];
+      const GeometrySet &set = set_group.geometry_set;
+      const MeshElementOffsets &group_offset = group_offsets[group_index];
+      int points_vert_offset = group_offset.vert;
 
-          new_vert = old_vert;
+      if (set.has_mesh()) {
+        const Mesh &mesh = *set.get_mesh_for_read();
 
-          const float3 new_position = transform * float3(old_vert.co);
-          copy_v3_v3(new_vert.co, new_position);
-        }
-        for (const int i : IndexRange(mesh.totedge)) {
-          const MEdge &old_edge = mesh.medge[i];
-          MEdge &new_edge = new_mesh->medge[edge_offset + i];
-          new_edge = old_edge;
-          new_edge.v1 += vert_offset;
-          new_edge.v2 += vert_offset;
-        }
-        for (const int i : IndexRange(mesh.totloop)) {
-          const MLoop &old_loop = mesh.mloop[i];
-          MLoop &new_loop = new_mesh->mloop[loop_offset + i];
-          new_loop = old_loop;
-          new_loop.v += vert_offset;
-          new_loop.e += edge_offset;
-        }
-        for (const int i : IndexRange(mesh.totpoly)) {
-          const MPoly &old_poly = mesh.mpoly[i];
-          MPoly &new_poly = new_mesh->mpoly[poly_offset + i];
-          new_poly = old_poly;
-          new_poly.loopstart += loop_offset;
-          if (old_poly.mat_nr >= 0 && old_poly.mat_nr < mesh.totcol) {
-            new_poly.mat_nr = material_index_map[new_poly.mat_nr];
-          }
-          else {
-            /* The material index was invalid before. */
-            new_poly.mat_nr = 0;
-          }
+        Array<int> material_index_map(mesh.totcol);
+        for (const int i : IndexRange(mesh.totcol)) {
+          Material *material = mesh.mat[i];
+          const int new_material_index = materials.index_of(material);
+          material_index_map[i] = new_material_index;
         }
 
-        vert_offset += mesh.totvert;
-        loop_offset += mesh.totloop;
-        edge_offset += mesh.totedge;
-        poly_offset += mesh.totpoly;
+        threading::parallel_for(set_group.transforms.index_range(),
+                                instances_grain_size(mesh.totvert + mesh.totloop),
+                                [&](IndexRange transform_range) {
+                                  for (const int i : transform_range) {
+                                    MeshElementOffsets offsets;
+                                    offsets.vert = group_offset.vert + mesh.totvert * i;
+                                    offsets.edge = group_offset.edge + mesh.totedge * i;
+                                    offsets.loop = group_offset.loop + mesh.totloop * i;
+                                    offsets.poly = group_offset.poly + mesh.totpoly * i;
+                                    copy_transformed_mesh(mesh,
+                                                          set_group.transforms[i],
+                                                          material_index_map,
+                                                          offsets,
+                                                          *new_mesh);
+                                  }
+                                });
+        points_vert_offset += mesh.totvert * set_group.transforms.size();
+      }
+
+      if (convert_points_to_vertices && set.has_pointcloud()) {
+        const PointCloud &pointcloud = *set.get_pointcloud_for_read();
+        threading::parallel_for(set_group.transforms.index_range(),
+                                instances_grain_size(pointcloud.totpoint),
+                                [&](IndexRange transform_range) {
+                                  for (const int i : transform_range) {
+                                    copy_transformed_points(
+                                        pointcloud,
+                                        set_group.transforms[i],
+                                        points_vert_offset + pointcloud.totpoint * i,
+                                        *new_mesh);
+                                  }
+                                });
       }
     }
+  });
 
-    const float3 point_normal{0.0f, 0.0f, 1.0f};
-    short point_normal_short[3];
-    normal_float_to_short_v3(point_normal_short, point_normal);
+  return new_mesh;
+}
 
-    if (convert_points_to_vertices && set.has_pointcloud()) {
-      const PointCloud &pointcloud = *set.get_pointcloud_for_read();
-      for (const float4x4 &transform : set_group.transforms) {
-        for (const int i : IndexRange(pointcloud.totpoint)) {
-          MVert &new_vert = new_mesh->mvert[vert_offset + i];
-          const float3 old_position = pointcloud.co[i];
-          const float3 new_position = transform * old_position;
-          copy_v3_v3(new_vert.co, new_position);
-          memcpy(&new_vert.no, point_normal_short, sizeof(point_normal_short));
-        }
-        vert_offset += pointcloud.totpoint;
+/**
+ * Copy the source values to every instance in the destination, which is as large as the source
+ * times the number of instances. The copy is split into chunks of elements instead of instances,
+ * so that a few large instances are copied in parallel as well.
+ */
+static void copy_attribute_to_instances(const fn::GSpan src,
+                                        fn::GMutableSpan dst,
+                                        const int64_t instances_num)
+{
+  const CPPType &type = src.type();
+  const int64_t src_size = src.size();
+  BLI_assert(dst.size() == src_size * instances_num);
+  UNUSED_VARS_NDEBUG(instances_num);
+
+  threading::parallel_for(IndexRange(dst.size()), 4096, [&](IndexRange range) {
+    int64_t dst_index = range.start();
+    while (dst_index < range.one_after_last()) {
+      const int64_t src_index = dst_index % src_size;
+      const int64_t size = std::min(src_size - src_index, range.one_after_last() - dst_index);
+      type.copy_to_initialized_n(src[src_index], dst[dst_index], size);
+      dst_index += size;
+    }
+  });
+}
+
+static void join_attribute(Span<GeometryInstanceGroup> set_groups,
+                           Span<GeometryComponentType> component_types,
+                           const StringRef name,
+                           const AttributeDomain domain,
+                           const CustomDataType data_type,
+                           fn::GMutableSpan dst_span)
+{
+  /* Offsets of the first instance of every group's component in the result. */
+  Array<int> offsets(set_groups.size() * component_types.size());
+  int offset = 0;
+  for (const int group_index : set_groups.index_range()) {
+    const GeometryInstanceGroup &set_group = set_groups[group_index];
+    for (const int type_index : component_types.index_range()) {
+      offsets[group_index * component_types.size() + type_index] = offset;
+      const GeometryComponent *component = set_group.geometry_set.get_component_for_read(
+          component_types[type_index]);
+      if (component != nullptr) {
+        offset += component->attribute_domain_size(domain) * set_group.transforms.size();
       }
     }
   }
 
-  return new_mesh;
+  threading::parallel_for(set_groups.index_range(), 1, [&](IndexRange group_range) {
+    for (const int group_index : group_range) {
+      const GeometryInstanceGroup &set_group = set_groups[group_index];
+      for (const int type_index : component_types.index_range()) {
+        const GeometryComponent *component = set_group.geometry_set.get_component_for_read(
+            component_types[type_index]);
+        if (component == nullptr) {
+          continue;
+        }
+        const int domain_size = component->attribute_domain_size(domain);
+        if (domain_size == 0) {
+          continue;
+        }
+        GVArrayPtr source_attribute = component->attribute_try_get_for_read(
+            name, domain, data_type);
+        if (!source_attribute) {
+          continue;
+        }
+        fn::GVArray_GSpan src_span{*source_attribute};
+        const int instances_num = set_group.transforms.size();
+        copy_attribute_to_instances(
+            src_span,
+            dst_span.slice(offsets[group_index * component_types.size() + type_index],
+                           domain_size * instances_num),
+            instances_num);
+      }
+    }
+  });
 }
 
 static void join_attributes(Span<GeometryInstanceGroup> set_groups,
@@ -500,6 +645,20 @@ static void join_attributes(Span<GeometryInstanceGroup> set_groups,
                             const Map<std::string, AttributeKind> &attribute_info,
                             GeometryComponent &result)
 {
+  /* Adding attributes to the result is not thread-safe, so all attributes are created before
+   * their values are copied in parallel. */
+  for (Map<std::string, AttributeKind>::Item entry : attribute_info.items()) {
+    result.attribute_try_create(
+        entry.key, entry.value.domain, entry.value.data_type, AttributeInitDefault());
+  }
+
+  struct JoinedAttribute {
+    StringRef name;
+    AttributeKind kind;
+    WriteAttributeLookup attribute;
+    std::unique_ptr<fn::GVMutableArray_GSpan> dst_span;
+  };
+  Vector<JoinedAttribute> joined_attributes;
   for (Map<std::string, AttributeKind>::Item entry : attribute_info.items()) {
     StringRef name = entry.key;
     const AttributeDomain domain_output = entry.value.domain;
@@ -507,71 +666,75 @@ static void join_attributes(Span<GeometryInstanceGroup> set_groups,
     const CPPType *cpp_type = bke::custom_data_type_to_cpp_type(data_type_output);
     BLI_assert(cpp_type != nullptr);
 
-    result.attribute_try_create(
-        entry.key, domain_output, data_type_output, AttributeInitDefault());
     WriteAttributeLookup write_attribute = result.attribute_try_get_for_write(name);
     if (!write_attribute || &write_attribute.varray->type() != cpp_type ||
         write_attribute.domain != domain_output) {
       continue;
     }
-
-    fn::GVMutableArray_GSpan dst_span{*write_attribute.varray};
-
-    int offset = 0;
-    for (const GeometryInstanceGroup &set_group : set_groups) {
-      const GeometrySet &set = set_group.geometry_set;
-      for (const GeometryComponentType component_type : component_types) {
-        if (set.has(component_type)) {
-          const GeometryComponent &component = *set.get_component_for_read(component_type);
-          const int domain_size = component.attribute_domain_size(domain_output);
-          if (domain_size == 0) {
-            continue; /* Domain size is 0, so no need to increment the offset. */
-          }
-          GVArrayPtr source_attribute = component.attribute_try_get_for_read(
-              name, domain_output, data_type_output);
-
-          if (source_attribute) {
-            fn::GVArray_GSpan src_span{*source_attribute};
-            const void *src_buffer = src_span.data();
-            for (const int UNUSED(i) : set_group.transforms.index_range()) {
-              void *dst_buffer = dst_span[offset];
-              cpp_type->copy_to_initialized_n(src_buffer, dst_buffer, domain_size);
-              offset += domain_size;
-            }
-          }
-          else {
-            offset += domain_size * set_group.transforms.size();
-          }
-        }
-      }
+    auto dst_span = std::make_unique<fn::GVMutableArray_GSpan>(*write_attribute.varray);
+    joined_attributes.append(
+        {name, entry.value, std::move(write_attribute), std::move(dst_span)});
+  }
+
+  threading::parallel_for(joined_attributes.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      const JoinedAttribute &joined_attribute = joined_attributes[i];
+      join_attribute(set_groups,
+                     component_types,
+                     joined_attribute.name,
+                     joined_attribute.kind.domain,
+                     joined_attribute.kind.data_type,
+                     *joined_attribute.dst_span);
     }
+  });
 
-    dst_span.save();
+  for (JoinedAttribute &joined_attribute : joined_attributes) {
+    joined_attribute.dst_span->save();
   }
 }
 
 static CurveEval *join_curve_splines(Span<GeometryInstanceGroup> set_groups)
 {
-  Vector<SplinePtr> new_splines;
-  for (const GeometryInstanceGroup &set_group : set_groups) {
+  /* Offsets of the splines of every group, the splines of all groups are copied in parallel. */
+  Array<int> group_offsets(set_groups.size());
+  int totsplines = 0;
+  for (const int group_index : set_groups.index_range()) {
+    const GeometryInstanceGroup &set_group = set_groups[group_index];
     const GeometrySet &set = set_group.geometry_set;
-    if (!set.has_curve()) {
-      continue;
-    }
-
-    const CurveEval &source_curve = *set.get_curve_for_read();
-    for (const SplinePtr &source_spline : source_curve.splines()) {
-      for (const float4x4 &transform : set_group.transforms) {
-        SplinePtr new_spline = source_spline->copy();
-        new_spline->transform(transform);
-        new_splines.append(std::move(new_spline));
-      }
+    group_offsets[group_index] = totsplines;
+    if (set.has_curve()) {
+      const CurveEval &source_curve = *set.get_curve_for_read();
+      totsplines += source_curve.splines().size() * set_group.transforms.size();
     }
   }
-  if (new_splines.is_empty()) {
+  if (totsplines == 0) {
     return nullptr;
   }
 
+  Array<SplinePtr> new_splines(totsplines);
+  threading::parallel_for(set_groups.index_range(), 1, [&](IndexRange group_range) {
+    for (const int group_index : group_range) {
+      const GeometryInstanceGroup &set_group = set_groups[group_index];
+      const GeometrySet &set = set_group.geometry_set;
+      if (!set.has_curve()) {
+        continue;
+      }
+
+      const CurveEval &source_curve = *set.get_curve_for_read();
+      Span<SplinePtr> source_splines = source_curve.splines();
+      const int tot_transforms = set_group.transforms.size();
+      threading::parallel_for(
+          IndexRange(source_splines.size() * tot_transforms), 64, [&](IndexRange range) {
+            for (const int i : range) {
+              const Spline &source_spline = *source_splines[i / tot_transforms];
+              SplinePtr new_spline = source_spline.copy();
+              new_spline->transform(set_group.transforms[i % tot_transforms]);
+              new_splines[group_offsets[group_index] + i] = std::move(new_spline);
+            }
+          });
+    }
+  });
+
   CurveEval *new_curve = new CurveEval();
   for (SplinePtr &new_spline : new_splines) {
     new_curve->add_spline(std::move(new_spline));
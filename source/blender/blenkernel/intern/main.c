@@ -38,6 +38,7 @@
 #include "BKE_lib_id.h"
 #include "BKE_lib_query.h"
 #include "BKE_main.h"
+#include "BKE_scene.h"
 
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
@@ -61,6 +62,9 @@ void BKE_main_free(Main *mainvar)
   const int free_flag = (LIB_ID_FREE_NO_MAIN | LIB_ID_FREE_NO_UI_USER |
                          LIB_ID_FREE_NO_USER_REFCOUNT | LIB_ID_FREE_NO_DEG_TAG);
 
+  /* Data-blocks can still be read by a frame that is evaluated in the background. */
+  BKE_scene_wait_playback_depsgraphs(mainvar);
+
   MEM_SAFE_FREE(mainvar->blen_thumb);
 
   a = set_listbasepointers(mainvar, lbarray);
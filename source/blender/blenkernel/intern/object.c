@@ -318,6 +318,8 @@ static void object_free_data(ID *id)
     ob->runtime.curve_cache = NULL;
   }
 
+  BKE_armature_skinning_cache_free(ob);
+
   BKE_previewimg_free(&ob->preview);
 }
 
@@ -2363,7 +2365,7 @@ ParticleSystem *BKE_object_copy_particlesystem(ParticleSystem *psys, const int f
   psysn->pdd = NULL;
   psysn->effectors = NULL;
   psysn->tree = NULL;
-  psysn->bvhtree = NULL;
+  psysn->sph_grid = NULL;
   psysn->batch_cache = NULL;
 
   BLI_listbase_clear(&psysn->pathcachebufs);
@@ -5113,6 +5115,7 @@ void BKE_object_runtime_reset_on_copy(Object *object, const int UNUSED(flag))
   runtime->object_as_temp_mesh = NULL;
   runtime->object_as_temp_curve = NULL;
   runtime->geometry_set_eval = NULL;
+  runtime->armature_skinning_cache = NULL;
 }
 
 /**
@@ -5123,8 +5126,8 @@ void BKE_object_runtime_reset_on_copy(Object *object, const int UNUSED(flag))
  */
 void BKE_object_runtime_free_data(Object *object)
 {
-  /* Currently this is all that's needed. */
   BKE_object_free_derived_caches(object);
+  BKE_armature_skinning_cache_free(object);
 
   BKE_object_runtime_reset(object);
 }
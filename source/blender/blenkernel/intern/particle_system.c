@@ -92,7 +92,7 @@
 #  include "manta_fluid_API.h"
 #endif  // WITH_FLUID
 
-static ThreadRWMutex psys_bvhtree_rwlock = BLI_RWLOCK_INITIALIZER;
+static ThreadRWMutex psys_sph_grid_rwlock = BLI_RWLOCK_INITIALIZER;
 
 /************************************************/
 /*          Reacting to system events           */
@@ -1323,47 +1323,6 @@ void psys_get_pointcache_start_end(Scene *scene, ParticleSystem *psys, int *sfra
 /************************************************/
 /*          Effectors                           */
 /************************************************/
-static void psys_update_particle_bvhtree(ParticleSystem *psys, float cfra)
-{
-  if (psys) {
-    PARTICLE_P;
-    int totpart = 0;
-    bool need_rebuild;
-
-    BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
-    need_rebuild = !psys->bvhtree || psys->bvhtree_frame != cfra;
-    BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
-
-    if (need_rebuild) {
-      LOOP_SHOWN_PARTICLES
-      {
-        totpart++;
-      }
-
-      BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_WRITE);
-
-      BLI_bvhtree_free(psys->bvhtree);
-      psys->bvhtree = BLI_bvhtree_new(totpart, 0.0, 4, 6);
-
-      LOOP_SHOWN_PARTICLES
-      {
-        if (pa->alive == PARS_ALIVE) {
-          if (pa->state.time == cfra) {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->prev_state.co, 1);
-          }
-          else {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->state.co, 1);
-          }
-        }
-      }
-      BLI_bvhtree_balance(psys->bvhtree);
-
-      psys->bvhtree_frame = cfra;
-
-      BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
-    }
-  }
-}
 void psys_update_particle_tree(ParticleSystem *psys, float cfra)
 {
   if (psys) {
@@ -1672,6 +1631,274 @@ static EdgeHash *sph_springhash_build(ParticleSystem *psys)
   return springhash;
 }
 
+/* Uniform grid of the alive particles of a system, used to find SPH neighbors. Particles are
+ * sorted by cell, so the cells of a grid row are contiguous in memory. */
+typedef struct SPHGrid {
+  float min[3];
+  float inv_cell_size;
+  int res[3];
+  /* Start of each cell in #indices and #co, with an extra element for the end of the last. */
+  int *cell_offsets;
+  /* Particle indices and positions, sorted by cell. */
+  int *indices;
+  float (*co)[3];
+  int totpoint;
+} SPHGrid;
+
+/* Cells are made larger than the interaction radius when there would be more than this many
+ * per particle, to bound the memory used by sparse systems. */
+#define SPH_GRID_MAX_CELLS_PER_POINT 8
+/* Iterations of the cell size search, each one at least grows the cells by 1%. */
+#define SPH_GRID_MAX_ITERATIONS 256
+
+typedef struct SPHGridBuildData {
+  SPHGrid *grid;
+  const int *index;
+  const float (*co)[3];
+  int *cell;
+  int *order;
+} SPHGridBuildData;
+
+/* Clamp a position in cell units to the grid, non-finite positions go to the border cells. */
+BLI_INLINE int sph_grid_coord_clamp(const SPHGrid *grid, const float f, const int axis)
+{
+  if (!(f > 0.0f)) {
+    return 0;
+  }
+  const int res_max = grid->res[axis] - 1;
+  return (f < (float)res_max) ? (int)f : res_max;
+}
+
+BLI_INLINE int sph_grid_cell_coord(const SPHGrid *grid, const float co, const int axis)
+{
+  return sph_grid_coord_clamp(grid, (co - grid->min[axis]) * grid->inv_cell_size, axis);
+}
+
+static void sph_grid_cell_task_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  const SPHGrid *grid = data->grid;
+  const float *co = data->co[i];
+
+  data->cell[i] = (sph_grid_cell_coord(grid, co[2], 2) * grid->res[1] +
+                   sph_grid_cell_coord(grid, co[1], 1)) *
+                      grid->res[0] +
+                  sph_grid_cell_coord(grid, co[0], 0);
+}
+
+static void sph_grid_gather_task_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  const int j = data->order[i];
+
+  data->grid->indices[i] = data->index[j];
+  copy_v3_v3(data->grid->co[i], data->co[j]);
+}
+
+/**
+ * Build a grid of \a totpoint particles with the given indices and positions. The cell size is
+ * only a performance parameter, queries with any radius find all neighbors.
+ */
+SPHGrid *psys_sph_grid_build(const int *index,
+                             const float (*co)[3],
+                             const int totpoint,
+                             const float cell_size)
+{
+  SPHGrid *grid = MEM_callocN(sizeof(SPHGrid), __func__);
+  float min[3], max[3], extent[3];
+  int i;
+
+  /* Diverged simulations can have non-finite positions, they are left out of the bounds and
+   * end up in the border cells. */
+  int totfinite = 0;
+  INIT_MINMAX(min, max);
+  for (i = 0; i < totpoint; i++) {
+    if (is_finite_v3(co[i])) {
+      minmax_v3v3_v3(min, max, co[i]);
+      totfinite++;
+    }
+  }
+  if (totfinite == 0) {
+    zero_v3(min);
+    zero_v3(max);
+  }
+  sub_v3_v3v3(extent, max, min);
+
+  /* Grow the cells until the grid is small enough. The extent of finite positions can still
+   * overflow, so fall back to a single cell when that doesn't converge. */
+  const double max_cells = (double)max_ii(totpoint, 1) * SPH_GRID_MAX_CELLS_PER_POINT;
+  double inv_cell_size = 1.0 / (double)max_ff(cell_size, FLT_EPSILON);
+  double res[3];
+  bool converged = false;
+  for (int iter = 0; iter < SPH_GRID_MAX_ITERATIONS; iter++) {
+    for (i = 0; i < 3; i++) {
+      res[i] = floor((double)extent[i] * inv_cell_size) + 1.0;
+    }
+    const double totcell = res[0] * res[1] * res[2];
+    if (totcell <= max_cells) {
+      converged = true;
+      break;
+    }
+    inv_cell_size /= max_dd(cbrt(totcell / max_cells), 1.01);
+  }
+  if (!converged) {
+    inv_cell_size = 0.0;
+    res[0] = res[1] = res[2] = 1.0;
+  }
+
+  copy_v3_v3(grid->min, min);
+  grid->inv_cell_size = (float)inv_cell_size;
+  for (i = 0; i < 3; i++) {
+    grid->res[i] = (int)res[i];
+  }
+  grid->totpoint = totpoint;
+
+  const int totcell = grid->res[0] * grid->res[1] * grid->res[2];
+  grid->cell_offsets = MEM_calloc_arrayN(totcell + 1, sizeof(int), __func__);
+  grid->indices = MEM_malloc_arrayN(max_ii(totpoint, 1), sizeof(int), __func__);
+  grid->co = MEM_malloc_arrayN(max_ii(totpoint, 1), sizeof(float[3]), __func__);
+
+  int *cell = MEM_malloc_arrayN(max_ii(totpoint, 1), sizeof(int), __func__);
+  int *order = MEM_malloc_arrayN(max_ii(totpoint, 1), sizeof(int), __func__);
+
+  SPHGridBuildData data = {
+      .grid = grid,
+      .index = index,
+      .co = co,
+      .cell = cell,
+      .order = order,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (totpoint > 1000);
+  settings.min_iter_per_thread = 1000;
+  BLI_task_parallel_range(0, totpoint, &data, sph_grid_cell_task_cb, &settings);
+
+  /* Counting sort by cell. Points keep their order within cells, so the order of neighbors,
+   * which matters when a particle has more than #SPH_NEIGHBORS, doesn't depend on threading. */
+  int *cell_offsets = grid->cell_offsets;
+  for (i = 0; i < totpoint; i++) {
+    cell_offsets[cell[i]]++;
+  }
+  for (i = 1; i < totcell; i++) {
+    cell_offsets[i] += cell_offsets[i - 1];
+  }
+  cell_offsets[totcell] = totpoint;
+  for (i = totpoint - 1; i >= 0; i--) {
+    order[--cell_offsets[cell[i]]] = i;
+  }
+
+  BLI_task_parallel_range(0, totpoint, &data, sph_grid_gather_task_cb, &settings);
+
+  MEM_freeN(cell);
+  MEM_freeN(order);
+
+  return grid;
+}
+
+void psys_sph_grid_free(SPHGrid *grid)
+{
+  if (grid) {
+    MEM_freeN(grid->cell_offsets);
+    MEM_freeN(grid->indices);
+    MEM_freeN(grid->co);
+    MEM_freeN(grid);
+  }
+}
+
+/**
+ * Call \a callback for all particles of the grid closer than \a radius to \a co. Like
+ * #BLI_bvhtree_range_query, the callback gets the particle index, the query center \a co and the
+ * squared distance.
+ */
+void psys_sph_grid_range_query(const SPHGrid *grid,
+                               const float co[3],
+                               const float radius,
+                               BVHTree_RangeQuery callback,
+                               void *userdata)
+{
+  const float radius_sq = radius * radius;
+  int lo[3], hi[3];
+
+  for (int axis = 0; axis < 3; axis++) {
+    /* Points outside the grid bounds are in the border cells. */
+    lo[axis] = sph_grid_coord_clamp(
+        grid, (co[axis] - radius - grid->min[axis]) * grid->inv_cell_size, axis);
+    hi[axis] = sph_grid_coord_clamp(
+        grid, (co[axis] + radius - grid->min[axis]) * grid->inv_cell_size, axis);
+  }
+
+  for (int z = lo[2]; z <= hi[2]; z++) {
+    for (int y = lo[1]; y <= hi[1]; y++) {
+      /* The cells of a row are contiguous, visit them as one range. */
+      const int row = (z * grid->res[1] + y) * grid->res[0];
+      const int start = grid->cell_offsets[row + lo[0]];
+      const int end = grid->cell_offsets[row + hi[0] + 1];
+
+      for (int j = start; j < end; j++) {
+        const float dist_sq = len_squared_v3v3(co, grid->co[j]);
+        if (dist_sq < radius_sq) {
+          callback(userdata, grid->indices[j], co, dist_sq);
+        }
+      }
+    }
+  }
+}
+
+/* Rebuild the SPH grid of a system, when it's not already up to date for this frame. */
+static void psys_update_particle_sph_grid(ParticleSystem *psys, float cfra, float cell_size)
+{
+  if (psys) {
+    PARTICLE_P;
+    int totpart = 0;
+    bool need_rebuild;
+
+    BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
+    need_rebuild = !psys->sph_grid || psys->sph_grid_frame != cfra;
+    BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
+
+    if (need_rebuild) {
+      LOOP_SHOWN_PARTICLES
+      {
+        if (pa->alive == PARS_ALIVE) {
+          totpart++;
+        }
+      }
+
+      int *index = MEM_malloc_arrayN(max_ii(totpart, 1), sizeof(int), __func__);
+      float(*co)[3] = MEM_malloc_arrayN(max_ii(totpart, 1), sizeof(float[3]), __func__);
+
+      totpart = 0;
+      LOOP_SHOWN_PARTICLES
+      {
+        if (pa->alive == PARS_ALIVE) {
+          index[totpart] = p;
+          copy_v3_v3(co[totpart], (pa->state.time == cfra) ? pa->prev_state.co : pa->state.co);
+          totpart++;
+        }
+      }
+
+      SPHGrid *grid = psys_sph_grid_build(index, (const float(*)[3])co, totpart, cell_size);
+
+      MEM_freeN(index);
+      MEM_freeN(co);
+
+      BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_WRITE);
+
+      psys_sph_grid_free(psys->sph_grid);
+      psys->sph_grid = grid;
+      psys->sph_grid_frame = cfra;
+
+      BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
+    }
+  }
+}
+
 #define SPH_NEIGHBORS 512
 typedef struct SPHNeighbor {
   ParticleSystem *psys;
@@ -1693,8 +1920,7 @@ typedef struct SPHRangeData {
   int use_size;
 } SPHRangeData;
 
-static void sph_evaluate_func(BVHTree *tree,
-                              ParticleSystem **psys,
+static void sph_evaluate_func(ParticleSystem **psys,
                               const float co[3],
                               SPHRangeData *pfr,
                               float interaction_radius,
@@ -1709,16 +1935,13 @@ static void sph_evaluate_func(BVHTree *tree,
     pfr->massfac = psys[i]->part->mass / pfr->mass;
     pfr->use_size = psys[i]->part->flag & PART_SIZEMASS;
 
-    if (tree) {
-      BLI_bvhtree_range_query(tree, co, interaction_radius, callback, pfr);
-      break;
-    }
-
-    BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
+    BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
 
-    BLI_bvhtree_range_query(psys[i]->bvhtree, co, interaction_radius, callback, pfr);
+    if (psys[i]->sph_grid) {
+      psys_sph_grid_range_query(psys[i]->sph_grid, co, interaction_radius, callback, pfr);
+    }
 
-    BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
+    BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
   }
 }
 static void sph_density_accum_cb(void *userdata, int index, const float co[3], float squared_dist)
@@ -1838,7 +2061,7 @@ static void sph_force_cb(void *sphdata_v, ParticleKey *state, float *force, floa
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(NULL, psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
+  sph_evaluate_func(psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
 
   density = data[0];
   near_density = data[1];
@@ -2030,8 +2253,7 @@ static void sphclassical_force_cb(void *sphdata_v,
   pfr.h = h;
   pfr.pa = pa;
 
-  sph_evaluate_func(
-      NULL, psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
+  sph_evaluate_func(psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
   pressure = stiffness * (pow7f(pa->sphdensity / rest_density) - 1.0f);
 
   /* multiply by mass so that we return a force, not accel */
@@ -2114,8 +2336,7 @@ static void sphclassical_calc_dens(ParticleData *pa, float UNUSED(dfra), SPHData
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(
-      NULL, psys, pa->state.co, &pfr, interaction_radius, sphclassical_density_accum_cb);
+  sph_evaluate_func(psys, pa->state.co, &pfr, interaction_radius, sphclassical_density_accum_cb);
   pa->sphdensity = min_ff(max_ff(data[0], fluid->rest_density * 0.9f), fluid->rest_density * 1.1f);
 }
 
@@ -2179,7 +2400,7 @@ void psys_sph_finalize(SPHData *sphdata)
 }
 
 /* Sample the density field at a point in space. */
-void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2])
+void psys_sph_density(SPHData *sphdata, float co[3], float vars[2])
 {
   ParticleSystem **psys = sphdata->psys;
   SPHFluidSettings *fluid = psys[0]->part->fluid;
@@ -2194,7 +2415,7 @@ void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2
   pfr.h = interaction_radius * sphdata->hfac;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(tree, psys, co, &pfr, interaction_radius, sphdata->density_cb);
+  sph_evaluate_func(psys, co, &pfr, interaction_radius, sphdata->density_cb);
 
   vars[0] = pfr.data[0];
   vars[1] = pfr.data[1];
@@ -3883,12 +4104,17 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
     }
     case PART_PHYS_FLUID: {
       ParticleTarget *pt = psys->targets.first;
-      psys_update_particle_bvhtree(psys, cfra);
+      SPHFluidSettings *fluid = part->fluid;
+      /* Neighbors are searched in cells of about the interaction radius. */
+      const float cell_size = fluid->radius *
+                              (fluid->flag & SPH_FAC_RADIUS ? 4.0f * part->size : 1.0f);
+      psys_update_particle_sph_grid(psys, cfra, cell_size);
 
       for (; pt;
-           pt = pt->next) { /* Updating others systems particle tree for fluid-fluid interaction */
+           pt = pt->next) { /* Updating others systems particle grid for fluid-fluid interaction */
         if (pt->ob) {
-          psys_update_particle_bvhtree(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1), cfra);
+          psys_update_particle_sph_grid(
+              BLI_findlink(&pt->ob->particlesystem, pt->psys - 1), cfra, cell_size);
         }
       }
       break;
@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+#include <vector>
+
+#include "BKE_particle.h"
+
+#include "BLI_float3.hh"
+#include "BLI_kdopbvh.h"
+#include "BLI_rand.hh"
+
+namespace blender::bke::tests {
+
+struct RangeQueryHit {
+  int index;
+  float3 co;
+  float dist_sq;
+
+  friend bool operator<(const RangeQueryHit &a, const RangeQueryHit &b)
+  {
+    return a.index < b.index;
+  }
+};
+
+static void range_query_collect_cb(void *userdata, int index, const float co[3], float dist_sq)
+{
+  std::vector<RangeQueryHit> *hits = static_cast<std::vector<RangeQueryHit> *>(userdata);
+  hits->push_back({index, co, dist_sq});
+}
+
+/* The grid query must find the same particles as a BVH range query, and pass the same arguments
+ * to the callback. */
+static void test_sph_grid_against_bvh(const int totpoint, const float cell_size, const int seed)
+{
+  RandomNumberGenerator rng(seed);
+  std::vector<int> indices(totpoint);
+  std::vector<float3> positions(totpoint);
+  BVHTree *tree = BLI_bvhtree_new(totpoint, 0.0f, 4, 6);
+  for (const int i : IndexRange(totpoint)) {
+    /* Particle indices don't need to be contiguous, only alive particles are in the grid. */
+    indices[i] = i * 3 + 1;
+    positions[i] = float3(rng.get_float(), rng.get_float(), rng.get_float() * 0.2f) * 2.0f;
+    BLI_bvhtree_insert(tree, indices[i], positions[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  SPHGrid *grid = psys_sph_grid_build(
+      indices.data(), (const float(*)[3])positions.data(), totpoint, cell_size);
+
+  for (int query = 0; query < 50; query++) {
+    /* Also query outside of the bounds of the particles. */
+    const float3 co = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 3.0f -
+                      float3(0.5f);
+    const float radius = rng.get_float() * 0.5f;
+
+    std::vector<RangeQueryHit> grid_hits;
+    std::vector<RangeQueryHit> bvh_hits;
+    psys_sph_grid_range_query(grid, co, radius, range_query_collect_cb, &grid_hits);
+    BLI_bvhtree_range_query(tree, co, radius, range_query_collect_cb, &bvh_hits);
+    std::sort(grid_hits.begin(), grid_hits.end());
+    std::sort(bvh_hits.begin(), bvh_hits.end());
+
+    ASSERT_EQ(grid_hits.size(), bvh_hits.size());
+    for (const int i : IndexRange(grid_hits.size())) {
+      EXPECT_EQ(grid_hits[i].index, bvh_hits[i].index);
+      EXPECT_EQ(grid_hits[i].co, co);
+      EXPECT_EQ(grid_hits[i].co, bvh_hits[i].co);
+      EXPECT_FLOAT_EQ(grid_hits[i].dist_sq, bvh_hits[i].dist_sq);
+    }
+  }
+
+  psys_sph_grid_free(grid);
+  BLI_bvhtree_free(tree);
+}
+
+TEST(particle_sph_grid, RangeQueryMatchesBVH)
+{
+  test_sph_grid_against_bvh(1000, 0.1f, 0);
+}
+
+TEST(particle_sph_grid, RangeQueryLargeCells)
+{
+  test_sph_grid_against_bvh(200, 5.0f, 1);
+}
+
+TEST(particle_sph_grid, RangeQuerySparse)
+{
+  /* The cells grow when there would be too many for the number of particles. */
+  test_sph_grid_against_bvh(20, 0.001f, 2);
+}
+
+TEST(particle_sph_grid, Empty)
+{
+  SPHGrid *grid = psys_sph_grid_build(nullptr, nullptr, 0, 0.1f);
+  std::vector<RangeQueryHit> hits;
+  psys_sph_grid_range_query(grid, float3(0.0f), 1.0f, range_query_collect_cb, &hits);
+  EXPECT_TRUE(hits.empty());
+  psys_sph_grid_free(grid);
+}
+
+TEST(particle_sph_grid, NonFinite)
+{
+  /* Diverged simulations must not stall the build, finite particles are still found. */
+  const float inf = std::numeric_limits<float>::infinity();
+  const float co[4][3] = {{0.0f, 0.0f, 0.0f},
+                          {inf, 0.0f, 0.0f},
+                          {0.0f, -inf, std::numeric_limits<float>::quiet_NaN()},
+                          {0.05f, 0.0f, 0.0f}};
+  const int index[4] = {0, 1, 2, 3};
+  SPHGrid *grid = psys_sph_grid_build(index, co, 4, 0.1f);
+  std::vector<RangeQueryHit> hits;
+  psys_sph_grid_range_query(grid, float3(0.0f), 0.1f, range_query_collect_cb, &hits);
+  std::sort(hits.begin(), hits.end());
+  ASSERT_EQ(hits.size(), 2);
+  EXPECT_EQ(hits[0].index, 0);
+  EXPECT_EQ(hits[1].index, 3);
+  psys_sph_grid_free(grid);
+
+  /* Finite positions whose extent overflows fall back to a single cell. */
+  const float co_huge[2][3] = {{-FLT_MAX, -FLT_MAX, -FLT_MAX}, {FLT_MAX, FLT_MAX, FLT_MAX}};
+  grid = psys_sph_grid_build(index, co_huge, 2, 0.1f);
+  hits.clear();
+  psys_sph_grid_range_query(grid, co_huge[1], 1.0f, range_query_collect_cb, &hits);
+  ASSERT_EQ(hits.size(), 1);
+  EXPECT_EQ(hits[0].index, 1);
+  psys_sph_grid_free(grid);
+}
+
+}  // namespace blender::bke::tests
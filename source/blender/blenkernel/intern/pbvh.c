@@ -170,28 +170,6 @@ static bool grid_materials_match(const DMFlagMat *f1, const DMFlagMat *f2)
   return ((f1->flag & ME_SMOOTH) == (f2->flag & ME_SMOOTH) && (f1->mat_nr == f2->mat_nr));
 }
 
-/* Adapted from BLI_kdopbvh.c */
-/* Returns the index of the first element on the right of the partition */
-static int partition_indices(int *prim_indices, int lo, int hi, int axis, float mid, BBC *prim_bbc)
-{
-  int i = lo, j = hi;
-  for (;;) {
-    for (; prim_bbc[prim_indices[i]].bcentroid[axis] < mid; i++) {
-      /* pass */
-    }
-    for (; mid < prim_bbc[prim_indices[j]].bcentroid[axis]; j--) {
-      /* pass */
-    }
-
-    if (!(i < j)) {
-      return i;
-    }
-
-    SWAP(int, prim_indices[i], prim_indices[j]);
-    i++;
-  }
-}
-
 /* Returns the index of the first element on the right of the partition */
 static int partition_indices_material(PBVH *pbvh, int lo, int hi)
 {
@@ -251,16 +229,19 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
 
 /* Add a vertex to the map, with a positive value for unique vertices and
  * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
+static int map_insert_vert(PBVH *pbvh,
+                           GHash *map,
+                           unsigned int *face_verts,
+                           unsigned int *uniq_verts,
+                           int node_index,
+                           int vertex)
 {
   void *key, **value_p;
 
   key = POINTER_FROM_INT(vertex);
   if (!BLI_ghash_ensure_p(map, key, &value_p)) {
     int value_i;
-    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
+    if (pbvh->vert_owner_node[vertex] == node_index) {
       value_i = *uniq_verts;
       (*uniq_verts)++;
     }
@@ -276,8 +257,9 @@ static int map_insert_vert(
 }
 
 /* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
+static void build_mesh_leaf_node(PBVH *pbvh, int node_index)
 {
+  PBVHNode *node = &pbvh->nodes[node_index];
   bool has_visible = false;
 
   node->uniq_verts = node->face_verts = 0;
@@ -297,8 +279,12 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->mloop[lt->tri[j]].v);
+      face_vert_indices[i][j] = map_insert_vert(pbvh,
+                                                map,
+                                                &node->face_verts,
+                                                &node->uniq_verts,
+                                                node_index,
+                                                pbvh->mloop[lt->tri[j]].v);
     }
 
     if (has_visible == false) {
@@ -423,7 +409,7 @@ static void build_leaf(PBVH *pbvh, int node_index, BBC *prim_bbc, int offset, in
   update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
 
   if (pbvh->looptri) {
-    build_mesh_leaf_node(pbvh, pbvh->nodes + node_index);
+    build_mesh_leaf_node(pbvh, node_index);
   }
   else {
     build_grid_leaf_node(pbvh, pbvh->nodes + node_index);
@@ -464,70 +450,354 @@ static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
   return false;
 }
 
-/* Recursively build a node in the tree
- *
- * vb is the voxel box around all of the primitives contained in
- * this node.
- *
- * cb is the bounding box around all the centroids of the primitives
- * contained in this node
+/* -------------------------------------------------------------------- */
+/** \name Tree Build
  *
- * offset and start indicate a range in the array of primitive indices
- */
+ * The tree is built one level at a time, nodes of the same level are split in parallel.
+ * Splits use a binned surface area heuristic, falling back to splitting at the median when all
+ * primitive centroids are at the same position.
+ * \{ */
+
+/** Number of bins evaluated as split candidates by the surface area heuristic. */
+#define BUILD_SAH_BINS 16
+/** Nodes with more primitives compute their bounds and bins with multiple threads. */
+#define BUILD_THREADED_PRIMS 100000
+
+typedef struct PBVHBuildNode {
+  int node_index;
+  int offset;
+  int count;
+  /** Index of the first primitive of the second child, -1 for leaves. */
+  int split;
+} PBVHBuildNode;
+
+typedef struct PBVHBuildData {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+  /** Bounds of all primitive centroids, used for the root node. */
+  BB *root_cb;
+  PBVHBuildNode *build_nodes;
+} PBVHBuildData;
+
+typedef struct PBVHBuildBins {
+  BB bounds[BUILD_SAH_BINS];
+  int count[BUILD_SAH_BINS];
+} PBVHBuildBins;
+
+typedef struct PBVHBuildBinning {
+  const int *prim_indices;
+  const BBC *prim_bbc;
+  int axis;
+  float min;
+  float scale;
+} PBVHBuildBinning;
+
+static float BB_half_area(const BB *bb)
+{
+  float dim[3];
+  sub_v3_v3v3(dim, bb->bmax, bb->bmin);
+  return dim[0] * dim[1] + dim[1] * dim[2] + dim[2] * dim[0];
+}
+
+BLI_INLINE int build_bin_index(const PBVHBuildBinning *binning, const int prim)
+{
+  const int bin = (int)((binning->prim_bbc[prim].bcentroid[binning->axis] - binning->min) *
+                        binning->scale);
+  return clamp_i(bin, 0, BUILD_SAH_BINS - 1);
+}
+
+static void build_centroid_bounds_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBuildBinning *binning = userdata;
+  BB_expand(tls->userdata_chunk, binning->prim_bbc[binning->prim_indices[i]].bcentroid);
+}
 
-static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_centroid_bounds_reduce(const void *__restrict UNUSED(userdata),
+                                         void *__restrict chunk_join,
+                                         void *__restrict chunk)
 {
-  int end;
+  BB_expand_with_bb(chunk_join, chunk);
+}
+
+static void build_bins_cb(void *__restrict userdata,
+                          const int i,
+                          const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBuildBinning *binning = userdata;
+  PBVHBuildBins *bins = tls->userdata_chunk;
+  const int prim = binning->prim_indices[i];
+  const int bin = build_bin_index(binning, prim);
+  BB_expand_with_bb(&bins->bounds[bin], (BB *)&binning->prim_bbc[prim]);
+  bins->count[bin]++;
+}
+
+static void build_bins_reduce(const void *__restrict UNUSED(userdata),
+                              void *__restrict chunk_join,
+                              void *__restrict chunk)
+{
+  PBVHBuildBins *join = chunk_join;
+  PBVHBuildBins *bins = chunk;
+  for (int i = 0; i < BUILD_SAH_BINS; i++) {
+    BB_expand_with_bb(&join->bounds[i], &bins->bounds[i]);
+    join->count[i] += bins->count[i];
+  }
+}
+
+/* Returns the bin left of which primitives should go to the first child, zero when no split
+ * leaves primitives on both sides. */
+static int build_sah_split_bin(const PBVHBuildBins *bins)
+{
+  float right_cost[BUILD_SAH_BINS];
+  BB bb;
+  int count = 0;
+
+  /* Cost of putting all primitives right of each bin boundary in the second child. */
+  BB_reset(&bb);
+  for (int i = BUILD_SAH_BINS - 1; i > 0; i--) {
+    BB_expand_with_bb(&bb, (BB *)&bins->bounds[i]);
+    count += bins->count[i];
+    right_cost[i] = count ? BB_half_area(&bb) * count : FLT_MAX;
+  }
+
+  int best_bin = 0;
+  float best_cost = FLT_MAX;
+  BB_reset(&bb);
+  count = 0;
+  for (int i = 1; i < BUILD_SAH_BINS; i++) {
+    BB_expand_with_bb(&bb, (BB *)&bins->bounds[i - 1]);
+    count += bins->count[i - 1];
+    if (count == 0 || right_cost[i] == FLT_MAX) {
+      continue;
+    }
+    const float cost = BB_half_area(&bb) * count + right_cost[i];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_bin = i;
+    }
+  }
+  return best_bin;
+}
+
+/* Returns the index of the first element on the right of the partition */
+static int partition_indices_bins(
+    int *prim_indices, int lo, int hi, const PBVHBuildBinning *binning, int split_bin)
+{
+  int i = lo, j = hi;
+  while (i <= j) {
+    if (build_bin_index(binning, prim_indices[i]) < split_bin) {
+      i++;
+    }
+    else {
+      SWAP(int, prim_indices[i], prim_indices[j]);
+      j--;
+    }
+  }
+  return i;
+}
+
+/* Partition primitives of a node for its two children, returning the index of the first
+ * primitive of the second child. cb is the bounding box around all the centroids of the
+ * primitives contained in the node, NULL when it still has to be computed. */
+static int build_partition(PBVH *pbvh, BB *cb, BBC *prim_bbc, int offset, int count)
+{
+  PBVHBuildBinning binning = {
+      .prim_indices = pbvh->prim_indices,
+      .prim_bbc = prim_bbc,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count >= BUILD_THREADED_PRIMS;
+  settings.min_iter_per_thread = BUILD_THREADED_PRIMS / 4;
+
   BB cb_backing;
+  if (!cb) {
+    cb = &cb_backing;
+    BB_reset(cb);
+    settings.userdata_chunk = cb;
+    settings.userdata_chunk_size = sizeof(*cb);
+    settings.func_reduce = build_centroid_bounds_reduce;
+    BLI_task_parallel_range(
+        offset, offset + count, &binning, build_centroid_bounds_cb, &settings);
+  }
+
+  /* Find axis with widest range of primitive centroids */
+  const int axis = BB_widest_axis(cb);
+  const float extent = cb->bmax[axis] - cb->bmin[axis];
+  if (!(extent > 0.0f)) {
+    /* All centroids at the same position, any split is as good. */
+    return offset + count / 2;
+  }
+
+  binning.axis = axis;
+  binning.min = cb->bmin[axis];
+  binning.scale = BUILD_SAH_BINS / extent;
 
-  /* Decide whether this is a leaf or not */
-  const bool below_leaf_limit = count <= pbvh->leaf_limit;
-  if (below_leaf_limit) {
+  PBVHBuildBins bins;
+  for (int i = 0; i < BUILD_SAH_BINS; i++) {
+    BB_reset(&bins.bounds[i]);
+    bins.count[i] = 0;
+  }
+  settings.userdata_chunk = &bins;
+  settings.userdata_chunk_size = sizeof(bins);
+  settings.func_reduce = build_bins_reduce;
+  BLI_task_parallel_range(offset, offset + count, &binning, build_bins_cb, &settings);
+
+  const int split_bin = build_sah_split_bin(&bins);
+  if (split_bin == 0) {
+    return offset + count / 2;
+  }
+
+  return partition_indices_bins(
+      pbvh->prim_indices, offset, offset + count - 1, &binning, split_bin);
+}
+
+/* Decide whether a node is a leaf, otherwise partition its primitives.
+ * Returns the index of the first primitive of the second child, -1 for leaves. */
+static int build_split(PBVH *pbvh, BB *cb, BBC *prim_bbc, int offset, int count)
+{
+  if (count <= pbvh->leaf_limit) {
     if (!leaf_needs_material_split(pbvh, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
-      return;
+      return -1;
     }
+    /* Partition primitives by material */
+    return partition_indices_material(pbvh, offset, offset + count - 1);
   }
+  return build_partition(pbvh, cb, prim_bbc, offset, count);
+}
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->totnode;
-  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
+static void build_split_task_cb(void *__restrict userdata,
+                                const int n,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildData *data = userdata;
+  PBVHBuildNode *build_node = &data->build_nodes[n];
+  BB *cb = (build_node->node_index == 0) ? data->root_cb : NULL;
 
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
+  build_node->split = build_split(
+      data->pbvh, cb, data->prim_bbc, build_node->offset, build_node->count);
+}
 
-  if (!below_leaf_limit) {
-    /* Find axis with widest range of primitive centroids */
-    if (!cb) {
-      cb = &cb_backing;
-      BB_reset(cb);
-      for (int i = offset + count - 1; i >= offset; i--) {
-        BB_expand(cb, prim_bbc[pbvh->prim_indices[i]].bcentroid);
+/* Assign each vertex to the leaf with the lowest index using it, the vertex is unique to that
+ * leaf. Deterministic regardless of the order leaves are built in. */
+static void build_vert_owner_task_cb(void *__restrict userdata,
+                                     const int n,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  const PBVHBuildNode *leaf = &data->build_nodes[n];
+  const int *prim_indices = pbvh->prim_indices;
+
+  for (int i = leaf->offset; i < leaf->offset + leaf->count; i++) {
+    const MLoopTri *lt = &pbvh->looptri[prim_indices[i]];
+    for (int j = 0; j < 3; j++) {
+      int32_t *owner = (int32_t *)&pbvh->vert_owner_node[pbvh->mloop[lt->tri[j]].v];
+      int32_t old_owner = *owner;
+      while (leaf->node_index < old_owner) {
+        const int32_t prev = atomic_cas_int32(owner, old_owner, leaf->node_index);
+        if (prev == old_owner) {
+          break;
+        }
+        old_owner = prev;
       }
     }
-    const int axis = BB_widest_axis(cb);
+  }
+}
 
-    /* Partition primitives along that axis */
-    end = partition_indices(pbvh->prim_indices,
-                            offset,
-                            offset + count - 1,
-                            axis,
-                            (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
-                            prim_bbc);
+static void build_leaf_task_cb(void *__restrict userdata,
+                               const int n,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildData *data = userdata;
+  const PBVHBuildNode *leaf = &data->build_nodes[n];
+  build_leaf(data->pbvh, leaf->node_index, data->prim_bbc, leaf->offset, leaf->count);
+}
+
+static void build_tree(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
+{
+  PBVHBuildData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .root_cb = cb,
+  };
+  TaskParallelSettings settings;
+
+  /* Nodes of the level being split, followed by the nodes of the next level. */
+  PBVHBuildNode *level = MEM_mallocN(sizeof(*level), __func__);
+  int level_len = 1;
+  level[0] = (PBVHBuildNode){.node_index = 0, .offset = 0, .count = totprim, .split = -1};
+
+  PBVHBuildNode *leaves = NULL;
+  int leaves_len = 0;
+
+  while (level_len) {
+    data.build_nodes = level;
+    BKE_pbvh_parallel_range_settings(&settings, true, level_len);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, level_len, &data, build_split_task_cb, &settings);
+
+    int split_len = 0;
+    for (int i = 0; i < level_len; i++) {
+      split_len += (level[i].split != -1);
+    }
+
+    /* Add child nodes in order, so node indices don't depend on threading. */
+    PBVHBuildNode *next_level = split_len ?
+                                    MEM_mallocN(sizeof(*next_level) * split_len * 2, __func__) :
+                                    NULL;
+    leaves = MEM_reallocN(leaves, sizeof(*leaves) * (leaves_len + level_len - split_len));
+    int next_level_len = 0;
+    for (int i = 0; i < level_len; i++) {
+      const PBVHBuildNode *build_node = &level[i];
+      if (build_node->split == -1) {
+        leaves[leaves_len++] = *build_node;
+        continue;
+      }
+
+      const int children_offset = pbvh->totnode;
+      pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
+      pbvh->nodes[build_node->node_index].children_offset = children_offset;
+
+      next_level[next_level_len++] = (PBVHBuildNode){
+          .node_index = children_offset,
+          .offset = build_node->offset,
+          .count = build_node->split - build_node->offset,
+          .split = -1,
+      };
+      next_level[next_level_len++] = (PBVHBuildNode){
+          .node_index = children_offset + 1,
+          .offset = build_node->split,
+          .count = build_node->offset + build_node->count - build_node->split,
+          .split = -1,
+      };
+    }
+
+    MEM_freeN(level);
+    level = next_level;
+    level_len = next_level_len;
   }
-  else {
-    /* Partition primitives by material */
-    end = partition_indices_material(pbvh, offset, offset + count - 1);
+
+  data.build_nodes = leaves;
+  BKE_pbvh_parallel_range_settings(&settings, true, leaves_len);
+  settings.min_iter_per_thread = 1;
+  if (pbvh->looptri) {
+    BLI_task_parallel_range(0, leaves_len, &data, build_vert_owner_task_cb, &settings);
   }
+  BLI_task_parallel_range(0, leaves_len, &data, build_leaf_task_cb, &settings);
+  MEM_freeN(leaves);
 
-  /* Build children */
-  build_sub(pbvh, pbvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(pbvh,
-            pbvh->nodes[node_index].children_offset + 1,
-            NULL,
-            prim_bbc,
-            end,
-            offset + count - end);
+  /* Update parent node bounding boxes, children always come after their parent. */
+  for (int i = pbvh->totnode - 1; i >= 0; i--) {
+    PBVHNode *node = &pbvh->nodes[i];
+    if (node->flag & PBVH_Leaf) {
+      continue;
+    }
+    node->vb = pbvh->nodes[node->children_offset].vb;
+    BB_expand_with_bb(&node->vb, &pbvh->nodes[node->children_offset + 1].vb);
+    node->orig_vb = node->vb;
+  }
 }
 
 static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
@@ -552,7 +822,35 @@ static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
   }
 
   pbvh->totnode = 1;
-  build_sub(pbvh, 0, cb, prim_bbc, 0, totprim);
+  build_tree(pbvh, cb, prim_bbc, totprim);
+}
+
+/** \} */
+
+typedef struct PBVHPrimBoundsData {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+} PBVHPrimBoundsData;
+
+static void pbvh_looptri_bounds_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict tls)
+{
+  PBVHPrimBoundsData *data = userdata;
+  const PBVH *pbvh = data->pbvh;
+  const MLoopTri *lt = &pbvh->looptri[i];
+  const int sides = 3;
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < sides; j++) {
+    BB_expand((BB *)bbc, pbvh->verts[pbvh->mloop[lt->tri[j]].v].co);
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
 }
 
 /**
@@ -582,7 +880,10 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->mloop = mloop;
   pbvh->looptri = looptri;
   pbvh->verts = verts;
-  pbvh->vert_bitmap = BLI_BITMAP_NEW(totvert, "bvh->vert_bitmap");
+  pbvh->vert_owner_node = MEM_mallocN(sizeof(*pbvh->vert_owner_node) * totvert, __func__);
+  for (int i = 0; i < totvert; i++) {
+    pbvh->vert_owner_node[i] = INT32_MAX;
+  }
   pbvh->totvert = totvert;
   pbvh->leaf_limit = LEAF_LIMIT;
   pbvh->vdata = vdata;
@@ -597,28 +898,42 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   /* For each face, store the AABB and the AABB centroid */
   prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
+  PBVHPrimBoundsData data = {.pbvh = pbvh, .prim_bbc = prim_bbc};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  settings.userdata_chunk = &cb;
+  settings.userdata_chunk_size = sizeof(cb);
+  settings.func_reduce = build_centroid_bounds_reduce;
+  BLI_task_parallel_range(0, looptri_num, &data, pbvh_looptri_bounds_cb, &settings);
 
-    BB_reset((BB *)bbc);
+  if (looptri_num) {
+    pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
+  }
 
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[pbvh->mloop[lt->tri[j]].v].co);
-    }
+  MEM_freeN(prim_bbc);
+  MEM_SAFE_FREE(pbvh->vert_owner_node);
+}
 
-    BBC_update_centroid(bbc);
+static void pbvh_grid_bounds_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict tls)
+{
+  PBVHPrimBoundsData *data = userdata;
+  const PBVH *pbvh = data->pbvh;
+  const CCGKey *key = &pbvh->gridkey;
+  CCGElem *grid = pbvh->grids[i];
+  BBC *bbc = data->prim_bbc + i;
 
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  BB_reset((BB *)bbc);
 
-  if (looptri_num) {
-    pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
+  for (int j = 0; j < key->grid_area; j++) {
+    BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
   }
 
-  MEM_freeN(prim_bbc);
-  MEM_freeN(pbvh->vert_bitmap);
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
 }
 
 /* Do a full rebuild with on Grids data structure */
@@ -647,20 +962,14 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHPrimBoundsData data = {.pbvh = pbvh, .prim_bbc = prim_bbc};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  settings.userdata_chunk = &cb;
+  settings.userdata_chunk_size = sizeof(cb);
+  settings.func_reduce = build_centroid_bounds_reduce;
+  BLI_task_parallel_range(0, totgrid, &data, pbvh_grid_bounds_cb, &settings);
 
   if (totgrid) {
     pbvh_build(pbvh, &cb, prim_bbc, totgrid);
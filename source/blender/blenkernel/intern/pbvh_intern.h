@@ -150,9 +150,9 @@ struct PBVH {
   int totgrid;
   BLI_bitmap **grid_hidden;
 
-  /* Only used during BVH build and update,
-   * don't need to remain valid after */
-  BLI_bitmap *vert_bitmap;
+  /* Only used during BVH build, don't need to remain valid after.
+   * Lowest index of the leaf nodes using each vertex, the vertex is unique to that node. */
+  int *vert_owner_node;
 
 #ifdef PERFCNTRS
   int perf_modified;
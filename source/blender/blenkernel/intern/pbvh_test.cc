@@ -0,0 +1,231 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_pbvh.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_geom.h"
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+
+namespace blender::bke::tests {
+
+struct PBVHTestContext {
+  Mesh mesh;
+  Array<MVert> verts;
+  Array<MLoop> loops;
+  Array<MPoly> polys;
+  PBVH *pbvh;
+};
+
+/* Build a PBVH over a grid of quads with a wavy surface, so splits happen along all axes. */
+static void test_pbvh_build(PBVHTestContext *ctx, const int size)
+{
+  const int verts_num = (size + 1) * (size + 1);
+  const int polys_num = size * size;
+  const int looptris_num = polys_num * 2;
+
+  ctx->mesh = {{nullptr}};
+  ctx->verts.reinitialize(verts_num);
+  ctx->loops.reinitialize(polys_num * 4);
+  ctx->polys.reinitialize(polys_num);
+
+  for (int y = 0; y <= size; y++) {
+    for (int x = 0; x <= size; x++) {
+      MVert &vert = ctx->verts[y * (size + 1) + x];
+      vert = {{0.0f}};
+      vert.co[0] = (float)x / size;
+      vert.co[1] = (float)y / size;
+      vert.co[2] = 0.1f * sinf(vert.co[0] * 20.0f) * cosf(vert.co[1] * 20.0f);
+    }
+  }
+
+  /* The PBVH takes ownership of the loop triangles. */
+  MLoopTri *looptris = (MLoopTri *)MEM_malloc_arrayN(looptris_num, sizeof(MLoopTri), __func__);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const int poly_index = y * size + x;
+      const int loopstart = poly_index * 4;
+      const int v = y * (size + 1) + x;
+      MPoly &poly = ctx->polys[poly_index];
+      poly = {0};
+      poly.loopstart = loopstart;
+      poly.totloop = 4;
+      const int quad_verts[4] = {v, v + 1, v + size + 2, v + size + 1};
+      for (int i = 0; i < 4; i++) {
+        ctx->loops[loopstart + i] = {(unsigned int)quad_verts[i], 0};
+      }
+      looptris[poly_index * 2] = {
+          {(unsigned int)loopstart, (unsigned int)loopstart + 1, (unsigned int)loopstart + 2},
+          (unsigned int)poly_index};
+      looptris[poly_index * 2 + 1] = {
+          {(unsigned int)loopstart, (unsigned int)loopstart + 2, (unsigned int)loopstart + 3},
+          (unsigned int)poly_index};
+    }
+  }
+
+  ctx->pbvh = BKE_pbvh_new();
+  BKE_pbvh_build_mesh(ctx->pbvh,
+                      &ctx->mesh,
+                      ctx->polys.data(),
+                      ctx->loops.data(),
+                      ctx->verts.data(),
+                      verts_num,
+                      nullptr,
+                      nullptr,
+                      nullptr,
+                      looptris,
+                      looptris_num);
+}
+
+static void test_pbvh_free(PBVHTestContext *ctx)
+{
+  BKE_pbvh_free(ctx->pbvh);
+}
+
+struct PBVHTestRaycastData {
+  PBVH *pbvh;
+  IsectRayPrecalc isect_precalc;
+  const float *ray_start;
+  const float *ray_normal;
+  float depth;
+  bool hit;
+};
+
+static void test_pbvh_raycast_cb(PBVHNode *node, void *data_v, float *tmin)
+{
+  PBVHTestRaycastData *data = (PBVHTestRaycastData *)data_v;
+  int active_vertex_index, active_face_index;
+  if (BKE_pbvh_node_raycast(data->pbvh,
+                            node,
+                            nullptr,
+                            false,
+                            data->ray_start,
+                            data->ray_normal,
+                            &data->isect_precalc,
+                            &data->depth,
+                            &active_vertex_index,
+                            &active_face_index,
+                            nullptr)) {
+    data->hit = true;
+    *tmin = data->depth;
+  }
+}
+
+/* Cast rays straight down at the grid, returns the number of rays that hit it. */
+static int test_pbvh_raycast(PBVHTestContext *ctx, const int rays_num)
+{
+  RandomNumberGenerator rng;
+  const float ray_normal[3] = {0.0f, 0.0f, -1.0f};
+  int hits = 0;
+  for (int i = 0; i < rays_num; i++) {
+    const float ray_start[3] = {
+        0.01f + rng.get_float() * 0.98f, 0.01f + rng.get_float() * 0.98f, 1.0f};
+    PBVHTestRaycastData data;
+    data.pbvh = ctx->pbvh;
+    data.ray_start = ray_start;
+    data.ray_normal = ray_normal;
+    data.depth = FLT_MAX;
+    data.hit = false;
+    isect_ray_tri_watertight_v3_precalc(&data.isect_precalc, ray_normal);
+    BKE_pbvh_raycast(ctx->pbvh, test_pbvh_raycast_cb, &data, ray_start, ray_normal, false);
+    hits += data.hit;
+  }
+  return hits;
+}
+
+TEST(pbvh, build_mesh_unique_verts)
+{
+  const int size = 200;
+  PBVHTestContext ctx;
+  test_pbvh_build(&ctx, size);
+
+  PBVHNode **nodes;
+  int totnode;
+  BKE_pbvh_search_gather(ctx.pbvh, nullptr, nullptr, &nodes, &totnode);
+  EXPECT_GT(totnode, 1);
+
+  /* Every vertex is unique to exactly one leaf, and contained in the bounds of its leaves. */
+  Array<int> unique_count(ctx.verts.size(), 0);
+  for (int i = 0; i < totnode; i++) {
+    int uniq_verts, totvert;
+    const int *vert_indices;
+    MVert *verts;
+    float bb_min[3], bb_max[3];
+    BKE_pbvh_node_num_verts(ctx.pbvh, nodes[i], &uniq_verts, &totvert);
+    BKE_pbvh_node_get_verts(ctx.pbvh, nodes[i], &vert_indices, &verts);
+    BKE_pbvh_node_get_BB(nodes[i], bb_min, bb_max);
+    for (int j = 0; j < totvert; j++) {
+      const float *co = verts[vert_indices[j]].co;
+      EXPECT_TRUE(co[0] >= bb_min[0] && co[1] >= bb_min[1] && co[2] >= bb_min[2]);
+      EXPECT_TRUE(co[0] <= bb_max[0] && co[1] <= bb_max[1] && co[2] <= bb_max[2]);
+      if (j < uniq_verts) {
+        unique_count[vert_indices[j]]++;
+      }
+    }
+  }
+  for (const int count : unique_count) {
+    EXPECT_EQ(count, 1);
+  }
+
+  MEM_SAFE_FREE(nodes);
+  test_pbvh_free(&ctx);
+}
+
+TEST(pbvh, raycast_mesh)
+{
+  PBVHTestContext ctx;
+  test_pbvh_build(&ctx, 100);
+  EXPECT_EQ(test_pbvh_raycast(&ctx, 1000), 1000);
+  test_pbvh_free(&ctx);
+}
+
+static void test_pbvh_performance(const int size, const int rays_num)
+{
+  PBVHTestContext ctx;
+  {
+    SCOPED_TIMER("build " + std::to_string(size * size * 2) + " triangles");
+    test_pbvh_build(&ctx, size);
+  }
+  {
+    SCOPED_TIMER("raycast " + std::to_string(rays_num) + " rays");
+    test_pbvh_raycast(&ctx, rays_num);
+  }
+  test_pbvh_free(&ctx);
+}
+
+TEST(pbvh_performance, performance_100)
+{
+  test_pbvh_performance(100, 10000);
+}
+TEST(pbvh_performance, performance_1000)
+{
+  test_pbvh_performance(1000, 100000);
+}
+TEST(pbvh_performance, performance_2000)
+{
+  test_pbvh_performance(2000, 100000);
+}
+
+}  // namespace blender::bke::tests
@@ -0,0 +1,107 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <mutex>
+
+#include "BLI_array.hh"
+#include "BLI_task.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_mesh_runtime.h"
+#include "BKE_point_grid_cache.hh"
+#include "BKE_pointcloud.h"
+
+using blender::PointGrid;
+
+namespace blender::bke {
+
+/* Building a grid is cheap compared to the lookups that use it, so a single lock for all
+ * geometries is fine. */
+static std::mutex point_grid_mutex;
+
+template<typename GetPositionsFn>
+static const PointGrid &point_grid_ensure(void *&grid_ptr, const GetPositionsFn &get_positions)
+{
+  std::lock_guard lock{point_grid_mutex};
+  if (grid_ptr == nullptr) {
+    /* Isolate the parallel build, so that this thread does not work on other tasks that might
+     * wait for the lock while it is held. */
+    threading::isolate_task([&]() { grid_ptr = new PointGrid(get_positions()); });
+  }
+  return *static_cast<const PointGrid *>(grid_ptr);
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh
+ * \{ */
+
+const PointGrid &mesh_vert_point_grid_ensure(const Mesh &mesh)
+{
+  /* The grid only updates a cache and can be considered to be logically const. */
+  Mesh &mesh_for_cache = const_cast<Mesh &>(mesh);
+  return point_grid_ensure(mesh_for_cache.runtime.vert_point_grid, [&]() {
+    Array<float3> positions(mesh.totvert);
+    threading::parallel_for(IndexRange(mesh.totvert), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        positions[i] = mesh.mvert[i].co;
+      }
+    });
+    return positions;
+  });
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Point Cloud
+ * \{ */
+
+const PointGrid &pointcloud_point_grid_ensure(const PointCloud &pointcloud)
+{
+  PointCloud &pointcloud_for_cache = const_cast<PointCloud &>(pointcloud);
+  return point_grid_ensure(pointcloud_for_cache.point_grid, [&]() {
+    return Span<float3>((const float3 *)pointcloud.co, pointcloud.totpoint);
+  });
+}
+
+/** \} */
+
+}  // namespace blender::bke
+
+/* -------------------------------------------------------------------- */
+/** \name C-API
+ * \{ */
+
+void BKE_mesh_runtime_clear_vert_point_grid(Mesh *mesh)
+{
+  delete static_cast<PointGrid *>(mesh->runtime.vert_point_grid);
+  mesh->runtime.vert_point_grid = nullptr;
+}
+
+void BKE_pointcloud_point_grid_free(PointCloud *pointcloud)
+{
+  delete static_cast<PointGrid *>(pointcloud->point_grid);
+  pointcloud->point_grid = nullptr;
+}
+
+/** \} */
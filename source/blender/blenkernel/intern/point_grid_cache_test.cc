@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BLI_float4x4.hh"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_point_grid_cache.hh"
+#include "BKE_pointcloud.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_pointcloud_types.h"
+
+namespace blender::bke::tests {
+
+class PointGridCacheTest : public testing::Test {
+ protected:
+  void SetUp() override
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* Points along the X axis, one unit apart. */
+static Mesh *create_line_mesh(const int verts_num)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num, 0, 0, 0, 0);
+  for (const int i : IndexRange(verts_num)) {
+    copy_v3_v3(mesh->mvert[i].co, float3(i, 0.0f, 0.0f));
+  }
+  return mesh;
+}
+
+static PointCloud *create_line_pointcloud(const int points_num)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  for (const int i : IndexRange(points_num)) {
+    copy_v3_v3(pointcloud->co[i], float3(i, 0.0f, 0.0f));
+  }
+  return pointcloud;
+}
+
+/* The nearest position and distance must come from the transformed positions, not from the grid
+ * that was built before the transform. */
+static void expect_nearest(const PointGrid &grid,
+                           const float3 &position,
+                           const int expected_index,
+                           const float3 &expected_position)
+{
+  float distance_sq;
+  float3 nearest_position;
+  EXPECT_EQ(grid.find_nearest(position, &distance_sq, &nearest_position), expected_index);
+  EXPECT_EQ(nearest_position, expected_position);
+  EXPECT_FLOAT_EQ(distance_sq, float3::distance_squared(position, expected_position));
+}
+
+TEST_F(PointGridCacheTest, MeshTranslate)
+{
+  Mesh *mesh = create_line_mesh(10);
+  expect_nearest(mesh_vert_point_grid_ensure(*mesh), float3(3.2f, 0.0f, 0.0f), 3, float3(3, 0, 0));
+
+  BKE_mesh_translate(mesh, float3(0.0f, 0.0f, 2.0f), false);
+  expect_nearest(mesh_vert_point_grid_ensure(*mesh), float3(3.2f, 0.0f, 2.0f), 3, float3(3, 0, 2));
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(PointGridCacheTest, MeshTransform)
+{
+  Mesh *mesh = create_line_mesh(10);
+  expect_nearest(mesh_vert_point_grid_ensure(*mesh), float3(3.2f, 0.0f, 0.0f), 3, float3(3, 0, 0));
+
+  const float4x4 matrix = float4x4::from_loc_eul_scale(float3(0.0f), float3(0.0f), float3(2.0f));
+  BKE_mesh_transform(mesh, matrix.values, false);
+  expect_nearest(mesh_vert_point_grid_ensure(*mesh), float3(3.2f, 0.0f, 0.0f), 2, float3(4, 0, 0));
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(PointGridCacheTest, PointCloudTransform)
+{
+  PointCloud *pointcloud = create_line_pointcloud(10);
+  expect_nearest(
+      pointcloud_point_grid_ensure(*pointcloud), float3(3.2f, 0.0f, 0.0f), 3, float3(3, 0, 0));
+
+  BKE_pointcloud_translate(pointcloud, float3(0.0f, 0.0f, 2.0f));
+  expect_nearest(
+      pointcloud_point_grid_ensure(*pointcloud), float3(3.2f, 0.0f, 2.0f), 3, float3(3, 0, 2));
+
+  const float4x4 matrix = float4x4::from_loc_eul_scale(float3(0.0f), float3(0.0f), float3(2.0f));
+  BKE_pointcloud_transform(pointcloud, matrix.values);
+  expect_nearest(
+      pointcloud_point_grid_ensure(*pointcloud), float3(3.2f, 0.0f, 4.0f), 2, float3(4, 0, 4));
+
+  BKE_id_free(nullptr, pointcloud);
+}
+
+}  // namespace blender::bke::tests
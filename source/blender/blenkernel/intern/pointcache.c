@@ -46,6 +46,7 @@
 #include "BLI_blenlib.h"
 #include "BLI_endian_switch.h"
 #include "BLI_math.h"
+#include "BLI_mmap.h"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
@@ -1654,24 +1655,17 @@ static int ptcache_file_data_read(PTCacheFile *pf)
 
   return 1;
 }
-static int ptcache_file_data_write(PTCacheFile *pf)
-{
-  int i;
+/* Files with #PTCACHE_TYPEFLAG_COLUMNS start with another identifier, so that versions which
+ * don't know about the column layout reject them instead of reading garbage. */
+#define PTCACHE_FILE_ID "BPHYSICS"
+#define PTCACHE_FILE_ID_COLUMNS "BPHYSCOL"
 
-  for (i = 0; i < BPHYS_TOT_DATA; i++) {
-    if ((pf->data_types & (1 << i)) &&
-        !ptcache_file_write(pf, pf->cur[i], 1, ptcache_data_size[i])) {
-      return 0;
-    }
-  }
-
-  return 1;
-}
 static int ptcache_file_header_begin_read(PTCacheFile *pf)
 {
   unsigned int typeflag = 0;
   int error = 0;
   char bphysics[8];
+  bool is_columns = false;
 
   pf->data_types = 0;
 
@@ -1679,8 +1673,11 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
     error = 1;
   }
 
-  if (!error && !STREQLEN(bphysics, "BPHYSICS", 8)) {
-    error = 1;
+  if (!error) {
+    is_columns = STREQLEN(bphysics, PTCACHE_FILE_ID_COLUMNS, 8);
+    if (!is_columns && !STREQLEN(bphysics, PTCACHE_FILE_ID, 8)) {
+      error = 1;
+    }
   }
 
   if (!error && !fread(&typeflag, sizeof(unsigned int), 1, pf->fp)) {
@@ -1690,6 +1687,10 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
   pf->type = (typeflag & PTCACHE_TYPEFLAG_TYPEMASK);
   pf->flag = (typeflag & PTCACHE_TYPEFLAG_FLAGMASK);
 
+  if (!error && is_columns != ((pf->flag & PTCACHE_TYPEFLAG_COLUMNS) != 0)) {
+    error = 1;
+  }
+
   /* if there was an error set file as it was */
   if (error) {
     BLI_fseek(pf->fp, 0, SEEK_SET);
@@ -1699,7 +1700,8 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
 }
 static int ptcache_file_header_begin_write(PTCacheFile *pf)
 {
-  const char *bphysics = "BPHYSICS";
+  const char *bphysics = (pf->flag & PTCACHE_TYPEFLAG_COLUMNS) ? PTCACHE_FILE_ID_COLUMNS :
+                                                                 PTCACHE_FILE_ID;
   unsigned int typeflag = pf->type + pf->flag;
 
   if (fwrite(bphysics, sizeof(char), 8, pf->fp) != 8) {
@@ -1939,12 +1941,153 @@ static void ptcache_find_frames_around(PTCacheID *pid, unsigned int frame, int *
   }
 }
 
-static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
+/* Columns of frames written with #PTCACHE_TYPEFLAG_COLUMNS start at a multiple of this, so
+ * uncompressed columns can be used directly from a memory mapped file. */
+#define PTCACHE_COLUMN_ALIGN 64
+
+/* Stored after the header of frames written with #PTCACHE_TYPEFLAG_COLUMNS. Offsets are from
+ * the start of the file, lengths are in bytes as stored (after compression). */
+typedef struct PTCacheColumnTable {
+  uint64_t offset[BPHYS_TOT_DATA];
+  uint64_t length[BPHYS_TOT_DATA];
+  uint64_t extra_offset;
+} PTCacheColumnTable;
+
+static int ptcache_file_column_begin_write(PTCacheFile *pf, uint64_t *r_offset)
+{
+  const char zero[PTCACHE_COLUMN_ALIGN] = {0};
+  const int64_t pos = BLI_ftell(pf->fp);
+
+  if (pos < 0) {
+    return 0;
+  }
+
+  const int64_t padding = (PTCACHE_COLUMN_ALIGN - pos % PTCACHE_COLUMN_ALIGN) %
+                          PTCACHE_COLUMN_ALIGN;
+  if (padding && !ptcache_file_write(pf, zero, (unsigned int)padding, sizeof(char))) {
+    return 0;
+  }
+
+  *r_offset = (uint64_t)(pos + padding);
+  return 1;
+}
+
+/**
+ * Read the column table and the data columns of a frame written with
+ * #PTCACHE_TYPEFLAG_COLUMNS, leaving the file at the start of the extra data.
+ *
+ * When \a r_mmap_file is given and the columns are not compressed, the file is memory mapped
+ * and the columns of \a pm point into the mapping instead of being copied, so only the pages
+ * that are actually accessed get read from disk.
+ */
+static int ptcache_file_columns_read(PTCacheFile *pf,
+                                     PTCacheMem *pm,
+                                     BLI_mmap_file **r_mmap_file)
+{
+  PTCacheColumnTable table;
+  const bool compressed = (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) != 0;
+  int i;
+
+  if (!ptcache_file_read(pf, &table, 1, sizeof(PTCacheColumnTable))) {
+    return 0;
+  }
+
+  if (BLI_fseek(pf->fp, 0, SEEK_END) != 0) {
+    return 0;
+  }
+  const int64_t file_len = BLI_ftell(pf->fp);
+
+  /* Don't trust the table of truncated or damaged files. */
+  for (i = 0; i < BPHYS_TOT_DATA; i++) {
+    if (pm->data_types & (1 << i)) {
+      const uint64_t data_len = (uint64_t)pm->totpoint * ptcache_data_size[i];
+      if (table.offset[i] > (uint64_t)file_len ||
+          table.length[i] > (uint64_t)file_len - table.offset[i] ||
+          (!compressed && table.length[i] != data_len)) {
+        return 0;
+      }
+    }
+  }
+  if ((pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) && table.extra_offset > (uint64_t)file_len) {
+    return 0;
+  }
+
+  if (r_mmap_file && !compressed && pm->totpoint > 0) {
+    BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(pf->fp));
+
+    if (mmap_file) {
+      char *memory = BLI_mmap_get_pointer(mmap_file);
+      for (i = 0; i < BPHYS_TOT_DATA; i++) {
+        if (pm->data_types & (1 << i)) {
+          pm->data[i] = memory + table.offset[i];
+        }
+      }
+      *r_mmap_file = mmap_file;
+    }
+  }
+
+  if (r_mmap_file == NULL || *r_mmap_file == NULL) {
+    ptcache_data_alloc(pm);
+
+    for (i = 0; i < BPHYS_TOT_DATA; i++) {
+      if ((pm->data_types & (1 << i)) == 0) {
+        continue;
+      }
+
+      const unsigned int data_len = pm->totpoint * ptcache_data_size[i];
+      if (BLI_fseek(pf->fp, (int64_t)table.offset[i], SEEK_SET) != 0) {
+        return 0;
+      }
+      if (compressed) {
+        ptcache_file_compressed_read(pf, (unsigned char *)(pm->data[i]), data_len);
+      }
+      else if (!ptcache_file_read(pf, pm->data[i], data_len, sizeof(unsigned char))) {
+        return 0;
+      }
+    }
+  }
+
+  if (pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) {
+    if (BLI_fseek(pf->fp, (int64_t)table.extra_offset, SEEK_SET) != 0) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/**
+ * Free a frame read with #ptcache_disk_frame_read, \a mmap_file is the mapping it returned.
+ */
+static void ptcache_disk_frame_free(PTCacheMem *pm, BLI_mmap_file *mmap_file)
+{
+  if (mmap_file) {
+    /* The columns point into the mapping. */
+    memset(pm->data, 0, sizeof(pm->data));
+
+    BLI_mmap_free(mmap_file);
+  }
+
+  ptcache_mem_clear(pm);
+  MEM_freeN(pm);
+}
+
+/**
+ * Read a frame from the disk cache.
+ *
+ * \param r_mmap_file: When not NULL, uncompressed columns may be mapped from the file instead of
+ * copied. The frame is read-only then, and must be freed with #ptcache_disk_frame_free.
+ */
+static PTCacheMem *ptcache_disk_frame_read(PTCacheID *pid, int cfra, BLI_mmap_file **r_mmap_file)
 {
   PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
   PTCacheMem *pm = NULL;
   unsigned int i, error = 0;
 
+  if (r_mmap_file) {
+    *r_mmap_file = NULL;
+  }
+
   if (pf == NULL) {
     return NULL;
   }
@@ -1964,9 +2107,14 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
     pm->data_types = pf->data_types;
     pm->frame = pf->frame;
 
-    ptcache_data_alloc(pm);
+    if (pf->flag & PTCACHE_TYPEFLAG_COLUMNS) {
+      if (!ptcache_file_columns_read(pf, pm, r_mmap_file)) {
+        error = 1;
+      }
+    }
+    else if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+      ptcache_data_alloc(pm);
 
-    if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
       for (i = 0; i < BPHYS_TOT_DATA; i++) {
         unsigned int out_len = pm->totpoint * ptcache_data_size[i];
         if (pf->data_types & (1 << i)) {
@@ -1975,7 +2123,9 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
       }
     }
     else {
+      /* Files written before #PTCACHE_TYPEFLAG_COLUMNS store the data point by point. */
       void *cur[BPHYS_TOT_DATA];
+      ptcache_data_alloc(pm);
       BKE_ptcache_mem_pointers_init(pm, cur);
       ptcache_file_pointers_init(pf);
 
@@ -2017,9 +2167,11 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
   }
 
   if (error && pm) {
-    ptcache_mem_clear(pm);
-    MEM_freeN(pm);
+    ptcache_disk_frame_free(pm, r_mmap_file ? *r_mmap_file : NULL);
     pm = NULL;
+    if (r_mmap_file) {
+      *r_mmap_file = NULL;
+    }
   }
 
   ptcache_file_close(pf);
@@ -2030,9 +2182,15 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 
   return pm;
 }
+static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
+{
+  return ptcache_disk_frame_read(pid, cfra, NULL);
+}
 static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 {
   PTCacheFile *pf = NULL;
+  PTCacheColumnTable table = {{0}};
+  int64_t table_offset = -1;
   unsigned int i, error = 0;
 
   BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_FRAME, pm->frame);
@@ -2049,7 +2207,7 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
   pf->data_types = pm->data_types;
   pf->totpoint = pm->totpoint;
   pf->type = pid->type;
-  pf->flag = 0;
+  pf->flag = PTCACHE_TYPEFLAG_COLUMNS;
 
   if (pm->extradata.first) {
     pf->flag |= PTCACHE_TYPEFLAG_EXTRADATA;
@@ -2063,38 +2221,46 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
     error = 1;
   }
 
+  /* The table is written again once the column offsets are known. */
   if (!error) {
-    if (pid->cache->compression) {
-      for (i = 0; i < BPHYS_TOT_DATA; i++) {
-        if (pm->data[i]) {
-          unsigned int in_len = pm->totpoint * ptcache_data_size[i];
-          unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
-                                                            "pointcache_lzo_buffer");
-          ptcache_file_compressed_write(
-              pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
-          MEM_freeN(out);
-        }
-      }
+    table_offset = BLI_ftell(pf->fp);
+    if (table_offset < 0 || !ptcache_file_write(pf, &table, 1, sizeof(PTCacheColumnTable))) {
+      error = 1;
     }
-    else {
-      void *cur[BPHYS_TOT_DATA];
-      BKE_ptcache_mem_pointers_init(pm, cur);
-      ptcache_file_pointers_init(pf);
+  }
 
-      for (i = 0; i < pm->totpoint; i++) {
-        ptcache_data_copy(cur, pf->cur);
-        if (!ptcache_file_data_write(pf)) {
-          error = 1;
-          break;
-        }
-        BKE_ptcache_mem_pointers_incr(cur);
-      }
+  for (i = 0; i < BPHYS_TOT_DATA && !error; i++) {
+    if ((pm->data_types & (1 << i)) == 0 || pm->data[i] == NULL) {
+      continue;
+    }
+
+    unsigned int in_len = pm->totpoint * ptcache_data_size[i];
+
+    if (!ptcache_file_column_begin_write(pf, &table.offset[i])) {
+      error = 1;
+      break;
+    }
+
+    if (pid->cache->compression) {
+      unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
+                                                        "pointcache_lzo_buffer");
+      ptcache_file_compressed_write(
+          pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
+      MEM_freeN(out);
+    }
+    else if (!ptcache_file_write(pf, pm->data[i], in_len, sizeof(unsigned char))) {
+      error = 1;
+      break;
     }
+
+    table.length[i] = (uint64_t)BLI_ftell(pf->fp) - table.offset[i];
   }
 
   if (!error && pm->extradata.first) {
     PTCacheExtra *extra = pm->extradata.first;
 
+    table.extra_offset = (uint64_t)BLI_ftell(pf->fp);
+
     for (; extra; extra = extra->next) {
       if (extra->data == NULL || extra->totdata == 0) {
         continue;
@@ -2117,6 +2283,13 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
     }
   }
 
+  if (!error) {
+    if (BLI_fseek(pf->fp, table_offset, SEEK_SET) != 0 ||
+        !ptcache_file_write(pf, &table, 1, sizeof(PTCacheColumnTable))) {
+      error = 1;
+    }
+  }
+
   ptcache_file_close(pf);
 
   if (error && G.debug & G_DEBUG) {
@@ -2177,12 +2350,13 @@ static int ptcache_read_stream(PTCacheID *pid, int cfra)
 static int ptcache_read(PTCacheID *pid, int cfra)
 {
   PTCacheMem *pm = NULL;
+  BLI_mmap_file *mmap_file = NULL;
   int i;
   int *index = &i;
 
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-    pm = ptcache_disk_frame_to_mem(pid, cfra);
+    pm = ptcache_disk_frame_read(pid, cfra, &mmap_file);
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -2224,8 +2398,7 @@ static int ptcache_read(PTCacheID *pid, int cfra)
 
     /* clean up temporary memory cache */
     if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-      ptcache_mem_clear(pm);
-      MEM_freeN(pm);
+      ptcache_disk_frame_free(pm, mmap_file);
     }
   }
 
@@ -2234,12 +2407,13 @@ static int ptcache_read(PTCacheID *pid, int cfra)
 static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
 {
   PTCacheMem *pm = NULL;
+  BLI_mmap_file *mmap_file = NULL;
   int i;
   int *index = &i;
 
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-    pm = ptcache_disk_frame_to_mem(pid, cfra2);
+    pm = ptcache_disk_frame_read(pid, cfra2, &mmap_file);
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -2280,8 +2454,7 @@ static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
 
     /* clean up temporary memory cache */
     if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-      ptcache_mem_clear(pm);
-      MEM_freeN(pm);
+      ptcache_disk_frame_free(pm, mmap_file);
     }
   }
 
@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_float3.hh"
+#include "BLI_string.h"
+
+#include "BKE_pointcache.h"
+#include "BKE_softbody.h"
+
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcache_types.h"
+
+namespace blender::bke::tests {
+
+static const int points_num = 1000;
+
+/* Writes and reads the cache of a soft body, which stores locations and velocities. */
+class PointCacheTest : public testing::Test {
+ protected:
+  Object object = {};
+  SoftBody softbody = {};
+  SoftBody_Shared softbody_shared = {};
+  PointCache cache = {};
+  Array<BodyPoint> points = Array<BodyPoint>(points_num);
+  PTCacheID pid;
+
+  void SetUp() override
+  {
+    STRNCPY(object.id.name, "OBsoftbody");
+
+    cache.flag = PTCACHE_DISK_CACHE | PTCACHE_EXTERNAL;
+    cache.step = 1;
+    cache.startframe = 1;
+    cache.endframe = 250;
+    STRNCPY(cache.name, "pointcache_test");
+    STRNCPY(cache.path, testing::TempDir().c_str());
+
+    softbody_shared.pointcache = &cache;
+    softbody.shared = &softbody_shared;
+    softbody.totpoint = points_num;
+    softbody.bpoint = points.data();
+    this->set_points(0.0f);
+
+    BKE_ptcache_id_from_softbody(&pid, &object, &softbody);
+  }
+
+  void TearDown() override
+  {
+    BKE_ptcache_id_clear(&pid, PTCACHE_CLEAR_ALL, 0);
+  }
+
+  void set_points(const float offset)
+  {
+    for (const int i : points.index_range()) {
+      copy_v3_v3(points[i].pos, float3(float(i), offset, 1.0f));
+      copy_v3_v3(points[i].vec, float3(offset, float(-i), 2.0f));
+    }
+  }
+
+  void expect_points(const float offset)
+  {
+    for (const int i : points.index_range()) {
+      EXPECT_EQ(float3(points[i].pos), float3(float(i), offset, 1.0f));
+      EXPECT_EQ(float3(points[i].vec), float3(offset, float(-i), 2.0f));
+    }
+  }
+
+  std::string frame_filepath(const int frame)
+  {
+    char filename[64];
+    BLI_snprintf(filename, sizeof(filename), "pointcache_test_%06d_00" PTCACHE_EXT, frame);
+    return testing::TempDir() + filename;
+  }
+
+  /* Write frames 1 and 2, with different values. */
+  void write_frames()
+  {
+    this->set_points(1.0f);
+    ASSERT_TRUE(BKE_ptcache_write(&pid, 1));
+    this->set_points(2.0f);
+    ASSERT_TRUE(BKE_ptcache_write(&pid, 2));
+    this->set_points(0.0f);
+  }
+};
+
+TEST_F(PointCacheTest, RoundTrip)
+{
+  this->write_frames();
+  EXPECT_TRUE(BKE_ptcache_id_exist(&pid, 1));
+  EXPECT_TRUE(BKE_ptcache_id_exist(&pid, 2));
+
+  EXPECT_EQ(BKE_ptcache_read(&pid, 2.0f, false), PTCACHE_READ_EXACT);
+  this->expect_points(2.0f);
+  EXPECT_EQ(BKE_ptcache_read(&pid, 1.0f, false), PTCACHE_READ_EXACT);
+  this->expect_points(1.0f);
+  EXPECT_EQ(BKE_ptcache_read(&pid, 1.5f, false), PTCACHE_READ_INTERPOLATED);
+}
+
+TEST_F(PointCacheTest, RoundTripCompressed)
+{
+  cache.compression = PTCACHE_COMPRESS_LZO;
+  this->write_frames();
+
+  EXPECT_EQ(BKE_ptcache_read(&pid, 2.0f, false), PTCACHE_READ_EXACT);
+  this->expect_points(2.0f);
+  EXPECT_EQ(BKE_ptcache_read(&pid, 1.0f, false), PTCACHE_READ_EXACT);
+  this->expect_points(1.0f);
+}
+
+TEST_F(PointCacheTest, ColumnFilesRejectedByOldReaders)
+{
+  this->write_frames();
+
+  /* Versions without the column layout only accept files starting with "BPHYSICS". */
+  FILE *file = BLI_fopen(this->frame_filepath(1).c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  char id[8];
+  ASSERT_EQ(fread(id, 1, sizeof(id), file), sizeof(id));
+  fclose(file);
+  EXPECT_FALSE(STREQLEN(id, "BPHYSICS", sizeof(id)));
+}
+
+TEST_F(PointCacheTest, ReadPointLayout)
+{
+  /* A frame written by earlier versions, with all data of a point next to each other. */
+  FILE *file = BLI_fopen(this->frame_filepath(3).c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  const unsigned int typeflag = PTCACHE_TYPE_SOFTBODY;
+  const unsigned int totpoint = points_num;
+  const unsigned int data_types = (1 << BPHYS_DATA_LOCATION) | (1 << BPHYS_DATA_VELOCITY);
+  fwrite("BPHYSICS", 1, 8, file);
+  fwrite(&typeflag, sizeof(typeflag), 1, file);
+  fwrite(&totpoint, sizeof(totpoint), 1, file);
+  fwrite(&data_types, sizeof(data_types), 1, file);
+  for (const int i : IndexRange(points_num)) {
+    const float3 pos(float(i), 3.0f, 1.0f);
+    const float3 vec(3.0f, float(-i), 2.0f);
+    fwrite(&pos, sizeof(pos), 1, file);
+    fwrite(&vec, sizeof(vec), 1, file);
+  }
+  fclose(file);
+
+  EXPECT_EQ(BKE_ptcache_read(&pid, 3.0f, false), PTCACHE_READ_EXACT);
+  this->expect_points(3.0f);
+}
+
+TEST_F(PointCacheTest, ReadTruncatedFile)
+{
+  this->write_frames();
+
+  /* Keep the beginning of the file and cut off the data. */
+  const std::string filepath = this->frame_filepath(2);
+  FILE *file = BLI_fopen(filepath.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  char head[128];
+  ASSERT_EQ(fread(head, 1, sizeof(head), file), sizeof(head));
+  fclose(file);
+  file = BLI_fopen(filepath.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fwrite(head, 1, sizeof(head), file);
+  fclose(file);
+
+  /* The damaged frame is not read, the points keep their values. */
+  this->set_points(5.0f);
+  BKE_ptcache_read(&pid, 2.0f, false);
+  this->expect_points(5.0f);
+}
+
+}  // namespace blender::bke::tests
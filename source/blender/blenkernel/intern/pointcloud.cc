@@ -90,6 +90,7 @@ static void pointcloud_copy_data(Main *UNUSED(bmain), ID *id_dst, const ID *id_s
   BKE_pointcloud_update_customdata_pointers(pointcloud_dst);
 
   pointcloud_dst->batch_cache = nullptr;
+  pointcloud_dst->point_grid = nullptr;
 }
 
 static void pointcloud_free_data(ID *id)
@@ -97,6 +98,7 @@ static void pointcloud_free_data(ID *id)
   PointCloud *pointcloud = (PointCloud *)id;
   BKE_animdata_free(&pointcloud->id, false);
   BKE_pointcloud_batch_cache_free(pointcloud);
+  BKE_pointcloud_point_grid_free(pointcloud);
   CustomData_free(&pointcloud->pdata, pointcloud->totpoint);
   MEM_SAFE_FREE(pointcloud->mat);
 }
@@ -149,6 +151,9 @@ static void pointcloud_blend_read_data(BlendDataReader *reader, ID *id)
 
   /* Materials */
   BLO_read_pointer_array(reader, (void **)&pointcloud->mat);
+
+  /* Runtime */
+  pointcloud->point_grid = nullptr;
 }
 
 static void pointcloud_blend_read_lib(BlendLibReader *reader, ID *id)
@@ -274,6 +279,22 @@ void BKE_pointcloud_minmax(const struct PointCloud *pointcloud, float r_min[3],
   }
 }
 
+void BKE_pointcloud_transform(PointCloud *pointcloud, const float mat[4][4])
+{
+  for (int i = 0; i < pointcloud->totpoint; i++) {
+    mul_m4_v3(mat, pointcloud->co[i]);
+  }
+  BKE_pointcloud_point_grid_free(pointcloud);
+}
+
+void BKE_pointcloud_translate(PointCloud *pointcloud, const float offset[3])
+{
+  for (int i = 0; i < pointcloud->totpoint; i++) {
+    add_v3_v3(pointcloud->co[i], offset);
+  }
+  BKE_pointcloud_point_grid_free(pointcloud);
+}
+
 BoundBox *BKE_pointcloud_boundbox_get(Object *ob)
 {
   BLI_assert(ob->type == OB_POINTCLOUD);
@@ -2785,6 +2785,81 @@ void BKE_scene_graph_update_for_newframe(Depsgraph *depsgraph)
   BKE_scene_graph_update_for_newframe_ex(depsgraph, true);
 }
 
+void BKE_scene_graph_update_for_newframe_background(Depsgraph *depsgraph, float ctime)
+{
+  DEG_evaluate_on_framechange_background(depsgraph, ctime);
+}
+
+/* The depsgraph was not active while it was evaluated in the background, so nothing was written
+ * back to the original data-blocks. Do that for animated properties and object transforms, which
+ * are what handlers and the interface read from the original data during playback. */
+static void scene_graph_background_flush_to_original(Depsgraph *depsgraph)
+{
+  BLI_assert(DEG_is_active(depsgraph));
+  const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(
+      depsgraph, DEG_get_ctime(depsgraph));
+
+  /* Only the data-blocks that changed in this evaluation, their recalc flags are cleared once the
+   * frame change is finished. */
+  DEGIDIterData data = {NULL};
+  data.graph = depsgraph;
+  data.only_updated = true;
+  ITER_BEGIN (DEG_iterator_ids_begin,
+              DEG_iterator_ids_next,
+              DEG_iterator_ids_end,
+              &data,
+              ID *,
+              id) {
+    if (id->recalc & ID_RECALC_ANIMATION) {
+      ID *id_orig = DEG_get_original_id(id);
+      AnimData *adt = BKE_animdata_from_id(id_orig);
+      if (adt != NULL) {
+        BKE_animsys_evaluate_animdata(id_orig, adt, &anim_eval_context, ADT_RECALC_ANIM, false);
+      }
+    }
+    if (GS(id->name) == ID_OB) {
+      BKE_object_sync_to_original(depsgraph, (Object *)id);
+    }
+  }
+  ITER_END;
+}
+
+void BKE_scene_graph_update_for_newframe_background_finish(Depsgraph *depsgraph)
+{
+  Scene *scene = DEG_get_input_scene(depsgraph);
+  Main *bmain = DEG_get_bmain(depsgraph);
+
+  DEG_background_evaluation_wait(depsgraph);
+  BLI_assert(DEG_get_ctime(depsgraph) == BKE_scene_frame_get(scene));
+
+  scene_graph_background_flush_to_original(depsgraph);
+
+  /* The handlers run after the evaluation here, changes done by them are taken into account
+   * like in the second pass of #BKE_scene_graph_update_for_newframe_ex. */
+  BKE_callback_exec_id(bmain, &scene->id, BKE_CB_EVT_FRAME_CHANGE_PRE);
+
+  BKE_image_editors_update_frame(bmain, scene->r.cfra);
+  BKE_sound_set_cfra(scene->r.cfra);
+  BKE_scene_update_sound(depsgraph, bmain);
+
+  BKE_callback_exec_id_depsgraph(bmain, &scene->id, depsgraph, BKE_CB_EVT_FRAME_CHANGE_POST);
+  DEG_graph_relations_update(depsgraph);
+
+  /* Also takes edits into account that were tagged while the evaluation was running. */
+  if (!DEG_is_fully_evaluated(depsgraph)) {
+    DEG_ids_clear_recalc(depsgraph, true);
+    DEG_evaluate_on_refresh(depsgraph);
+    BKE_scene_update_sound(depsgraph, bmain);
+    DEG_ids_restore_recalc(depsgraph);
+  }
+
+  const bool is_time_update = true;
+  DEG_editors_update(depsgraph, is_time_update);
+
+  const bool backup = false;
+  DEG_ids_clear_recalc(depsgraph, backup);
+}
+
 /**
  * Ensures given scene/view_layer pair has a valid, up-to-date depsgraph.
  *
@@ -3362,6 +3437,8 @@ int BKE_scene_multiview_num_videos_get(const RenderData *rd)
 /* This is a key which identifies depsgraph. */
 typedef struct DepsgraphKey {
   const ViewLayer *view_layer;
+  /* Second depsgraph of the view layer, see #BKE_scene_get_playback_depsgraph. */
+  bool is_playback;
   /* TODO(sergey): Need to include window somehow (same layer might be in a
    * different states in different windows).
    */
@@ -3370,7 +3447,7 @@ typedef struct DepsgraphKey {
 static unsigned int depsgraph_key_hash(const void *key_v)
 {
   const DepsgraphKey *key = key_v;
-  unsigned int hash = BLI_ghashutil_ptrhash(key->view_layer);
+  unsigned int hash = BLI_ghashutil_ptrhash(key->view_layer) ^ (unsigned int)key->is_playback;
   /* TODO(sergey): Include hash from other fields in the key. */
   return hash;
 }
@@ -3380,7 +3457,7 @@ static bool depsgraph_key_compare(const void *key_a_v, const void *key_b_v)
   const DepsgraphKey *key_a = key_a_v;
   const DepsgraphKey *key_b = key_b_v;
   /* TODO(sergey): Compare rest of  */
-  return !(key_a->view_layer == key_b->view_layer);
+  return !(key_a->view_layer == key_b->view_layer && key_a->is_playback == key_b->is_playback);
 }
 
 static void depsgraph_key_free(void *key_v)
@@ -3420,7 +3497,9 @@ void BKE_scene_free_depsgraph_hash(Scene *scene)
 void BKE_scene_free_view_layer_depsgraph(Scene *scene, ViewLayer *view_layer)
 {
   if (scene->depsgraph_hash != NULL) {
-    DepsgraphKey key = {view_layer};
+    DepsgraphKey key = {view_layer, false};
+    BLI_ghash_remove(scene->depsgraph_hash, &key, depsgraph_key_free, depsgraph_key_value_free);
+    key.is_playback = true;
     BLI_ghash_remove(scene->depsgraph_hash, &key, depsgraph_key_free, depsgraph_key_value_free);
   }
 }
@@ -3429,6 +3508,7 @@ void BKE_scene_free_view_layer_depsgraph(Scene *scene, ViewLayer *view_layer)
 
 static Depsgraph **scene_get_depsgraph_p(Scene *scene,
                                          ViewLayer *view_layer,
+                                         const bool is_playback,
                                          const bool allocate_ghash_entry)
 {
   /* bmain may be NULL here! */
@@ -3446,6 +3526,7 @@ static Depsgraph **scene_get_depsgraph_p(Scene *scene,
 
   DepsgraphKey key;
   key.view_layer = view_layer;
+  key.is_playback = is_playback;
 
   Depsgraph **depsgraph_ptr;
   if (!allocate_ghash_entry) {
@@ -3467,11 +3548,14 @@ static Depsgraph **scene_get_depsgraph_p(Scene *scene,
   return depsgraph_ptr;
 }
 
-static Depsgraph **scene_ensure_depsgraph_p(Main *bmain, Scene *scene, ViewLayer *view_layer)
+static Depsgraph **scene_ensure_depsgraph_p(Main *bmain,
+                                            Scene *scene,
+                                            ViewLayer *view_layer,
+                                            const bool is_playback)
 {
   BLI_assert(bmain != NULL);
 
-  Depsgraph **depsgraph_ptr = scene_get_depsgraph_p(scene, view_layer, true);
+  Depsgraph **depsgraph_ptr = scene_get_depsgraph_p(scene, view_layer, is_playback, true);
   if (depsgraph_ptr == NULL) {
     /* The scene has no depsgraph hash. */
     return NULL;
@@ -3490,7 +3574,12 @@ static Depsgraph **scene_ensure_depsgraph_p(Main *bmain, Scene *scene, ViewLayer
    * we will ever enable debug messages for this depsgraph.
    */
   char name[1024];
-  BLI_snprintf(name, sizeof(name), "%s :: %s", scene->id.name, view_layer->name);
+  BLI_snprintf(name,
+               sizeof(name),
+               "%s :: %s%s",
+               scene->id.name,
+               view_layer->name,
+               is_playback ? " :: Playback" : "");
   DEG_debug_name_set(*depsgraph_ptr, name);
 
   /* These viewport depsgraphs communicate changes to the editors. */
@@ -3509,15 +3598,92 @@ Depsgraph *BKE_scene_get_depsgraph(const Scene *scene, const ViewLayer *view_lay
 
   DepsgraphKey key;
   key.view_layer = view_layer;
+  key.is_playback = false;
   return BLI_ghash_lookup(scene->depsgraph_hash, &key);
 }
 
 Depsgraph *BKE_scene_ensure_depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer)
 {
-  Depsgraph **depsgraph_ptr = scene_ensure_depsgraph_p(bmain, scene, view_layer);
+  Depsgraph **depsgraph_ptr = scene_ensure_depsgraph_p(bmain, scene, view_layer, false);
+  return (depsgraph_ptr != NULL) ? *depsgraph_ptr : NULL;
+}
+
+Depsgraph *BKE_scene_get_playback_depsgraph(const Scene *scene, const ViewLayer *view_layer)
+{
+  BLI_assert(BKE_scene_has_view_layer(scene, view_layer));
+
+  if (scene->depsgraph_hash == NULL) {
+    return NULL;
+  }
+
+  DepsgraphKey key;
+  key.view_layer = view_layer;
+  key.is_playback = true;
+  return BLI_ghash_lookup(scene->depsgraph_hash, &key);
+}
+
+Depsgraph *BKE_scene_ensure_playback_depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer)
+{
+  Depsgraph **depsgraph_ptr = scene_ensure_depsgraph_p(bmain, scene, view_layer, true);
   return (depsgraph_ptr != NULL) ? *depsgraph_ptr : NULL;
 }
 
+void BKE_scene_swap_playback_depsgraph(Scene *scene, ViewLayer *view_layer)
+{
+  Depsgraph **depsgraph_ptr = scene_get_depsgraph_p(scene, view_layer, false, false);
+  Depsgraph **playback_depsgraph_ptr = scene_get_depsgraph_p(scene, view_layer, true, false);
+  if (depsgraph_ptr == NULL || playback_depsgraph_ptr == NULL) {
+    BLI_assert_unreachable();
+    return;
+  }
+
+  SWAP(Depsgraph *, *depsgraph_ptr, *playback_depsgraph_ptr);
+
+  /* Only the depsgraph that is drawn writes animated values back to the original data. */
+  DEG_make_inactive(*playback_depsgraph_ptr);
+  DEG_make_active(*depsgraph_ptr);
+}
+
+void BKE_scene_start_playback_depsgraphs(Main *bmain)
+{
+  LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+    LISTBASE_FOREACH (ViewLayer *, view_layer, &scene->view_layers) {
+      Depsgraph *depsgraph = BKE_scene_get_playback_depsgraph(scene, view_layer);
+      if (depsgraph != NULL) {
+        DEG_background_evaluation_start(depsgraph);
+      }
+    }
+  }
+}
+
+void BKE_scene_wait_playback_depsgraphs(Main *bmain)
+{
+  LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+    LISTBASE_FOREACH (ViewLayer *, view_layer, &scene->view_layers) {
+      Depsgraph *depsgraph = BKE_scene_get_playback_depsgraph(scene, view_layer);
+      if (depsgraph != NULL) {
+        DEG_background_evaluation_wait(depsgraph);
+      }
+    }
+  }
+}
+
+bool BKE_scene_free_playback_depsgraphs(Main *bmain)
+{
+  bool freed = false;
+  LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+    if (scene->depsgraph_hash == NULL) {
+      continue;
+    }
+    LISTBASE_FOREACH (ViewLayer *, view_layer, &scene->view_layers) {
+      DepsgraphKey key = {view_layer, true};
+      freed |= BLI_ghash_remove(
+          scene->depsgraph_hash, &key, depsgraph_key_free, depsgraph_key_value_free);
+    }
+  }
+  return freed;
+}
+
 static char *scene_undo_depsgraph_gen_key(Scene *scene, ViewLayer *view_layer, char *key_full)
 {
   if (key_full == NULL) {
@@ -3540,6 +3706,9 @@ GHash *BKE_scene_undo_depsgraphs_extract(Main *bmain)
   GHash *depsgraph_extract = BLI_ghash_new(
       BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, __func__);
 
+  /* The original data-blocks are about to be replaced, they must not be read anymore. */
+  BKE_scene_wait_playback_depsgraphs(bmain);
+
   for (Scene *scene = bmain->scenes.first; scene != NULL; scene = scene->id.next) {
     if (scene->depsgraph_hash == NULL) {
       /* In some cases, e.g. when undo has to perform multiple steps at once, no depsgraph will
@@ -3550,6 +3719,7 @@ GHash *BKE_scene_undo_depsgraphs_extract(Main *bmain)
          view_layer = view_layer->next) {
       DepsgraphKey key;
       key.view_layer = view_layer;
+      key.is_playback = false;
       Depsgraph **depsgraph = (Depsgraph **)BLI_ghash_lookup_p(scene->depsgraph_hash, &key);
 
       if (depsgraph != NULL && *depsgraph != NULL) {
@@ -3580,7 +3750,7 @@ void BKE_scene_undo_depsgraphs_restore(Main *bmain, GHash *depsgraph_extract)
       }
       BLI_assert(*depsgraph_extract_ptr != NULL);
 
-      Depsgraph **depsgraph_scene_ptr = scene_get_depsgraph_p(scene, view_layer, true);
+      Depsgraph **depsgraph_scene_ptr = scene_get_depsgraph_p(scene, view_layer, false, true);
       BLI_assert(depsgraph_scene_ptr != NULL);
       BLI_assert(*depsgraph_scene_ptr == NULL);
 
@@ -28,6 +28,7 @@
 #include "BLI_listbase.h"
 #include "BLI_string.h"
 #include "BLI_sys_types.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -43,6 +44,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #define undo_stack _wm_undo_stack_disallow /* pass in as a variable always. */
 
 /** Odd requirement of Blender that we always keep a memfile undo in the stack. */
@@ -120,6 +123,106 @@ static const UndoType *BKE_undosys_type_from_context(bContext *C)
   return NULL;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Background Compression
+ *
+ * Steps that aren't active are compressed by #UndoType.step_compress in a background task pool.
+ * The last step of each type is kept as is since new steps are usually compared against it,
+ * as well as the active step of each type since it's read to restore the current state.
+ *
+ * While a job runs it accesses its step and the next step of the same type, so those are waited
+ * for before being freed or decompressed. Resulting sizes are applied on the main thread.
+ * \{ */
+
+typedef struct UndoCompressJob {
+  struct UndoCompressJob *next, *prev;
+  UndoStep *us;
+  /** Next step of the same type, can be accessed by the compress callback. */
+  UndoStep *us_next;
+  size_t data_size;
+  int32_t is_done;
+} UndoCompressJob;
+
+static void undosys_compress_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  UndoCompressJob *job = taskdata;
+  job->data_size = job->us->type->step_compress(job->us, job->us_next);
+  atomic_fetch_and_or_int32(&job->is_done, 1);
+}
+
+/**
+ * Apply the sizes of finished compression jobs.
+ *
+ * \param wait: Wait for all jobs to finish first.
+ */
+static void undosys_compress_jobs_apply(UndoStack *ustack, const bool wait)
+{
+  if (ustack->compress_pool == NULL) {
+    return;
+  }
+  if (wait) {
+    BLI_task_pool_work_and_wait(ustack->compress_pool);
+  }
+  LISTBASE_FOREACH_MUTABLE (UndoCompressJob *, job, &ustack->compress_jobs) {
+    if (wait || atomic_fetch_and_or_int32(&job->is_done, 0)) {
+      job->us->data_size = job->data_size;
+      BLI_freelinkN(&ustack->compress_jobs, job);
+    }
+  }
+}
+
+/** Wait for compression jobs that may access the data of \a us. */
+static void undosys_compress_wait_for_step(UndoStack *ustack, UndoStep *us)
+{
+  UndoStep *us_next = BKE_undosys_step_same_type_next(us);
+  LISTBASE_FOREACH (UndoCompressJob *, job, &ustack->compress_jobs) {
+    if (ELEM(job->us, us, us_next) || job->us_next == us) {
+      undosys_compress_jobs_apply(ustack, true);
+      return;
+    }
+  }
+}
+
+static void undosys_compress_schedule(UndoStack *ustack)
+{
+  LISTBASE_FOREACH (UndoStep *, us, &ustack->steps) {
+    if (us->type->step_compress == NULL || us->is_compressed || us == ustack->step_active) {
+      continue;
+    }
+    UndoStep *us_next = BKE_undosys_step_same_type_next(us);
+    if (us_next == NULL || us == BKE_undosys_stack_active_with_type(ustack, us->type)) {
+      continue;
+    }
+
+    if (ustack->compress_pool == NULL) {
+      ustack->compress_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+    }
+    UndoCompressJob *job = MEM_callocN(sizeof(*job), __func__);
+    job->us = us;
+    job->us_next = us_next;
+    job->data_size = us->data_size;
+    BLI_addtail(&ustack->compress_jobs, job);
+    /* Set before the job runs, so decompressing always waits for it. */
+    us->is_compressed = true;
+    BLI_task_pool_push(ustack->compress_pool, undosys_compress_task, job, false, NULL);
+  }
+}
+
+/**
+ * Restore the data of a step compressed in the background,
+ * needed before accessing the data of steps other than the one being decoded.
+ */
+void BKE_undosys_step_decompress(UndoStack *ustack, UndoStep *us)
+{
+  undosys_compress_wait_for_step(ustack, us);
+  if (us->is_compressed) {
+    us->type->step_decompress(us);
+    us->is_compressed = false;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Internal Callback Wrappers
  *
@@ -186,6 +289,8 @@ static void undosys_step_decode(bContext *C,
 {
   CLOG_INFO(&LOG, 2, "addr=%p, name='%s', type='%s'", us, us->name, us->type->name);
 
+  BKE_undosys_step_decompress(ustack, us);
+
   if (us->type->step_foreach_ID_ref) {
 #ifdef WITH_GLOBAL_UNDO_CORRECT_ORDER
     if (us->type != BKE_UNDOSYS_TYPE_MEMFILE) {
@@ -225,6 +330,7 @@ static void undosys_step_decode(bContext *C,
 static void undosys_step_free_and_unlink(UndoStack *ustack, UndoStep *us)
 {
   CLOG_INFO(&LOG, 2, "addr=%p, name='%s', type='%s'", us, us->name, us->type->name);
+  undosys_compress_wait_for_step(ustack, us);
   UNDO_NESTED_CHECK_BEGIN;
   us->type->step_free(us);
   UNDO_NESTED_CHECK_END;
@@ -271,6 +377,9 @@ UndoStack *BKE_undosys_stack_create(void)
 void BKE_undosys_stack_destroy(UndoStack *ustack)
 {
   BKE_undosys_stack_clear(ustack);
+  if (ustack->compress_pool != NULL) {
+    BLI_task_pool_free(ustack->compress_pool);
+  }
   MEM_freeN(ustack);
 }
 
@@ -278,6 +387,7 @@ void BKE_undosys_stack_clear(UndoStack *ustack)
 {
   UNDO_NESTED_ASSERT(false);
   CLOG_INFO(&LOG, 1, "steps=%d", BLI_listbase_count(&ustack->steps));
+  undosys_compress_jobs_apply(ustack, true);
   for (UndoStep *us = ustack->steps.last, *us_prev; us; us = us_prev) {
     us_prev = us->prev;
     undosys_step_free_and_unlink(ustack, us);
@@ -409,6 +519,8 @@ void BKE_undosys_stack_limit_steps_and_memory(UndoStack *ustack, int steps, size
   }
 
   CLOG_INFO(&LOG, 1, "steps=%d, memory_limit=%zu", steps, memory_limit);
+  /* Account for steps that have been compressed since. */
+  undosys_compress_jobs_apply(ustack, false);
   UndoStep *us;
   UndoStep *us_exclude = NULL;
   /* keep at least two (original + other) */
@@ -598,6 +710,8 @@ UndoPushReturn BKE_undosys_step_push_with_type(UndoStack *ustack,
     ustack->step_active->skip = true;
   }
 
+  undosys_compress_schedule(ustack);
+
   undosys_stack_validate(ustack, true);
   return (retval | UNDO_PUSH_RET_SUCCESS);
 }
@@ -819,6 +933,7 @@ bool BKE_undosys_step_load_data_ex(UndoStack *ustack,
 
     if (is_final) {
       /* Undo/Redo process is finished and successful. */
+      undosys_compress_schedule(ustack);
       return true;
     }
   }
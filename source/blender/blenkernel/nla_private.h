@@ -146,6 +146,9 @@ typedef struct NlaEvalData {
 
   /* Evaluation result shapshot. */
   NlaEvalSnapshot eval_snapshot;
+
+  /* Keyframe segment hints of evaluated actions, owned by the evaluated AnimData (optional). */
+  GHash *segment_hints;
 } NlaEvalData;
 
 /* Information about the currently edited strip and ones below it for keyframing. */
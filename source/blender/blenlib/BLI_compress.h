@@ -0,0 +1,56 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Fast lossless in-memory compression, for data that has to be kept around but is rarely
+ * accessed (undo history for example).
+ */
+
+#include "BLI_sys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compress a group of buffers into a single newly allocated block, as if they were one
+ * contiguous buffer.
+ *
+ * \return The compressed block, to be freed with #MEM_freeN,
+ * or NULL when compression failed or didn't reduce the size.
+ */
+void *BLI_compress_buffers(const void *const *buffers,
+                           const size_t *sizes,
+                           int buffers_num,
+                           size_t *r_compressed_size);
+
+/**
+ * Decompress a block created by #BLI_compress_buffers into \a buffers,
+ * which must have the same sizes as the buffers that were compressed.
+ */
+bool BLI_decompress_buffers(const void *compressed,
+                            size_t compressed_size,
+                            void *const *buffers,
+                            const size_t *sizes,
+                            int buffers_num);
+
+#ifdef __cplusplus
+}
+#endif
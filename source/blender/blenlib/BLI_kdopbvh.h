@@ -233,6 +233,34 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+/**
+ * Batched versions of #BLI_bvhtree_find_nearest_ex and #BLI_bvhtree_ray_cast_ex, giving the
+ * same results as a query per element, much faster when there are many queries.
+ * Queries are reordered and run in parallel, so the callback must be thread-safe.
+ *
+ * \param r_nearest, r_hits: One per query. They must be initialized like the arguments of a
+ * single query (index and distance), to limit the search distance.
+ *
+ * \note When several elements are at exactly the same distance, the element that is
+ * returned may differ from the one a single query finds.
+ */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag);
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                int rays_len,
+                                float radius,
+                                BVHTreeRayHit *r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
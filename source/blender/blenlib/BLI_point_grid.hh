@@ -0,0 +1,88 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * A uniform grid over a set of points, used to find the closest point to a position.
+ *
+ * The points are sorted by the cell they are in, so building the grid only takes a few linear
+ * passes over the points. That is much cheaper than building a BVH tree or a KD-tree, while the
+ * lookups are about as fast for points that are distributed somewhat evenly. Flat point sets
+ * (e.g. all points lie on a plane) are handled by not subdividing the flat axes.
+ */
+
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_span.hh"
+#include "BLI_virtual_array.hh"
+
+namespace blender {
+
+class PointGrid {
+ private:
+  float3 min_ = {0.0f, 0.0f, 0.0f};
+  float cell_size_ = 1.0f;
+  int cells_num_[3] = {1, 1, 1};
+  /** Start of the points of every cell in the sorted arrays, with one extra element at the end. */
+  Array<int> cell_offsets_;
+  /** The positions sorted by cell, so that the points of a cell are next to each other. */
+  Array<float3> sorted_positions_;
+  /** The original index of every sorted point. */
+  Array<int> sorted_indices_;
+
+ public:
+  PointGrid() = default;
+  PointGrid(Span<float3> positions);
+
+  int64_t size() const
+  {
+    return sorted_indices_.size();
+  }
+
+  bool is_empty() const
+  {
+    return sorted_indices_.is_empty();
+  }
+
+  /**
+   * Find the point closest to the given position, optionally returning its squared distance and
+   * its position.
+   * \return The index of the point in the positions the grid was built from, or -1 when the grid
+   * is empty or the position is not finite. The distance is #FLT_MAX then.
+   */
+  int find_nearest(const float3 &position,
+                   float *r_distance_sq = nullptr,
+                   float3 *r_position = nullptr) const;
+
+  /**
+   * Find the closest points for many positions in parallel. The output spans are optional, they
+   * can be empty when the result is not needed. For positions that are not finite, the index is
+   * -1, the distance is #FLT_MAX and the position is the query position.
+   */
+  void find_nearest(const VArray<float3> &positions,
+                    MutableSpan<int> r_indices,
+                    MutableSpan<float> r_distances_sq = {},
+                    MutableSpan<float3> r_positions = {}) const;
+
+ private:
+  int cell_coord(const float3 &position, const int axis) const;
+  int find_nearest_sorted(const float3 &position, float &r_distance_sq) const;
+};
+
+}  // namespace blender
@@ -420,6 +420,67 @@ template<typename T> class VArray_Span final : public Span<T> {
   }
 };
 
+/**
+ * A virtual array that is either a span or a single value internally. Other virtual arrays are
+ * copied into an owned array. Compared to #VArray_Span, single values are not copied for every
+ * index. This is useful when the elements are accessed in a devirtualized loop, which only has
+ * fast paths for spans and single values.
+ */
+template<typename T> class VArray_SpanOrSingle final : public VArray<T> {
+ private:
+  const VArray<T> &varray_;
+  bool is_single_;
+  Span<T> span_;
+  Array<T> owned_data_;
+
+ public:
+  VArray_SpanOrSingle(const VArray<T> &varray)
+      : VArray<T>(varray.size()), varray_(varray), is_single_(varray.is_single())
+  {
+    if (is_single_) {
+      return;
+    }
+    if (varray_.is_span()) {
+      span_ = varray_.get_internal_span();
+    }
+    else {
+      owned_data_.~Array();
+      new (&owned_data_) Array<T>(varray_.size(), NoInitialization{});
+      varray_.materialize_to_uninitialized(owned_data_);
+      span_ = owned_data_;
+    }
+  }
+
+ private:
+  T get_impl(const int64_t index) const override
+  {
+    if (is_single_) {
+      return varray_.get(index);
+    }
+    return span_[index];
+  }
+
+  bool is_span_impl() const override
+  {
+    return !is_single_;
+  }
+
+  Span<T> get_internal_span_impl() const override
+  {
+    return span_;
+  }
+
+  bool is_single_impl() const override
+  {
+    return is_single_;
+  }
+
+  T get_internal_single_impl() const override
+  {
+    return varray_.get_internal_single();
+  }
+};
+
 /**
  * Same as VArray_Span, but for a mutable span.
  * The important thing to note is that when changing this span, the results might not be
@@ -44,6 +44,8 @@
 #include "BLI_heap_simple.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_math.h"
+#include "BLI_math_bits.h"
+#include "BLI_simd.h"
 #include "BLI_stack.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
@@ -132,6 +134,8 @@ typedef struct BVHNearestData {
   void *userdata;
   float proj[13]; /* coordinates projection over axis */
   BVHTreeNearest nearest;
+  /* Leaf of the current nearest element, used to start batched queries. */
+  BVHNode *nearest_node;
 
 } BVHNearestData;
 
@@ -1508,17 +1512,25 @@ static float calc_nearest_point_squared(const float proj[3], BVHNode *node, floa
   return len_squared_v3v3(proj, nearest);
 }
 
+static void find_nearest_leaf(BVHNearestData *data, BVHNode *node)
+{
+  if (data->callback) {
+    data->callback(data->userdata, node->index, data->co, &data->nearest);
+  }
+  else {
+    data->nearest.index = node->index;
+    data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
+  }
+  if (data->nearest.index == node->index) {
+    data->nearest_node = node;
+  }
+}
+
 /* Depth first search method */
 static void dfs_find_nearest_dfs(BVHNearestData *data, BVHNode *node)
 {
   if (node->totnode == 0) {
-    if (data->callback) {
-      data->callback(data->userdata, node->index, data->co, &data->nearest);
-    }
-    else {
-      data->nearest.index = node->index;
-      data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
-    }
+    find_nearest_leaf(data, node);
   }
   else {
     /* Better heuristic to pick the closest node to dive on */
@@ -1561,13 +1573,7 @@ static void dfs_find_nearest_begin(BVHNearestData *data, BVHNode *node)
 static void heap_find_nearest_inner(BVHNearestData *data, HeapSimple *heap, BVHNode *node)
 {
   if (node->totnode == 0) {
-    if (data->callback) {
-      data->callback(data->userdata, node->index, data->co, &data->nearest);
-    }
-    else {
-      data->nearest.index = node->index;
-      data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
-    }
+    find_nearest_leaf(data, node);
   }
   else {
     float nearest[3];
@@ -1602,36 +1608,47 @@ static void heap_find_nearest_begin(BVHNearestData *data, BVHNode *root)
   }
 }
 
-int BLI_bvhtree_find_nearest_ex(BVHTree *tree,
-                                const float co[3],
-                                BVHTreeNearest *nearest,
-                                BVHTree_NearestPointCallback callback,
-                                void *userdata,
-                                int flag)
+static void bvhtree_find_nearest_data_init(BVHNearestData *data,
+                                           const BVHTree *tree,
+                                           const float co[3],
+                                           const BVHTreeNearest *nearest,
+                                           BVHTree_NearestPointCallback callback,
+                                           void *userdata)
 {
   axis_t axis_iter;
 
-  BVHNearestData data;
-  BVHNode *root = tree->nodes[tree->totleaf];
-
   /* init data to search */
-  data.tree = tree;
-  data.co = co;
+  data->tree = tree;
+  data->co = co;
 
-  data.callback = callback;
-  data.userdata = userdata;
+  data->callback = callback;
+  data->userdata = userdata;
 
-  for (axis_iter = data.tree->start_axis; axis_iter != data.tree->stop_axis; axis_iter++) {
-    data.proj[axis_iter] = dot_v3v3(data.co, bvhtree_kdop_axes[axis_iter]);
+  for (axis_iter = tree->start_axis; axis_iter != tree->stop_axis; axis_iter++) {
+    data->proj[axis_iter] = dot_v3v3(co, bvhtree_kdop_axes[axis_iter]);
   }
 
   if (nearest) {
-    memcpy(&data.nearest, nearest, sizeof(*nearest));
+    memcpy(&data->nearest, nearest, sizeof(*nearest));
   }
   else {
-    data.nearest.index = -1;
-    data.nearest.dist_sq = FLT_MAX;
+    data->nearest.index = -1;
+    data->nearest.dist_sq = FLT_MAX;
   }
+  data->nearest_node = NULL;
+}
+
+int BLI_bvhtree_find_nearest_ex(BVHTree *tree,
+                                const float co[3],
+                                BVHTreeNearest *nearest,
+                                BVHTree_NearestPointCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  BVHNearestData data;
+  BVHNode *root = tree->nodes[tree->totleaf];
+
+  bvhtree_find_nearest_data_init(&data, tree, co, nearest, callback, userdata);
 
   /* dfs search */
   if (root) {
@@ -1936,6 +1953,38 @@ static void bvhtree_ray_cast_data_precalc(BVHRayCastData *data, int flag)
 #endif
 }
 
+static void bvhtree_ray_cast_data_init(BVHRayCastData *data,
+                                       const BVHTree *tree,
+                                       const float co[3],
+                                       const float dir[3],
+                                       float radius,
+                                       const BVHTreeRayHit *hit,
+                                       BVHTree_RayCastCallback callback,
+                                       void *userdata,
+                                       int flag)
+{
+  BLI_ASSERT_UNIT_V3(dir);
+
+  data->tree = tree;
+
+  data->callback = callback;
+  data->userdata = userdata;
+
+  copy_v3_v3(data->ray.origin, co);
+  copy_v3_v3(data->ray.direction, dir);
+  data->ray.radius = radius;
+
+  bvhtree_ray_cast_data_precalc(data, flag);
+
+  if (hit) {
+    memcpy(&data->hit, hit, sizeof(*hit));
+  }
+  else {
+    data->hit.index = -1;
+    data->hit.dist = BVH_RAYCAST_DIST_MAX;
+  }
+}
+
 int BLI_bvhtree_ray_cast_ex(BVHTree *tree,
                             const float co[3],
                             const float dir[3],
@@ -1948,26 +1997,7 @@ int BLI_bvhtree_ray_cast_ex(BVHTree *tree,
   BVHRayCastData data;
   BVHNode *root = tree->nodes[tree->totleaf];
 
-  BLI_ASSERT_UNIT_V3(dir);
-
-  data.tree = tree;
-
-  data.callback = callback;
-  data.userdata = userdata;
-
-  copy_v3_v3(data.ray.origin, co);
-  copy_v3_v3(data.ray.direction, dir);
-  data.ray.radius = radius;
-
-  bvhtree_ray_cast_data_precalc(&data, flag);
-
-  if (hit) {
-    memcpy(&data.hit, hit, sizeof(*hit));
-  }
-  else {
-    data.hit.index = -1;
-    data.hit.dist = BVH_RAYCAST_DIST_MAX;
-  }
+  bvhtree_ray_cast_data_init(&data, tree, co, dir, radius, hit, callback, userdata, flag);
 
   if (root) {
     dfs_raycast(&data, root);
@@ -2077,6 +2107,368 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_find_nearest_batch / BLI_bvhtree_ray_cast_batch
+ *
+ * Queries are sorted along a Morton curve so consecutive queries visit the same parts of the
+ * tree, and processed in parallel chunks. Nearest point queries start from the element found
+ * by the previous query of the chunk, rays are traversed in packets that test each node against
+ * all rays of the packet at once.
+ *
+ * \{ */
+
+/* Number of consecutive (sorted) queries handled by one task. */
+#define BVH_BATCH_CHUNK_SIZE 64
+#define BVH_RAY_PACKET_SIZE 4
+
+typedef struct BVHBatchQuery {
+  uint key;
+  int index;
+} BVHBatchQuery;
+
+typedef struct BVHBatchData {
+  BVHTree *tree;
+  const BVHBatchQuery *queries;
+  int queries_len;
+
+  const float (*co)[3];
+  const float (*dir)[3];
+  float radius;
+  BVHTreeNearest *nearest;
+  BVHTreeRayHit *hits;
+  BVHTree_NearestPointCallback nearest_callback;
+  BVHTree_RayCastCallback raycast_callback;
+  void *userdata;
+  int flag;
+} BVHBatchData;
+
+typedef struct BVHRayPacket {
+  BVHRayCastData rays[BVH_RAY_PACKET_SIZE];
+  /* Ray data used for node tests, stored per axis so all rays are tested at once. */
+  float origin[3][BVH_RAY_PACKET_SIZE];
+  float idot_axis[3][BVH_RAY_PACKET_SIZE];
+  float hit_dist[BVH_RAY_PACKET_SIZE];
+} BVHRayPacket;
+
+/* Spread the lower 10 bits of \a x so there are two zero bits between each of them. */
+static uint morton_spread_bits(uint x)
+{
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+static int bvhtree_batch_query_cmp(const void *a_v, const void *b_v)
+{
+  const BVHBatchQuery *a = a_v, *b = b_v;
+  if (a->key != b->key) {
+    return (a->key < b->key) ? -1 : 1;
+  }
+  return (a->index < b->index) ? -1 : (a->index > b->index);
+}
+
+/**
+ * Order queries along a Morton curve through their positions, \a dir groups rays by the octant
+ * of their direction first. Uses 9 bits per axis for rays, 10 otherwise.
+ */
+static BVHBatchQuery *bvhtree_batch_queries_sort(const float (*co)[3],
+                                                 const float (*dir)[3],
+                                                 const int queries_len)
+{
+  BVHBatchQuery *queries = MEM_malloc_arrayN(
+      (size_t)queries_len, sizeof(*queries), "BVHBatchQuery");
+
+  float min[3], max[3], scale[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < queries_len; i++) {
+    minmax_v3v3_v3(min, max, co[i]);
+  }
+  const int bits = dir ? 9 : 10;
+  const float cells = (float)((1 << bits) - 1);
+  for (int axis = 0; axis < 3; axis++) {
+    const float size = max[axis] - min[axis];
+    scale[axis] = (size > 0.0f) ? cells / size : 0.0f;
+  }
+
+  for (int i = 0; i < queries_len; i++) {
+    uint key = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      const uint cell = (uint)((co[i][axis] - min[axis]) * scale[axis]);
+      key |= morton_spread_bits(cell) << axis;
+    }
+    if (dir) {
+      const uint octant = (dir[i][0] < 0.0f ? 1u : 0u) | (dir[i][1] < 0.0f ? 2u : 0u) |
+                          (dir[i][2] < 0.0f ? 4u : 0u);
+      key |= octant << 27;
+    }
+    queries[i].key = key;
+    queries[i].index = i;
+  }
+
+  qsort(queries, (size_t)queries_len, sizeof(*queries), bvhtree_batch_query_cmp);
+  return queries;
+}
+
+static void bvhtree_find_nearest_batch_task_cb(void *__restrict userdata,
+                                               const int chunk,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHBatchData *batch = userdata;
+  BVHNode *root = batch->tree->nodes[batch->tree->totleaf];
+  const int start = chunk * BVH_BATCH_CHUNK_SIZE;
+  const int end = min_ii(start + BVH_BATCH_CHUNK_SIZE, batch->queries_len);
+
+  BVHNode *prev_nearest_node = NULL;
+  for (int i = start; i < end; i++) {
+    const int index = batch->queries[i].index;
+    BVHNearestData data;
+    bvhtree_find_nearest_data_init(&data,
+                                   batch->tree,
+                                   batch->co[index],
+                                   &batch->nearest[index],
+                                   batch->nearest_callback,
+                                   batch->userdata);
+
+    if (batch->flag & BVH_NEAREST_OPTIMAL_ORDER) {
+      heap_find_nearest_begin(&data, root);
+    }
+    else {
+      /* The previous query point is close, so its nearest element usually is a good first
+       * guess that lets the search skip most of the tree. */
+      if (prev_nearest_node) {
+        dfs_find_nearest_begin(&data, prev_nearest_node);
+      }
+      dfs_find_nearest_begin(&data, root);
+    }
+
+    memcpy(&batch->nearest[index], &data.nearest, sizeof(data.nearest));
+    if (data.nearest_node) {
+      prev_nearest_node = data.nearest_node;
+    }
+  }
+}
+
+/**
+ * Same as #fast_ray_nearest_hit for all rays of the packet in \a mask.
+ * Returns the mask of rays that need to visit the node, the distances are written to \a r_dist.
+ */
+static int fast_ray_packet_nearest_hit(const BVHRayPacket *packet,
+                                       const BVHNode *node,
+                                       const int mask,
+                                       float r_dist[BVH_RAY_PACKET_SIZE])
+{
+  const float *bv = node->bv;
+
+#ifdef BLI_HAVE_SSE2
+  __m128 t_near = _mm_setzero_ps(), t_far = _mm_setzero_ps();
+  for (int axis = 0; axis < 3; axis++) {
+    const __m128 origin = _mm_loadu_ps(packet->origin[axis]);
+    const __m128 idot = _mm_loadu_ps(packet->idot_axis[axis]);
+    const __m128 ta = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[axis * 2]), origin), idot);
+    const __m128 tb = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[axis * 2 + 1]), origin), idot);
+    const __m128 t1 = _mm_min_ps(ta, tb);
+    const __m128 t2 = _mm_max_ps(ta, tb);
+    t_near = (axis == 0) ? t1 : _mm_max_ps(t_near, t1);
+    t_far = (axis == 0) ? t2 : _mm_min_ps(t_far, t2);
+  }
+  const __m128 visit = _mm_and_ps(
+      _mm_and_ps(_mm_cmple_ps(t_near, t_far), _mm_cmpge_ps(t_far, _mm_setzero_ps())),
+      _mm_cmplt_ps(t_near, _mm_loadu_ps(packet->hit_dist)));
+  _mm_storeu_ps(r_dist, t_near);
+  return _mm_movemask_ps(visit) & mask;
+#else
+  int visit = 0;
+  for (int lane = 0; lane < BVH_RAY_PACKET_SIZE; lane++) {
+    float t_near = 0.0f, t_far = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+      const float origin = packet->origin[axis][lane];
+      const float idot = packet->idot_axis[axis][lane];
+      const float ta = (bv[axis * 2] - origin) * idot;
+      const float tb = (bv[axis * 2 + 1] - origin) * idot;
+      const float t1 = min_ff(ta, tb);
+      const float t2 = max_ff(ta, tb);
+      t_near = (axis == 0) ? t1 : max_ff(t_near, t1);
+      t_far = (axis == 0) ? t2 : min_ff(t_far, t2);
+    }
+    if (t_near <= t_far && t_far >= 0.0f && t_near < packet->hit_dist[lane]) {
+      visit |= 1 << lane;
+    }
+    r_dist[lane] = t_near;
+  }
+  return visit & mask;
+#endif
+}
+
+/**
+ * A version of #dfs_raycast for packets of rays without radius.
+ * Children are visited in the order that suits the first ray of the packet.
+ */
+static void dfs_raycast_packet(BVHRayPacket *packet, BVHNode *node, int mask)
+{
+  float dist[BVH_RAY_PACKET_SIZE];
+  mask = fast_ray_packet_nearest_hit(packet, node, mask, dist);
+  if (mask == 0) {
+    return;
+  }
+
+  if (node->totnode == 0) {
+    for (int lane = 0; lane < BVH_RAY_PACKET_SIZE; lane++) {
+      if ((mask & (1 << lane)) == 0) {
+        continue;
+      }
+      BVHRayCastData *data = &packet->rays[lane];
+      if (data->callback) {
+        data->callback(data->userdata, node->index, &data->ray, &data->hit);
+      }
+      else {
+        data->hit.index = node->index;
+        data->hit.dist = dist[lane];
+        madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist[lane]);
+      }
+      packet->hit_dist[lane] = data->hit.dist;
+    }
+  }
+  else {
+    const BVHRayCastData *data = &packet->rays[bitscan_forward_i(mask)];
+    if (data->ray_dot_axis[node->main_axis] > 0.0f) {
+      for (int i = 0; i != node->totnode; i++) {
+        dfs_raycast_packet(packet, node->children[i], mask);
+      }
+    }
+    else {
+      for (int i = node->totnode - 1; i >= 0; i--) {
+        dfs_raycast_packet(packet, node->children[i], mask);
+      }
+    }
+  }
+}
+
+static void bvhtree_ray_cast_batch_task_cb(void *__restrict userdata,
+                                           const int chunk,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHBatchData *batch = userdata;
+  BVHNode *root = batch->tree->nodes[batch->tree->totleaf];
+  const int start = chunk * BVH_BATCH_CHUNK_SIZE;
+  const int end = min_ii(start + BVH_BATCH_CHUNK_SIZE, batch->queries_len);
+
+  BVHRayPacket packet;
+  for (int packet_start = start; packet_start < end; packet_start += BVH_RAY_PACKET_SIZE) {
+    const int packet_len = min_ii(BVH_RAY_PACKET_SIZE, end - packet_start);
+    for (int lane = 0; lane < BVH_RAY_PACKET_SIZE; lane++) {
+      BVHRayCastData *data = &packet.rays[lane];
+      if (lane >= packet_len) {
+        for (int axis = 0; axis < 3; axis++) {
+          packet.origin[axis][lane] = 0.0f;
+          packet.idot_axis[axis][lane] = 0.0f;
+        }
+        packet.hit_dist[lane] = -FLT_MAX;
+        continue;
+      }
+      const int index = batch->queries[packet_start + lane].index;
+      bvhtree_ray_cast_data_init(data,
+                                 batch->tree,
+                                 batch->co[index],
+                                 batch->dir[index],
+                                 batch->radius,
+                                 &batch->hits[index],
+                                 batch->raycast_callback,
+                                 batch->userdata,
+                                 batch->flag);
+      for (int axis = 0; axis < 3; axis++) {
+        packet.origin[axis][lane] = data->ray.origin[axis];
+        packet.idot_axis[axis][lane] = data->idot_axis[axis];
+      }
+      packet.hit_dist[lane] = data->hit.dist;
+    }
+
+    if (batch->radius == 0.0f) {
+      dfs_raycast_packet(&packet, root, (1 << packet_len) - 1);
+    }
+    else {
+      /* The packet node test doesn't support a radius. */
+      for (int lane = 0; lane < packet_len; lane++) {
+        dfs_raycast(&packet.rays[lane], root);
+      }
+    }
+
+    for (int lane = 0; lane < packet_len; lane++) {
+      const int index = batch->queries[packet_start + lane].index;
+      memcpy(&batch->hits[index], &packet.rays[lane].hit, sizeof(BVHTreeRayHit));
+    }
+  }
+}
+
+static void bvhtree_batch_run(BVHBatchData *batch,
+                              const float (*co)[3],
+                              const float (*dir)[3],
+                              const int queries_len,
+                              TaskParallelRangeFunc func)
+{
+  if (queries_len == 0 || batch->tree->nodes[batch->tree->totleaf] == NULL) {
+    return;
+  }
+
+  BVHBatchQuery *queries = bvhtree_batch_queries_sort(co, dir, queries_len);
+  batch->queries = queries;
+  batch->queries_len = queries_len;
+
+  const int chunks_len = (queries_len + BVH_BATCH_CHUNK_SIZE - 1) / BVH_BATCH_CHUNK_SIZE;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (queries_len >= KDOPBVH_THREAD_LEAF_THRESHOLD);
+  BLI_task_parallel_range(0, chunks_len, batch, func, &settings);
+
+  MEM_freeN(queries);
+}
+
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    const int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag)
+{
+  BVHBatchData batch = {NULL};
+  batch.tree = tree;
+  batch.co = co;
+  batch.nearest = r_nearest;
+  batch.nearest_callback = callback;
+  batch.userdata = userdata;
+  batch.flag = flag;
+
+  bvhtree_batch_run(&batch, co, NULL, co_len, bvhtree_find_nearest_batch_task_cb);
+}
+
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                const int rays_len,
+                                float radius,
+                                BVHTreeRayHit *r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  BVHBatchData batch = {NULL};
+  batch.tree = tree;
+  batch.co = co;
+  batch.dir = dir;
+  batch.radius = radius;
+  batch.hits = r_hits;
+  batch.raycast_callback = callback;
+  batch.userdata = userdata;
+  batch.flag = flag;
+
+  bvhtree_batch_run(&batch, co, dir, rays_len, bvhtree_ray_cast_batch_task_cb);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
@@ -24,6 +24,7 @@
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h"
 
 #include <string.h>
@@ -73,6 +74,10 @@ static struct error_handler_data {
   void (*next_handler)(int, siginfo_t *, void *);
 } error_handler = {0};
 
+/* Files may be opened and freed from multiple threads, this guards the setup of the handler and
+ * changes to the list of open files. */
+static ThreadMutex error_handler_lock = BLI_MUTEX_INITIALIZER;
+
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
@@ -108,7 +113,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
   }
 }
 
-/* Ensures that the error handler is set up and ready. */
+/* Ensures that the error handler is set up and ready. Call with the lock held. */
 static bool sigbus_handler_setup(void)
 {
   if (!error_handler.configured) {
@@ -133,14 +138,21 @@ static bool sigbus_handler_setup(void)
 /* Adds a file to the list that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  /* Allocate outside of the lock, only the list update needs to be guarded. */
+  LinkData *link = BLI_genericNodeN(file);
+  BLI_mutex_lock(&error_handler_lock);
+  BLI_addtail(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_lock);
 }
 
 /* Removes a file from the list that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
+  BLI_mutex_lock(&error_handler_lock);
   LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  BLI_remlink(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_lock);
+  MEM_freeN(link);
 }
 #endif
 
@@ -151,7 +163,10 @@ BLI_mmap_file *BLI_mmap_open(int fd)
 
 #ifndef WIN32
   /* Ensure that the SIGBUS handler is configured. */
-  if (!sigbus_handler_setup()) {
+  BLI_mutex_lock(&error_handler_lock);
+  const bool handler_ok = sigbus_handler_setup();
+  BLI_mutex_unlock(&error_handler_lock);
+  if (!handler_ok) {
     return NULL;
   }
 
@@ -226,8 +241,9 @@ void *BLI_mmap_get_pointer(BLI_mmap_file *file)
 void BLI_mmap_free(BLI_mmap_file *file)
 {
 #ifndef WIN32
-  munmap((void *)file->memory, file->length);
+  /* Unregister before unmapping, so that the handler never sees a range that may be reused. */
   sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
 #else
   UnmapViewOfFile(file->memory);
   CloseHandle(file->handle);
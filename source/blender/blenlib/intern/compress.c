@@ -0,0 +1,175 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Uses zlib at its fastest level, which gives good ratios on the highly redundant data stored by
+ * undo systems while keeping compression in the order of hundreds of megabytes per second.
+ */
+
+#include <limits.h>
+
+#include "zlib.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_compress.h"
+#include "BLI_utildefines.h"
+
+/* zlib sizes are 32 bit, larger buffers are passed in pieces. */
+#define ZLIB_MAX_CHUNK ((size_t)UINT_MAX)
+
+void *BLI_compress_buffers(const void *const *buffers,
+                           const size_t *sizes,
+                           int buffers_num,
+                           size_t *r_compressed_size)
+{
+  size_t total_size = 0;
+  for (int i = 0; i < buffers_num; i++) {
+    total_size += sizes[i];
+  }
+  if (total_size == 0) {
+    return NULL;
+  }
+
+  z_stream stream = {NULL};
+  if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+    return NULL;
+  }
+
+  /* Only keep the result when it saves memory. */
+  char *compressed = MEM_mallocN(total_size, __func__);
+  size_t compressed_size = 0;
+  bool ok = true;
+
+  for (int i = 0; i < buffers_num && ok; i++) {
+    const char *buffer = buffers[i];
+    size_t remaining = sizes[i];
+    const bool is_last_buffer = (i == buffers_num - 1);
+
+    do {
+      const size_t in_size = MIN2(remaining, ZLIB_MAX_CHUNK);
+      stream.next_in = (Bytef *)buffer;
+      stream.avail_in = (uInt)in_size;
+      buffer += in_size;
+      remaining -= in_size;
+      const int flush = (is_last_buffer && remaining == 0) ? Z_FINISH : Z_NO_FLUSH;
+
+      do {
+        const size_t out_size = MIN2(total_size - compressed_size, ZLIB_MAX_CHUNK);
+        if (out_size == 0) {
+          /* Doesn't fit, the data isn't compressible. */
+          ok = false;
+          break;
+        }
+        stream.next_out = (Bytef *)(compressed + compressed_size);
+        stream.avail_out = (uInt)out_size;
+        const int result = deflate(&stream, flush);
+        compressed_size += out_size - stream.avail_out;
+        if (result == Z_STREAM_END) {
+          break;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+          ok = false;
+          break;
+        }
+      } while (stream.avail_in != 0 || (flush == Z_FINISH));
+    } while (remaining != 0 && ok);
+  }
+
+  deflateEnd(&stream);
+
+  if (!ok) {
+    MEM_freeN(compressed);
+    return NULL;
+  }
+
+  *r_compressed_size = compressed_size;
+  return MEM_reallocN(compressed, compressed_size);
+}
+
+bool BLI_decompress_buffers(const void *compressed,
+                            size_t compressed_size,
+                            void *const *buffers,
+                            const size_t *sizes,
+                            int buffers_num)
+{
+  z_stream stream = {NULL};
+  if (inflateInit(&stream) != Z_OK) {
+    return false;
+  }
+
+  const char *in = compressed;
+  size_t in_remaining = compressed_size;
+  bool ok = true;
+  bool stream_end = false;
+
+  for (int i = 0; i < buffers_num && ok; i++) {
+    char *buffer = buffers[i];
+    size_t remaining = sizes[i];
+
+    while (remaining != 0) {
+      if (stream.avail_in == 0) {
+        const size_t in_size = MIN2(in_remaining, ZLIB_MAX_CHUNK);
+        stream.next_in = (Bytef *)in;
+        stream.avail_in = (uInt)in_size;
+        in += in_size;
+        in_remaining -= in_size;
+      }
+      const size_t out_size = MIN2(remaining, ZLIB_MAX_CHUNK);
+      stream.next_out = (Bytef *)buffer;
+      stream.avail_out = (uInt)out_size;
+      const int result = inflate(&stream, Z_NO_FLUSH);
+      const size_t written = out_size - stream.avail_out;
+      buffer += written;
+      remaining -= written;
+      if (result == Z_STREAM_END) {
+        stream_end = true;
+        break;
+      }
+      if (result != Z_OK || (written == 0 && stream.avail_in == 0 && in_remaining == 0)) {
+        ok = false;
+        break;
+      }
+    }
+    if (stream_end) {
+      /* The remaining buffers must be empty. */
+      ok = (remaining == 0);
+      for (int j = i + 1; j < buffers_num; j++) {
+        if (sizes[j] != 0) {
+          ok = false;
+        }
+      }
+      break;
+    }
+  }
+
+  if (ok && !stream_end) {
+    /* All buffers are filled, the compressed data must not contain more. */
+    char extra;
+    if (stream.avail_in == 0) {
+      stream.next_in = (Bytef *)in;
+      stream.avail_in = (uInt)MIN2(in_remaining, ZLIB_MAX_CHUNK);
+    }
+    stream.next_out = (Bytef *)&extra;
+    stream.avail_out = 1;
+    ok = inflate(&stream, Z_NO_FLUSH) == Z_STREAM_END && stream.avail_out == 1;
+  }
+
+  inflateEnd(&stream);
+  return ok;
+}
@@ -0,0 +1,268 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "BLI_point_grid.hh"
+#include "BLI_task.hh"
+
+namespace blender {
+
+/** Average number of points in a cell the grid is built for. */
+static constexpr int64_t points_per_cell = 2;
+/** Upper bound for the number of cells along one axis, to avoid integer overflow. */
+static constexpr int max_cells_per_axis = 1 << 20;
+
+PointGrid::PointGrid(Span<float3> positions)
+{
+  if (positions.is_empty()) {
+    return;
+  }
+
+  min_ = positions[0];
+  float3 max = positions[0];
+  for (const float3 &position : positions) {
+    for (const int axis : IndexRange(3)) {
+      min_[axis] = std::min(min_[axis], position[axis]);
+      max[axis] = std::max(max[axis], position[axis]);
+    }
+  }
+
+  const int64_t target_cells_num = std::max<int64_t>(1, positions.size() / points_per_cell);
+  const float3 size = max - min_;
+  const float max_size = std::max({size.x, size.y, size.z});
+  if (max_size > 0.0f) {
+    /* Axes along which the points are (almost) flat are not subdivided, otherwise the cells would
+     * become tiny for points on a plane or a line. */
+    const float flat_size = max_size * 1e-4f;
+    double volume = 1.0;
+    int subdivided_axes_num = 0;
+    for (const int axis : IndexRange(3)) {
+      if (size[axis] > flat_size) {
+        volume *= size[axis];
+        subdivided_axes_num++;
+      }
+    }
+    cell_size_ = float(std::pow(volume / target_cells_num, 1.0 / subdivided_axes_num));
+    if (!(cell_size_ > 0.0f)) {
+      cell_size_ = max_size;
+    }
+
+    /* Rounding up the number of cells along every axis can add many cells for thin point sets,
+     * grow the cells until there are not too many. */
+    while (true) {
+      int64_t cells_num = 1;
+      for (const int axis : IndexRange(3)) {
+        const float cells_along_axis = size[axis] / cell_size_;
+        if (cells_along_axis >= float(max_cells_per_axis)) {
+          cells_num_[axis] = max_cells_per_axis;
+        }
+        else if (cells_along_axis >= 0.0f) {
+          cells_num_[axis] = int(cells_along_axis) + 1;
+        }
+        else {
+          cells_num_[axis] = 1;
+        }
+        cells_num *= cells_num_[axis];
+      }
+      if (cells_num <= target_cells_num * 4) {
+        break;
+      }
+      cell_size_ *= 1.25f;
+    }
+  }
+
+  const int cells_num = cells_num_[0] * cells_num_[1] * cells_num_[2];
+  Array<int> point_cells(positions.size());
+  threading::parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const float3 &position = positions[i];
+      point_cells[i] = this->cell_coord(position, 0) +
+                       cells_num_[0] * (this->cell_coord(position, 1) +
+                                        cells_num_[1] * this->cell_coord(position, 2));
+    }
+  });
+
+  /* Sort the points by cell with a counting sort. */
+  cell_offsets_.reinitialize(cells_num + 1);
+  cell_offsets_.fill(0);
+  for (const int cell : point_cells) {
+    cell_offsets_[cell + 1]++;
+  }
+  for (const int cell : IndexRange(cells_num)) {
+    cell_offsets_[cell + 1] += cell_offsets_[cell];
+  }
+
+  Array<int> cell_fill(cell_offsets_.as_span().drop_back(1));
+  sorted_positions_.reinitialize(positions.size());
+  sorted_indices_.reinitialize(positions.size());
+  for (const int i : positions.index_range()) {
+    const int sorted_index = cell_fill[point_cells[i]]++;
+    sorted_positions_[sorted_index] = positions[i];
+    sorted_indices_[sorted_index] = i;
+  }
+}
+
+int PointGrid::cell_coord(const float3 &position, const int axis) const
+{
+  const float coord = (position[axis] - min_[axis]) / cell_size_;
+  /* Positions outside of the grid (and NaN) are clamped to the closest cell. */
+  if (!(coord > 0.0f)) {
+    return 0;
+  }
+  if (coord >= float(cells_num_[axis] - 1)) {
+    return cells_num_[axis] - 1;
+  }
+  return int(coord);
+}
+
+int PointGrid::find_nearest_sorted(const float3 &position, float &r_distance_sq) const
+{
+  int center[3];
+  for (const int axis : IndexRange(3)) {
+    center[axis] = this->cell_coord(position, axis);
+  }
+
+  int nearest_index = -1;
+  float nearest_distance_sq = FLT_MAX;
+  auto visit_cell = [&](const int x, const int y, const int z) {
+    const int cell = x + cells_num_[0] * (y + cells_num_[1] * z);
+    for (int i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; i++) {
+      const float distance_sq = float3::distance_squared(position, sorted_positions_[i]);
+      if (distance_sq < nearest_distance_sq) {
+        nearest_distance_sq = distance_sq;
+        nearest_index = i;
+      }
+    }
+  };
+
+  /* Visit growing boxes of cells around the center cell, until all points outside of the box are
+   * known to be farther away than the closest point found so far. */
+  for (int radius = 0;; radius++) {
+    int start[3], end[3];
+    for (const int axis : IndexRange(3)) {
+      start[axis] = std::max(center[axis] - radius, 0);
+      end[axis] = std::min(center[axis] + radius, cells_num_[axis] - 1);
+    }
+
+    /* Only the cells on the surface of the box are visited, the cells inside of it have been
+     * visited for smaller boxes already. */
+    for (int z = start[2]; z <= end[2]; z++) {
+      for (int y = start[1]; y <= end[1]; y++) {
+        if (std::abs(z - center[2]) == radius || std::abs(y - center[1]) == radius) {
+          for (int x = start[0]; x <= end[0]; x++) {
+            visit_cell(x, y, z);
+          }
+        }
+        else {
+          if (center[0] - radius >= 0) {
+            visit_cell(center[0] - radius, y, z);
+          }
+          if (center[0] + radius < cells_num_[0]) {
+            visit_cell(center[0] + radius, y, z);
+          }
+        }
+      }
+    }
+
+    bool box_contains_grid = true;
+    float distance_to_outside = FLT_MAX;
+    for (const int axis : IndexRange(3)) {
+      if (center[axis] - radius > 0) {
+        box_contains_grid = false;
+        const float face = min_[axis] + (center[axis] - radius) * cell_size_;
+        distance_to_outside = std::min(distance_to_outside, position[axis] - face);
+      }
+      if (center[axis] + radius < cells_num_[axis] - 1) {
+        box_contains_grid = false;
+        const float face = min_[axis] + (center[axis] + radius + 1) * cell_size_;
+        distance_to_outside = std::min(distance_to_outside, face - position[axis]);
+      }
+    }
+    if (box_contains_grid) {
+      break;
+    }
+    if (distance_to_outside > 0.0f &&
+        nearest_distance_sq <= distance_to_outside * distance_to_outside) {
+      break;
+    }
+  }
+
+  /* No point is found for NaN or infinite positions, since no distance is smaller than the
+   * initial one then. */
+  r_distance_sq = (nearest_index == -1) ? FLT_MAX : nearest_distance_sq;
+  return nearest_index;
+}
+
+int PointGrid::find_nearest(const float3 &position,
+                            float *r_distance_sq,
+                            float3 *r_position) const
+{
+  if (this->is_empty()) {
+    if (r_distance_sq != nullptr) {
+      *r_distance_sq = FLT_MAX;
+    }
+    return -1;
+  }
+  float distance_sq;
+  const int sorted_index = this->find_nearest_sorted(position, distance_sq);
+  if (r_distance_sq != nullptr) {
+    *r_distance_sq = distance_sq;
+  }
+  if (sorted_index == -1) {
+    return -1;
+  }
+  if (r_position != nullptr) {
+    *r_position = sorted_positions_[sorted_index];
+  }
+  return sorted_indices_[sorted_index];
+}
+
+void PointGrid::find_nearest(const VArray<float3> &positions,
+                             MutableSpan<int> r_indices,
+                             MutableSpan<float> r_distances_sq,
+                             MutableSpan<float3> r_positions) const
+{
+  BLI_assert(r_indices.is_empty() || r_indices.size() == positions.size());
+  BLI_assert(r_distances_sq.is_empty() || r_distances_sq.size() == positions.size());
+  BLI_assert(r_positions.is_empty() || r_positions.size() == positions.size());
+  BLI_assert(!this->is_empty());
+
+  threading::parallel_for(positions.index_range(), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      const float3 position = positions[i];
+      float distance_sq;
+      const int sorted_index = this->find_nearest_sorted(position, distance_sq);
+      if (!r_indices.is_empty()) {
+        r_indices[i] = (sorted_index == -1) ? -1 : sorted_indices_[sorted_index];
+      }
+      if (!r_distances_sq.is_empty()) {
+        r_distances_sq[i] = distance_sq;
+      }
+      if (!r_positions.is_empty()) {
+        r_positions[i] = (sorted_index == -1) ? position : sorted_positions_[sorted_index];
+      }
+    }
+  });
+}
+
+}  // namespace blender
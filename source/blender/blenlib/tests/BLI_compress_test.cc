@@ -0,0 +1,62 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_compress.h"
+#include "BLI_rand.hh"
+
+namespace blender::tests {
+
+TEST(compress, RoundTrip)
+{
+  /* Mix of compressible, random and empty buffers. */
+  Array<float> positions(10000);
+  for (const int i : positions.index_range()) {
+    positions[i] = (float)(i / 3) * 0.5f;
+  }
+  Array<int> noise(1000);
+  RandomNumberGenerator rng(1);
+  for (int &value : noise) {
+    value = (int)rng.get_uint32();
+  }
+
+  const void *buffers[3] = {positions.data(), nullptr, noise.data()};
+  const size_t sizes[3] = {sizeof(float) * positions.size(), 0, sizeof(int) * noise.size()};
+
+  size_t compressed_size = 0;
+  void *compressed = BLI_compress_buffers(buffers, sizes, 3, &compressed_size);
+  ASSERT_NE(compressed, nullptr);
+  EXPECT_LT(compressed_size, sizes[0] + sizes[2]);
+
+  Array<float> positions_result(positions.size());
+  Array<int> noise_result(noise.size());
+  void *result_buffers[3] = {positions_result.data(), nullptr, noise_result.data()};
+  EXPECT_TRUE(BLI_decompress_buffers(compressed, compressed_size, result_buffers, sizes, 3));
+  EXPECT_EQ(positions.as_span(), positions_result.as_span());
+  EXPECT_EQ(noise.as_span(), noise_result.as_span());
+
+  /* Sizes that don't match the compressed data. */
+  const size_t sizes_wrong[3] = {sizes[0], 0, sizes[2] - sizeof(int)};
+  EXPECT_FALSE(
+      BLI_decompress_buffers(compressed, compressed_size, result_buffers, sizes_wrong, 3));
+
+  MEM_freeN(compressed);
+}
+
+TEST(compress, Incompressible)
+{
+  Array<int> noise(100);
+  RandomNumberGenerator rng(2);
+  for (int &value : noise) {
+    value = (int)rng.get_uint32();
+  }
+  const void *buffers[1] = {noise.data()};
+  const size_t sizes[1] = {sizeof(int) * noise.size()};
+  size_t compressed_size = 0;
+  EXPECT_EQ(BLI_compress_buffers(buffers, sizes, 1, &compressed_size), nullptr);
+}
+
+}  // namespace blender::tests
@@ -10,6 +10,7 @@
 #include "BLI_kdopbvh.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.h"
+#include "BLI_timeit.hh"
 
 /* -------------------------------------------------------------------- */
 /* Helper Functions */
@@ -132,3 +133,243 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+static void nearest_point_callback(void *userdata,
+                                   int index,
+                                   const float co[3],
+                                   BVHTreeNearest *nearest)
+{
+  float(*points)[3] = (float(*)[3])userdata;
+  const float dist_sq = len_squared_v3v3(co, points[index]);
+  if (dist_sq < nearest->dist_sq) {
+    nearest->index = index;
+    nearest->dist_sq = dist_sq;
+    copy_v3_v3(nearest->co, points[index]);
+  }
+}
+
+static BVHTree *points_tree_create(float (*points)[3], int points_len, float epsilon, RNG *rng)
+{
+  BVHTree *tree = BLI_bvhtree_new(points_len, epsilon, 4, 6);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+  return tree;
+}
+
+/**
+ * Batched queries must find the same elements as single queries.
+ */
+static void find_nearest_batch_test(int points_len, int queries_len, bool use_callback, int flag)
+{
+  RNG *rng = BLI_rng_new(points_len);
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTree *tree = points_tree_create(points, points_len, 0.0f, rng);
+
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(BVHTreeNearest) * queries_len,
+                                                          __func__);
+  for (int i = 0; i < queries_len; i++) {
+    rng_v3_round(queries[i], 3, rng, 1000000, 1.2f);
+    nearest[i].index = -1;
+    /* Limit the search distance of some queries. */
+    nearest[i].dist_sq = (i % 7 == 0) ? 0.001f : FLT_MAX;
+  }
+
+  BVHTree_NearestPointCallback callback = use_callback ? nearest_point_callback : nullptr;
+  BLI_bvhtree_find_nearest_batch(tree, queries, queries_len, nearest, callback, points, flag);
+
+  for (int i = 0; i < queries_len; i++) {
+    BVHTreeNearest expected;
+    expected.index = -1;
+    expected.dist_sq = (i % 7 == 0) ? 0.001f : FLT_MAX;
+    BLI_bvhtree_find_nearest_ex(tree, queries[i], &expected, callback, points, flag);
+    EXPECT_EQ(nearest[i].index, expected.index);
+    EXPECT_EQ(nearest[i].dist_sq, expected.dist_sq);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(nearest);
+}
+
+TEST(kdopbvh, FindNearestBatch_1)
+{
+  find_nearest_batch_test(1, 10, false, 0);
+}
+TEST(kdopbvh, FindNearestBatch_500)
+{
+  find_nearest_batch_test(500, 5000, false, 0);
+}
+TEST(kdopbvh, FindNearestBatchCallback_500)
+{
+  find_nearest_batch_test(500, 5000, true, 0);
+}
+TEST(kdopbvh, OptimalFindNearestBatch_500)
+{
+  find_nearest_batch_test(500, 5000, true, BVH_NEAREST_OPTIMAL_ORDER);
+}
+
+static void ray_cast_batch_test(int points_len, int rays_len, float radius)
+{
+  RNG *rng = BLI_rng_new(points_len);
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTree *tree = points_tree_create(points, points_len, 0.01f, rng);
+
+  float(*origins)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+  float(*directions)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+  BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(BVHTreeRayHit) * rays_len, __func__);
+  for (int i = 0; i < rays_len; i++) {
+    rng_v3_round(origins[i], 3, rng, 1000000, 1.5f);
+    BLI_rng_get_float_unit_v3(rng, directions[i]);
+    /* Some axis aligned rays. */
+    if (i % 5 == 0) {
+      zero_v3(directions[i]);
+      directions[i][i % 3] = (i % 2) ? 1.0f : -1.0f;
+    }
+    hits[i].index = -1;
+    hits[i].dist = (i % 3 == 0) ? 0.5f : BVH_RAYCAST_DIST_MAX;
+  }
+
+  BLI_bvhtree_ray_cast_batch(tree,
+                             origins,
+                             directions,
+                             rays_len,
+                             radius,
+                             hits,
+                             nullptr,
+                             nullptr,
+                             BVH_RAYCAST_DEFAULT);
+
+  int hits_num = 0;
+  for (int i = 0; i < rays_len; i++) {
+    BVHTreeRayHit expected;
+    expected.index = -1;
+    expected.dist = (i % 3 == 0) ? 0.5f : BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast(tree, origins[i], directions[i], radius, &expected, nullptr, nullptr);
+    EXPECT_EQ(hits[i].index, expected.index);
+    EXPECT_EQ(hits[i].dist, expected.dist);
+    hits_num += (hits[i].index != -1);
+  }
+  EXPECT_GT(hits_num, 0);
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(origins);
+  MEM_freeN(directions);
+  MEM_freeN(hits);
+}
+
+TEST(kdopbvh, RayCastBatch_1)
+{
+  ray_cast_batch_test(1, 3, 0.0f);
+}
+TEST(kdopbvh, RayCastBatch_2000)
+{
+  ray_cast_batch_test(2000, 5000, 0.0f);
+}
+TEST(kdopbvh, RayCastBatchRadius_2000)
+{
+  ray_cast_batch_test(2000, 5000, 0.01f);
+}
+
+/**
+ * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
+ */
+#if 0
+static void nearest_batch_benchmark(int points_len, int queries_len)
+{
+  RNG *rng = BLI_rng_new(0);
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTree *tree = points_tree_create(points, points_len, 0.0f, rng);
+
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(BVHTreeNearest) * queries_len,
+                                                          __func__);
+  for (int i = 0; i < queries_len; i++) {
+    rng_v3_round(queries[i], 3, rng, 1000000, 1.0f);
+  }
+
+  const std::string name = std::to_string(queries_len) + " queries in " +
+                           std::to_string(points_len) + " points";
+  {
+    SCOPED_TIMER("find_nearest " + name);
+    for (int i = 0; i < queries_len; i++) {
+      nearest[i].index = -1;
+      nearest[i].dist_sq = FLT_MAX;
+      BLI_bvhtree_find_nearest(tree, queries[i], &nearest[i], nearest_point_callback, points);
+    }
+  }
+  {
+    SCOPED_TIMER("find_nearest_batch " + name);
+    for (int i = 0; i < queries_len; i++) {
+      nearest[i].index = -1;
+      nearest[i].dist_sq = FLT_MAX;
+    }
+    BLI_bvhtree_find_nearest_batch(
+        tree, queries, queries_len, nearest, nearest_point_callback, points, 0);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(nearest);
+}
+
+static void ray_cast_batch_benchmark(int points_len, int rays_len)
+{
+  RNG *rng = BLI_rng_new(0);
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTree *tree = points_tree_create(points, points_len, 0.001f, rng);
+
+  float(*origins)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+  float(*directions)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+  BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(BVHTreeRayHit) * rays_len, __func__);
+  for (int i = 0; i < rays_len; i++) {
+    rng_v3_round(origins[i], 3, rng, 1000000, 1.0f);
+    origins[i][2] = 2.0f;
+    copy_v3_fl3(directions[i], 0.0f, 0.0f, -1.0f);
+  }
+
+  const std::string name = std::to_string(rays_len) + " rays in " + std::to_string(points_len) +
+                           " points";
+  {
+    SCOPED_TIMER("ray_cast " + name);
+    for (int i = 0; i < rays_len; i++) {
+      hits[i].index = -1;
+      hits[i].dist = BVH_RAYCAST_DIST_MAX;
+      BLI_bvhtree_ray_cast(tree, origins[i], directions[i], 0.0f, &hits[i], nullptr, nullptr);
+    }
+  }
+  {
+    SCOPED_TIMER("ray_cast_batch " + name);
+    for (int i = 0; i < rays_len; i++) {
+      hits[i].index = -1;
+      hits[i].dist = BVH_RAYCAST_DIST_MAX;
+    }
+    BLI_bvhtree_ray_cast_batch(
+        tree, origins, directions, rays_len, 0.0f, hits, nullptr, nullptr, BVH_RAYCAST_DEFAULT);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(origins);
+  MEM_freeN(directions);
+  MEM_freeN(hits);
+}
+
+TEST(kdopbvh, BatchBenchmark)
+{
+  for (int i = 0; i < 3; i++) {
+    nearest_batch_benchmark(100000, 1000000);
+    ray_cast_batch_benchmark(100000, 1000000);
+  }
+}
+#endif /* Benchmark */
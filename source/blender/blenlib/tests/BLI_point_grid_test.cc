@@ -0,0 +1,131 @@
+/* Apache License, Version 2.0 */
+
+#include "BLI_point_grid.hh"
+#include "BLI_rand.hh"
+
+#include "testing/testing.h"
+
+namespace blender::tests {
+
+static int find_nearest_brute_force(Span<float3> points, const float3 &position)
+{
+  int nearest = -1;
+  float nearest_distance_sq = FLT_MAX;
+  for (const int i : points.index_range()) {
+    const float distance_sq = float3::distance_squared(points[i], position);
+    if (distance_sq < nearest_distance_sq) {
+      nearest_distance_sq = distance_sq;
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
+static void test_against_brute_force(Span<float3> points, Span<float3> positions)
+{
+  PointGrid grid(points);
+  EXPECT_EQ(grid.size(), points.size());
+  for (const float3 &position : positions) {
+    float distance_sq;
+    const int nearest = grid.find_nearest(position, &distance_sq);
+    const int expected = find_nearest_brute_force(points, position);
+    ASSERT_NE(nearest, -1);
+    EXPECT_FLOAT_EQ(distance_sq, float3::distance_squared(points[expected], position));
+  }
+}
+
+TEST(point_grid, Empty)
+{
+  PointGrid grid(Span<float3>{});
+  EXPECT_TRUE(grid.is_empty());
+  float distance_sq;
+  EXPECT_EQ(grid.find_nearest({1.0f, 2.0f, 3.0f}, &distance_sq), -1);
+  EXPECT_EQ(distance_sq, FLT_MAX);
+}
+
+TEST(point_grid, SinglePoint)
+{
+  Array<float3> points = {{1.0f, 2.0f, 3.0f}};
+  PointGrid grid(points);
+  float distance_sq;
+  float3 nearest_position;
+  EXPECT_EQ(grid.find_nearest({1.0f, 2.0f, 5.0f}, &distance_sq, &nearest_position), 0);
+  EXPECT_FLOAT_EQ(distance_sq, 4.0f);
+  EXPECT_EQ(nearest_position, points[0]);
+}
+
+TEST(point_grid, NonFinitePosition)
+{
+  Array<float3> points = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+  PointGrid grid(points);
+  float distance_sq;
+  float3 nearest_position{2.0f, 2.0f, 2.0f};
+  EXPECT_EQ(grid.find_nearest({NAN, 0.0f, 0.0f}, &distance_sq, &nearest_position), -1);
+  EXPECT_EQ(distance_sq, FLT_MAX);
+  EXPECT_EQ(nearest_position, float3(2.0f, 2.0f, 2.0f));
+  EXPECT_EQ(grid.find_nearest({INFINITY, 0.0f, 0.0f}, &distance_sq), -1);
+
+  Array<float3> positions = {{NAN, NAN, NAN}, {0.1f, 0.0f, 0.0f}};
+  Array<int> indices(positions.size());
+  Array<float> distances_sq(positions.size());
+  grid.find_nearest(VArray_For_Span<float3>(positions), indices, distances_sq);
+  EXPECT_EQ(indices[0], -1);
+  EXPECT_EQ(distances_sq[0], FLT_MAX);
+  EXPECT_EQ(indices[1], 0);
+}
+
+TEST(point_grid, RandomPoints)
+{
+  RandomNumberGenerator rng(42);
+  Array<float3> points(2000);
+  for (float3 &point : points) {
+    point = {rng.get_float(), rng.get_float() * 10.0f, rng.get_float() * 0.1f};
+  }
+  /* Query positions inside and far outside of the bounds of the points. */
+  Array<float3> positions(500);
+  for (float3 &position : positions) {
+    position = {rng.get_float() * 30.0f - 15.0f, rng.get_float() * 30.0f - 15.0f, 0.0f};
+  }
+  test_against_brute_force(points, positions);
+}
+
+TEST(point_grid, FlatPoints)
+{
+  RandomNumberGenerator rng(7);
+  Array<float3> points(1000);
+  for (float3 &point : points) {
+    point = {rng.get_float(), 0.0f, rng.get_float() * 1e-7f};
+  }
+  /* Add duplicate points. */
+  points[10] = points[20];
+  Array<float3> positions(200);
+  for (float3 &position : positions) {
+    position = {rng.get_float() * 2.0f - 0.5f, rng.get_float() - 0.5f, rng.get_float()};
+  }
+  test_against_brute_force(points, positions);
+}
+
+TEST(point_grid, FindNearestParallel)
+{
+  Array<float3> points(10000);
+  for (const int i : points.index_range()) {
+    points[i] = {float(i % 100), float(i / 100), 0.0f};
+  }
+  PointGrid grid(points);
+
+  Array<float3> positions(5000);
+  for (const int i : positions.index_range()) {
+    positions[i] = points[i * 2] + float3(0.1f, -0.2f, 0.3f);
+  }
+  Array<int> indices(positions.size());
+  Array<float> distances_sq(positions.size());
+  Array<float3> nearest_positions(positions.size());
+  grid.find_nearest(VArray_For_Span<float3>(positions), indices, distances_sq, nearest_positions);
+  for (const int i : positions.index_range()) {
+    EXPECT_EQ(indices[i], i * 2);
+    EXPECT_NEAR(distances_sq[i], 0.14f, 1e-4f);
+    EXPECT_EQ(nearest_positions[i], points[i * 2]);
+  }
+}
+
+}  // namespace blender::tests
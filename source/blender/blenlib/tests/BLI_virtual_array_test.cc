@@ -118,6 +118,31 @@ TEST(virtual_array, AsSpan)
   EXPECT_EQ(span[6], 60);
 }
 
+TEST(virtual_array, SpanOrSingle)
+{
+  auto func = [](int64_t index) { return (int)(10 * index); };
+  VArray_For_Func<int, decltype(func)> func_varray{10, func};
+  VArray_SpanOrSingle<int> func_span_or_single{func_varray};
+  EXPECT_TRUE(func_span_or_single.is_span());
+  EXPECT_FALSE(func_span_or_single.is_single());
+  EXPECT_EQ(func_span_or_single.size(), 10);
+  EXPECT_EQ(func_span_or_single[3], 30);
+  EXPECT_EQ(func_span_or_single.get_internal_span()[6], 60);
+
+  std::array<int, 3> data = {3, 4, 5};
+  VArray_For_Span<int> span_varray{data};
+  VArray_SpanOrSingle<int> span_span_or_single{span_varray};
+  EXPECT_TRUE(span_span_or_single.is_span());
+  EXPECT_EQ(span_span_or_single.get_internal_span().data(), data.data());
+
+  VArray_For_Single<int> single_varray{7, 10};
+  VArray_SpanOrSingle<int> single_span_or_single{single_varray};
+  EXPECT_FALSE(single_span_or_single.is_span());
+  EXPECT_TRUE(single_span_or_single.is_single());
+  EXPECT_EQ(single_span_or_single.get_internal_single(), 7);
+  EXPECT_EQ(single_span_or_single[9], 7);
+}
+
 static int get_x(const std::array<int, 3> &item)
 {
   return item[0];
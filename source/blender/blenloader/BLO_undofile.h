@@ -41,11 +41,16 @@ typedef struct {
   /** Session UUID of the ID being currently written (MAIN_ID_SESSION_UUID_UNSET when not writing
    * ID-related data). Used to find matching chunks in previous memundo step. */
   uint id_session_uuid;
+  /** When true, `buf` is NULL and the data is stored in #MemFile.compressed. */
+  bool is_compressed;
 } MemFileChunk;
 
 typedef struct MemFile {
   ListBase chunks;
   size_t size;
+  /** Data of all compressed chunks, see #BLO_memfile_compress. */
+  void *compressed;
+  size_t compressed_size;
 } MemFile;
 
 typedef struct MemFileWriteData {
@@ -78,6 +83,8 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
 extern void BLO_memfile_clear_future(MemFile *memfile);
+extern void BLO_memfile_compress(MemFile *memfile, const MemFile *memfile_next);
+extern void BLO_memfile_decompress(MemFile *memfile);
 
 /* utilities */
 extern struct Main *BLO_memfile_main_get(struct MemFile *memfile,
@@ -1579,6 +1579,8 @@ FileData *blo_filedata_from_memfile(MemFile *memfile,
     BKE_report(reports, RPT_WARNING, "Unable to open blend <memory>");
     return NULL;
   }
+  /* Compressed undo steps are restored by the undo system before they are read. */
+  BLI_assert(memfile->compressed == NULL);
 
   FileData *fd = filedata_new();
   fd->memfile = memfile;
@@ -41,6 +41,7 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_compress.h"
 #include "BLI_ghash.h"
 
 #include "BLO_readfile.h"
@@ -60,11 +61,13 @@ void BLO_memfile_free(MemFile *memfile)
   MemFileChunk *chunk;
 
   while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_identical == false && chunk->is_compressed == false) {
       MEM_freeN((void *)chunk->buf);
     }
     MEM_freeN(chunk);
   }
+  MEM_SAFE_FREE(memfile->compressed);
+  memfile->compressed_size = 0;
   memfile->size = 0;
 }
 
@@ -87,7 +90,8 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
   /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
    * it is also used by the second memfile, transfer the ownership. */
   for (MemFileChunk *fc = first->chunks.first; fc != NULL; fc = fc->next) {
-    if (!fc->is_identical) {
+    /* Compressed chunks are never shared, see #BLO_memfile_compress. */
+    if (!fc->is_identical && !fc->is_compressed) {
       MemFileChunk *sc = BLI_ghash_lookup(buffer_to_second_memchunk, fc->buf);
       if (sc != NULL) {
         BLI_assert(sc->is_identical);
@@ -113,6 +117,113 @@ void BLO_memfile_clear_future(MemFile *memfile)
   }
 }
 
+/**
+ * Compress the chunks owned by \a memfile into a single buffer, to reduce the memory used by undo
+ * steps that aren't active. Chunks shared with \a memfile_next (which may be NULL) are kept as is,
+ * since reading the next step still needs them.
+ *
+ * Chunks can only be shared with the next memfile, when later memfiles share a buffer they
+ * always do so through the next one.
+ */
+void BLO_memfile_compress(MemFile *memfile, const MemFile *memfile_next)
+{
+  BLI_assert(memfile->compressed == NULL);
+
+  GSet *buffers_next = BLI_gset_ptr_new(__func__);
+  if (memfile_next != NULL) {
+    LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile_next->chunks) {
+      if (chunk->is_identical) {
+        BLI_gset_add(buffers_next, (void *)chunk->buf);
+      }
+    }
+  }
+
+  int chunks_num = 0;
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+    if (!chunk->is_identical && !BLI_gset_haskey(buffers_next, chunk->buf)) {
+      chunks_num++;
+    }
+  }
+
+  if (chunks_num > 0) {
+    MemFileChunk **chunks = MEM_malloc_arrayN((size_t)chunks_num, sizeof(*chunks), __func__);
+    const void **buffers = MEM_malloc_arrayN((size_t)chunks_num, sizeof(*buffers), __func__);
+    size_t *sizes = MEM_malloc_arrayN((size_t)chunks_num, sizeof(*sizes), __func__);
+    int i = 0;
+    LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+      if (!chunk->is_identical && !BLI_gset_haskey(buffers_next, chunk->buf)) {
+        chunks[i] = chunk;
+        buffers[i] = chunk->buf;
+        sizes[i] = chunk->size;
+        i++;
+      }
+    }
+
+    size_t compressed_size;
+    void *compressed = BLI_compress_buffers(buffers, sizes, chunks_num, &compressed_size);
+    if (compressed != NULL) {
+      for (i = 0; i < chunks_num; i++) {
+        MEM_freeN((void *)chunks[i]->buf);
+        chunks[i]->buf = NULL;
+        chunks[i]->is_compressed = true;
+        memfile->size -= sizes[i];
+      }
+      memfile->compressed = compressed;
+      memfile->compressed_size = compressed_size;
+      memfile->size += compressed_size;
+    }
+
+    MEM_freeN(chunks);
+    MEM_freeN(buffers);
+    MEM_freeN(sizes);
+  }
+
+  BLI_gset_free(buffers_next, NULL);
+}
+
+/** Restore the chunks compressed by #BLO_memfile_compress. */
+void BLO_memfile_decompress(MemFile *memfile)
+{
+  if (memfile->compressed == NULL) {
+    return;
+  }
+
+  int chunks_num = 0;
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+    if (chunk->is_compressed) {
+      chunks_num++;
+    }
+  }
+
+  void **buffers = MEM_malloc_arrayN((size_t)chunks_num, sizeof(*buffers), __func__);
+  size_t *sizes = MEM_malloc_arrayN((size_t)chunks_num, sizeof(*sizes), __func__);
+  int i = 0;
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+    if (chunk->is_compressed) {
+      void *buf_new = MEM_mallocN(chunk->size, "Chunk buffer");
+      chunk->buf = buf_new;
+      chunk->is_compressed = false;
+      buffers[i] = buf_new;
+      sizes[i] = chunk->size;
+      memfile->size += chunk->size;
+      i++;
+    }
+  }
+
+  const bool ok = BLI_decompress_buffers(
+      memfile->compressed, memfile->compressed_size, buffers, sizes, chunks_num);
+  BLI_assert(ok);
+  UNUSED_VARS_NDEBUG(ok);
+
+  memfile->size -= memfile->compressed_size;
+  MEM_freeN(memfile->compressed);
+  memfile->compressed = NULL;
+  memfile->compressed_size = 0;
+
+  MEM_freeN(buffers);
+  MEM_freeN(sizes);
+}
+
 void BLO_memfile_write_init(MemFileWriteData *mem_data,
                             MemFile *written_memfile,
                             MemFile *reference_memfile)
@@ -168,11 +279,14 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
   curchunk->is_identical_future = true;
   curchunk->id_session_uuid = mem_data->current_id_session_uuid;
+  curchunk->is_compressed = false;
   BLI_addtail(&memfile->chunks, curchunk);
 
   /* we compare compchunk with buf */
   if (*compchunk_step != NULL) {
     MemFileChunk *compchunk = *compchunk_step;
+    /* The reference memfile must have been decompressed by the undo system. */
+    BLI_assert(!compchunk->is_compressed);
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
         curchunk->buf = compchunk->buf;
@@ -231,6 +345,9 @@ bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
    * we may want to allow writing to symlinks.
    */
 
+  /* Only the active undo step is written, which is never compressed. */
+  BLI_assert(memfile->compressed == NULL);
+
   oflags = O_BINARY | O_WRONLY | O_CREAT | O_TRUNC;
 #ifdef O_NOFOLLOW
   /* use O_NOFOLLOW to avoid writing to a symlink - use 'O_EXCL' (CVE-2008-1103) */
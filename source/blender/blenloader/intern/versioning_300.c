@@ -403,5 +403,18 @@ void blo_do_versions_300(FileData *fd, Library *UNUSED(lib), Main *bmain)
    */
   {
     /* Keep this block, even when empty. */
+
+    if (!DNA_struct_elem_find(fd->filesdna, "NodesModifierData", "int", "bake_frame_start")) {
+      LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+        LISTBASE_FOREACH (ModifierData *, md, &ob->modifiers) {
+          if (md->type == eModifierType_Nodes) {
+            NodesModifierData *nmd = (NodesModifierData *)md;
+            STRNCPY(nmd->bake_directory, "//geometry_nodes_cache/");
+            nmd->bake_frame_start = 1;
+            nmd->bake_frame_end = 250;
+          }
+        }
+      }
+    }
   }
 }
@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_CachedOperationBuffers.h"
+
+namespace blender::compositor {
+
+CachedOperationBuffers::CachedOperationBuffers() : mem_in_use_(0), max_mem_(0), execution_(0)
+{
+}
+
+/**
+ * Sets maximum memory in bytes used by cached buffers. Exceeding buffers are freed on next add.
+ */
+void CachedOperationBuffers::set_max_memory(const size_t max_mem)
+{
+  max_mem_ = max_mem;
+}
+
+/**
+ * Starts a new execution. Buffers used during an execution are not freed until it has finished
+ * so that they can be safely read.
+ */
+void CachedOperationBuffers::begin_execution()
+{
+  execution_++;
+}
+
+/**
+ * Get cached buffer of an operation with given hash.
+ * \return nullptr when no buffer is cached.
+ */
+const MemoryBuffer *CachedOperationBuffers::lookup(const NodeOperationHash &hash)
+{
+  CachedBuffer *cached = buffers_.lookup_ptr(hash);
+  if (cached == nullptr) {
+    return nullptr;
+  }
+  cached->last_execution = execution_;
+  return cached->buffer.get();
+}
+
+/**
+ * Caches a copy of given operation buffer. It's not cached when memory can't be freed without
+ * freeing buffers in use by current execution.
+ */
+void CachedOperationBuffers::add(const NodeOperationHash &hash, const MemoryBuffer &buffer)
+{
+  BLI_assert(!buffer.is_a_single_elem());
+  const size_t mem_size = sizeof(float) * buffer.get_memory_width() * buffer.get_memory_height() *
+                          buffer.get_num_channels();
+  if (buffers_.contains(hash) || !free_memory(mem_size)) {
+    return;
+  }
+
+  CachedBuffer cached;
+  cached.buffer = std::make_unique<MemoryBuffer>(buffer);
+  cached.mem_size = mem_size;
+  cached.last_execution = execution_;
+  buffers_.add_new(hash, std::move(cached));
+  mem_in_use_ += mem_size;
+}
+
+void CachedOperationBuffers::clear()
+{
+  buffers_.clear();
+  mem_in_use_ = 0;
+}
+
+/**
+ * Frees least recently used buffers until given memory size fits within memory limit.
+ * \return false when there is not enough memory that can be freed.
+ */
+bool CachedOperationBuffers::free_memory(const size_t mem_size)
+{
+  if (mem_size > max_mem_) {
+    return false;
+  }
+
+  while (mem_in_use_ + mem_size > max_mem_) {
+    const NodeOperationHash *lru_hash = nullptr;
+    int lru_execution = execution_;
+    for (auto item : buffers_.items()) {
+      if (item.value.last_execution < lru_execution) {
+        lru_hash = &item.key;
+        lru_execution = item.value.last_execution;
+      }
+    }
+    if (lru_hash == nullptr) {
+      /* All cached buffers are in use by current execution. */
+      return false;
+    }
+
+    const NodeOperationHash hash = *lru_hash;
+    mem_in_use_ -= buffers_.lookup(hash).mem_size;
+    buffers_.remove_contained(hash);
+  }
+  return true;
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,73 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+#include <memory>
+
+namespace blender::compositor {
+
+/**
+ * Keeps operations rendered buffers between executions keyed by their #NodeOperationHash. When
+ * editing a node tree only the operations whose hash changed need to be rendered again, the rest
+ * are copied from cache. Least recently used buffers are freed once the memory limit is exceeded.
+ */
+class CachedOperationBuffers {
+ private:
+  typedef struct CachedBuffer {
+   public:
+    std::unique_ptr<MemoryBuffer> buffer;
+    size_t mem_size;
+    /** Execution the buffer was last used in. */
+    int last_execution;
+  } CachedBuffer;
+  blender::Map<NodeOperationHash, CachedBuffer> buffers_;
+
+  size_t mem_in_use_;
+  size_t max_mem_;
+  int execution_;
+
+ public:
+  CachedOperationBuffers();
+
+  void set_max_memory(size_t max_mem);
+  size_t get_memory_in_use() const
+  {
+    return mem_in_use_;
+  }
+
+  void begin_execution();
+  const MemoryBuffer *lookup(const NodeOperationHash &hash);
+  void add(const NodeOperationHash &hash, const MemoryBuffer &buffer);
+  void clear();
+
+ private:
+  bool free_memory(size_t mem_size);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:CachedOperationBuffers")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -41,7 +41,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bool fastcalculation,
                                  const ColorManagedViewSettings *viewSettings,
                                  const ColorManagedDisplaySettings *displaySettings,
-                                 const char *viewName)
+                                 const char *viewName,
+                                 CachedOperationBuffers *cached_buffers)
 {
   this->m_context.setViewName(viewName);
   this->m_context.setScene(scene);
@@ -73,7 +74,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
       execution_model_ = new TiledExecutionModel(m_context, m_operations, m_groups);
       break;
     case eExecutionModel::FullFrame:
-      execution_model_ = new FullFrameExecutionModel(m_context, active_buffers_, m_operations);
+      execution_model_ = new FullFrameExecutionModel(
+          m_context, active_buffers_, cached_buffers, m_operations);
       break;
     default:
       BLI_assert(!"Non implemented execution model");
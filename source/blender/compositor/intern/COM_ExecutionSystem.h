@@ -25,6 +25,7 @@ class ExecutionGroup;
 #include "COM_ExecutionGroup.h"
 #include "COM_Node.h"
 #include "COM_NodeOperation.h"
+#include "COM_CachedOperationBuffers.h"
 #include "COM_SharedOperationBuffers.h"
 
 #include "DNA_color_types.h"
@@ -158,6 +159,7 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param cached_buffers: Buffers kept between executions, may be nullptr.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
@@ -166,7 +168,8 @@ class ExecutionSystem {
                   bool fastcalculation,
                   const ColorManagedViewSettings *viewSettings,
                   const ColorManagedDisplaySettings *displaySettings,
-                  const char *viewName);
+                  const char *viewName,
+                  CachedOperationBuffers *cached_buffers = nullptr);
 
   /**
    * Destructor
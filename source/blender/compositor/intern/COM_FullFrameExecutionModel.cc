@@ -32,9 +32,11 @@ namespace blender::compositor {
 
 FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  SharedOperationBuffers &shared_buffers,
+                                                 CachedOperationBuffers *cached_buffers,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
+      cached_buffers_(cached_buffers),
       num_operations_finished_(0),
       work_mutex_(),
       work_finished_cond_()
@@ -62,10 +64,100 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system);
 
+  determine_cached_operations();
   determine_areas_to_render_and_reads();
   render_operations(exec_system);
 }
 
+/**
+ * Finds operations which buffers were cached in previous executions, they won't be rendered.
+ */
+void FullFrameExecutionModel::determine_cached_operations()
+{
+  if (cached_buffers_ == nullptr) {
+    return;
+  }
+
+  cached_buffers_->begin_execution();
+  for (NodeOperation *op : operations_) {
+    if (!is_operation_cacheable(op)) {
+      continue;
+    }
+    const std::optional<NodeOperationHash> hash = hash_operation(op);
+    if (!hash) {
+      continue;
+    }
+    const MemoryBuffer *cached_buf = cached_buffers_->lookup(*hash);
+    if (cached_buf) {
+      cached_operations_.add_new(op, cached_buf);
+    }
+  }
+}
+
+/**
+ * Generates given operation hash including its inputs hashes recursively. Operations with any
+ * input not hashable are not hashable either.
+ */
+std::optional<NodeOperationHash> FullFrameExecutionModel::hash_operation(NodeOperation *op)
+{
+  const std::optional<NodeOperationHash> *computed_hash = operations_hashes_.lookup_ptr(op);
+  if (computed_hash) {
+    return *computed_hash;
+  }
+
+  std::optional<NodeOperationHash> hash = op->generate_hash();
+  const int num_inputs = op->getNumberOfInputSockets();
+  for (int i = 0; hash && i < num_inputs; i++) {
+    const std::optional<NodeOperationHash> input_hash = hash_operation(
+        op->get_input_operation(i));
+    if (input_hash) {
+      hash->add_input(*input_hash);
+    }
+    else {
+      hash.reset();
+    }
+  }
+
+  operations_hashes_.add_new(op, hash);
+  return hash;
+}
+
+/**
+ * Whether it's worth caching given operation buffer. Set operations are cheaper to render than
+ * copying them.
+ */
+bool FullFrameExecutionModel::is_operation_cacheable(NodeOperation *op)
+{
+  return op->getNumberOfOutputSockets() > 0 && !op->get_flags().is_set_operation;
+}
+
+/**
+ * Caches given operation rendered buffer for next executions. Only buffers rendered entirely and
+ * not cancelled are cached as cached operations are not rendered again.
+ */
+void FullFrameExecutionModel::cache_operation_buffer(NodeOperation *op,
+                                                     const MemoryBuffer *op_buf,
+                                                     Span<rcti> areas)
+{
+  if (cached_buffers_ == nullptr || !is_operation_cacheable(op) || is_breaked()) {
+    return;
+  }
+
+  const std::optional<NodeOperationHash> hash = operations_hashes_.lookup_default(op,
+                                                                                  std::nullopt);
+  if (!hash) {
+    return;
+  }
+
+  const rcti &op_rect = op_buf->get_rect();
+  for (const rcti &area : areas) {
+    if (BLI_rcti_inside_rcti(&area, &op_rect)) {
+      cached_buffers_->add(*hash, *op_buf);
+      return;
+    }
+  }
+}
+
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
 {
   const bool is_rendering = context_.isRendering();
@@ -109,12 +201,22 @@ MemoryBuffer *FullFrameExecutionModel::create_operation_buffer(NodeOperation *op
 
 void FullFrameExecutionModel::render_operation(NodeOperation *op, ExecutionSystem &exec_system)
 {
+  const MemoryBuffer *cached_buf = cached_operations_.lookup_default(op, nullptr);
+  if (cached_buf) {
+    active_buffers_.set_rendered_buffer(op, std::make_unique<MemoryBuffer>(*cached_buf));
+    operation_finished(op);
+    return;
+  }
+
   Vector<MemoryBuffer *> input_bufs = get_input_buffers(op);
 
   const bool has_outputs = op->getNumberOfOutputSockets() > 0;
   MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op) : nullptr;
   Span<rcti> areas = active_buffers_.get_areas_to_render(op);
   op->render(op_buf, areas, input_bufs, exec_system);
+  if (has_outputs) {
+    cache_operation_buffer(op, op_buf, areas);
+  }
   active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
 
   operation_finished(op);
@@ -141,9 +243,10 @@ void FullFrameExecutionModel::render_operations(ExecutionSystem &exec_system)
 
 /**
  * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
+ * several operations depend on it. Inputs of cached operations are not included.
  */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+static Vector<NodeOperation *> get_operation_dependencies(
+    NodeOperation *operation, const Map<NodeOperation *, const MemoryBuffer *> &cached_operations)
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -153,6 +256,9 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
+      if (cached_operations.contains(output)) {
+        continue;
+      }
       for (int i = 0; i < output->getNumberOfInputSockets(); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
@@ -170,7 +276,7 @@ void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_o
                                                          ExecutionSystem &exec_system)
 {
   BLI_assert(output_op->isOutputOperation(context_.isRendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
+  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op, cached_operations_);
   for (NodeOperation *op : dependencies) {
     if (!active_buffers_.is_operation_rendered(op)) {
       render_operation(op, exec_system);
@@ -197,6 +303,9 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
     }
 
     active_buffers_.register_area(operation, render_area);
+    if (cached_operations_.contains(operation)) {
+      continue;
+    }
 
     const int num_inputs = operation->getNumberOfInputSockets();
     for (int i = 0; i < num_inputs; i++) {
@@ -225,6 +334,9 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (cached_operations_.contains(operation)) {
+      continue;
+    }
     const int num_inputs = operation->getNumberOfInputSockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -332,8 +444,11 @@ void FullFrameExecutionModel::execute_work(const rcti &work_rect,
 
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
 {
-  /* Report inputs reads so that buffers may be freed/reused. */
-  const int num_inputs = operation->getNumberOfInputSockets();
+  /* Report inputs reads so that buffers may be freed/reused. Cached operations don't read
+   * their inputs. */
+  const int num_inputs = cached_operations_.contains(operation) ?
+                             0 :
+                             operation->getNumberOfInputSockets();
   for (int i = 0; i < num_inputs; i++) {
     active_buffers_.read_finished(operation->get_input_operation(i));
   }
@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include "COM_CachedOperationBuffers.h"
 #include "COM_ExecutionModel.h"
 
+#include <optional>
+
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
@@ -40,6 +43,22 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   SharedOperationBuffers &active_buffers_;
 
+  /**
+   * Buffers kept between executions. When nullptr no buffers are reused nor cached.
+   */
+  CachedOperationBuffers *cached_buffers_;
+
+  /**
+   * Operations hashes including their inputs. Not hashable operations have no value.
+   */
+  Map<NodeOperation *, std::optional<NodeOperationHash>> operations_hashes_;
+
+  /**
+   * Operations whose output is copied from cached buffers instead of being rendered. Their
+   * inputs are not rendered unless other operations need them.
+   */
+  Map<NodeOperation *, const MemoryBuffer *> cached_operations_;
+
   /**
    * Number of operations finished.
    */
@@ -56,6 +75,7 @@ class FullFrameExecutionModel : public ExecutionModel {
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
+                          CachedOperationBuffers *cached_buffers,
                           Span<NodeOperation *> operations);
   ~FullFrameExecutionModel();
 
@@ -65,6 +85,11 @@ class FullFrameExecutionModel : public ExecutionModel {
                     std::function<void(const rcti &split_rect)> work_func) override;
 
  private:
+  void determine_cached_operations();
+  std::optional<NodeOperationHash> hash_operation(NodeOperation *op);
+  bool is_operation_cacheable(NodeOperation *op);
+  void cache_operation_buffer(NodeOperation *op, const MemoryBuffer *op_buf, Span<rcti> areas);
+
   void determine_areas_to_render_and_reads();
   void render_operations(ExecutionSystem &exec_system);
   void render_output_dependencies(NodeOperation *output_op, ExecutionSystem &exec_system);
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_MultiThreadedRowOperation.h"
+
+#include "BLI_array.hh"
+
+namespace blender::compositor {
+
+/* Whether the input buffer has all elements of the given output row. */
+static bool input_covers_row(const MemoryBuffer &input, const rcti &output_rect, const int y)
+{
+  if (input.is_a_single_elem()) {
+    return true;
+  }
+  const rcti &rect = input.get_rect();
+  return output_rect.xmin >= rect.xmin && output_rect.xmax <= rect.xmax && y >= rect.ymin &&
+         y < rect.ymax;
+}
+
+void MultiThreadedRowOperation::update_memory_buffer_partial(
+    MemoryBuffer *output,
+    const rcti &output_rect,
+    blender::Span<MemoryBuffer *> inputs,
+    ExecutionSystem &UNUSED(exec_system),
+    int UNUSED(current_pass))
+{
+  BLI_assert(inputs.size() <= MAX_ROW_INPUTS);
+  const int width = BLI_rcti_size_x(&output_rect);
+  PixelCursor p;
+  p.out_stride = output->elem_stride;
+  p.num_inputs = inputs.size();
+
+  /* Inputs with another resolution than the output (e.g. when their resize mode is none) don't
+   * have all pixels of the output rows. Their pixels are read one by one into a row buffer, with
+   * transparent black outside of the input like in the tiled execution model. */
+  Array<float> input_rows[MAX_ROW_INPUTS];
+  for (int i = 0; i < p.num_inputs; i++) {
+    p.in_strides[i] = inputs[i]->elem_stride;
+    if (!input_covers_row(*inputs[i], output_rect, output_rect.ymin) ||
+        !input_covers_row(*inputs[i], output_rect, output_rect.ymax - 1)) {
+      input_rows[i].reinitialize(width * inputs[i]->get_num_channels());
+      p.in_strides[i] = inputs[i]->get_num_channels();
+    }
+  }
+
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    p.out = output->get_elem(output_rect.xmin, y);
+    p.row_end = p.out + width * p.out_stride;
+    for (int i = 0; i < p.num_inputs; i++) {
+      MemoryBuffer *input = inputs[i];
+      if (!input_rows[i].is_empty()) {
+        float *row = input_rows[i].data();
+        for (int x = output_rect.xmin; x < output_rect.xmax; x++) {
+          input->read(row, x, y);
+          row += p.in_strides[i];
+        }
+        p.ins[i] = input_rows[i].data();
+      }
+      else if (input->is_a_single_elem()) {
+        p.ins[i] = input->getBuffer();
+      }
+      else {
+        p.ins[i] = input->get_elem(output_rect.xmin, y);
+      }
+    }
+    update_memory_buffer_row(p);
+  }
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,72 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "COM_MultiThreadedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Full frame operation that processes its output area row by row. Subclasses only have to
+ * implement #update_memory_buffer_row, which receives a cursor with pointers to the first element
+ * of a row in the output and in every input buffer. Inner loops are free of virtual calls and
+ * coordinate calculations, letting the compiler vectorize them.
+ *
+ * Inputs are read directly from their buffers when they have all pixels of the output rows,
+ * single element inputs (set operations) have an element stride of 0. Inputs with a different
+ * resolution are read pixel by pixel into a row buffer first.
+ */
+class MultiThreadedRowOperation : public MultiThreadedOperation {
+ protected:
+  static constexpr int MAX_ROW_INPUTS = 6;
+
+  struct PixelCursor {
+    float *out;
+    int out_stride;
+    const float *row_end;
+    const float *ins[MAX_ROW_INPUTS];
+    int in_strides[MAX_ROW_INPUTS];
+    int num_inputs;
+
+    void next()
+    {
+      BLI_assert(out < row_end);
+      out += out_stride;
+      for (int i = 0; i < num_inputs; i++) {
+        ins[i] += in_strides[i];
+      }
+    }
+  };
+
+ protected:
+  /**
+   * Updates a single output row. Row bounds are given by the cursor: iterate while
+   * `p.out < p.row_end` calling `p.next()` after each element. Multi-threaded calls.
+   */
+  virtual void update_memory_buffer_row(PixelCursor &p) = 0;
+
+ private:
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    blender::Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) final;
+};
+
+}  // namespace blender::compositor
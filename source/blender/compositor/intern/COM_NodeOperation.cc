@@ -39,6 +39,8 @@ NodeOperation::NodeOperation()
   this->m_width = 0;
   this->m_height = 0;
   this->m_btree = nullptr;
+  this->m_params_hash = 0;
+  this->m_is_params_hashed = false;
 }
 
 NodeOperationOutput *NodeOperation::getOutputSocket(unsigned int index)
@@ -221,6 +223,43 @@ void NodeOperation::get_area_of_interest(NodeOperation *input_op,
   BLI_assert(!"input_op is not an input operation.");
 }
 
+bool NodeOperation::get_input_constant_value(const int input_op_idx, float &r_value)
+{
+  NodeOperation *input_op = getInputOperation(input_op_idx);
+  if (!input_op->get_flags().is_set_operation) {
+    return false;
+  }
+  float value[4];
+  input_op->readSampled(value, 0, 0, PixelSampler::Nearest);
+  r_value = value[0];
+  return true;
+}
+
+std::optional<NodeOperationHash> NodeOperation::generate_hash()
+{
+  m_params_hash = get_default_hash_2(m_width, m_height);
+  m_params_data.clear();
+  append_param_data(m_width);
+  append_param_data(m_height);
+
+  /* Hash subclasses parameters. */
+  m_is_params_hashed = true;
+  hash_output_params();
+  if (!m_is_params_hashed) {
+    return std::nullopt;
+  }
+
+  if (getNumberOfOutputSockets() > 0) {
+    hash_params(getOutputSocket()->getDataType());
+  }
+
+  NodeOperationHash hash;
+  hash.type_ = &typeid(*this);
+  hash.params_hash_ = m_params_hash;
+  hash.params_data_ = std::move(m_params_data);
+  return hash;
+}
+
 /**
  * Executes operation image manipulation algorithm rendering given areas.
  * \param output_buf: Buffer to write result to.
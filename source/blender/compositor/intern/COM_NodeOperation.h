@@ -19,12 +19,19 @@
 #pragma once
 
 #include <list>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 
+#include "BLI_ghash.h"
+#include "BLI_hash.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector.h"
+#include "BLI_string_ref.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "COM_Enums.h"
 #include "COM_MemoryBuffer.h"
@@ -261,6 +268,67 @@ struct NodeOperationFlags {
   }
 };
 
+/**
+ * Identifies an operation output by the operation type, its parameters, resolution and its
+ * inputs. Operations with equal hashes are expected to render equal outputs, which allows reusing
+ * buffers rendered in previous executions.
+ *
+ * Besides the hashes, the parameters values and the inputs are kept so that equality doesn't
+ * depend on the absence of hash collisions.
+ */
+class NodeOperationHash {
+ private:
+  const std::type_info *type_ = nullptr;
+  size_t params_hash_ = 0;
+  size_t inputs_hash_ = 0;
+  /** Bytes of all hashed parameters, in the order they were hashed. */
+  Vector<char> params_data_;
+  /** Inputs are shared, so copying a hash doesn't copy the hashes of all operations before it. */
+  Vector<std::shared_ptr<const NodeOperationHash>> inputs_;
+
+  friend class NodeOperation;
+
+ public:
+  /**
+   * Adds the hash of an input operation. Must be called in inputs sockets order.
+   */
+  void add_input(const NodeOperationHash &input_hash)
+  {
+    inputs_hash_ = BLI_ghashutil_combine_hash(inputs_hash_, input_hash.hash());
+    inputs_.append(std::make_shared<const NodeOperationHash>(input_hash));
+  }
+
+  uint64_t hash() const
+  {
+    return BLI_ghashutil_combine_hash(
+        BLI_ghashutil_combine_hash(type_->hash_code(), params_hash_), inputs_hash_);
+  }
+
+  bool operator==(const NodeOperationHash &other) const
+  {
+    if (params_hash_ != other.params_hash_ || inputs_hash_ != other.inputs_hash_) {
+      return false;
+    }
+    if (*type_ != *other.type_ || params_data_.as_span() != other.params_data_.as_span()) {
+      return false;
+    }
+    if (inputs_.size() != other.inputs_.size()) {
+      return false;
+    }
+    for (const int i : inputs_.index_range()) {
+      if (inputs_[i] != other.inputs_[i] && *inputs_[i] != *other.inputs_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator!=(const NodeOperationHash &other) const
+  {
+    return !(*this == other);
+  }
+};
+
 /**
  * \brief NodeOperation contains calculation logic
  *
@@ -295,6 +363,13 @@ class NodeOperation {
    */
   const bNodeTree *m_btree;
 
+  /**
+   * Parameters hash and data being generated by #generate_hash.
+   */
+  size_t m_params_hash;
+  Vector<char> m_params_data;
+  bool m_is_params_hashed;
+
  protected:
   /**
    * Compositor execution model.
@@ -590,11 +665,58 @@ class NodeOperation {
   virtual void get_area_of_interest(int input_op_idx, const rcti &output_area, rcti &r_input_area);
   void get_area_of_interest(NodeOperation *input_op, const rcti &output_area, rcti &r_input_area);
 
+  /**
+   * Get first channel of an input when it's a set operation. Allows knowing constant input
+   * values before execution (e.g. when calculating areas of interest).
+   * \return false when input is not constant.
+   */
+  bool get_input_constant_value(int input_op_idx, float &r_value);
+
+  /**
+   * Generates a hash of the operation type, parameters and resolution. Inputs hashes are not
+   * included, they have to be added with #NodeOperationHash::add_input.
+   * \return std::nullopt when the operation output can't be identified by its parameters.
+   */
+  std::optional<NodeOperationHash> generate_hash();
+
   /** \} */
 
  protected:
   NodeOperation();
 
+  /**
+   * Hashes all the parameters affecting the operation output using #hash_params. Operations not
+   * overriding it are not hashable, so neither them nor the operations depending on them are
+   * reused between executions.
+   */
+  virtual void hash_output_params()
+  {
+    m_is_params_hashed = false;
+  }
+
+  template<typename... Ts> void hash_params(const Ts &...params)
+  {
+    ((m_params_hash = BLI_ghashutil_combine_hash(m_params_hash, get_default_hash(params))), ...);
+    (append_param_data(params), ...);
+  }
+
+  template<typename T> void append_param_data(const T &param)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    m_params_data.extend(Span<char>(reinterpret_cast<const char *>(&param), sizeof(T)));
+  }
+
+  void append_param_data(const StringRef param)
+  {
+    append_param_data(param.size());
+    m_params_data.extend(Span<char>(param.data(), param.size()));
+  }
+
+  void append_param_data(const std::string &param)
+  {
+    append_param_data(StringRef(param));
+  }
+
   void addInputSocket(DataType datatype, ResizeMode resize_mode = ResizeMode::Center);
   void addOutputSocket(DataType datatype);
 
@@ -20,9 +20,13 @@
 
 #include "BLT_translation.h"
 
+#include "BKE_global.h"
 #include "BKE_node.h"
 #include "BKE_scene.h"
 
+#include "DNA_userdef_types.h"
+
+#include "COM_CachedOperationBuffers.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
 #include "COM_WorkScheduler.h"
@@ -32,6 +36,8 @@
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  /** Operations buffers reused between executions when editing. */
+  std::unique_ptr<blender::compositor::CachedOperationBuffers> cached_buffers;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -94,11 +100,33 @@ void COM_execute(RenderData *render_data,
   const bool use_opencl = (node_tree->flag & NTREE_COM_OPENCL) != 0;
   blender::compositor::WorkScheduler::initialize(use_opencl, BKE_render_num_threads(render_data));
 
+  /* Cached buffers share the memory limit of the other image caches. On rendering render passes
+   * may have changed, free buffers cached by previous executions. Don't use cache when editing
+   * while rendering as render passes are being written. */
+  if (!g_compositor.cached_buffers) {
+    g_compositor.cached_buffers = std::make_unique<blender::compositor::CachedOperationBuffers>();
+  }
+  blender::compositor::CachedOperationBuffers *cached_buffers = g_compositor.cached_buffers.get();
+  cached_buffers->set_max_memory(((size_t)U.memcachelimit) * 1024 * 1024);
+  if (rendering) {
+    cached_buffers->clear();
+  }
+  else if (G.is_rendering) {
+    cached_buffers = nullptr;
+  }
+
   /* Execute. */
   const bool twopass = (node_tree->flag & NTREE_TWO_PASS) && !rendering;
   if (twopass) {
-    blender::compositor::ExecutionSystem fast_pass(
-        render_data, scene, node_tree, rendering, true, viewSettings, displaySettings, viewName);
+    blender::compositor::ExecutionSystem fast_pass(render_data,
+                                                   scene,
+                                                   node_tree,
+                                                   rendering,
+                                                   true,
+                                                   viewSettings,
+                                                   displaySettings,
+                                                   viewName,
+                                                   cached_buffers);
     fast_pass.execute();
 
     if (node_tree->test_break(node_tree->tbh)) {
@@ -107,8 +135,15 @@ void COM_execute(RenderData *render_data,
     }
   }
 
-  blender::compositor::ExecutionSystem system(
-      render_data, scene, node_tree, rendering, false, viewSettings, displaySettings, viewName);
+  blender::compositor::ExecutionSystem system(render_data,
+                                              scene,
+                                              node_tree,
+                                              rendering,
+                                              false,
+                                              viewSettings,
+                                              displaySettings,
+                                              viewName,
+                                              cached_buffers);
   system.execute();
 
   BLI_mutex_unlock(&g_compositor.mutex);
@@ -119,6 +154,7 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    g_compositor.cached_buffers.reset();
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
@@ -25,6 +25,12 @@ AlphaOverMixedOperation::AlphaOverMixedOperation()
   this->m_x = 0.0f;
 }
 
+void AlphaOverMixedOperation::hash_output_params()
+{
+  MixBaseOperation::hash_output_params();
+  hash_params(m_x);
+}
+
 void AlphaOverMixedOperation::executePixelSampled(float output[4],
                                                   float x,
                                                   float y,
@@ -56,4 +62,31 @@ void AlphaOverMixedOperation::executePixelSampled(float output[4],
   }
 }
 
+void AlphaOverMixedOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *over_color = p.ins[2];
+    const float value = p.ins[0][0];
+
+    if (over_color[3] <= 0.0f) {
+      copy_v4_v4(p.out, color1);
+    }
+    else if (value == 1.0f && over_color[3] >= 1.0f) {
+      copy_v4_v4(p.out, over_color);
+    }
+    else {
+      const float addfac = 1.0f - this->m_x + over_color[3] * this->m_x;
+      const float premul = value * addfac;
+      const float mul = 1.0f - value * over_color[3];
+
+      p.out[0] = (mul * color1[0]) + premul * over_color[0];
+      p.out[1] = (mul * color1[1]) + premul * over_color[1];
+      p.out[2] = (mul * color1[2]) + premul * over_color[2];
+      p.out[3] = (mul * color1[3]) + value * over_color[3];
+    }
+    p.next();
+  }
+}
+
 }  // namespace blender::compositor
@@ -41,10 +41,15 @@ class AlphaOverMixedOperation : public MixBaseOperation {
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
 
+  void update_memory_buffer_row(PixelCursor &p) override;
+
   void setX(float x)
   {
     this->m_x = x;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -37,10 +37,8 @@ BlurBaseOperation::BlurBaseOperation(DataType data_type)
   this->m_sizeavailable = false;
   this->m_extend_bounds = false;
 }
-void BlurBaseOperation::initExecution()
+void BlurBaseOperation::init_data()
 {
-  this->m_inputProgram = this->getInputSocketReader(0);
-  this->m_inputSize = this->getInputSocketReader(1);
   this->m_data.image_in_width = this->getWidth();
   this->m_data.image_in_height = this->getHeight();
   if (this->m_data.relative) {
@@ -61,6 +59,13 @@ void BlurBaseOperation::initExecution()
     this->m_data.sizex = round_fl_to_int(this->m_data.percentx * 0.01f * sizex);
     this->m_data.sizey = round_fl_to_int(this->m_data.percenty * 0.01f * sizey);
   }
+}
+
+void BlurBaseOperation::initExecution()
+{
+  this->m_inputProgram = this->getInputSocketReader(0);
+  this->m_inputSize = this->getInputSocketReader(1);
+  init_data();
 
   QualityStepHelper::initExecution(COM_QH_MULTIPLY);
 }
@@ -165,6 +170,16 @@ void BlurBaseOperation::setData(const NodeBlurData *data)
   memcpy(&m_data, data, sizeof(NodeBlurData));
 }
 
+void BlurBaseOperation::hash_blur_params()
+{
+  hash_params(getQuality(), m_extend_bounds, m_sizeavailable);
+  if (m_sizeavailable) {
+    hash_params(m_size);
+  }
+  hash_params(m_data.filtertype, m_data.relative, m_data.aspect);
+  hash_params(m_data.sizex, m_data.sizey, m_data.percentx, m_data.percenty);
+}
+
 void BlurBaseOperation::updateSize()
 {
   if (!this->m_sizeavailable) {
@@ -37,8 +37,19 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
 #endif
   float *make_dist_fac_inverse(float rad, int size, int falloff);
 
+  /**
+   * Calculate blur size in pixels from node data. Only depends on operation resolution, so it
+   * can be called before execution (e.g. to determine areas of interest).
+   */
+  void init_data();
+
   void updateSize();
 
+  /**
+   * Hashes node data and quality for subclasses which output only depends on them.
+   */
+  void hash_blur_params();
+
   /**
    * Cached reference to the inputProgram
    */
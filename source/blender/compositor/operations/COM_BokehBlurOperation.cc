@@ -18,6 +18,8 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_FFTConvolution.h"
 #include "COM_OpenCLDevice.h"
 
 #include "RE_pipeline.h"
@@ -34,6 +36,7 @@ BokehBlurOperation::BokehBlurOperation()
 
   flags.complex = true;
   flags.open_cl = true;
+  flags.is_fullframe_operation = true;
 
   this->m_size = 1.0f;
   this->m_sizeavailable = false;
@@ -140,6 +143,7 @@ void BokehBlurOperation::deinitExecution()
   this->m_inputProgram = nullptr;
   this->m_inputBokehProgram = nullptr;
   this->m_inputBoundingBoxReader = nullptr;
+  this->m_fft_result.reset();
 }
 
 bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
@@ -245,4 +249,159 @@ void BokehBlurOperation::determineResolution(unsigned int resolution[2],
   }
 }
 
+int BokehBlurOperation::get_pixel_size() const
+{
+  const float max_dim = MAX2(this->getWidth(), this->getHeight());
+  return this->m_size * max_dim / 100.0f;
+}
+
+bool BokehBlurOperation::use_fft_convolution() const
+{
+  const int kernel_size = 2 * get_pixel_size();
+  return FFTConvolution::is_faster_than_direct(kernel_size, kernel_size);
+}
+
+void BokehBlurOperation::get_area_of_interest(const int input_idx,
+                                              const rcti &output_area,
+                                              rcti &r_input_area)
+{
+  switch (input_idx) {
+    case 0: {
+      if (this->m_sizeavailable && !use_fft_convolution()) {
+        const int pixel_size = get_pixel_size();
+        r_input_area.xmin = output_area.xmin - pixel_size;
+        r_input_area.xmax = output_area.xmax + pixel_size;
+        r_input_area.ymin = output_area.ymin - pixel_size;
+        r_input_area.ymax = output_area.ymax + pixel_size;
+      }
+      else {
+        /* FFT convolution needs the whole image, so does an unknown size. */
+        BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+      }
+      break;
+    }
+    case 1: {
+      NodeOperation *bokeh = getInputOperation(1);
+      BLI_rcti_init(&r_input_area, 0, bokeh->getWidth(), 0, bokeh->getHeight());
+      break;
+    }
+    case 2:
+      r_input_area = output_area;
+      break;
+    case 3:
+      /* Size input, only its first element is read. */
+      BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+      break;
+  }
+}
+
+void BokehBlurOperation::render_fft_convolution(Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *image = inputs[0];
+  MemoryBuffer *bokeh = inputs[1];
+  const int pixel_size = get_pixel_size();
+  const int kernel_size = 2 * pixel_size;
+  const float m = this->m_bokehDimension / pixel_size;
+
+  /* Direct blur samples the bokeh at offsets [-pixel_size, pixel_size) from the blurred pixel,
+   * convolution kernel is mirrored: element k matches offset `center - k`. */
+  const int center = pixel_size - 1;
+  Array<float> kernel(kernel_size * kernel_size * COM_DATA_TYPE_COLOR_CHANNELS);
+  for (int ky = 0; ky < kernel_size; ky++) {
+    const float v = this->m_bokehMidY - (center - ky) * m;
+    for (int kx = 0; kx < kernel_size; kx++) {
+      const float u = this->m_bokehMidX - (center - kx) * m;
+      float *elem = &kernel[(ky * kernel_size + kx) * COM_DATA_TYPE_COLOR_CHANNELS];
+      bokeh->read(elem, (int)u, (int)v);
+    }
+  }
+
+  FFTConvolution convolution(
+      image->getWidth(), image->getHeight(), kernel_size, kernel_size, center, center);
+  for (int ch = 0; ch < COM_DATA_TYPE_COLOR_CHANNELS; ch++) {
+    convolution.add_kernel_channel(&kernel[ch], COM_DATA_TYPE_COLOR_CHANNELS);
+  }
+  m_fft_result = std::make_unique<MemoryBuffer>(DataType::Color, image->get_rect());
+  convolution.convolve(*image, COM_DATA_TYPE_COLOR_CHANNELS, *m_fft_result);
+  convolution.normalize_by_kernel_coverage(*m_fft_result, COM_DATA_TYPE_COLOR_CHANNELS);
+}
+
+void BokehBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                              const rcti &output_area,
+                                              Span<MemoryBuffer *> inputs,
+                                              ExecutionSystem &exec_system)
+{
+  if (!this->m_sizeavailable) {
+    /* Size input is not constant, it's rendered at this point. */
+    this->m_size = *inputs[3]->get_elem(0, 0);
+    CLAMP(this->m_size, 0.0f, 10.0f);
+    this->m_sizeavailable = true;
+  }
+
+  const MemoryBuffer *image = inputs[0];
+  MemoryBuffer *bokeh = inputs[1];
+  const MemoryBuffer *bounding_box = inputs[2];
+
+  if (use_fft_convolution()) {
+    /* Whole image is convolved at once, output areas only pick the result. */
+    if (!m_fft_result) {
+      render_fft_convolution(inputs);
+    }
+    const MemoryBuffer *blurred = m_fft_result.get();
+    exec_system.execute_work(output_area, [=](const rcti &split_rect) {
+      for (int y = split_rect.ymin; y < split_rect.ymax; y++) {
+        float *out = output->get_elem(split_rect.xmin, y);
+        for (int x = split_rect.xmin; x < split_rect.xmax; x++, out += output->elem_stride) {
+          const MemoryBuffer *src = *bounding_box->get_elem(x, y) > 0.0f ? blurred : image;
+          copy_v4_v4(out, src->get_elem(x, y));
+        }
+      }
+    });
+    return;
+  }
+
+  const int pixel_size = get_pixel_size();
+  const float m = this->m_bokehDimension / pixel_size;
+  const int step = getStep();
+  const int in_stride = image->elem_stride * step;
+  const rcti &image_rect = image->get_rect();
+  exec_system.execute_work(output_area, [=](const rcti &split_rect) {
+    float bokeh_color[4];
+    for (int y = split_rect.ymin; y < split_rect.ymax; y++) {
+      float *out = output->get_elem(split_rect.xmin, y);
+      for (int x = split_rect.xmin; x < split_rect.xmax; x++, out += output->elem_stride) {
+        if (*bounding_box->get_elem(x, y) <= 0.0f) {
+          copy_v4_v4(out, image->get_elem(x, y));
+          continue;
+        }
+
+        float color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        if (pixel_size < 2) {
+          copy_v4_v4(color_accum, image->get_elem(x, y));
+          copy_v4_fl(multiplier_accum, 1.0f);
+        }
+        const int miny = max_ii(y - pixel_size, image_rect.ymin);
+        const int maxy = min_ii(y + pixel_size, image_rect.ymax);
+        const int minx = max_ii(x - pixel_size, image_rect.xmin);
+        const int maxx = min_ii(x + pixel_size, image_rect.xmax);
+        for (int ny = miny; ny < maxy; ny += step) {
+          const float v = this->m_bokehMidY - (ny - y) * m;
+          const float *in = image->get_elem(minx, ny);
+          for (int nx = minx; nx < maxx; nx += step, in += in_stride) {
+            const float u = this->m_bokehMidX - (nx - x) * m;
+            bokeh->read(bokeh_color, (int)u, (int)v);
+            madd_v4_v4v4(color_accum, bokeh_color, in);
+            add_v4_v4(multiplier_accum, bokeh_color);
+          }
+        }
+        out[0] = color_accum[0] * (1.0f / multiplier_accum[0]);
+        out[1] = color_accum[1] * (1.0f / multiplier_accum[1]);
+        out[2] = color_accum[2] * (1.0f / multiplier_accum[2]);
+        out[3] = color_accum[3] * (1.0f / multiplier_accum[3]);
+      }
+    }
+  });
+}
+
 }  // namespace blender::compositor
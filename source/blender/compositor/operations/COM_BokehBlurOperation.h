@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "COM_NodeOperation.h"
 #include "COM_QualityStepHelper.h"
 
@@ -36,6 +38,13 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   float m_bokehDimension;
   bool m_extend_bounds;
 
+  /** Whole image convolved with the bokeh, only used in full frame execution. */
+  std::unique_ptr<MemoryBuffer> m_fft_result;
+
+  int get_pixel_size() const;
+  bool use_fft_convolution() const;
+  void render_fft_convolution(Span<MemoryBuffer *> inputs);
+
  public:
   BokehBlurOperation();
 
@@ -79,6 +88,12 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
 
   void determineResolution(unsigned int resolution[2],
                            unsigned int preferredResolution[2]) override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &output_area,
+                            Span<MemoryBuffer *> inputs,
+                            ExecutionSystem &exec_system) override;
 };
 
 }  // namespace blender::compositor
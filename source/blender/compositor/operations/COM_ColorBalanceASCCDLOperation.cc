@@ -76,10 +76,37 @@ void ColorBalanceASCCDLOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ColorBalanceASCCDLOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float *in_factor = p.ins[0];
+    const float *in_color = p.ins[1];
+    const float fac = MIN2(1.0f, in_factor[0]);
+    const float mfac = 1.0f - fac;
+    p.out[0] = mfac * in_color[0] +
+               fac * colorbalance_cdl(
+                         in_color[0], this->m_offset[0], this->m_power[0], this->m_slope[0]);
+    p.out[1] = mfac * in_color[1] +
+               fac * colorbalance_cdl(
+                         in_color[1], this->m_offset[1], this->m_power[1], this->m_slope[1]);
+    p.out[2] = mfac * in_color[2] +
+               fac * colorbalance_cdl(
+                         in_color[2], this->m_offset[2], this->m_power[2], this->m_slope[2]);
+    p.out[3] = in_color[3];
+  }
+}
+
 void ColorBalanceASCCDLOperation::deinitExecution()
 {
   this->m_inputValueOperation = nullptr;
   this->m_inputColorOperation = nullptr;
 }
 
+void ColorBalanceASCCDLOperation::hash_output_params()
+{
+  hash_params(m_offset[0], m_offset[1], m_offset[2]);
+  hash_params(m_power[0], m_power[1], m_power[2]);
+  hash_params(m_slope[0], m_slope[1], m_slope[2]);
+}
+
 }  // namespace blender::compositor
@@ -81,10 +81,37 @@ void ColorBalanceLGGOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ColorBalanceLGGOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float *in_factor = p.ins[0];
+    const float *in_color = p.ins[1];
+    const float fac = MIN2(1.0f, in_factor[0]);
+    const float mfac = 1.0f - fac;
+    p.out[0] = mfac * in_color[0] +
+               fac * colorbalance_lgg(
+                         in_color[0], this->m_lift[0], this->m_gamma_inv[0], this->m_gain[0]);
+    p.out[1] = mfac * in_color[1] +
+               fac * colorbalance_lgg(
+                         in_color[1], this->m_lift[1], this->m_gamma_inv[1], this->m_gain[1]);
+    p.out[2] = mfac * in_color[2] +
+               fac * colorbalance_lgg(
+                         in_color[2], this->m_lift[2], this->m_gamma_inv[2], this->m_gain[2]);
+    p.out[3] = in_color[3];
+  }
+}
+
 void ColorBalanceLGGOperation::deinitExecution()
 {
   this->m_inputValueOperation = nullptr;
   this->m_inputColorOperation = nullptr;
 }
 
+void ColorBalanceLGGOperation::hash_output_params()
+{
+  hash_params(m_gain[0], m_gain[1], m_gain[2]);
+  hash_params(m_lift[0], m_lift[1], m_lift[2]);
+  hash_params(m_gamma_inv[0], m_gamma_inv[1], m_gamma_inv[2]);
+}
+
 }  // namespace blender::compositor
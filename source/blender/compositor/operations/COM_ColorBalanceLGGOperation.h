@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedRowOperation.h"
 
 namespace blender::compositor {
 
@@ -26,7 +26,7 @@ namespace blender::compositor {
  * this program converts an input color to an output value.
  * it assumes we are in sRGB color space.
  */
-class ColorBalanceLGGOperation : public NodeOperation {
+class ColorBalanceLGGOperation : public MultiThreadedRowOperation {
  protected:
   /**
    * Prefetched reference to the inputProgram
@@ -59,6 +59,8 @@ class ColorBalanceLGGOperation : public NodeOperation {
    */
   void deinitExecution() override;
 
+  void update_memory_buffer_row(PixelCursor &p) override;
+
   void setGain(const float gain[3])
   {
     copy_v3_v3(this->m_gain, gain);
@@ -71,6 +73,9 @@ class ColorBalanceLGGOperation : public NodeOperation {
   {
     copy_v3_v3(this->m_gamma_inv, gamma_inv);
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
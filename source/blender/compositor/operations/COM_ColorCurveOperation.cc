@@ -89,6 +89,40 @@ void ColorCurveOperation::executePixelSampled(float output[4],
   output[3] = image[3];
 }
 
+void ColorCurveOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  CurveMapping *cumap = this->m_curveMapping;
+  float bwmul[3];
+
+  /* Black and white levels are usually constant, compute their multiplier once per row. */
+  const bool constant_levels = p.in_strides[2] == 0 && p.in_strides[3] == 0;
+  if (constant_levels) {
+    BKE_curvemapping_set_black_white_ex(p.ins[2], p.ins[3], bwmul);
+  }
+
+  for (; p.out < p.row_end; p.next()) {
+    const float fac = p.ins[0][0];
+    const float *image = p.ins[1];
+    const float *black = p.ins[2];
+    if (!constant_levels) {
+      BKE_curvemapping_set_black_white_ex(black, p.ins[3], bwmul);
+    }
+
+    if (fac >= 1.0f) {
+      BKE_curvemapping_evaluate_premulRGBF_ex(cumap, p.out, image, black, bwmul);
+    }
+    else if (fac <= 0.0f) {
+      copy_v3_v3(p.out, image);
+    }
+    else {
+      float col[4];
+      BKE_curvemapping_evaluate_premulRGBF_ex(cumap, col, image, black, bwmul);
+      interp_v3_v3v3(p.out, image, col, fac);
+    }
+    p.out[3] = image[3];
+  }
+}
+
 void ColorCurveOperation::deinitExecution()
 {
   CurveBaseOperation::deinitExecution();
@@ -147,6 +181,27 @@ void ConstantLevelColorCurveOperation::executePixelSampled(float output[4],
   output[3] = image[3];
 }
 
+void ConstantLevelColorCurveOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  CurveMapping *cumap = this->m_curveMapping;
+  for (; p.out < p.row_end; p.next()) {
+    const float fac = p.ins[0][0];
+    const float *image = p.ins[1];
+    if (fac >= 1.0f) {
+      BKE_curvemapping_evaluate_premulRGBF(cumap, p.out, image);
+    }
+    else if (fac <= 0.0f) {
+      copy_v3_v3(p.out, image);
+    }
+    else {
+      float col[4];
+      BKE_curvemapping_evaluate_premulRGBF(cumap, col, image);
+      interp_v3_v3v3(p.out, image, col, fac);
+    }
+    p.out[3] = image[3];
+  }
+}
+
 void ConstantLevelColorCurveOperation::deinitExecution()
 {
   CurveBaseOperation::deinitExecution();
@@ -154,4 +209,11 @@ void ConstantLevelColorCurveOperation::deinitExecution()
   this->m_inputImageProgram = nullptr;
 }
 
+void ConstantLevelColorCurveOperation::hash_output_params()
+{
+  CurveBaseOperation::hash_output_params();
+  hash_params(m_black[0], m_black[1], m_black[2]);
+  hash_params(m_white[0], m_white[1], m_white[2]);
+}
+
 }  // namespace blender::compositor
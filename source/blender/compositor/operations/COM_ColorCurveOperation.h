@@ -51,6 +51,8 @@ class ColorCurveOperation : public CurveBaseOperation {
    * Deinitialize the execution
    */
   void deinitExecution() override;
+
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class ConstantLevelColorCurveOperation : public CurveBaseOperation {
@@ -81,6 +83,8 @@ class ConstantLevelColorCurveOperation : public CurveBaseOperation {
    */
   void deinitExecution() override;
 
+  void update_memory_buffer_row(PixelCursor &p) override;
+
   void setBlackLevel(float black[3])
   {
     copy_v3_v3(this->m_black, black);
@@ -89,6 +93,9 @@ class ConstantLevelColorCurveOperation : public CurveBaseOperation {
   {
     copy_v3_v3(this->m_white, white);
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
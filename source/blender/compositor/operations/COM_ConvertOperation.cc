@@ -39,6 +39,11 @@ void ConvertBaseOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+void ConvertBaseOperation::hash_output_params()
+{
+  /* Conversions output only depends on their input. */
+}
+
 /* ******** Value to Color ******** */
 
 ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperation()
@@ -189,6 +194,12 @@ void ConvertRGBToYCCOperation::setMode(int mode)
   }
 }
 
+void ConvertRGBToYCCOperation::hash_output_params()
+{
+  ConvertBaseOperation::hash_output_params();
+  hash_params(m_mode);
+}
+
 void ConvertRGBToYCCOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -231,6 +242,12 @@ void ConvertYCCToRGBOperation::setMode(int mode)
   }
 }
 
+void ConvertYCCToRGBOperation::hash_output_params()
+{
+  ConvertBaseOperation::hash_output_params();
+  hash_params(m_mode);
+}
+
 void ConvertYCCToRGBOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -400,6 +417,11 @@ void SeparateChannelOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+void SeparateChannelOperation::hash_output_params()
+{
+  hash_params(m_channel);
+}
+
 void SeparateChannelOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -442,6 +464,10 @@ void CombineChannelsOperation::deinitExecution()
   this->m_inputChannel4Operation = nullptr;
 }
 
+void CombineChannelsOperation::hash_output_params()
+{
+}
+
 void CombineChannelsOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -20,6 +20,8 @@
 
 #include "BKE_colortools.h"
 
+#include "DNA_color_types.h"
+
 namespace blender::compositor {
 
 CurveBaseOperation::CurveBaseOperation()
@@ -56,4 +58,25 @@ void CurveBaseOperation::setCurveMapping(CurveMapping *mapping)
   this->m_curveMapping = BKE_curvemapping_copy(mapping);
 }
 
+void CurveBaseOperation::hash_output_params()
+{
+  if (!m_curveMapping) {
+    return;
+  }
+
+  const CurveMapping &mapping = *m_curveMapping;
+  hash_params(mapping.flag, mapping.tone);
+  hash_params(mapping.clipr.xmin, mapping.clipr.xmax, mapping.clipr.ymin, mapping.clipr.ymax);
+  hash_params(mapping.black[0], mapping.black[1], mapping.black[2]);
+  hash_params(mapping.white[0], mapping.white[1], mapping.white[2]);
+  for (const CurveMap &curve_map : mapping.cm) {
+    hash_params(curve_map.totpoint);
+    for (int i = 0; i < curve_map.totpoint; i++) {
+      /* Selection doesn't affect evaluation. */
+      const CurveMapPoint &point = curve_map.curve[i];
+      hash_params(point.x, point.y, static_cast<short>(point.flag & ~CUMA_SELECT));
+    }
+  }
+}
+
 }  // namespace blender::compositor
@@ -18,12 +18,12 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedRowOperation.h"
 #include "DNA_color_types.h"
 
 namespace blender::compositor {
 
-class CurveBaseOperation : public NodeOperation {
+class CurveBaseOperation : public MultiThreadedRowOperation {
  protected:
   /**
    * Cached reference to the inputProgram
@@ -41,6 +41,9 @@ class CurveBaseOperation : public NodeOperation {
   void deinitExecution() override;
 
   void setCurveMapping(CurveMapping *mapping);
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -0,0 +1,441 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_FFTConvolution.h"
+#include "COM_MemoryBuffer.h"
+
+#include "BLI_math.h"
+#include "BLI_task.hh"
+
+namespace blender::compositor {
+
+/*
+ *  2D Fast Hartley Transform, used for convolution
+ */
+
+using fREAL = float;
+
+// returns next highest power of 2 of x, as well its log2 in L2
+static unsigned int nextPow2(unsigned int x, unsigned int *L2)
+{
+  unsigned int pw, x_notpow2 = x & (x - 1);
+  *L2 = 0;
+  while (x >>= 1) {
+    ++(*L2);
+  }
+  pw = 1 << (*L2);
+  if (x_notpow2) {
+    (*L2)++;
+    pw <<= 1;
+  }
+  return pw;
+}
+
+//------------------------------------------------------------------------------
+
+// from FXT library by Joerg Arndt, faster in order bitreversal
+// use: r = revbin_upd(r, h) where h = N>>1
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+  while (!((r ^= h) & h)) {
+    h >>= 1;
+  }
+  return r;
+}
+//------------------------------------------------------------------------------
+static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
+{
+  double tt, fc, dc, fs, ds, a = M_PI;
+  fREAL t1, t2;
+  int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+  int i, j = 0;
+  unsigned int Nh = len >> 1;
+  for (i = 1; i < (len - 1); i++) {
+    j = revbin_upd(j, Nh);
+    if (j > i) {
+      t1 = data[i];
+      data[i] = data[j];
+      data[j] = t1;
+    }
+  }
+
+  do {
+    fREAL *data_n = &data[n];
+
+    istep = n << 1;
+    for (k = 0; k < len; k += istep) {
+      t1 = data_n[k];
+      data_n[k] = data[k] - t1;
+      data[k] += t1;
+    }
+
+    n2 = n >> 1;
+    if (n > 2) {
+      fc = dc = cos(a);
+      fs = ds = sqrt(1.0 - fc * fc);  // sin(a);
+      bd = n - 2;
+      for (bl = 1; bl < n2; bl++) {
+        fREAL *data_nbd = &data_n[bd];
+        fREAL *data_bd = &data[bd];
+        for (k = bl; k < len; k += istep) {
+          t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+          t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+          data_n[k] = data[k] - t1;
+          data_nbd[k] = data_bd[k] - t2;
+          data[k] += t1;
+          data_bd[k] += t2;
+        }
+        tt = fc * dc - fs * ds;
+        fs = fs * dc + fc * ds;
+        fc = tt;
+        bd -= 2;
+      }
+    }
+
+    if (n > 1) {
+      for (k = n2; k < len; k += istep) {
+        t1 = data_n[k];
+        data_n[k] = data[k] - t1;
+        data[k] += t1;
+      }
+    }
+
+    n = istep;
+    a *= 0.5;
+  } while (n < len);
+
+  if (inverse) {
+    fREAL sc = (fREAL)1 / (fREAL)len;
+    for (k = 0; k < len; k++) {
+      data[k] *= sc;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+/* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
+ * nzp -> the row where zero pad data starts,
+ * inverse -> see above */
+static void FHT2D(
+    fREAL *data, unsigned int Mx, unsigned int My, unsigned int nzp, unsigned int inverse)
+{
+  unsigned int i, j, Nx, Ny, maxy;
+
+  Nx = 1 << Mx;
+  Ny = 1 << My;
+
+  // rows (forward transform skips 0 pad data)
+  maxy = inverse ? Ny : nzp;
+  for (j = 0; j < maxy; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  // transpose data
+  if (Nx == Ny) {  // square
+    for (j = 0; j < Ny; j++) {
+      for (i = j + 1; i < Nx; i++) {
+        unsigned int op = i + (j << Mx), np = j + (i << My);
+        SWAP(fREAL, data[op], data[np]);
+      }
+    }
+  }
+  else {  // rectangular
+    unsigned int k, Nym = Ny - 1, stm = 1 << (Mx + My);
+    for (i = 0; stm > 0; i++) {
+#define PRED(k) (((k & Nym) << Mx) + (k >> My))
+      for (j = PRED(i); j > i; j = PRED(j)) {
+        /* pass */
+      }
+      if (j < i) {
+        continue;
+      }
+      for (k = i, j = PRED(i); j != i; k = j, j = PRED(j), stm--) {
+        SWAP(fREAL, data[j], data[k]);
+      }
+#undef PRED
+      stm--;
+    }
+  }
+
+  SWAP(unsigned int, Nx, Ny);
+  SWAP(unsigned int, Mx, My);
+
+  // now columns == transposed rows
+  for (j = 0; j < Ny; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  // finalize
+  for (j = 0; j <= (Ny >> 1); j++) {
+    unsigned int jm = (Ny - j) & (Ny - 1);
+    unsigned int ji = j << Mx;
+    unsigned int jmi = jm << Mx;
+    for (i = 0; i <= (Nx >> 1); i++) {
+      unsigned int im = (Nx - i) & (Nx - 1);
+      fREAL A = data[ji + i];
+      fREAL B = data[jmi + i];
+      fREAL C = data[ji + im];
+      fREAL D = data[jmi + im];
+      fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+      data[ji + i] = A - E;
+      data[jmi + i] = B + E;
+      data[ji + im] = C + E;
+      data[jmi + im] = D - E;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height */
+static void fht_convolve(fREAL *d1, const fREAL *d2, unsigned int M, unsigned int N)
+{
+  fREAL a, b;
+  unsigned int i, j, k, L, mj, mL;
+  unsigned int m = 1 << M, n = 1 << N;
+  unsigned int m2 = 1 << (M - 1), n2 = 1 << (N - 1);
+  unsigned int mn2 = m << (N - 1);
+
+  d1[0] *= d2[0];
+  d1[mn2] *= d2[mn2];
+  d1[m2] *= d2[m2];
+  d1[m2 + mn2] *= d2[m2 + mn2];
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    a = d1[i] * d2[i] - d1[k] * d2[k];
+    b = d1[k] * d2[i] + d1[i] * d2[k];
+    d1[i] = (b + a) * (fREAL)0.5;
+    d1[k] = (b - a) * (fREAL)0.5;
+    a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+    b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+    d1[i + mn2] = (b + a) * (fREAL)0.5;
+    d1[k + mn2] = (b - a) * (fREAL)0.5;
+  }
+  for (j = 1; j < n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+    b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+    d1[mj] = (b + a) * (fREAL)0.5;
+    d1[mL] = (b - a) * (fREAL)0.5;
+    a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+    b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+    d1[m2 + mj] = (b + a) * (fREAL)0.5;
+    d1[m2 + mL] = (b - a) * (fREAL)0.5;
+  }
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    for (j = 1; j < n2; j++) {
+      L = n - j;
+      mj = j << M;
+      mL = L << M;
+      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+      d1[i + mj] = (b + a) * (fREAL)0.5;
+      d1[k + mL] = (b - a) * (fREAL)0.5;
+      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+      d1[i + mL] = (b + a) * (fREAL)0.5;
+      d1[k + mj] = (b - a) * (fREAL)0.5;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+
+/**
+ * Minimum width and height of the image area convolved at once. Larger blocks waste less work
+ * on the overlapping kernel borders, smaller ones need less memory.
+ */
+constexpr int MIN_BLOCK_SIZE = 256;
+
+static void calc_block_size(const int image_size,
+                            const int kernel_size,
+                            int &r_block_size,
+                            unsigned int &r_fft_size,
+                            unsigned int &r_log2_fft_size)
+{
+  const int covered_size = std::min(image_size, std::max(kernel_size, MIN_BLOCK_SIZE));
+  /* Block and kernel must fit in the transform without wrapping around. Transforms of size 1
+   * aren't supported by #fht_convolve. */
+  r_fft_size = nextPow2(std::max(covered_size + kernel_size - 1, 2), &r_log2_fft_size);
+  r_block_size = r_fft_size + 1 - kernel_size;
+}
+
+FFTConvolution::FFTConvolution(const int image_width,
+                               const int image_height,
+                               const int kernel_width,
+                               const int kernel_height,
+                               const int center_x,
+                               const int center_y)
+    : image_width_(image_width),
+      image_height_(image_height),
+      kernel_width_(kernel_width),
+      kernel_height_(kernel_height),
+      center_x_(center_x),
+      center_y_(center_y)
+{
+  BLI_assert(image_width > 0 && image_height > 0 && kernel_width > 0 && kernel_height > 0);
+  calc_block_size(image_width, kernel_width, block_width_, fft_width_, log2_fft_width_);
+  calc_block_size(image_height, kernel_height, block_height_, fft_height_, log2_fft_height_);
+}
+
+void FFTConvolution::add_kernel_channel(const float *kernel, const int elem_stride)
+{
+  Array<float> transform(fft_width_ * fft_height_, 0.0f);
+  for (int y = 0; y < kernel_height_; y++) {
+    float *row = &transform[y * fft_width_];
+    const float *elem = &kernel[y * kernel_width_ * elem_stride];
+    for (int x = 0; x < kernel_width_; x++, elem += elem_stride) {
+      row[x] = *elem;
+    }
+  }
+  FHT2D(transform.data(), log2_fft_width_, log2_fft_height_, kernel_height_, 0);
+  kernel_transforms_.append(std::move(transform));
+
+  const int sums_width = kernel_width_ + 1;
+  Array<double> sums(sums_width * (kernel_height_ + 1), 0.0);
+  for (int y = 0; y < kernel_height_; y++) {
+    const float *elem = &kernel[y * kernel_width_ * elem_stride];
+    double row_sum = 0.0;
+    for (int x = 0; x < kernel_width_; x++, elem += elem_stride) {
+      row_sum += *elem;
+      sums[(y + 1) * sums_width + x + 1] = sums[y * sums_width + x + 1] + row_sum;
+    }
+  }
+  kernel_sums_.append(std::move(sums));
+}
+
+int FFTConvolution::get_kernel_channel(const int channel) const
+{
+  BLI_assert(kernel_transforms_.size() == 1 || channel < kernel_transforms_.size());
+  return kernel_transforms_.size() == 1 ? 0 : channel;
+}
+
+void FFTConvolution::convolve_block(const MemoryBuffer &image,
+                                    const int num_channels,
+                                    const int block_x,
+                                    const int block_y,
+                                    float *data,
+                                    MemoryBuffer &r_result) const
+{
+  const rcti &rect = image.get_rect();
+  const int block_xmin = block_x * block_width_;
+  const int block_ymin = block_y * block_height_;
+  const int block_width = std::min(block_width_, image_width_ - block_xmin);
+  const int block_height = std::min(block_height_, image_height_ - block_ymin);
+  /* Rows past the kernel and block data are zero, forward transform can skip them. */
+  const int zero_pad_row = std::max(kernel_height_, block_height);
+
+  for (int ch = 0; ch < num_channels; ch++) {
+    memset(data, 0, sizeof(float) * fft_width_ * fft_height_);
+    for (int y = 0; y < block_height; y++) {
+      float *row = &data[y * fft_width_];
+      const float *elem = image.get_elem(rect.xmin + block_xmin, rect.ymin + block_ymin + y);
+      for (int x = 0; x < block_width; x++, elem += image.elem_stride) {
+        row[x] = elem[ch];
+      }
+    }
+
+    FHT2D(data, log2_fft_width_, log2_fft_height_, zero_pad_row, 0);
+    /* Transform is transposed, rows and columns are swapped. */
+    const Array<float> &kernel_transform = kernel_transforms_[get_kernel_channel(ch)];
+    fht_convolve(data, kernel_transform.data(), log2_fft_height_, log2_fft_width_);
+    FHT2D(data, log2_fft_height_, log2_fft_width_, 0, 1);
+
+    /* Overlap-add result. */
+    for (int y = 0; y < (int)fft_height_; y++) {
+      const int result_y = block_ymin + y - center_y_;
+      if (result_y < 0 || result_y >= image_height_) {
+        continue;
+      }
+      const float *row = &data[y * fft_width_];
+      for (int x = 0; x < (int)fft_width_; x++) {
+        const int result_x = block_xmin + x - center_x_;
+        if (result_x < 0 || result_x >= image_width_) {
+          continue;
+        }
+        r_result.get_elem(rect.xmin + result_x, rect.ymin + result_y)[ch] += row[x];
+      }
+    }
+  }
+}
+
+void FFTConvolution::convolve(const MemoryBuffer &image,
+                              const int num_channels,
+                              MemoryBuffer &r_result) const
+{
+  BLI_assert(!kernel_transforms_.is_empty());
+  BLI_assert(image.getWidth() == image_width_ && image.getHeight() == image_height_);
+  BLI_assert(BLI_rcti_compare(&image.get_rect(), &r_result.get_rect()));
+  BLI_assert(num_channels <= r_result.get_num_channels());
+  r_result.clear();
+
+  const int num_blocks_x = (image_width_ + block_width_ - 1) / block_width_;
+  const int num_blocks_y = (image_height_ + block_height_ - 1) / block_height_;
+  /* A block result only overlaps the results of its neighbor blocks. Blocks with the same
+   * parity on both axes can be added to the result in parallel. */
+  for (int parity_y = 0; parity_y < 2; parity_y++) {
+    for (int parity_x = 0; parity_x < 2; parity_x++) {
+      const int phase_blocks_x = (num_blocks_x - parity_x + 1) / 2;
+      const int phase_blocks_y = (num_blocks_y - parity_y + 1) / 2;
+      threading::parallel_for(
+          IndexRange(phase_blocks_x * phase_blocks_y), 1, [&](const IndexRange range) {
+            Array<float> data(fft_width_ * fft_height_);
+            for (const int64_t i : range) {
+              const int block_x = parity_x + 2 * (i % phase_blocks_x);
+              const int block_y = parity_y + 2 * (i / phase_blocks_x);
+              convolve_block(image, num_channels, block_x, block_y, data.data(), r_result);
+            }
+          });
+    }
+  }
+}
+
+void FFTConvolution::normalize_by_kernel_coverage(MemoryBuffer &result,
+                                                  const int num_channels) const
+{
+  BLI_assert(result.getWidth() == image_width_ && result.getHeight() == image_height_);
+  const rcti &rect = result.get_rect();
+  const int sums_width = kernel_width_ + 1;
+  threading::parallel_for(IndexRange(image_height_), 16, [&](const IndexRange rows) {
+    for (const int64_t y : rows) {
+      /* Kernel rows that overlapped the image, see #FFTConvolution class description. */
+      const int kernel_ymin = std::max(0, (int)y + center_y_ - image_height_ + 1);
+      const int kernel_ymax = std::min(kernel_height_, (int)y + center_y_ + 1);
+      float *elem = result.get_elem(rect.xmin, rect.ymin + y);
+      for (int x = 0; x < image_width_; x++, elem += result.elem_stride) {
+        const int kernel_xmin = std::max(0, x + center_x_ - image_width_ + 1);
+        const int kernel_xmax = std::min(kernel_width_, x + center_x_ + 1);
+        for (int ch = 0; ch < num_channels; ch++) {
+          float weight = 0.0f;
+          if (kernel_xmin < kernel_xmax && kernel_ymin < kernel_ymax) {
+            const Array<double> &sums = kernel_sums_[get_kernel_channel(ch)];
+            weight = (float)(sums[kernel_ymax * sums_width + kernel_xmax] -
+                             sums[kernel_ymin * sums_width + kernel_xmax] -
+                             sums[kernel_ymax * sums_width + kernel_xmin] +
+                             sums[kernel_ymin * sums_width + kernel_xmin]);
+          }
+          elem[ch] = weight != 0.0f ? elem[ch] / weight : 0.0f;
+        }
+      }
+    }
+  });
+}
+
+}  // namespace blender::compositor
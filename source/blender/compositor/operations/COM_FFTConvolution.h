@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_array.hh"
+#include "BLI_vector.hh"
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Convolves images with a constant kernel using a 2D Fast Hartley Transform.
+ *
+ * Cost per pixel only grows logarithmically with the kernel size, making it much faster than
+ * direct convolution for large kernels. The image is split in blocks that are convolved
+ * independently and overlap-added into the result, which bounds the memory needed for the
+ * transforms no matter the image size. Blocks are processed in parallel.
+ *
+ * For every output pixel X the result is `sum(K(k) * I(X - k + center))` over all kernel
+ * pixels k, where pixels outside the image are zero.
+ */
+class FFTConvolution {
+ public:
+  /**
+   * Kernels with at least this number of pixels are convolved faster with an FFT than directly.
+   */
+  static constexpr int MIN_KERNEL_AREA = 32 * 32;
+
+ private:
+  int image_width_;
+  int image_height_;
+  int kernel_width_;
+  int kernel_height_;
+  int center_x_;
+  int center_y_;
+
+  /** Width and height of the image area covered by each block. */
+  int block_width_;
+  int block_height_;
+
+  unsigned int fft_width_;
+  unsigned int fft_height_;
+  unsigned int log2_fft_width_;
+  unsigned int log2_fft_height_;
+
+  /** Transformed kernel of each channel. */
+  Vector<Array<float>> kernel_transforms_;
+  /** Summed area table of each kernel channel, used to normalize results at image edges. */
+  Vector<Array<double>> kernel_sums_;
+
+ public:
+  FFTConvolution(int image_width,
+                 int image_height,
+                 int kernel_width,
+                 int kernel_height,
+                 int center_x,
+                 int center_y);
+
+  /**
+   * Add a kernel channel. Result channel `c` is convolved with kernel channel `c`, or with the
+   * first kernel channel when only one has been added.
+   *
+   * \param kernel: First kernel element, rows are contiguous.
+   * \param elem_stride: Number of floats between two kernel elements.
+   */
+  void add_kernel_channel(const float *kernel, int elem_stride);
+
+  /**
+   * Convolve the first \a num_channels channels of \a image into \a r_result, which is
+   * overwritten. Both buffers must have the size given on construction.
+   */
+  void convolve(const MemoryBuffer &image, int num_channels, MemoryBuffer &r_result) const;
+
+  /**
+   * Divide each result pixel by the sum of the kernel elements that overlapped the image when
+   * calculating it. Gives the same result as direct convolutions normalized by their accumulated
+   * weights.
+   */
+  void normalize_by_kernel_coverage(MemoryBuffer &result, int num_channels) const;
+
+  static bool is_faster_than_direct(const int kernel_width, const int kernel_height)
+  {
+    return kernel_width * kernel_height >= MIN_KERNEL_AREA;
+  }
+
+ private:
+  int get_kernel_channel(int channel) const;
+  void convolve_block(const MemoryBuffer &image,
+                      int num_channels,
+                      int block_x,
+                      int block_y,
+                      float *data,
+                      MemoryBuffer &r_result) const;
+};
+
+}  // namespace blender::compositor
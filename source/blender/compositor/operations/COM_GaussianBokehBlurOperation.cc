@@ -18,6 +18,8 @@
 
 #include "COM_GaussianBokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_FFTConvolution.h"
 #include "MEM_guardedalloc.h"
 
 #include "RE_pipeline.h"
@@ -26,6 +28,7 @@ namespace blender::compositor {
 
 GaussianBokehBlurOperation::GaussianBokehBlurOperation() : BlurBaseOperation(DataType::Color)
 {
+  flags.is_fullframe_operation = true;
   this->m_gausstab = nullptr;
 }
 
@@ -51,6 +54,18 @@ void GaussianBokehBlurOperation::initExecution()
   }
 }
 
+void GaussianBokehBlurOperation::calc_radius(float &r_radx, float &r_rady) const
+{
+  const float width = this->getWidth();
+  const float height = this->getHeight();
+  r_radx = this->m_size * (float)this->m_data.sizex;
+  CLAMP(r_radx, 0.0f, width / 2.0f);
+
+  /* vertical */
+  r_rady = this->m_size * (float)this->m_data.sizey;
+  CLAMP(r_rady, 0.0f, height / 2.0f);
+}
+
 void GaussianBokehBlurOperation::updateGauss()
 {
   if (this->m_gausstab == nullptr) {
@@ -60,17 +75,10 @@ void GaussianBokehBlurOperation::updateGauss()
     float *dgauss;
     float *ddgauss;
     int j, i;
-    const float width = this->getWidth();
-    const float height = this->getHeight();
     if (!this->m_sizeavailable) {
       updateSize();
     }
-    radxf = this->m_size * (float)this->m_data.sizex;
-    CLAMP(radxf, 0.0f, width / 2.0f);
-
-    /* vertical */
-    radyf = this->m_size * (float)this->m_data.sizey;
-    CLAMP(radyf, 0.0f, height / 2.0f);
+    calc_radius(radxf, radyf);
 
     this->m_radx = ceil(radxf);
     this->m_rady = ceil(radyf);
@@ -160,6 +168,7 @@ void GaussianBokehBlurOperation::deinitExecution()
     MEM_freeN(this->m_gausstab);
     this->m_gausstab = nullptr;
   }
+  this->m_fft_result.reset();
 
   deinitMutex();
 }
@@ -196,6 +205,113 @@ bool GaussianBokehBlurOperation::determineDependingAreaOfInterest(
   return BlurBaseOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+bool GaussianBokehBlurOperation::use_fft_convolution() const
+{
+  return FFTConvolution::is_faster_than_direct(2 * this->m_radx + 1, 2 * this->m_rady + 1);
+}
+
+void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
+                                                      const rcti &output_area,
+                                                      rcti &r_input_area)
+{
+  if (input_idx == 1) {
+    /* Size input, only its first element is read. */
+    BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+    return;
+  }
+
+  if (!this->m_sizeavailable) {
+    /* Size is only known once the size input is rendered, read the whole image. */
+    BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+    return;
+  }
+
+  init_data();
+  float radxf, radyf;
+  calc_radius(radxf, radyf);
+  const int radx = ceil(radxf);
+  const int rady = ceil(radyf);
+  if (FFTConvolution::is_faster_than_direct(2 * radx + 1, 2 * rady + 1)) {
+    BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+  }
+  else {
+    r_input_area.xmin = output_area.xmin - radx;
+    r_input_area.xmax = output_area.xmax + radx;
+    r_input_area.ymin = output_area.ymin - rady;
+    r_input_area.ymax = output_area.ymax + rady;
+  }
+}
+
+void GaussianBokehBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                                      const rcti &output_area,
+                                                      Span<MemoryBuffer *> inputs,
+                                                      ExecutionSystem &exec_system)
+{
+  if (this->m_gausstab == nullptr) {
+    /* Size input is not constant, it's rendered at this point. */
+    this->m_size = *inputs[1]->get_elem(0, 0);
+    this->m_sizeavailable = true;
+    updateGauss();
+  }
+
+  const MemoryBuffer *input = inputs[0];
+  if (use_fft_convolution()) {
+    /* Whole image is convolved at once, output areas only copy the result. */
+    if (!m_fft_result) {
+      FFTConvolution convolution(input->getWidth(),
+                                 input->getHeight(),
+                                 2 * this->m_radx + 1,
+                                 2 * this->m_rady + 1,
+                                 this->m_radx,
+                                 this->m_rady);
+      /* Filter is symmetric, no need to mirror it. */
+      convolution.add_kernel_channel(this->m_gausstab, 1);
+      m_fft_result = std::make_unique<MemoryBuffer>(DataType::Color, input->get_rect());
+      convolution.convolve(*input, COM_DATA_TYPE_COLOR_CHANNELS, *m_fft_result);
+      convolution.normalize_by_kernel_coverage(*m_fft_result, COM_DATA_TYPE_COLOR_CHANNELS);
+    }
+    const MemoryBuffer *blurred = m_fft_result.get();
+    exec_system.execute_work(output_area, [=](const rcti &split_rect) {
+      for (int y = split_rect.ymin; y < split_rect.ymax; y++) {
+        float *out = output->get_elem(split_rect.xmin, y);
+        for (int x = split_rect.xmin; x < split_rect.xmax; x++, out += output->elem_stride) {
+          copy_v4_v4(out, blurred->get_elem(x, y));
+        }
+      }
+    });
+    return;
+  }
+
+  const rcti &input_rect = input->get_rect();
+  const int step = QualityStepHelper::getStep();
+  const int in_stride = input->elem_stride * step;
+  const int filter_width = this->m_radx * 2 + 1;
+  exec_system.execute_work(output_area, [=](const rcti &split_rect) {
+    for (int y = split_rect.ymin; y < split_rect.ymax; y++) {
+      float *out = output->get_elem(split_rect.xmin, y);
+      for (int x = split_rect.xmin; x < split_rect.xmax; x++, out += output->elem_stride) {
+        const int ymin = max_ii(y - this->m_rady, input_rect.ymin);
+        const int ymax = min_ii(y + this->m_rady + 1, input_rect.ymax);
+        const int xmin = max_ii(x - this->m_radx, input_rect.xmin);
+        const int xmax = min_ii(x + this->m_radx + 1, input_rect.xmax);
+
+        float color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float multiplier_accum = 0.0f;
+        for (int ny = ymin; ny < ymax; ny += step) {
+          const float *in = input->get_elem(xmin, ny);
+          int index = ((ny - y) + this->m_rady) * filter_width + (xmin - x + this->m_radx);
+          for (int nx = xmin; nx < xmax; nx += step, in += in_stride, index += step) {
+            const float multiplier = this->m_gausstab[index];
+            madd_v4_v4fl(color_accum, in, multiplier);
+            multiplier_accum += multiplier;
+          }
+        }
+        mul_v4_v4fl(out, color_accum, 1.0f / multiplier_accum);
+      }
+    }
+  });
+}
+
 // reference image
 GaussianBlurReferenceOperation::GaussianBlurReferenceOperation()
     : BlurBaseOperation(DataType::Color)
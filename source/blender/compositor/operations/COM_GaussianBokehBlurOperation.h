@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "COM_BlurBaseOperation.h"
 #include "COM_NodeOperation.h"
 #include "COM_QualityStepHelper.h"
@@ -28,7 +30,12 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
  private:
   float *m_gausstab;
   int m_radx, m_rady;
+  /** Whole image convolved with the filter, only used in full frame execution. */
+  std::unique_ptr<MemoryBuffer> m_fft_result;
+
+  void calc_radius(float &r_radx, float &r_rady) const;
   void updateGauss();
+  bool use_fft_convolution() const;
 
  public:
   GaussianBokehBlurOperation();
@@ -47,6 +54,12 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   bool determineDependingAreaOfInterest(rcti *input,
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &output_area,
+                            Span<MemoryBuffer *> inputs,
+                            ExecutionSystem &exec_system) override;
 };
 
 class GaussianBlurReferenceOperation : public BlurBaseOperation {
@@ -62,10 +62,19 @@ class GaussianXBlurOperation : public BlurBaseOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
 
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &output_area,
+                            Span<MemoryBuffer *> inputs,
+                            ExecutionSystem &exec_system) override;
+
   void checkOpenCL()
   {
     flags.open_cl = (m_data.sizex >= 128);
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
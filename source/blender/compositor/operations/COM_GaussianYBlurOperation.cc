@@ -18,6 +18,7 @@
 
 #include "COM_GaussianYBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_ExecutionSystem.h"
 #include "COM_OpenCLDevice.h"
 #include "MEM_guardedalloc.h"
 
@@ -27,6 +28,7 @@ namespace blender::compositor {
 
 GaussianYBlurOperation::GaussianYBlurOperation() : BlurBaseOperation(DataType::Color)
 {
+  flags.is_fullframe_operation = true;
   this->m_gausstab = nullptr;
 #ifdef BLI_HAVE_SSE2
   this->m_gausstab_sse = nullptr;
@@ -208,4 +210,83 @@ bool GaussianYBlurOperation::determineDependingAreaOfInterest(rcti *input,
   }
 }
 
+void GaussianYBlurOperation::get_area_of_interest(const int input_idx,
+                                                  const rcti &output_area,
+                                                  rcti &r_input_area)
+{
+  if (input_idx == 1) {
+    /* Size input, only its first element is read. */
+    BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+    return;
+  }
+
+  r_input_area = output_area;
+  if (this->m_sizeavailable) {
+    init_data();
+    const float rad = max_ff(m_size * m_data.sizey, 0.0f);
+    const int filter_size = min_ii(ceil(rad), MAX_GAUSSTAB_RADIUS);
+    r_input_area.ymin -= filter_size + 1;
+    r_input_area.ymax += filter_size + 1;
+  }
+  else {
+    /* Size is only known once the size input is rendered, read whole columns. */
+    r_input_area.ymin = 0;
+    r_input_area.ymax = this->getHeight();
+  }
+}
+
+void GaussianYBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                                  const rcti &output_area,
+                                                  Span<MemoryBuffer *> inputs,
+                                                  ExecutionSystem &exec_system)
+{
+  if (this->m_gausstab == nullptr) {
+    /* Size input is not constant, it's rendered at this point. */
+    this->m_size = *inputs[1]->get_elem(0, 0);
+    this->m_sizeavailable = true;
+    updateGauss();
+  }
+
+  const MemoryBuffer *input = inputs[0];
+  const rcti &input_rect = input->get_rect();
+  const int step = getStep();
+  const int in_stride = input->row_stride * step;
+  exec_system.execute_work(output_area, [=](const rcti &split_rect) {
+    for (int y = split_rect.ymin; y < split_rect.ymax; y++) {
+      float *out = output->get_elem(split_rect.xmin, y);
+      for (int x = split_rect.xmin; x < split_rect.xmax; x++, out += output->elem_stride) {
+        const int ymin = max_ii(y - m_filtersize, input_rect.ymin);
+        const int ymax = min_ii(y + m_filtersize + 1, input_rect.ymax);
+        const float *in = input->get_elem(x, ymin);
+        const int index_start = (ymin - y) + m_filtersize;
+        const int index_end = (ymax - y) + m_filtersize;
+        float ATTR_ALIGN(16) color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float multiplier_accum = 0.0f;
+#ifdef BLI_HAVE_SSE2
+        __m128 accum_r = _mm_load_ps(color_accum);
+        for (int index = index_start; index < index_end; index += step, in += in_stride) {
+          __m128 reg_a = _mm_load_ps(in);
+          reg_a = _mm_mul_ps(reg_a, this->m_gausstab_sse[index]);
+          accum_r = _mm_add_ps(accum_r, reg_a);
+          multiplier_accum += this->m_gausstab[index];
+        }
+        _mm_store_ps(color_accum, accum_r);
+#else
+        for (int index = index_start; index < index_end; index += step, in += in_stride) {
+          const float multiplier = this->m_gausstab[index];
+          madd_v4_v4fl(color_accum, in, multiplier);
+          multiplier_accum += multiplier;
+        }
+#endif
+        mul_v4_v4fl(out, color_accum, 1.0f / multiplier_accum);
+      }
+    }
+  });
+}
+
+void GaussianYBlurOperation::hash_output_params()
+{
+  hash_blur_params();
+}
+
 }  // namespace blender::compositor
@@ -67,6 +67,31 @@ void HueSaturationValueCorrectOperation::executePixelSampled(float output[4],
   output[3] = hsv[3];
 }
 
+void HueSaturationValueCorrectOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    float hsv[4];
+    copy_v4_v4(hsv, p.ins[0]);
+
+    /* adjust hue, scaling returned default 0.5 up to 1 */
+    float f = BKE_curvemapping_evaluateF(this->m_curveMapping, 0, hsv[0]);
+    hsv[0] += f - 0.5f;
+
+    /* adjust saturation, scaling returned default 0.5 up to 1 */
+    f = BKE_curvemapping_evaluateF(this->m_curveMapping, 1, hsv[0]);
+    hsv[1] *= (f * 2.0f);
+
+    /* adjust value, scaling returned default 0.5 up to 1 */
+    f = BKE_curvemapping_evaluateF(this->m_curveMapping, 2, hsv[0]);
+    hsv[2] *= (f * 2.0f);
+
+    hsv[0] = hsv[0] - floorf(hsv[0]); /* mod 1.0 */
+    CLAMP(hsv[1], 0.0f, 1.0f);
+
+    copy_v4_v4(p.out, hsv);
+  }
+}
+
 void HueSaturationValueCorrectOperation::deinitExecution()
 {
   CurveBaseOperation::deinitExecution();
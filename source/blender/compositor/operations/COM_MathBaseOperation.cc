@@ -48,6 +48,11 @@ void MathBaseOperation::deinitExecution()
   this->m_inputValue3Operation = nullptr;
 }
 
+void MathBaseOperation::hash_output_params()
+{
+  hash_params(m_useClamp);
+}
+
 void MathBaseOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
@@ -86,6 +91,11 @@ void MathAddOperation::executePixelSampled(float output[4], float x, float y, Pi
   clampIfNeeded(output);
 }
 
+void MathAddOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return a + b; });
+}
+
 void MathSubtractOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -102,6 +112,11 @@ void MathSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSubtractOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return a - b; });
+}
+
 void MathMultiplyOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -118,6 +133,11 @@ void MathMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathMultiplyOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return a * b; });
+}
+
 void MathDivideOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -139,6 +159,14 @@ void MathDivideOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathDivideOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) {
+    /* We don't want to divide by zero. */
+    return (b == 0.0f) ? 0.0f : a / b;
+  });
+}
+
 void MathSineOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -155,6 +183,11 @@ void MathSineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return sinf(a); });
+}
+
 void MathCosineOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -171,6 +204,11 @@ void MathCosineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathCosineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return cosf(a); });
+}
+
 void MathTangentOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -187,6 +225,11 @@ void MathTangentOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathTangentOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return tanf(a); });
+}
+
 void MathHyperbolicSineOperation::executePixelSampled(float output[4],
                                                       float x,
                                                       float y,
@@ -203,6 +246,11 @@ void MathHyperbolicSineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathHyperbolicSineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return sinhf(a); });
+}
+
 void MathHyperbolicCosineOperation::executePixelSampled(float output[4],
                                                         float x,
                                                         float y,
@@ -219,6 +267,11 @@ void MathHyperbolicCosineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathHyperbolicCosineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return coshf(a); });
+}
+
 void MathHyperbolicTangentOperation::executePixelSampled(float output[4],
                                                          float x,
                                                          float y,
@@ -235,6 +288,11 @@ void MathHyperbolicTangentOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathHyperbolicTangentOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return tanhf(a); });
+}
+
 void MathArcSineOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -256,6 +314,13 @@ void MathArcSineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathArcSineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) {
+    return (a <= 1.0f && a >= -1.0f) ? asinf(a) : 0.0f;
+  });
+}
+
 void MathArcCosineOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -277,6 +342,13 @@ void MathArcCosineOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathArcCosineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) {
+    return (a <= 1.0f && a >= -1.0f) ? acosf(a) : 0.0f;
+  });
+}
+
 void MathArcTangentOperation::executePixelSampled(float output[4],
                                                   float x,
                                                   float y,
@@ -293,6 +365,11 @@ void MathArcTangentOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathArcTangentOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return atanf(a); });
+}
+
 void MathPowerOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -321,6 +398,21 @@ void MathPowerOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathPowerOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) {
+    if (a >= 0.0f) {
+      return powf(a, b);
+    }
+    const float y_mod_1 = fmodf(b, 1.0f);
+    /* if input value is not nearly an integer, fall back to zero, nicer than straight rounding */
+    if (y_mod_1 > 0.999f || y_mod_1 < 0.001f) {
+      return powf(a, floorf(b + 0.5f));
+    }
+    return 0.0f;
+  });
+}
+
 void MathLogarithmOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -342,6 +434,13 @@ void MathLogarithmOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathLogarithmOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) {
+    return (a > 0.0f && b > 0.0f) ? logf(a) / logf(b) : 0.0f;
+  });
+}
+
 void MathMinimumOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -358,6 +457,11 @@ void MathMinimumOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathMinimumOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return MIN2(a, b); });
+}
+
 void MathMaximumOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -374,6 +478,11 @@ void MathMaximumOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathMaximumOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return MAX2(a, b); });
+}
+
 void MathRoundOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -390,6 +499,11 @@ void MathRoundOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathRoundOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return roundf(a); });
+}
+
 void MathLessThanOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -406,6 +520,11 @@ void MathLessThanOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathLessThanOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return a < b ? 1.0f : 0.0f; });
+}
+
 void MathGreaterThanOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -422,6 +541,11 @@ void MathGreaterThanOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathGreaterThanOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return a > b ? 1.0f : 0.0f; });
+}
+
 void MathModuloOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -443,6 +567,13 @@ void MathModuloOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathModuloOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) {
+    return (b == 0.0f) ? 0.0f : fmodf(a, b);
+  });
+}
+
 void MathAbsoluteOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -457,6 +588,11 @@ void MathAbsoluteOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathAbsoluteOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return fabsf(a); });
+}
+
 void MathRadiansOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -471,6 +607,11 @@ void MathRadiansOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathRadiansOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return DEG2RADF(a); });
+}
+
 void MathDegreesOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -485,6 +626,11 @@ void MathDegreesOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathDegreesOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return RAD2DEGF(a); });
+}
+
 void MathArcTan2Operation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -501,6 +647,11 @@ void MathArcTan2Operation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathArcTan2Operation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return atan2f(a, b); });
+}
+
 void MathFloorOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -515,6 +666,11 @@ void MathFloorOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathFloorOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return floorf(a); });
+}
+
 void MathCeilOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -529,6 +685,11 @@ void MathCeilOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathCeilOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return ceilf(a); });
+}
+
 void MathFractOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -543,6 +704,11 @@ void MathFractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathFractOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return a - floorf(a); });
+}
+
 void MathSqrtOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -562,6 +728,13 @@ void MathSqrtOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSqrtOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) {
+    return (a > 0.0f) ? sqrtf(a) : 0.0f;
+  });
+}
+
 void MathInverseSqrtOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -581,6 +754,13 @@ void MathInverseSqrtOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathInverseSqrtOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) {
+    return (a > 0.0f) ? 1.0f / sqrtf(a) : 0.0f;
+  });
+}
+
 void MathSignOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -595,6 +775,11 @@ void MathSignOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSignOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return compatible_signf(a); });
+}
+
 void MathExponentOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -609,6 +794,11 @@ void MathExponentOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathExponentOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) { return expf(a); });
+}
+
 void MathTruncOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -623,6 +813,13 @@ void MathTruncOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathTruncOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float, const float) {
+    return (a >= 0.0f) ? floorf(a) : ceilf(a);
+  });
+}
+
 void MathSnapOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -644,6 +841,14 @@ void MathSnapOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSnapOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) {
+    /* We don't want to divide by zero. */
+    return (a == 0.0f || b == 0.0f) ? 0.0f : floorf(a / b) * b;
+  });
+}
+
 void MathWrapOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -662,6 +867,11 @@ void MathWrapOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathWrapOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float c) { return wrapf(a, b, c); });
+}
+
 void MathPingpongOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -678,6 +888,11 @@ void MathPingpongOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathPingpongOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float) { return pingpongf(a, b); });
+}
+
 void MathCompareOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -697,6 +912,13 @@ void MathCompareOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathCompareOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float c) {
+    return (fabsf(a - b) <= MAX2(c, 1e-5f)) ? 1.0f : 0.0f;
+  });
+}
+
 void MathMultiplyAddOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -715,6 +937,11 @@ void MathMultiplyAddOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathMultiplyAddOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float c) { return a * b + c; });
+}
+
 void MathSmoothMinOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -733,6 +960,11 @@ void MathSmoothMinOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSmoothMinOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float c) { return smoothminf(a, b, c); });
+}
+
 void MathSmoothMaxOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -751,4 +983,11 @@ void MathSmoothMaxOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MathSmoothMaxOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  update_row(p, [](const float a, const float b, const float c) {
+    return -smoothminf(-a, -b, c);
+  });
+}
+
 }  // namespace blender::compositor
@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedRowOperation.h"
 
 namespace blender::compositor {
 
@@ -26,7 +26,7 @@ namespace blender::compositor {
  * this program converts an input color to an output value.
  * it assumes we are in sRGB color space.
  */
-class MathBaseOperation : public NodeOperation {
+class MathBaseOperation : public MultiThreadedRowOperation {
  protected:
   /**
    * Prefetched reference to the inputProgram
@@ -45,6 +45,23 @@ class MathBaseOperation : public NodeOperation {
 
   void clampIfNeeded(float color[4]);
 
+  /**
+   * Evaluates `math_fn(value1, value2, value3)` for every element of the cursor row.
+   */
+  template<typename MathFn> void update_row(PixelCursor &p, MathFn &&math_fn)
+  {
+    if (m_useClamp) {
+      for (; p.out < p.row_end; p.next()) {
+        p.out[0] = clamp_f(math_fn(p.ins[0][0], p.ins[1][0], p.ins[2][0]), 0.0f, 1.0f);
+      }
+    }
+    else {
+      for (; p.out < p.row_end; p.next()) {
+        p.out[0] = math_fn(p.ins[0][0], p.ins[1][0], p.ins[2][0]);
+      }
+    }
+  }
+
  public:
   /**
    * Initialize the execution
@@ -66,6 +83,9 @@ class MathBaseOperation : public NodeOperation {
   {
     this->m_useClamp = value;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 class MathAddOperation : public MathBaseOperation {
@@ -74,6 +94,9 @@ class MathAddOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathSubtractOperation : public MathBaseOperation {
  public:
@@ -81,6 +104,9 @@ class MathSubtractOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathMultiplyOperation : public MathBaseOperation {
  public:
@@ -88,6 +114,9 @@ class MathMultiplyOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathDivideOperation : public MathBaseOperation {
  public:
@@ -95,6 +124,9 @@ class MathDivideOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathSineOperation : public MathBaseOperation {
  public:
@@ -102,6 +134,9 @@ class MathSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathCosineOperation : public MathBaseOperation {
  public:
@@ -109,6 +144,9 @@ class MathCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathTangentOperation : public MathBaseOperation {
  public:
@@ -116,6 +154,9 @@ class MathTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathHyperbolicSineOperation : public MathBaseOperation {
@@ -124,6 +165,9 @@ class MathHyperbolicSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathHyperbolicCosineOperation : public MathBaseOperation {
  public:
@@ -131,6 +175,9 @@ class MathHyperbolicCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathHyperbolicTangentOperation : public MathBaseOperation {
  public:
@@ -138,6 +185,9 @@ class MathHyperbolicTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathArcSineOperation : public MathBaseOperation {
@@ -146,6 +196,9 @@ class MathArcSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathArcCosineOperation : public MathBaseOperation {
  public:
@@ -153,6 +206,9 @@ class MathArcCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathArcTangentOperation : public MathBaseOperation {
  public:
@@ -160,6 +216,9 @@ class MathArcTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathPowerOperation : public MathBaseOperation {
  public:
@@ -167,6 +226,9 @@ class MathPowerOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathLogarithmOperation : public MathBaseOperation {
  public:
@@ -174,6 +236,9 @@ class MathLogarithmOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathMinimumOperation : public MathBaseOperation {
  public:
@@ -181,6 +246,9 @@ class MathMinimumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathMaximumOperation : public MathBaseOperation {
  public:
@@ -188,6 +256,9 @@ class MathMaximumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathRoundOperation : public MathBaseOperation {
  public:
@@ -195,6 +266,9 @@ class MathRoundOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathLessThanOperation : public MathBaseOperation {
  public:
@@ -202,6 +276,9 @@ class MathLessThanOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 class MathGreaterThanOperation : public MathBaseOperation {
  public:
@@ -209,6 +286,9 @@ class MathGreaterThanOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathModuloOperation : public MathBaseOperation {
@@ -217,6 +297,9 @@ class MathModuloOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathAbsoluteOperation : public MathBaseOperation {
@@ -225,6 +308,9 @@ class MathAbsoluteOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathRadiansOperation : public MathBaseOperation {
@@ -233,6 +319,9 @@ class MathRadiansOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathDegreesOperation : public MathBaseOperation {
@@ -241,6 +330,9 @@ class MathDegreesOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathArcTan2Operation : public MathBaseOperation {
@@ -249,6 +341,9 @@ class MathArcTan2Operation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathFloorOperation : public MathBaseOperation {
@@ -257,6 +352,9 @@ class MathFloorOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathCeilOperation : public MathBaseOperation {
@@ -265,6 +363,9 @@ class MathCeilOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathFractOperation : public MathBaseOperation {
@@ -273,6 +374,9 @@ class MathFractOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathSqrtOperation : public MathBaseOperation {
@@ -281,6 +385,9 @@ class MathSqrtOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathInverseSqrtOperation : public MathBaseOperation {
@@ -289,6 +396,9 @@ class MathInverseSqrtOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathSignOperation : public MathBaseOperation {
@@ -297,6 +407,9 @@ class MathSignOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathExponentOperation : public MathBaseOperation {
@@ -305,6 +418,9 @@ class MathExponentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathTruncOperation : public MathBaseOperation {
@@ -313,6 +429,9 @@ class MathTruncOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathSnapOperation : public MathBaseOperation {
@@ -321,6 +440,9 @@ class MathSnapOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathWrapOperation : public MathBaseOperation {
@@ -329,6 +451,9 @@ class MathWrapOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathPingpongOperation : public MathBaseOperation {
@@ -337,6 +462,9 @@ class MathPingpongOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathCompareOperation : public MathBaseOperation {
@@ -345,6 +473,9 @@ class MathCompareOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathMultiplyAddOperation : public MathBaseOperation {
@@ -353,6 +484,9 @@ class MathMultiplyAddOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathSmoothMinOperation : public MathBaseOperation {
@@ -361,6 +495,9 @@ class MathSmoothMinOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 class MathSmoothMaxOperation : public MathBaseOperation {
@@ -369,6 +506,9 @@ class MathSmoothMaxOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+
+ protected:
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 }  // namespace blender::compositor
@@ -65,6 +65,24 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
   output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = valuem * color1[0] + value * color2[0];
+    p.out[1] = valuem * color1[1] + value * color2[1];
+    p.out[2] = valuem * color1[2] + value * color2[2];
+    p.out[3] = color1[3];
+    p.next();
+  }
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2],
                                            unsigned int preferredResolution[2])
 {
@@ -97,6 +115,11 @@ void MixBaseOperation::deinitExecution()
   this->m_inputColor2Operation = nullptr;
 }
 
+void MixBaseOperation::hash_output_params()
+{
+  hash_params(m_valueAlphaMultiply, m_useClamp);
+}
+
 /* ******** Mix Add Operation ******** */
 
 void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -121,6 +144,25 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+void MixAddOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    p.out[0] = color1[0] + value * color2[0];
+    p.out[1] = color1[1] + value * color2[1];
+    p.out[2] = color1[2] + value * color2[2];
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Blend Operation ******** */
 
 void MixBlendOperation::executePixelSampled(float output[4],
@@ -150,6 +192,26 @@ void MixBlendOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixBlendOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = valuem * color1[0] + value * color2[0];
+    p.out[1] = valuem * color1[1] + value * color2[1];
+    p.out[2] = valuem * color1[2] + value * color2[2];
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Burn Operation ******** */
 
 void MixColorBurnOperation::executePixelSampled(float output[4],
@@ -228,6 +290,27 @@ void MixColorBurnOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixColorBurnOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    for (int i = 0; i < 3; i++) {
+      const float tmp = valuem + value * color2[i];
+      p.out[i] = (tmp <= 0.0f) ? 0.0f : clamp_f(1.0f - (1.0f - color1[i]) / tmp, 0.0f, 1.0f);
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Color Operation ******** */
 
 void MixColorOperation::executePixelSampled(float output[4],
@@ -268,6 +351,37 @@ void MixColorOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixColorOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    float colH, colS, colV;
+    rgb_to_hsv(color2[0], color2[1], color2[2], &colH, &colS, &colV);
+    if (colS != 0.0f) {
+      float rH, rS, rV;
+      float tmpr, tmpg, tmpb;
+      rgb_to_hsv(color1[0], color1[1], color1[2], &rH, &rS, &rV);
+      hsv_to_rgb(colH, colS, rV, &tmpr, &tmpg, &tmpb);
+      p.out[0] = (valuem * color1[0]) + (value * tmpr);
+      p.out[1] = (valuem * color1[1]) + (value * tmpg);
+      p.out[2] = (valuem * color1[2]) + (value * tmpb);
+    }
+    else {
+      copy_v3_v3(p.out, color1);
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Darken Operation ******** */
 
 void MixDarkenOperation::executePixelSampled(float output[4],
@@ -296,6 +410,26 @@ void MixDarkenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixDarkenOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = min_ff(color1[0], color2[0]) * value + color1[0] * valuem;
+    p.out[1] = min_ff(color1[1], color2[1]) * value + color1[1] * valuem;
+    p.out[2] = min_ff(color1[2], color2[2]) * value + color1[2] * valuem;
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Difference Operation ******** */
 
 void MixDifferenceOperation::executePixelSampled(float output[4],
@@ -324,6 +458,26 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixDifferenceOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = valuem * color1[0] + value * fabsf(color1[0] - color2[0]);
+    p.out[1] = valuem * color1[1] + value * fabsf(color1[1] - color2[1]);
+    p.out[2] = valuem * color1[2] + value * fabsf(color1[2] - color2[2]);
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Difference Operation ******** */
 
 void MixDivideOperation::executePixelSampled(float output[4],
@@ -369,6 +523,26 @@ void MixDivideOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixDivideOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    for (int i = 0; i < 3; i++) {
+      p.out[i] = (color2[i] != 0.0f) ? valuem * color1[i] + value * color1[i] / color2[i] : 0.0f;
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Dodge Operation ******** */
 
 void MixDodgeOperation::executePixelSampled(float output[4],
@@ -452,6 +626,31 @@ void MixDodgeOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixDodgeOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    for (int i = 0; i < 3; i++) {
+      if (color1[i] != 0.0f) {
+        const float tmp = 1.0f - value * color2[i];
+        p.out[i] = (tmp <= 0.0f) ? 1.0f : min_ff(color1[i] / tmp, 1.0f);
+      }
+      else {
+        p.out[i] = 0.0f;
+      }
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Glare Operation ******** */
 
 void MixGlareOperation::executePixelSampled(float output[4],
@@ -487,6 +686,35 @@ void MixGlareOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixGlareOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    const float value = p.ins[0][0];
+    /* Linear interpolation between 3 cases:
+     *  value=-1:output=input    value=0:output=input+glare   value=1:output=glare
+     */
+    float input_weight;
+    float glare_weight;
+    if (value < 0.0f) {
+      input_weight = 1.0f;
+      glare_weight = 1.0f + value;
+    }
+    else {
+      input_weight = 1.0f - value;
+      glare_weight = 1.0f;
+    }
+    p.out[0] = input_weight * MAX2(color1[0], 0.0f) + glare_weight * color2[0];
+    p.out[1] = input_weight * MAX2(color1[1], 0.0f) + glare_weight * color2[1];
+    p.out[2] = input_weight * MAX2(color1[2], 0.0f) + glare_weight * color2[2];
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Hue Operation ******** */
 
 void MixHueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -524,6 +752,37 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+void MixHueOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    float colH, colS, colV;
+    rgb_to_hsv(color2[0], color2[1], color2[2], &colH, &colS, &colV);
+    if (colS != 0.0f) {
+      float rH, rS, rV;
+      float tmpr, tmpg, tmpb;
+      rgb_to_hsv(color1[0], color1[1], color1[2], &rH, &rS, &rV);
+      hsv_to_rgb(colH, rS, rV, &tmpr, &tmpg, &tmpb);
+      p.out[0] = valuem * color1[0] + value * tmpr;
+      p.out[1] = valuem * color1[1] + value * tmpg;
+      p.out[2] = valuem * color1[2] + value * tmpb;
+    }
+    else {
+      copy_v3_v3(p.out, color1);
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Lighten Operation ******** */
 
 void MixLightenOperation::executePixelSampled(float output[4],
@@ -570,6 +829,26 @@ void MixLightenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixLightenOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    for (int i = 0; i < 3; i++) {
+      const float tmp = value * color2[i];
+      p.out[i] = (tmp > color1[i]) ? tmp : color1[i];
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Linear Light Operation ******** */
 
 void MixLinearLightOperation::executePixelSampled(float output[4],
@@ -613,6 +892,30 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixLinearLightOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    for (int i = 0; i < 3; i++) {
+      if (color2[i] > 0.5f) {
+        p.out[i] = color1[i] + value * (2.0f * (color2[i] - 0.5f));
+      }
+      else {
+        p.out[i] = color1[i] + value * (2.0f * color2[i] - 1.0f);
+      }
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Multiply Operation ******** */
 
 void MixMultiplyOperation::executePixelSampled(float output[4],
@@ -641,6 +944,26 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = color1[0] * (valuem + value * color2[0]);
+    p.out[1] = color1[1] * (valuem + value * color2[1]);
+    p.out[2] = color1[2] * (valuem + value * color2[2]);
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Overlay Operation ******** */
 
 void MixOverlayOperation::executePixelSampled(float output[4],
@@ -686,6 +1009,31 @@ void MixOverlayOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixOverlayOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    for (int i = 0; i < 3; i++) {
+      if (color1[i] < 0.5f) {
+        p.out[i] = color1[i] * (valuem + 2.0f * value * color2[i]);
+      }
+      else {
+        p.out[i] = 1.0f - (valuem + 2.0f * value * (1.0f - color2[i])) * (1.0f - color1[i]);
+      }
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Saturation Operation ******** */
 
 void MixSaturationOperation::executePixelSampled(float output[4],
@@ -723,6 +1071,33 @@ void MixSaturationOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixSaturationOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    float rH, rS, rV;
+    rgb_to_hsv(color1[0], color1[1], color1[2], &rH, &rS, &rV);
+    if (rS != 0.0f) {
+      float colH, colS, colV;
+      rgb_to_hsv(color2[0], color2[1], color2[2], &colH, &colS, &colV);
+      hsv_to_rgb(rH, (valuem * rS + value * colS), rV, &p.out[0], &p.out[1], &p.out[2]);
+    }
+    else {
+      copy_v3_v3(p.out, color1);
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Screen Operation ******** */
 
 void MixScreenOperation::executePixelSampled(float output[4],
@@ -752,6 +1127,26 @@ void MixScreenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixScreenOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    p.out[0] = 1.0f - (valuem + value * (1.0f - color2[0])) * (1.0f - color1[0]);
+    p.out[1] = 1.0f - (valuem + value * (1.0f - color2[1])) * (1.0f - color1[1]);
+    p.out[2] = 1.0f - (valuem + value * (1.0f - color2[2])) * (1.0f - color1[2]);
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 void MixSoftLightOperation::executePixelSampled(float output[4],
@@ -793,6 +1188,29 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixSoftLightOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    for (int i = 0; i < 3; i++) {
+      /* First calculate non-fac based Screen mix. */
+      const float screen = 1.0f - (1.0f - color2[i]) * (1.0f - color1[i]);
+      p.out[i] = valuem * color1[i] +
+                 value * (((1.0f - color1[i]) * color2[i] * color1[i]) + (color1[i] * screen));
+    }
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Subtract Operation ******** */
 
 void MixSubtractOperation::executePixelSampled(float output[4],
@@ -820,6 +1238,25 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixSubtractOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    p.out[0] = color1[0] - value * color2[0];
+    p.out[1] = color1[1] - value * color2[1];
+    p.out[2] = color1[2] - value * color2[2];
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 /* ******** Mix Value Operation ******** */
 
 void MixValueOperation::executePixelSampled(float output[4],
@@ -851,4 +1288,26 @@ void MixValueOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixValueOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  while (p.out < p.row_end) {
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    float value = p.ins[0][0];
+    if (this->useValueAlphaMultiply()) {
+      value *= color2[3];
+    }
+    const float valuem = 1.0f - value;
+    float rH, rS, rV;
+    float colH, colS, colV;
+    rgb_to_hsv(color1[0], color1[1], color1[2], &rH, &rS, &rV);
+    rgb_to_hsv(color2[0], color2[1], color2[2], &colH, &colS, &colV);
+    hsv_to_rgb(rH, rS, (valuem * rV + value * colV), &p.out[0], &p.out[1], &p.out[2]);
+    p.out[3] = color1[3];
+
+    clampIfNeeded(p.out);
+    p.next();
+  }
+}
+
 }  // namespace blender::compositor
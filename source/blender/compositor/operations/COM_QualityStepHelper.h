@@ -47,6 +47,10 @@ class QualityStepHelper {
   {
     return this->m_offsetadd;
   }
+  inline eCompositorQuality getQuality() const
+  {
+    return this->m_quality;
+  }
 
  public:
   QualityStepHelper();
@@ -47,11 +47,15 @@ RenderLayersProg::RenderLayersProg(const char *passName, DataType type, int elem
   this->addOutputSocket(type);
 }
 
-void RenderLayersProg::initExecution()
+/**
+ * Get the float buffer of the render pass, nullptr when the pass has not been rendered.
+ */
+float *RenderLayersProg::get_pass_buffer()
 {
   Scene *scene = this->getScene();
   Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
   RenderResult *rr = nullptr;
+  float *pass_buffer = nullptr;
 
   if (re) {
     rr = RE_AcquireResultRead(re);
@@ -63,8 +67,7 @@ void RenderLayersProg::initExecution()
 
       RenderLayer *rl = RE_GetRenderLayer(rr, view_layer->name);
       if (rl) {
-        this->m_inputBuffer = RE_RenderLayerGetPass(
-            rl, this->m_passName.c_str(), this->m_viewName);
+        pass_buffer = RE_RenderLayerGetPass(rl, this->m_passName.c_str(), this->m_viewName);
       }
     }
   }
@@ -72,6 +75,26 @@ void RenderLayersProg::initExecution()
     RE_ReleaseResult(re);
     re = nullptr;
   }
+  return pass_buffer;
+}
+
+void RenderLayersProg::initExecution()
+{
+  this->m_inputBuffer = get_pass_buffer();
+}
+
+void RenderLayersProg::hash_output_params()
+{
+  /* Pass contents only change on rendering. Identify the render by its start time as buffers
+   * addresses may be reused. */
+  Render *re = (m_scene) ? RE_GetSceneRender(m_scene) : nullptr;
+  if (re) {
+    hash_params(RE_GetStats(re)->starttime);
+  }
+  hash_params(m_scene, m_layerId, m_passName, get_pass_buffer());
+  if (m_viewName) {
+    hash_params(StringRef(m_viewName));
+  }
 }
 
 void RenderLayersProg::doInterpolation(float output[4], float x, float y, PixelSampler sampler)
@@ -83,6 +83,11 @@ class RenderLayersProg : public NodeOperation {
 
   void doInterpolation(float output[4], float x, float y, PixelSampler sampler);
 
+  void hash_output_params() override;
+
+ private:
+  float *get_pass_buffer();
+
  public:
   /**
    * Constructor
@@ -46,25 +46,66 @@ void RotateOperation::deinitExecution()
   this->m_degreeSocket = nullptr;
 }
 
+void RotateOperation::hash_output_params()
+{
+  hash_params(m_doDegree2RadConversion);
+}
+
+void RotateOperation::set_degree(const float degree)
+{
+  double rad;
+  if (this->m_doDegree2RadConversion) {
+    rad = DEG2RAD((double)degree);
+  }
+  else {
+    rad = degree;
+  }
+  this->m_cosine = cos(rad);
+  this->m_sine = sin(rad);
+
+  this->m_isDegreeSet = true;
+}
+
 inline void RotateOperation::ensureDegree()
 {
   if (!this->m_isDegreeSet) {
     float degree[4];
     this->m_degreeSocket->readSampled(degree, 0, 0, PixelSampler::Nearest);
-    double rad;
-    if (this->m_doDegree2RadConversion) {
-      rad = DEG2RAD((double)degree[0]);
-    }
-    else {
-      rad = degree[0];
-    }
-    this->m_cosine = cos(rad);
-    this->m_sine = sin(rad);
-
-    this->m_isDegreeSet = true;
+    set_degree(degree[0]);
   }
 }
 
+void RotateOperation::get_rotation_bounds(const rcti &area,
+                                          const float center_x,
+                                          const float center_y,
+                                          const float sine,
+                                          const float cosine,
+                                          rcti &r_bounds)
+{
+  const float dxmin = area.xmin - center_x;
+  const float dymin = area.ymin - center_y;
+  const float dxmax = area.xmax - center_x;
+  const float dymax = area.ymax - center_y;
+
+  const float x1 = center_x + (cosine * dxmin + sine * dymin);
+  const float x2 = center_x + (cosine * dxmax + sine * dymin);
+  const float x3 = center_x + (cosine * dxmin + sine * dymax);
+  const float x4 = center_x + (cosine * dxmax + sine * dymax);
+  const float y1 = center_y + (-sine * dxmin + cosine * dymin);
+  const float y2 = center_y + (-sine * dxmax + cosine * dymin);
+  const float y3 = center_y + (-sine * dxmin + cosine * dymax);
+  const float y4 = center_y + (-sine * dxmax + cosine * dymax);
+  const float minx = MIN2(x1, MIN2(x2, MIN2(x3, x4)));
+  const float maxx = MAX2(x1, MAX2(x2, MAX2(x3, x4)));
+  const float miny = MIN2(y1, MIN2(y2, MIN2(y3, y4)));
+  const float maxy = MAX2(y1, MAX2(y2, MAX2(y3, y4)));
+
+  r_bounds.xmax = ceil(maxx) + 1;
+  r_bounds.xmin = floor(minx) - 1;
+  r_bounds.ymax = ceil(maxy) + 1;
+  r_bounds.ymin = floor(miny) - 1;
+}
+
 void RotateOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
   ensureDegree();
@@ -81,31 +122,65 @@ bool RotateOperation::determineDependingAreaOfInterest(rcti *input,
 {
   ensureDegree();
   rcti newInput;
+  get_rotation_bounds(
+      *input, this->m_centerX, this->m_centerY, this->m_sine, this->m_cosine, newInput);
 
-  const float dxmin = input->xmin - this->m_centerX;
-  const float dymin = input->ymin - this->m_centerY;
-  const float dxmax = input->xmax - this->m_centerX;
-  const float dymax = input->ymax - this->m_centerY;
-
-  const float x1 = this->m_centerX + (this->m_cosine * dxmin + this->m_sine * dymin);
-  const float x2 = this->m_centerX + (this->m_cosine * dxmax + this->m_sine * dymin);
-  const float x3 = this->m_centerX + (this->m_cosine * dxmin + this->m_sine * dymax);
-  const float x4 = this->m_centerX + (this->m_cosine * dxmax + this->m_sine * dymax);
-  const float y1 = this->m_centerY + (-this->m_sine * dxmin + this->m_cosine * dymin);
-  const float y2 = this->m_centerY + (-this->m_sine * dxmax + this->m_cosine * dymin);
-  const float y3 = this->m_centerY + (-this->m_sine * dxmin + this->m_cosine * dymax);
-  const float y4 = this->m_centerY + (-this->m_sine * dxmax + this->m_cosine * dymax);
-  const float minx = MIN2(x1, MIN2(x2, MIN2(x3, x4)));
-  const float maxx = MAX2(x1, MAX2(x2, MAX2(x3, x4)));
-  const float miny = MIN2(y1, MIN2(y2, MIN2(y3, y4)));
-  const float maxy = MAX2(y1, MAX2(y2, MAX2(y3, y4)));
+  return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
+}
 
-  newInput.xmax = ceil(maxx) + 1;
-  newInput.xmin = floor(minx) - 1;
-  newInput.ymax = ceil(maxy) + 1;
-  newInput.ymin = floor(miny) - 1;
+void RotateOperation::get_area_of_interest(const int input_idx,
+                                           const rcti &output_area,
+                                           rcti &r_input_area)
+{
+  if (input_idx == 1) {
+    /* Degree input, only its first element is read. */
+    BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+    return;
+  }
 
-  return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
+  float degree;
+  if (!this->m_isDegreeSet && get_input_constant_value(1, degree)) {
+    set_degree(degree);
+  }
+  if (!this->m_isDegreeSet) {
+    NodeOperation *image_op = get_input_operation(0);
+    BLI_rcti_init(&r_input_area, 0, image_op->getWidth(), 0, image_op->getHeight());
+    return;
+  }
+
+  const float center_x = (getWidth() - 1) / 2.0;
+  const float center_y = (getHeight() - 1) / 2.0;
+  get_rotation_bounds(output_area, center_x, center_y, m_sine, m_cosine, r_input_area);
+}
+
+void RotateOperation::update_memory_buffer_started(MemoryBuffer *UNUSED(output),
+                                                   const rcti &UNUSED(output_rect),
+                                                   Span<MemoryBuffer *> inputs,
+                                                   ExecutionSystem &UNUSED(exec_system),
+                                                   int UNUSED(current_pass))
+{
+  if (!this->m_isDegreeSet) {
+    set_degree(*inputs[1]->get_elem(0, 0));
+  }
+}
+
+void RotateOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                   const rcti &output_rect,
+                                                   Span<MemoryBuffer *> inputs,
+                                                   ExecutionSystem &UNUSED(exec_system),
+                                                   int UNUSED(current_pass))
+{
+  MemoryBuffer *input_image = inputs[0];
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    float *out = output->get_elem(output_rect.xmin, y);
+    const float dy = y - this->m_centerY;
+    for (int x = output_rect.xmin; x < output_rect.xmax; x++, out += output->elem_stride) {
+      const float dx = x - this->m_centerX;
+      const float nx = this->m_centerX + (this->m_cosine * dx + this->m_sine * dy);
+      const float ny = this->m_centerY + (-this->m_sine * dx + this->m_cosine * dy);
+      input_image->readBilinear(out, nx, ny);
+    }
+  }
 }
 
 }  // namespace blender::compositor
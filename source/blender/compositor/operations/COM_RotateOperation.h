@@ -18,11 +18,11 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedOperation.h"
 
 namespace blender::compositor {
 
-class RotateOperation : public NodeOperation {
+class RotateOperation : public MultiThreadedOperation {
  private:
   SocketReader *m_imageSocket;
   SocketReader *m_degreeSocket;
@@ -33,6 +33,14 @@ class RotateOperation : public NodeOperation {
   bool m_doDegree2RadConversion;
   bool m_isDegreeSet;
 
+  void set_degree(float degree);
+  static void get_rotation_bounds(const rcti &area,
+                                  float center_x,
+                                  float center_y,
+                                  float sine,
+                                  float cosine,
+                                  rcti &r_bounds);
+
  public:
   RotateOperation();
   bool determineDependingAreaOfInterest(rcti *input,
@@ -47,6 +55,21 @@ class RotateOperation : public NodeOperation {
   }
 
   void ensureDegree();
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
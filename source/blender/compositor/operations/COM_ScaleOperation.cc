@@ -18,6 +18,8 @@
 
 #include "COM_ScaleOperation.h"
 
+#include "BLI_rect.h"
+
 namespace blender::compositor {
 
 #define USE_FORCE_BILINEAR
@@ -37,6 +39,11 @@ BaseScaleOperation::BaseScaleOperation()
   m_variable_size = false;
 }
 
+void BaseScaleOperation::hash_output_params()
+{
+  hash_params(m_sampler, m_variable_size);
+}
+
 ScaleOperation::ScaleOperation() : BaseScaleOperation()
 {
   this->addInputSocket(DataType::Color);
@@ -111,6 +118,56 @@ bool ScaleOperation::determineDependingAreaOfInterest(rcti *input,
   return BaseScaleOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void ScaleOperation::get_area_of_interest(const int input_idx,
+                                          const rcti &output_area,
+                                          rcti &r_input_area)
+{
+  if (input_idx != 0) {
+    BaseScaleOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  float scx, scy;
+  if (m_variable_size || !get_input_constant_value(1, scx) || !get_input_constant_value(2, scy)) {
+    NodeOperation *image_op = get_input_operation(0);
+    BLI_rcti_init(&r_input_area, 0, image_op->getWidth(), 0, image_op->getHeight());
+    return;
+  }
+
+  const float center_x = this->getWidth() / 2.0f;
+  const float center_y = this->getHeight() / 2.0f;
+  r_input_area.xmax = center_x + (output_area.xmax - center_x) / scx + 1;
+  r_input_area.xmin = center_x + (output_area.xmin - center_x) / scx - 1;
+  r_input_area.ymax = center_y + (output_area.ymax - center_y) / scy + 1;
+  r_input_area.ymin = center_y + (output_area.ymin - center_y) / scy - 1;
+}
+
+void ScaleOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                  const rcti &output_rect,
+                                                  Span<MemoryBuffer *> inputs,
+                                                  ExecutionSystem &UNUSED(exec_system),
+                                                  int UNUSED(current_pass))
+{
+  const PixelSampler sampler = getEffectiveSampler(PixelSampler::Bilinear);
+  MemoryBuffer *input_image = inputs[0];
+  const MemoryBuffer *input_x = inputs[1];
+  const MemoryBuffer *input_y = inputs[2];
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    float *out = output->get_elem(output_rect.xmin, y);
+    const float *scale_x = input_x->get_elem(output_rect.xmin, y);
+    const float *scale_y = input_y->get_elem(output_rect.xmin, y);
+    for (int x = output_rect.xmin; x < output_rect.xmax; x++) {
+      const float nx = this->m_centerX + (x - this->m_centerX) / *scale_x;
+      const float ny = this->m_centerY + (y - this->m_centerY) / *scale_y;
+      sample(input_image, nx, ny, sampler, out);
+
+      out += output->elem_stride;
+      scale_x += input_x->elem_stride;
+      scale_y += input_y->elem_stride;
+    }
+  }
+}
+
 // SCALE ABSOLUTE
 ScaleAbsoluteOperation::ScaleAbsoluteOperation() : BaseScaleOperation()
 {
@@ -202,6 +259,63 @@ bool ScaleAbsoluteOperation::determineDependingAreaOfInterest(rcti *input,
   return BaseScaleOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void ScaleAbsoluteOperation::get_area_of_interest(const int input_idx,
+                                                  const rcti &output_area,
+                                                  rcti &r_input_area)
+{
+  if (input_idx != 0) {
+    BaseScaleOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  float scx, scy;
+  if (m_variable_size || !get_input_constant_value(1, scx) || !get_input_constant_value(2, scy)) {
+    NodeOperation *image_op = get_input_operation(0);
+    BLI_rcti_init(&r_input_area, 0, image_op->getWidth(), 0, image_op->getHeight());
+    return;
+  }
+
+  const float center_x = this->getWidth() / 2.0f;
+  const float center_y = this->getHeight() / 2.0f;
+  const float relative_x_scale = scx / this->getWidth();
+  const float relative_y_scale = scy / this->getHeight();
+  r_input_area.xmax = center_x + (output_area.xmax - center_x) / relative_x_scale + 1;
+  r_input_area.xmin = center_x + (output_area.xmin - center_x) / relative_x_scale - 1;
+  r_input_area.ymax = center_y + (output_area.ymax - center_y) / relative_y_scale + 1;
+  r_input_area.ymin = center_y + (output_area.ymin - center_y) / relative_y_scale - 1;
+}
+
+void ScaleAbsoluteOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                          const rcti &output_rect,
+                                                          Span<MemoryBuffer *> inputs,
+                                                          ExecutionSystem &UNUSED(exec_system),
+                                                          int UNUSED(current_pass))
+{
+  const PixelSampler sampler = getEffectiveSampler(PixelSampler::Bilinear);
+  MemoryBuffer *input_image = inputs[0];
+  const MemoryBuffer *input_x = inputs[1];
+  const MemoryBuffer *input_y = inputs[2];
+  const float width = this->getWidth();
+  const float height = this->getHeight();
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    float *out = output->get_elem(output_rect.xmin, y);
+    const float *scale_x = input_x->get_elem(output_rect.xmin, y);
+    const float *scale_y = input_y->get_elem(output_rect.xmin, y);
+    for (int x = output_rect.xmin; x < output_rect.xmax; x++) {
+      /* Target absolute scale relative to operation size. */
+      const float relative_x_scale = *scale_x / width;
+      const float relative_y_scale = *scale_y / height;
+      const float nx = this->m_centerX + (x - this->m_centerX) / relative_x_scale;
+      const float ny = this->m_centerY + (y - this->m_centerY) / relative_y_scale;
+      sample(input_image, nx, ny, sampler, out);
+
+      out += output->elem_stride;
+      scale_x += input_x->elem_stride;
+      scale_y += input_y->elem_stride;
+    }
+  }
+}
+
 // Absolute fixed size
 ScaleFixedSizeOperation::ScaleFixedSizeOperation() : BaseScaleOperation()
 {
@@ -268,6 +382,12 @@ void ScaleFixedSizeOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+void ScaleFixedSizeOperation::hash_output_params()
+{
+  BaseScaleOperation::hash_output_params();
+  hash_params(m_newWidth, m_newHeight, m_is_aspect, m_is_crop, m_offsetX, m_offsetY);
+}
+
 void ScaleFixedSizeOperation::executePixelSampled(float output[4],
                                                   float x,
                                                   float y,
@@ -300,6 +420,35 @@ bool ScaleFixedSizeOperation::determineDependingAreaOfInterest(rcti *input,
   return BaseScaleOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void ScaleFixedSizeOperation::get_area_of_interest(const int input_idx,
+                                                   const rcti &UNUSED(output_area),
+                                                   rcti &r_input_area)
+{
+  /* Scale factors and offsets are only known after initialization, read the whole input. */
+  NodeOperation *input_op = get_input_operation(input_idx);
+  BLI_rcti_init(&r_input_area, 0, input_op->getWidth(), 0, input_op->getHeight());
+}
+
+void ScaleFixedSizeOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                           const rcti &output_rect,
+                                                           Span<MemoryBuffer *> inputs,
+                                                           ExecutionSystem &UNUSED(exec_system),
+                                                           int UNUSED(current_pass))
+{
+  const PixelSampler sampler = getEffectiveSampler(PixelSampler::Bilinear);
+  MemoryBuffer *input_image = inputs[0];
+  const float offset_x = this->m_is_offset ? this->m_offsetX : 0.0f;
+  const float offset_y = this->m_is_offset ? this->m_offsetY : 0.0f;
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    float *out = output->get_elem(output_rect.xmin, y);
+    const float ny = (y - offset_y) * this->m_relY;
+    for (int x = output_rect.xmin; x < output_rect.xmax; x++, out += output->elem_stride) {
+      const float nx = (x - offset_x) * this->m_relX;
+      sample(input_image, nx, ny, sampler, out);
+    }
+  }
+}
+
 void ScaleFixedSizeOperation::determineResolution(unsigned int resolution[2],
                                                   unsigned int /*preferredResolution*/[2])
 {
@@ -18,11 +18,11 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedOperation.h"
 
 namespace blender::compositor {
 
-class BaseScaleOperation : public NodeOperation {
+class BaseScaleOperation : public MultiThreadedOperation {
  public:
   void setSampler(PixelSampler sampler)
   {
@@ -41,6 +41,21 @@ class BaseScaleOperation : public NodeOperation {
     return (m_sampler == -1) ? sampler : (PixelSampler)m_sampler;
   }
 
+  /**
+   * Sample an input buffer the same way a buffer backed #SocketReader does.
+   */
+  static void sample(MemoryBuffer *input, float x, float y, PixelSampler sampler, float r_color[4])
+  {
+    if (sampler == PixelSampler::Nearest) {
+      input->read(r_color, x, y);
+    }
+    else {
+      input->readBilinear(r_color, x, y);
+    }
+  }
+
+  void hash_output_params() override;
+
   int m_sampler;
   bool m_variable_size;
 };
@@ -62,6 +77,13 @@ class ScaleOperation : public BaseScaleOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
 };
 
 class ScaleAbsoluteOperation : public BaseScaleOperation {
@@ -80,6 +102,13 @@ class ScaleAbsoluteOperation : public BaseScaleOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
 };
 
 class ScaleFixedSizeOperation : public BaseScaleOperation {
@@ -109,6 +138,13 @@ class ScaleFixedSizeOperation : public BaseScaleOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
   void setNewWidth(int width)
   {
     this->m_newWidth = width;
@@ -130,6 +166,9 @@ class ScaleFixedSizeOperation : public BaseScaleOperation {
     this->m_offsetX = x;
     this->m_offsetY = y;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
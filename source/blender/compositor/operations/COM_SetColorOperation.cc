@@ -52,4 +52,9 @@ void SetColorOperation::update_memory_buffer(MemoryBuffer *output,
   copy_v4_v4(out_elem, m_color);
 }
 
+void SetColorOperation::hash_output_params()
+{
+  hash_params(m_color[0], m_color[1], m_color[2], m_color[3]);
+}
+
 }  // namespace blender::compositor
@@ -85,6 +85,9 @@ class SetColorOperation : public NodeOperation {
                             const rcti &output_area,
                             Span<MemoryBuffer *> inputs,
                             ExecutionSystem &exec_system) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
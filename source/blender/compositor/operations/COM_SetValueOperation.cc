@@ -52,4 +52,9 @@ void SetValueOperation::update_memory_buffer(MemoryBuffer *output,
   *out_elem = m_value;
 }
 
+void SetValueOperation::hash_output_params()
+{
+  hash_params(m_value);
+}
+
 }  // namespace blender::compositor
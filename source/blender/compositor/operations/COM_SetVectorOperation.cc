@@ -44,4 +44,9 @@ void SetVectorOperation::determineResolution(unsigned int resolution[2],
   resolution[1] = preferredResolution[1];
 }
 
+void SetVectorOperation::hash_output_params()
+{
+  hash_params(m_x, m_y, m_z);
+}
+
 }  // namespace blender::compositor
@@ -83,4 +83,70 @@ void TranslateOperation::setFactorXY(float factorX, float factorY)
   m_factorY = factorY;
 }
 
+void TranslateOperation::hash_output_params()
+{
+  hash_params(m_factorX, m_factorY);
+}
+
+void TranslateOperation::get_area_of_interest(const int input_idx,
+                                              const rcti &output_area,
+                                              rcti &r_input_area)
+{
+  if (input_idx != 0) {
+    /* Delta inputs, only their first element is read. */
+    BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+    return;
+  }
+
+  if (!this->m_isDeltaSet) {
+    float delta_x, delta_y;
+    if (get_input_constant_value(1, delta_x) && get_input_constant_value(2, delta_y)) {
+      this->m_deltaX = delta_x;
+      this->m_deltaY = delta_y;
+      this->m_isDeltaSet = true;
+    }
+  }
+  if (!this->m_isDeltaSet) {
+    NodeOperation *image_op = get_input_operation(0);
+    BLI_rcti_init(&r_input_area, 0, image_op->getWidth(), 0, image_op->getHeight());
+    return;
+  }
+
+  /* Expand by one pixel for bilinear sampling of fractional deltas. */
+  r_input_area.xmin = floorf(output_area.xmin - this->getDeltaX()) - 1;
+  r_input_area.xmax = ceilf(output_area.xmax - this->getDeltaX()) + 1;
+  r_input_area.ymin = floorf(output_area.ymin - this->getDeltaY()) - 1;
+  r_input_area.ymax = ceilf(output_area.ymax - this->getDeltaY()) + 1;
+}
+
+void TranslateOperation::update_memory_buffer_started(MemoryBuffer *UNUSED(output),
+                                                      const rcti &UNUSED(output_rect),
+                                                      Span<MemoryBuffer *> inputs,
+                                                      ExecutionSystem &UNUSED(exec_system),
+                                                      int UNUSED(current_pass))
+{
+  if (!this->m_isDeltaSet) {
+    this->m_deltaX = *inputs[1]->get_elem(0, 0);
+    this->m_deltaY = *inputs[2]->get_elem(0, 0);
+    this->m_isDeltaSet = true;
+  }
+}
+
+void TranslateOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                      const rcti &output_rect,
+                                                      Span<MemoryBuffer *> inputs,
+                                                      ExecutionSystem &UNUSED(exec_system),
+                                                      int UNUSED(current_pass))
+{
+  MemoryBuffer *input_image = inputs[0];
+  const float delta_x = this->getDeltaX();
+  const float delta_y = this->getDeltaY();
+  for (int y = output_rect.ymin; y < output_rect.ymax; y++) {
+    float *out = output->get_elem(output_rect.xmin, y);
+    for (int x = output_rect.xmin; x < output_rect.xmax; x++, out += output->elem_stride) {
+      input_image->readBilinear(out, x - delta_x, y - delta_y);
+    }
+  }
+}
+
 }  // namespace blender::compositor
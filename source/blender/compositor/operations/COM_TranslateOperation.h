@@ -18,11 +18,11 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedOperation.h"
 
 namespace blender::compositor {
 
-class TranslateOperation : public NodeOperation {
+class TranslateOperation : public MultiThreadedOperation {
  private:
   SocketReader *m_inputOperation;
   SocketReader *m_inputXOperation;
@@ -65,6 +65,21 @@ class TranslateOperation : public NodeOperation {
   }
 
   void setFactorXY(float factorX, float factorY);
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &output_rect,
+                                    Span<MemoryBuffer *> inputs,
+                                    ExecutionSystem &exec_system,
+                                    int current_pass) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
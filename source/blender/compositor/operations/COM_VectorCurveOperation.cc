@@ -47,6 +47,14 @@ void VectorCurveOperation::executePixelSampled(float output[4],
   BKE_curvemapping_evaluate_premulRGBF(this->m_curveMapping, output, input);
 }
 
+void VectorCurveOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  CurveMapping *cumap = this->m_curveMapping;
+  for (; p.out < p.row_end; p.next()) {
+    BKE_curvemapping_evaluate_premulRGBF(cumap, p.out, p.ins[0]);
+  }
+}
+
 void VectorCurveOperation::deinitExecution()
 {
   CurveBaseOperation::deinitExecution();
@@ -35,6 +35,10 @@ ZCombineOperation::ZCombineOperation()
   this->m_depth2Reader = nullptr;
 }
 
+void ZCombineOperation::hash_output_params()
+{
+}
+
 void ZCombineOperation::initExecution()
 {
   this->m_image1Reader = this->getInputSocketReader(0);
@@ -60,6 +64,16 @@ void ZCombineOperation::executePixelSampled(float output[4],
     this->m_image2Reader->readSampled(output, x, y, sampler);
   }
 }
+
+void ZCombineOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float depth1 = p.ins[1][0];
+    const float depth2 = p.ins[3][0];
+    const float *color = (depth1 < depth2) ? p.ins[0] : p.ins[2];
+    copy_v4_v4(p.out, color);
+  }
+}
 void ZCombineAlphaOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -88,6 +102,30 @@ void ZCombineAlphaOperation::executePixelSampled(float output[4],
   output[3] = MAX2(color1[3], color2[3]);
 }
 
+void ZCombineAlphaOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float depth1 = p.ins[1][0];
+    const float depth2 = p.ins[3][0];
+    const float *color1;
+    const float *color2;
+    if (depth1 <= depth2) {
+      color1 = p.ins[0];
+      color2 = p.ins[2];
+    }
+    else {
+      color1 = p.ins[2];
+      color2 = p.ins[0];
+    }
+    const float fac = color1[3];
+    const float ifac = 1.0f - fac;
+    p.out[0] = fac * color1[0] + ifac * color2[0];
+    p.out[1] = fac * color1[1] + ifac * color2[1];
+    p.out[2] = fac * color1[2] + ifac * color2[2];
+    p.out[3] = MAX2(color1[3], color2[3]);
+  }
+}
+
 void ZCombineOperation::deinitExecution()
 {
   this->m_image1Reader = nullptr;
@@ -132,6 +170,14 @@ void ZCombineMaskOperation::executePixelSampled(float output[4],
   interp_v4_v4v4(output, color1, color2, 1.0f - mask[0]);
 }
 
+void ZCombineMaskOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float mask = p.ins[0][0];
+    interp_v4_v4v4(p.out, p.ins[1], p.ins[2], 1.0f - mask);
+  }
+}
+
 void ZCombineMaskAlphaOperation::executePixelSampled(float output[4],
                                                      float x,
                                                      float y,
@@ -154,6 +200,22 @@ void ZCombineMaskAlphaOperation::executePixelSampled(float output[4],
   output[3] = MAX2(color1[3], color2[3]);
 }
 
+void ZCombineMaskAlphaOperation::update_memory_buffer_row(PixelCursor &p)
+{
+  for (; p.out < p.row_end; p.next()) {
+    const float mask = p.ins[0][0];
+    const float *color1 = p.ins[1];
+    const float *color2 = p.ins[2];
+    const float fac = (1.0f - mask) * (1.0f - color1[3]) + mask * color2[3];
+    const float mfac = 1.0f - fac;
+
+    p.out[0] = color1[0] * mfac + color2[0] * fac;
+    p.out[1] = color1[1] * mfac + color2[1] * fac;
+    p.out[2] = color1[2] * mfac + color2[2] * fac;
+    p.out[3] = MAX2(color1[3], color2[3]);
+  }
+}
+
 void ZCombineMaskOperation::deinitExecution()
 {
   this->m_image1Reader = nullptr;
@@ -161,4 +223,8 @@ void ZCombineMaskOperation::deinitExecution()
   this->m_image2Reader = nullptr;
 }
 
+void ZCombineMaskOperation::hash_output_params()
+{
+}
+
 }  // namespace blender::compositor
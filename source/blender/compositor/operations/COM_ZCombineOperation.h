@@ -26,7 +26,7 @@ namespace blender::compositor {
  * this program converts an input color to an output value.
  * it assumes we are in sRGB color space.
  */
-class ZCombineOperation : public NodeOperation {
+class ZCombineOperation : public MultiThreadedRowOperation {
  protected:
   SocketReader *m_image1Reader;
   SocketReader *m_depth1Reader;
@@ -46,13 +46,18 @@ class ZCombineOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+  void update_memory_buffer_row(PixelCursor &p) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 class ZCombineAlphaOperation : public ZCombineOperation {
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
-class ZCombineMaskOperation : public NodeOperation {
+class ZCombineMaskOperation : public MultiThreadedRowOperation {
  protected:
   SocketReader *m_maskReader;
   SocketReader *m_image1Reader;
@@ -64,9 +69,14 @@ class ZCombineMaskOperation : public NodeOperation {
   void initExecution() override;
   void deinitExecution() override;
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+  void update_memory_buffer_row(PixelCursor &p) override;
+
+ protected:
+  void hash_output_params() override;
 };
 class ZCombineMaskAlphaOperation : public ZCombineMaskOperation {
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+  void update_memory_buffer_row(PixelCursor &p) override;
 };
 
 }  // namespace blender::compositor
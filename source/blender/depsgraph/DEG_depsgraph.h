@@ -164,6 +164,19 @@ void DEG_evaluate_on_framechange(Depsgraph *graph, float ctime);
 /* Data changed recalculation entry point. */
 void DEG_evaluate_on_refresh(Depsgraph *graph);
 
+/* Frame changed recalculation on a background thread, for example to evaluate the next frame
+ * during playback while the current one is drawn. The evaluation reads the original data-blocks,
+ * so it is only scheduled here, and started with DEG_background_evaluation_start() when nothing
+ * modifies them. Until it is finished, tagging the graph for updates, evaluating or freeing it
+ * waits for the background evaluation. The evaluated data must not be accessed meanwhile. */
+void DEG_evaluate_on_framechange_background(Depsgraph *graph, float ctime);
+
+/* Start the scheduled background evaluation of the graph, if there is one. */
+void DEG_background_evaluation_start(Depsgraph *graph);
+
+/* Wait until the background evaluation of the graph is finished, if there is one. */
+void DEG_background_evaluation_wait(Depsgraph *graph);
+
 /* Editors Integration  -------------------------- */
 
 /* Mechanism to allow editors to be informed of depsgraph updates,
@@ -1058,6 +1058,13 @@ void DepsgraphNodeBuilder::build_animdata(ID *id)
   /* Make sure ID node exists. */
   (void)add_id_node(id);
   ID *id_cow = get_cow_id(id);
+  if (deg_copy_on_write_is_expanded(id_cow)) {
+    /* Paths resolved by previous evaluations may point to data changed along with relations. */
+    AnimData *adt_cow = BKE_animdata_from_id(id_cow);
+    if (adt_cow != nullptr) {
+      BKE_animsys_free_eval_bindings(adt_cow);
+    }
+  }
   if (adt->action != nullptr || !BLI_listbase_is_empty(&adt->nla_tracks)) {
     OperationNode *operation_node;
     /* Explicit entry operation. */
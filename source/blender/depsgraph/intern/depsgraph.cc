@@ -32,6 +32,7 @@
 
 #include "BLI_console.h"
 #include "BLI_hash.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -70,6 +71,9 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       scene_cow(nullptr),
       is_active(false),
       is_evaluating(false),
+      background_evaluation_pool(nullptr),
+      background_evaluation_scheduled(false),
+      background_evaluation_ctime(0.0f),
       is_render_pipeline_depsgraph(false),
       use_editors_update(false)
 {
@@ -109,6 +113,16 @@ void Depsgraph::tag_time_source()
   time_source->tag_update(this, DEG_UPDATE_SOURCE_TIME);
 }
 
+void Depsgraph::wait_for_background_evaluation()
+{
+  if (background_evaluation_pool == nullptr) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(background_evaluation_pool);
+  BLI_task_pool_free(background_evaluation_pool);
+  background_evaluation_pool = nullptr;
+}
+
 IDNode *Depsgraph::find_id_node(const ID *id) const
 {
   return id_hash.lookup_default(id, nullptr);
@@ -295,6 +309,7 @@ void DEG_graph_replace_owners(struct Depsgraph *depsgraph,
                               ViewLayer *view_layer)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
 
   const bool do_update_register = deg_graph->bmain != bmain;
   if (do_update_register && deg_graph->bmain != nullptr) {
@@ -318,6 +333,7 @@ void DEG_graph_free(Depsgraph *graph)
   }
   using deg::Depsgraph;
   deg::Depsgraph *deg_depsgraph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_depsgraph->wait_for_background_evaluation();
   deg::unregister_graph(deg_depsgraph);
   delete deg_depsgraph;
 }
@@ -344,6 +360,9 @@ bool DEG_is_active(const struct Depsgraph *depsgraph)
 void DEG_make_active(struct Depsgraph *depsgraph)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
+  /* The active graph is evaluated on the main thread. */
+  deg_graph->background_evaluation_scheduled = false;
   deg_graph->is_active = true;
   /* TODO(sergey): Copy data from evaluated state to original. */
 }
@@ -351,5 +370,6 @@ void DEG_make_active(struct Depsgraph *depsgraph)
 void DEG_make_inactive(struct Depsgraph *depsgraph)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
   deg_graph->is_active = false;
 }
@@ -45,6 +45,7 @@
 
 struct ID;
 struct Scene;
+struct TaskPool;
 struct ViewLayer;
 
 namespace blender {
@@ -68,6 +69,9 @@ struct Depsgraph {
   TimeSourceNode *find_time_source() const;
   void tag_time_source();
 
+  /* Wait until the evaluation on a background thread is finished, if there is one. */
+  void wait_for_background_evaluation();
+
   IDNode *find_id_node(const ID *id) const;
   IDNode *add_id_node(ID *id, ID *id_cow_hint = nullptr);
   void clear_id_nodes();
@@ -155,6 +159,13 @@ struct Depsgraph {
 
   bool is_evaluating;
 
+  /* Task pool of the evaluation on a background thread, see
+   * DEG_evaluate_on_framechange_background(). Only accessed from the main thread. */
+  TaskPool *background_evaluation_pool;
+  /* Frame of the background evaluation that is scheduled but not started yet. */
+  bool background_evaluation_scheduled;
+  float background_evaluation_ctime;
+
   /* Is set to truth for dependency graph which are used for post-processing (compositor and
    * sequencer).
    * Such dependency graph needs all view layers (so render pipeline can access names), but it
@@ -255,6 +255,7 @@ struct Depsgraph *DEG_get_graph_from_handle(struct DepsNodeHandle *node_handle)
 /* Build depsgraph for the given scene layer, and dump results in given graph container. */
 void DEG_graph_build_from_view_layer(Depsgraph *graph)
 {
+  reinterpret_cast<deg::Depsgraph *>(graph)->wait_for_background_evaluation();
   deg::ViewLayerBuilderPipeline builder(graph);
   builder.build();
 }
@@ -288,6 +289,7 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
 {
   DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->wait_for_background_evaluation();
   deg_graph->need_update = true;
   /* NOTE: When relations are updated, it's quite possible that
    * we've got new bases in the scene. This means, we need to
@@ -26,6 +26,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_scene.h"
@@ -34,6 +35,7 @@
 #include "DNA_scene_types.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
 #include "intern/eval/deg_eval.h"
@@ -58,10 +60,18 @@ static void deg_flush_updates_and_refresh(deg::Depsgraph *deg_graph)
   deg::deg_evaluate_on_refresh(deg_graph);
 }
 
+static void deg_evaluate_on_framechange(deg::Depsgraph *deg_graph, float ctime)
+{
+  deg_graph->tag_time_source();
+  deg_graph->ctime = ctime;
+  deg_flush_updates_and_refresh(deg_graph);
+}
+
 /* Evaluate all nodes tagged for updating. */
 void DEG_evaluate_on_refresh(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->wait_for_background_evaluation();
   const Scene *scene = DEG_get_input_scene(graph);
   const float ctime = BKE_scene_frame_get(scene);
 
@@ -77,7 +87,56 @@ void DEG_evaluate_on_refresh(Depsgraph *graph)
 void DEG_evaluate_on_framechange(Depsgraph *graph, float ctime)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
-  deg_graph->tag_time_source();
-  deg_graph->ctime = ctime;
-  deg_flush_updates_and_refresh(deg_graph);
+  deg_graph->wait_for_background_evaluation();
+  deg_evaluate_on_framechange(deg_graph, ctime);
+}
+
+struct BackgroundEvaluationData {
+  deg::Depsgraph *graph;
+  float ctime;
+};
+
+static void deg_background_evaluation_run(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  BackgroundEvaluationData *data = static_cast<BackgroundEvaluationData *>(taskdata);
+  deg_evaluate_on_framechange(data->graph, data->ctime);
+}
+
+void DEG_evaluate_on_framechange_background(Depsgraph *graph, float ctime)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->wait_for_background_evaluation();
+  deg_graph->background_evaluation_scheduled = true;
+  deg_graph->background_evaluation_ctime = ctime;
+}
+
+void DEG_background_evaluation_start(Depsgraph *graph)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  if (!deg_graph->background_evaluation_scheduled) {
+    return;
+  }
+  deg_graph->wait_for_background_evaluation();
+  deg_graph->background_evaluation_scheduled = false;
+
+  /* Building relations accesses the original data-blocks, so only the evaluation itself is done
+   * in the background. Relations can also be tagged for update after the evaluation has been
+   * scheduled. */
+  DEG_graph_relations_update(graph);
+
+  BackgroundEvaluationData *data = static_cast<BackgroundEvaluationData *>(
+      MEM_mallocN(sizeof(BackgroundEvaluationData), __func__));
+  data->graph = deg_graph;
+  data->ctime = deg_graph->background_evaluation_ctime;
+
+  deg_graph->background_evaluation_pool = BLI_task_pool_create_background(nullptr,
+                                                                          TASK_PRIORITY_HIGH);
+  BLI_task_pool_push(
+      deg_graph->background_evaluation_pool, deg_background_evaluation_run, data, true, nullptr);
+}
+
+void DEG_background_evaluation_wait(Depsgraph *graph)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->wait_for_background_evaluation();
 }
@@ -627,6 +627,9 @@ void id_tag_update(Main *bmain, ID *id, int flag, eUpdateSource update_source)
 void graph_id_tag_update(
     Main *bmain, Depsgraph *graph, ID *id, int flag, eUpdateSource update_source)
 {
+  if (graph != nullptr) {
+    graph->wait_for_background_evaluation();
+  }
   const int debug_flags = (graph != nullptr) ? DEG_debug_flags_get((::Depsgraph *)graph) : G.debug;
   if (graph != nullptr && graph->is_evaluating) {
     if (debug_flags & G_DEBUG_DEPSGRAPH) {
@@ -775,6 +778,7 @@ void DEG_time_tag_update(struct Main *bmain)
 void DEG_graph_time_tag_update(struct Depsgraph *depsgraph)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
   deg_graph->tag_time_source();
 }
 
@@ -793,6 +797,7 @@ void DEG_graph_id_type_tag(Depsgraph *depsgraph, short id_type)
   }
   const int id_type_index = BKE_idtype_idcode_to_index(id_type);
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
   deg_graph->id_type_updated[id_type_index] = 1;
 }
 
@@ -807,6 +812,7 @@ void DEG_id_type_tag(Main *bmain, short id_type)
 void DEG_graph_on_visible_update(Main *bmain, Depsgraph *depsgraph, const bool do_time)
 {
   deg::Depsgraph *graph = (deg::Depsgraph *)depsgraph;
+  graph->wait_for_background_evaluation();
   deg::deg_graph_on_visible_update(bmain, graph, do_time);
 }
 
@@ -828,6 +834,7 @@ void DEG_enable_editors_update(Depsgraph *depsgraph)
 void DEG_editors_update(Depsgraph *depsgraph, bool time)
 {
   deg::Depsgraph *graph = (deg::Depsgraph *)depsgraph;
+  graph->wait_for_background_evaluation();
   if (!graph->use_editors_update) {
     return;
   }
@@ -859,6 +866,7 @@ static void deg_graph_clear_id_recalc_flags(ID *id)
 void DEG_ids_clear_recalc(Depsgraph *depsgraph, const bool backup)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->wait_for_background_evaluation();
   /* TODO(sergey): Re-implement POST_UPDATE_HANDLER_WORKAROUND using entry_tags
    * and id_tags storage from the new dependency graph. */
   if (!DEG_id_type_any_updated(depsgraph)) {
@@ -120,6 +120,7 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
   const bool export_normals = RNA_boolean_get(op->ptr, "export_normals");
   const bool export_materials = RNA_boolean_get(op->ptr, "export_materials");
   const bool use_instancing = RNA_boolean_get(op->ptr, "use_instancing");
+  const bool use_write_thread = RNA_boolean_get(op->ptr, "use_write_thread");
   const bool evaluation_mode = RNA_enum_get(op->ptr, "evaluation_mode");
 
   struct USDExportParams params = {
@@ -131,6 +132,7 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
       selected_objects_only,
       visible_objects_only,
       use_instancing,
+      use_write_thread,
       evaluation_mode,
   };
 
@@ -166,6 +168,7 @@ static void wm_usd_export_draw(bContext *UNUSED(C), wmOperator *op)
   box = uiLayoutBox(layout);
   uiItemL(box, IFACE_("Experimental"), ICON_NONE);
   uiItemR(box, ptr, "use_instancing", 0, NULL, ICON_NONE);
+  uiItemR(box, ptr, "use_write_thread", 0, NULL, ICON_NONE);
 }
 
 void WM_OT_usd_export(struct wmOperatorType *ot)
@@ -233,6 +236,13 @@ void WM_OT_usd_export(struct wmOperatorType *ot)
                   "When checked, instanced objects are exported as references in USD. "
                   "When unchecked, instanced objects are exported as real objects");
 
+  RNA_def_boolean(ot->srna,
+                  "use_write_thread",
+                  false,
+                  "Write in Background",
+                  "When checked, the animated values of a frame are written to the USD stage "
+                  "while the next frame is evaluated");
+
   RNA_def_enum(ot->srna,
                "evaluation_mode",
                rna_enum_usd_export_evaluation_mode_items,
@@ -3099,6 +3099,216 @@ void OBJECT_OT_ocean_bake(wmOperatorType *ot)
 
 /** \} */
 
+/* ------------------------------------------------------------------- */
+/** \name Geometry Nodes Bake Operator
+ * \{ */
+
+static bool geometry_nodes_bake_poll(bContext *C)
+{
+  return edit_modifier_poll_generic(C, &RNA_NodesModifier, 0, true, false);
+}
+
+typedef struct GeometryNodesBakeJob {
+  wmWindowManager *wm;
+  Main *bmain;
+  Scene *scene;
+  /* Depsgraph is used to sweep the frame range and evaluate the modifier at different times. */
+  Depsgraph *depsgraph;
+  Object *object;
+  NodesModifierData *nmd;
+  bool canceled;
+  bool write_failed;
+  bool files_missing;
+} GeometryNodesBakeJob;
+
+static void geometry_nodes_bake_startjob(void *customdata,
+                                         short *stop,
+                                         short *do_update,
+                                         float *progress)
+{
+  GeometryNodesBakeJob *job = customdata;
+  Scene *scene = job->scene;
+  NodesModifierData *nmd = job->nmd;
+  const int frame_orig = scene->r.cfra;
+  const float subframe_orig = scene->r.subframe;
+
+  G.is_break = false;
+
+  /* The scene frame is changed in this thread. */
+  WM_set_locked_interface(job->wm, true);
+
+  /* The files of the previous frames are written while the next frames are evaluated. */
+  MOD_nodes_bake_begin(job->bmain, job->object, nmd);
+
+  const int frames_num = max_ii(nmd->bake_frame_end - nmd->bake_frame_start + 1, 1);
+  for (int frame = nmd->bake_frame_start; frame <= nmd->bake_frame_end; frame++) {
+    scene->r.cfra = frame;
+    scene->r.subframe = 0.0f;
+    /* The modifier is only evaluated again on frame changes when something in the node tree
+     * depends on time, but it has to run for every frame to write the geometry. */
+    DEG_id_tag_update(&job->object->id, ID_RECALC_GEOMETRY);
+    BKE_scene_graph_update_for_newframe(job->depsgraph);
+
+    *progress = (float)(frame - nmd->bake_frame_start + 1) / (float)frames_num;
+    *do_update = true;
+
+    if (*stop || G.is_break) {
+      job->canceled = true;
+      break;
+    }
+  }
+
+  job->write_failed = !MOD_nodes_bake_end(nmd);
+  if (!job->canceled && !job->write_failed) {
+    /* A frame is not written when the modifier is not evaluated for it, e.g. when the object is
+     * hidden or the modifier is disabled in the viewport. */
+    job->files_missing = !MOD_nodes_bake_files_exist(job->bmain, job->object, nmd);
+  }
+
+  scene->r.cfra = frame_orig;
+  scene->r.subframe = subframe_orig;
+  BKE_scene_graph_update_for_newframe(job->depsgraph);
+
+  *do_update = true;
+  *stop = 0;
+}
+
+static void geometry_nodes_bake_endjob(void *customdata)
+{
+  GeometryNodesBakeJob *job = customdata;
+  Object *ob = job->object;
+
+  WM_set_locked_interface(job->wm, false);
+
+  if (job->write_failed) {
+    WM_report(RPT_ERROR, "Could not write the baked geometry");
+  }
+  else if (job->files_missing) {
+    WM_report(RPT_ERROR, "The modifier was not evaluated for all frames of the bake range");
+  }
+  if (!job->canceled && !job->write_failed && !job->files_missing) {
+    job->nmd->bake_flag |= NODES_MODIFIER_BAKED;
+  }
+
+  /* Reading the baked geometry depends on time. */
+  DEG_relations_tag_update(job->bmain);
+  DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+
+  WM_main_add_notifier(NC_SCENE | ND_FRAME, job->scene);
+  WM_main_add_notifier(NC_OBJECT | ND_MODIFIER, ob);
+}
+
+static int geometry_nodes_bake_exec(bContext *C, wmOperator *op)
+{
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = CTX_data_scene(C);
+  Object *ob = ED_object_active_context(C);
+  NodesModifierData *nmd = (NodesModifierData *)edit_modifier_property_get(
+      op, ob, eModifierType_Nodes);
+
+  if (!nmd) {
+    return OPERATOR_CANCELLED;
+  }
+
+  if (RNA_boolean_get(op->ptr, "free")) {
+    MOD_nodes_bake_free(bmain, ob, nmd);
+    DEG_relations_tag_update(bmain);
+    DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+    WM_event_add_notifier(C, NC_OBJECT | ND_MODIFIER, ob);
+    return OPERATOR_FINISHED;
+  }
+
+  if (nmd->bake_frame_end < nmd->bake_frame_start) {
+    BKE_report(op->reports, RPT_ERROR, "The bake end frame is before the start frame");
+    return OPERATOR_CANCELLED;
+  }
+
+  wmJob *wm_job = WM_jobs_get(CTX_wm_manager(C),
+                              CTX_wm_window(C),
+                              scene,
+                              "Geometry Nodes Bake",
+                              WM_JOB_PROGRESS,
+                              WM_JOB_TYPE_OBJECT_BAKE_GEOMETRY_NODES);
+  GeometryNodesBakeJob *job = MEM_callocN(sizeof(GeometryNodesBakeJob), __func__);
+  job->wm = CTX_wm_manager(C);
+  job->bmain = bmain;
+  job->scene = scene;
+  job->depsgraph = CTX_data_depsgraph_pointer(C);
+  job->object = ob;
+  job->nmd = nmd;
+
+  WM_jobs_customdata_set(wm_job, job, MEM_freeN);
+  WM_jobs_timer(wm_job, 0.1, NC_OBJECT | ND_MODIFIER, NC_OBJECT | ND_MODIFIER);
+  WM_jobs_callbacks(
+      wm_job, geometry_nodes_bake_startjob, NULL, NULL, geometry_nodes_bake_endjob);
+
+  WM_set_locked_interface(CTX_wm_manager(C), true);
+
+  WM_jobs_start(CTX_wm_manager(C), wm_job);
+
+  return OPERATOR_FINISHED;
+}
+
+static int geometry_nodes_bake_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
+{
+  if (!edit_modifier_invoke_properties(C, op)) {
+    return OPERATOR_CANCELLED;
+  }
+
+  const int ret = geometry_nodes_bake_exec(C, op);
+  if (ret != OPERATOR_FINISHED || RNA_boolean_get(op->ptr, "free")) {
+    return ret;
+  }
+
+  /* Run modal until the bake job is done, otherwise the undo push happens before the job ends,
+   * while the job still changes the scene frame. */
+  op->customdata = CTX_data_scene(C);
+  WM_event_add_modal_handler(C, op);
+  return OPERATOR_RUNNING_MODAL;
+}
+
+static int geometry_nodes_bake_modal(bContext *C,
+                                     wmOperator *op,
+                                     const wmEvent *UNUSED(event))
+{
+  Scene *scene = (Scene *)op->customdata;
+
+  /* No running job, remove handler and pass through. */
+  if (0 == WM_jobs_test(CTX_wm_manager(C), scene, WM_JOB_TYPE_OBJECT_BAKE_GEOMETRY_NODES)) {
+    return OPERATOR_FINISHED | OPERATOR_PASS_THROUGH;
+  }
+
+  return OPERATOR_PASS_THROUGH;
+}
+
+static void geometry_nodes_bake_cancel(bContext *C, wmOperator *op)
+{
+  Scene *scene = (Scene *)op->customdata;
+  WM_jobs_kill_type(CTX_wm_manager(C), scene, WM_JOB_TYPE_OBJECT_BAKE_GEOMETRY_NODES);
+}
+
+void OBJECT_OT_geometry_nodes_bake(wmOperatorType *ot)
+{
+  ot->name = "Bake Geometry Nodes";
+  ot->description =
+      "Write the geometry of every frame in the bake range to files, so it is not computed again";
+  ot->idname = "OBJECT_OT_geometry_nodes_bake";
+
+  ot->poll = geometry_nodes_bake_poll;
+  ot->invoke = geometry_nodes_bake_invoke;
+  ot->exec = geometry_nodes_bake_exec;
+  ot->modal = geometry_nodes_bake_modal;
+  ot->cancel = geometry_nodes_bake_cancel;
+
+  /* flags */
+  ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO | OPTYPE_INTERNAL;
+  edit_modifier_properties(ot);
+
+  RNA_def_boolean(ot->srna, "free", false, "Free", "Free the bake, rather than generating it");
+}
+
+/** \} */
+
 /* ------------------------------------------------------------------- */
 /** \name Laplaciandeform Bind Operator
  * \{ */
@@ -759,6 +759,16 @@ void ED_area_exit(bContext *C, ScrArea *area)
   CTX_wm_area_set(C, prevsa);
 }
 
+/* Free the depsgraphs used to evaluate the next frame in the background during playback. */
+static void screen_animation_playback_depsgraphs_free(Main *bmain)
+{
+  if (BKE_scene_free_playback_depsgraphs(bmain)) {
+    /* The drawn depsgraphs were not active while they were evaluated in the background, update
+     * them once more so animated values are written back to the original data. */
+    DEG_time_tag_update(bmain);
+  }
+}
+
 void ED_screen_exit(bContext *C, wmWindow *window, bScreen *screen)
 {
   wmWindowManager *wm = CTX_wm_manager(C);
@@ -768,6 +778,7 @@ void ED_screen_exit(bContext *C, wmWindow *window, bScreen *screen)
 
   if (screen->animtimer) {
     WM_event_remove_timer(wm, window, screen->animtimer);
+    screen_animation_playback_depsgraphs_free(CTX_data_main(C));
 
     Depsgraph *depsgraph = CTX_data_depsgraph_pointer(C);
     Scene *scene = WM_window_get_active_scene(prevwin);
@@ -1666,6 +1677,7 @@ void ED_screen_animation_timer(bContext *C, int redraws, int sync, int enable)
   if (stopscreen) {
     WM_event_remove_timer(wm, win, stopscreen->animtimer);
     stopscreen->animtimer = NULL;
+    screen_animation_playback_depsgraphs_free(CTX_data_main(C));
   }
 
   if (enable) {
@@ -1754,13 +1766,8 @@ void ED_screen_animation_timer_update(bScreen *screen, int redraws)
   }
 }
 
-/* results in fully updated anim system */
-void ED_update_for_newframe(Main *bmain, Depsgraph *depsgraph)
+static void screen_update_for_newframe_editors(Main *bmain, Scene *scene)
 {
-  Scene *scene = DEG_get_input_scene(depsgraph);
-
-  DEG_time_tag_update(bmain);
-
 #ifdef DURIAN_CAMERA_SWITCH
   void *camera = BKE_scene_camera_switch_find(scene);
   if (camera && scene->camera != camera) {
@@ -1774,11 +1781,32 @@ void ED_update_for_newframe(Main *bmain, Depsgraph *depsgraph)
 #endif
 
   ED_clip_update_frame(bmain, scene->r.cfra);
+}
+
+/* results in fully updated anim system */
+void ED_update_for_newframe(Main *bmain, Depsgraph *depsgraph)
+{
+  Scene *scene = DEG_get_input_scene(depsgraph);
+
+  DEG_time_tag_update(bmain);
+
+  screen_update_for_newframe_editors(bmain, scene);
 
   /* this function applies the changes too */
   BKE_scene_graph_update_for_newframe(depsgraph);
 }
 
+/* Same as ED_update_for_newframe(), for a depsgraph that has been evaluated for the current frame
+ * in the background already, see BKE_scene_graph_update_for_newframe_background(). */
+void screen_update_for_newframe_evaluated(Main *bmain, Depsgraph *depsgraph)
+{
+  Scene *scene = DEG_get_input_scene(depsgraph);
+
+  screen_update_for_newframe_editors(bmain, scene);
+
+  BKE_scene_graph_update_for_newframe_background_finish(depsgraph);
+}
+
 /*
  * return true if any active area requires to see in 3D
  */
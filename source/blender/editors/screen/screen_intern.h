@@ -23,6 +23,7 @@
 
 #pragma once
 
+struct Depsgraph;
 struct Main;
 struct bContext;
 struct bContextDataResult;
@@ -95,6 +96,7 @@ void area_getoffsets(
     ScrArea *sa_a, ScrArea *sa_b, const eScreenDir dir, int *r_offset1, int *r_offset2);
 bool screen_area_close(struct bContext *C, bScreen *screen, ScrArea *area);
 struct AZone *ED_area_actionzone_find_xy(ScrArea *area, const int xy[2]);
+void screen_update_for_newframe_evaluated(struct Main *bmain, struct Depsgraph *depsgraph);
 
 /* screen_geometry.c */
 int screen_geom_area_height(const ScrArea *area);
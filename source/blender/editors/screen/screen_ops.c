@@ -55,6 +55,7 @@
 #include "BKE_main.h"
 #include "BKE_mask.h"
 #include "BKE_object.h"
+#include "BKE_pointcache.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
 #include "BKE_screen.h"
@@ -4502,6 +4503,84 @@ static void screen_animation_region_tag_redraw(ScrArea *area,
   ED_region_tag_redraw(region);
 }
 
+/* Simulations step from the previous frame and write their caches only when they are evaluated by
+ * the active depsgraph, which a depsgraph evaluated in the background is not. */
+static bool screen_animation_has_simulations(Scene *scene, ViewLayer *view_layer)
+{
+  if (scene->rigidbody_world != NULL) {
+    return true;
+  }
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    if (BKE_ptcache_object_has(scene, base->object, 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Evaluating the next frame in the background is only done when the playback doesn't follow the
+ * audio, and for a single window, as only the depsgraphs of the active window get time updates. */
+static bool screen_animation_use_async(const wmWindowManager *wm,
+                                       Scene *scene,
+                                       ViewLayer *view_layer)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_async_playback)) {
+    return false;
+  }
+  if (scene->audio.flag & AUDIO_SYNC) {
+    return false;
+  }
+  if (!BLI_listbase_is_single(&wm->windows)) {
+    return false;
+  }
+  return !screen_animation_has_simulations(scene, view_layer);
+}
+
+/* The frame that is expected to be played after the current one, when no frames are dropped. */
+static int screen_animation_next_frame(const Scene *scene, const ScreenAnimData *sad)
+{
+  const int sfra = PRVRANGEON ? scene->r.psfra : scene->r.sfra;
+  const int efra = PRVRANGEON ? scene->r.pefra : scene->r.efra;
+
+  if (sad->flag & ANIMPLAY_FLAG_REVERSE) {
+    return (scene->r.cfra - 1 < sfra) ? efra : scene->r.cfra - 1;
+  }
+  return (scene->r.cfra + 1 > efra) ? sfra : scene->r.cfra + 1;
+}
+
+static void screen_animation_update_for_newframe(Main *bmain,
+                                                 wmWindowManager *wm,
+                                                 Scene *scene,
+                                                 ViewLayer *view_layer,
+                                                 Depsgraph *depsgraph,
+                                                 const ScreenAnimData *sad)
+{
+  if (!screen_animation_use_async(wm, scene, view_layer)) {
+    ED_update_for_newframe(bmain, depsgraph);
+    return;
+  }
+
+  /* Use the depsgraph that was evaluated in the background while the previous frame was drawn,
+   * if it was evaluated for the current frame. Otherwise (frames were dropped, or the playback
+   * jumped) fall back to evaluating the frame now. */
+  Depsgraph *playback_depsgraph = BKE_scene_get_playback_depsgraph(scene, view_layer);
+  if (playback_depsgraph != NULL) {
+    DEG_background_evaluation_wait(playback_depsgraph);
+  }
+  if (playback_depsgraph != NULL &&
+      DEG_get_ctime(playback_depsgraph) == BKE_scene_frame_get(scene)) {
+    BKE_scene_swap_playback_depsgraph(scene, view_layer);
+    screen_update_for_newframe_evaluated(bmain, playback_depsgraph);
+  }
+  else {
+    ED_update_for_newframe(bmain, depsgraph);
+  }
+
+  playback_depsgraph = BKE_scene_ensure_playback_depsgraph(bmain, scene, view_layer);
+  BKE_scene_graph_update_for_newframe_background(
+      playback_depsgraph, screen_animation_next_frame(scene, sad) + scene->r.subframe);
+}
+
 //#define PROFILE_AUDIO_SYNCH
 
 static int screen_animation_step_invoke(bContext *C, wmOperator *UNUSED(op), const wmEvent *event)
@@ -4667,7 +4746,7 @@ static int screen_animation_step_invoke(bContext *C, wmOperator *UNUSED(op), con
 
   /* since we follow drawflags, we can't send notifier but tag regions ourselves */
   if (depsgraph != NULL) {
-    ED_update_for_newframe(bmain, depsgraph);
+    screen_animation_update_for_newframe(bmain, wm, scene, view_layer, depsgraph, sad);
   }
 
   LISTBASE_FOREACH (wmWindow *, window, &wm->windows) {
@@ -672,6 +672,11 @@ typedef struct SculptUndoNode {
   /* Sculpt Face Sets */
   int *face_sets;
 
+  /* Arrays compressed while the undo step isn't active, see #sculpt_undosys_step_compress. */
+  void *compressed;
+  size_t compressed_size;
+  size_t compressed_array_sizes[4];
+
   size_t undo_size;
 } SculptUndoNode;
 
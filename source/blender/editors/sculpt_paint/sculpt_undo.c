@@ -26,6 +26,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_compress.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
@@ -897,6 +898,9 @@ static void sculpt_undo_free_list(ListBase *lb)
     if (unode->face_sets) {
       MEM_freeN(unode->face_sets);
     }
+    if (unode->compressed) {
+      MEM_freeN(unode->compressed);
+    }
 
     MEM_freeN(unode);
 
@@ -1470,6 +1474,7 @@ static void sculpt_undosys_step_decode_undo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == true);
+  BKE_undosys_step_decompress(ED_undo_stack_get(), &us->step);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
   us->step.is_applied = false;
 }
@@ -1479,6 +1484,7 @@ static void sculpt_undosys_step_decode_redo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == false);
+  BKE_undosys_step_decompress(ED_undo_stack_get(), &us->step);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
   us->step.is_applied = true;
 }
@@ -1586,6 +1592,81 @@ static void sculpt_undosys_step_free(UndoStep *us_p)
   sculpt_undo_free_list(&us->data.nodes);
 }
 
+/* Arrays of a node that are compressed, matching #SculptUndoNode.compressed_array_sizes. */
+static void sculpt_undo_node_compress_arrays(SculptUndoNode *unode, void **r_arrays[4])
+{
+  r_arrays[0] = (void **)&unode->co;
+  r_arrays[1] = (void **)&unode->orig_co;
+  r_arrays[2] = (void **)&unode->col;
+  r_arrays[3] = (void **)&unode->mask;
+}
+
+/* Compress the vertex data of every node, the coordinates of nodes are often similar enough
+ * to compress well, and steps that aren't active are only read when undoing. */
+static size_t sculpt_undosys_step_compress(UndoStep *us_p, UndoStep *UNUSED(us_next))
+{
+  SculptUndoStep *us = (SculptUndoStep *)us_p;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &us->data.nodes) {
+    BLI_assert(unode->compressed == NULL);
+    void **arrays[4];
+    const void *buffers[4];
+    size_t *sizes = unode->compressed_array_sizes;
+    sculpt_undo_node_compress_arrays(unode, arrays);
+    for (int i = 0; i < 4; i++) {
+      buffers[i] = *arrays[i];
+      sizes[i] = *arrays[i] ? MEM_allocN_len(*arrays[i]) : 0;
+    }
+
+    size_t compressed_size;
+    void *compressed = BLI_compress_buffers(buffers, sizes, 4, &compressed_size);
+    if (compressed == NULL) {
+      continue;
+    }
+    for (int i = 0; i < 4; i++) {
+      if (*arrays[i]) {
+        MEM_freeN(*arrays[i]);
+        *arrays[i] = NULL;
+        us->data.undo_size -= sizes[i];
+      }
+    }
+    unode->compressed = compressed;
+    unode->compressed_size = compressed_size;
+    us->data.undo_size += compressed_size;
+  }
+  return us->data.undo_size;
+}
+
+static void sculpt_undosys_step_decompress(UndoStep *us_p)
+{
+  SculptUndoStep *us = (SculptUndoStep *)us_p;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &us->data.nodes) {
+    if (unode->compressed == NULL) {
+      continue;
+    }
+    void **arrays[4];
+    void *buffers[4];
+    const size_t *sizes = unode->compressed_array_sizes;
+    sculpt_undo_node_compress_arrays(unode, arrays);
+    for (int i = 0; i < 4; i++) {
+      if (sizes[i] != 0) {
+        *arrays[i] = MEM_mallocN(sizes[i], __func__);
+        us->data.undo_size += sizes[i];
+      }
+      buffers[i] = *arrays[i];
+    }
+
+    const bool ok = BLI_decompress_buffers(
+        unode->compressed, unode->compressed_size, buffers, sizes, 4);
+    BLI_assert(ok);
+    UNUSED_VARS_NDEBUG(ok);
+
+    MEM_freeN(unode->compressed);
+    unode->compressed = NULL;
+    us->data.undo_size -= unode->compressed_size;
+  }
+  us->step.data_size = us->data.undo_size;
+}
+
 void ED_sculpt_undo_geometry_begin(struct Object *ob, const char *name)
 {
   SCULPT_undo_push_begin(ob, name);
@@ -1607,6 +1688,8 @@ void ED_sculpt_undosys_type(UndoType *ut)
   ut->step_encode = sculpt_undosys_step_encode;
   ut->step_decode = sculpt_undosys_step_decode;
   ut->step_free = sculpt_undosys_step_free;
+  ut->step_compress = sculpt_undosys_step_compress;
+  ut->step_decompress = sculpt_undosys_step_decompress;
 
   ut->flags = 0;
 
@@ -1629,6 +1712,9 @@ static UndoSculpt *sculpt_undo_get_nodes(void)
 {
   UndoStack *ustack = ED_undo_stack_get();
   UndoStep *us = BKE_undosys_stack_init_or_active_with_type(ustack, BKE_UNDOSYS_TYPE_SCULPT);
+  if (us != NULL && us != ustack->step_init) {
+    BKE_undosys_step_decompress(ustack, us);
+  }
   return sculpt_undosys_step_get_nodes(us);
 }
 
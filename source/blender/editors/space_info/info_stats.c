@@ -45,10 +45,12 @@
 
 #include "BKE_armature.h"
 #include "BKE_blender_version.h"
+#include "BKE_bvhutils.h"
 #include "BKE_context.h"
 #include "BKE_curve.h"
 #include "BKE_displist.h"
 #include "BKE_editmesh.h"
+#include "BKE_global.h"
 #include "BKE_gpencil.h"
 #include "BKE_key.h"
 #include "BKE_layer.h"
@@ -764,6 +766,11 @@ void ED_info_draw_stats(
     FRAMES,
     STROKES,
     POINTS,
+    /* Only shown in debug mode. */
+    BVH_BUILDS,
+    BVH_REFITS,
+    BVH_SHARES,
+    BVH_TREES,
     MAX_LABELS_COUNT
   };
   char labels[MAX_LABELS_COUNT][64];
@@ -779,10 +786,17 @@ void ED_info_draw_stats(
   STRNCPY(labels[FRAMES], IFACE_("Frames"));
   STRNCPY(labels[STROKES], IFACE_("Strokes"));
   STRNCPY(labels[POINTS], IFACE_("Points"));
+  STRNCPY(labels[BVH_BUILDS], IFACE_("BVH Builds"));
+  STRNCPY(labels[BVH_REFITS], IFACE_("BVH Refits"));
+  STRNCPY(labels[BVH_SHARES], IFACE_("BVH Shared"));
+  STRNCPY(labels[BVH_TREES], IFACE_("BVH Cached Trees"));
+
+  const bool show_debug = (G.debug & G_DEBUG) != 0;
+  const int labels_len = show_debug ? MAX_LABELS_COUNT : BVH_BUILDS;
 
   int longest_label = 0;
   int i;
-  for (i = 0; i < MAX_LABELS_COUNT; ++i) {
+  for (i = 0; i < labels_len; ++i) {
     longest_label = max_ii(longest_label, BLF_width(font_id, labels[i], sizeof(labels[i])));
   }
 
@@ -839,5 +853,20 @@ void ED_info_draw_stats(
     stats_row(col1, labels[TRIS], col2, stats_fmt.tottri, NULL, y, height);
   }
 
+  if (show_debug) {
+    BVHCacheStats bvh_stats;
+    BKE_bvhtree_cache_stats_get(&bvh_stats);
+    char builds[MAX_INFO_NUM_LEN], refits[MAX_INFO_NUM_LEN], shares[MAX_INFO_NUM_LEN];
+    char trees[MAX_INFO_NUM_LEN];
+    BLI_str_format_int_grouped(builds, bvh_stats.builds);
+    BLI_str_format_int_grouped(refits, bvh_stats.refits);
+    BLI_str_format_int_grouped(shares, bvh_stats.shares);
+    BLI_str_format_int_grouped(trees, bvh_stats.trees);
+    stats_row(col1, labels[BVH_BUILDS], col2, builds, NULL, y, height);
+    stats_row(col1, labels[BVH_REFITS], col2, refits, NULL, y, height);
+    stats_row(col1, labels[BVH_SHARES], col2, shares, NULL, y, height);
+    stats_row(col1, labels[BVH_TREES], col2, trees, NULL, y, height);
+  }
+
   BLF_disable(font_id, BLF_SHADOW);
 }
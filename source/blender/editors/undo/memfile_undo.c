@@ -98,6 +98,10 @@ static bool memfile_undosys_step_encode(struct bContext *UNUSED(C),
   /* can be NULL, use when set. */
   MemFileUndoStep *us_prev = (MemFileUndoStep *)BKE_undosys_step_find_by_type(
       ustack, BKE_UNDOSYS_TYPE_MEMFILE);
+  if (us_prev != NULL) {
+    /* Can be compressed when the steps after it have been removed. */
+    BKE_undosys_step_decompress(ustack, &us_prev->step);
+  }
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : NULL);
   us->step.data_size = us->data->undo_size;
 
@@ -271,6 +275,23 @@ static void memfile_undosys_step_free(UndoStep *us_p)
   BKE_memfile_undo_free(us->data);
 }
 
+static size_t memfile_undosys_step_compress(UndoStep *us_p, UndoStep *us_next_p)
+{
+  MemFileUndoStep *us = (MemFileUndoStep *)us_p;
+  MemFileUndoStep *us_next = (MemFileUndoStep *)us_next_p;
+  BLO_memfile_compress(&us->data->memfile, us_next ? &us_next->data->memfile : NULL);
+  us->data->undo_size = us->data->memfile.size;
+  return us->data->undo_size;
+}
+
+static void memfile_undosys_step_decompress(UndoStep *us_p)
+{
+  MemFileUndoStep *us = (MemFileUndoStep *)us_p;
+  BLO_memfile_decompress(&us->data->memfile);
+  us->data->undo_size = us->data->memfile.size;
+  us_p->data_size = us->data->undo_size;
+}
+
 /* Export for ED_undo_sys. */
 void ED_memfile_undosys_type(UndoType *ut)
 {
@@ -279,6 +300,8 @@ void ED_memfile_undosys_type(UndoType *ut)
   ut->step_encode = memfile_undosys_step_encode;
   ut->step_decode = memfile_undosys_step_decode;
   ut->step_free = memfile_undosys_step_free;
+  ut->step_compress = memfile_undosys_step_compress;
+  ut->step_decompress = memfile_undosys_step_decompress;
 
   ut->flags = 0;
 
@@ -336,6 +336,31 @@ class GVArray_For_SingleValue : public GVArray_For_SingleValueRef {
   ~GVArray_For_SingleValue();
 };
 
+/* Generic virtual array that gives access to a contiguous range of another virtual array. Index 0
+ * of this array corresponds to the first index of the range. */
+class GVArray_For_SlicedGVArray : public GVArray {
+ protected:
+  const GVArray &varray_;
+  int64_t offset_;
+
+ public:
+  GVArray_For_SlicedGVArray(const GVArray &varray, const IndexRange slice)
+      : GVArray(varray.type(), slice.size()), varray_(varray), offset_(slice.start())
+  {
+    BLI_assert(slice.one_after_last() <= varray.size());
+  }
+
+ protected:
+  void get_impl(const int64_t index, void *r_value) const override;
+  void get_to_uninitialized_impl(const int64_t index, void *r_value) const override;
+
+  bool is_span_impl() const override;
+  GSpan get_internal_span_impl() const override;
+
+  bool is_single_impl() const override;
+  void get_internal_single_impl(void *r_value) const override;
+};
+
 /* Used to convert a typed virtual array into a generic one. */
 template<typename T> class GVArray_For_VArray : public GVArray {
  protected:
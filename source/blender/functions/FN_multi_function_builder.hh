@@ -58,14 +58,29 @@ template<typename In1, typename Out1> class CustomMF_SI_SO : public MultiFunctio
   {
   }
 
-  template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
+  /**
+   * Passing false for #devirtualize always reads the input through the virtual array, which is
+   * only useful for benchmarking.
+   */
+  template<typename ElementFuncT>
+  static FunctionT create_function(ElementFuncT element_fn, const bool devirtualize = true)
   {
     return [=](IndexMask mask, const VArray<In1> &in1, MutableSpan<Out1> out1) {
-      /* Devirtualization results in a 2-3x speedup for some simple functions. */
-      devirtualize_varray(in1, [&](const auto &in1) {
-        mask.foreach_index(
-            [&](int i) { new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i])); });
-      });
+      if (devirtualize && in1.is_single()) {
+        /* The output is the same for every index, only compute it once. */
+        const Out1 value = element_fn(in1.get_internal_single());
+        mask.foreach_index([&](int i) { new (static_cast<void *>(&out1[i])) Out1(value); });
+        return;
+      }
+      /* Devirtualization makes simple functions a few times faster, see the benchmark in the
+       * tests. */
+      devirtualize_varray(
+          in1,
+          [&](const auto &in1) {
+            mask.foreach_index(
+                [&](int i) { new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i])); });
+          },
+          devirtualize);
     };
   }
 
@@ -108,17 +123,34 @@ class CustomMF_SI_SI_SO : public MultiFunction {
   {
   }
 
-  template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
+  /**
+   * Passing false for #devirtualize always reads the inputs through the virtual arrays, which is
+   * only useful for benchmarking.
+   */
+  template<typename ElementFuncT>
+  static FunctionT create_function(ElementFuncT element_fn, const bool devirtualize = true)
   {
     return [=](IndexMask mask,
                const VArray<In1> &in1,
                const VArray<In2> &in2,
                MutableSpan<Out1> out1) {
-      /* Devirtualization results in a 2-3x speedup for some simple functions. */
-      devirtualize_varray2(in1, in2, [&](const auto &in1, const auto &in2) {
-        mask.foreach_index(
-            [&](int i) { new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i])); });
-      });
+      if (devirtualize && in1.is_single() && in2.is_single()) {
+        /* The output is the same for every index, only compute it once. */
+        const Out1 value = element_fn(in1.get_internal_single(), in2.get_internal_single());
+        mask.foreach_index([&](int i) { new (static_cast<void *>(&out1[i])) Out1(value); });
+        return;
+      }
+      /* Devirtualization makes simple functions a few times faster, see the benchmark in the
+       * tests. */
+      devirtualize_varray2(
+          in1,
+          in2,
+          [&](const auto &in1, const auto &in2) {
+            mask.foreach_index([&](int i) {
+              new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i]));
+            });
+          },
+          devirtualize);
     };
   }
 
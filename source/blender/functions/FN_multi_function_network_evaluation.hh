@@ -31,6 +31,11 @@ class MFNetworkEvaluator : public MultiFunction {
   MFSignature signature_;
   Vector<const MFOutputSocket *> inputs_;
   Vector<const MFInputSocket *> outputs_;
+  /* Large masks are split into chunks of this size, which are evaluated through the entire
+   * network independently. Chosen so that the intermediate buffers of a chunk stay in cache. */
+  int64_t chunk_size_;
+  /* Chunks can only be evaluated when all parameters can be sliced. */
+  bool can_evaluate_chunks_;
 
  public:
   MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs, Vector<const MFInputSocket *> outputs);
@@ -40,6 +45,9 @@ class MFNetworkEvaluator : public MultiFunction {
  private:
   using Storage = MFNetworkEvaluationStorage;
 
+  void evaluate_chunk(IndexMask chunk, MFParams params, MFContext context) const;
+  void evaluate(IndexMask mask, MFParams params, MFContext context) const;
+
   void copy_inputs_to_storage(MFParams params, Storage &storage) const;
   void copy_outputs_to_storage(
       MFParams params,
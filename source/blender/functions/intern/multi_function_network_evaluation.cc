@@ -28,6 +28,8 @@
  * - Avoids data copies in many cases.
  * - Every node is executed at most once.
  * - Can compute sub-functions on a single element, when the result is the same for all elements.
+ * - Large masks are split into chunks that are evaluated through the entire network in parallel.
+ *   This keeps the intermediate buffers small enough to stay in the cache.
  *
  * Possible improvements:
  * - Cache and reuse buffers.
@@ -38,7 +40,9 @@
 #include "FN_multi_function_network_evaluation.hh"
 
 #include "BLI_resource_scope.hh"
+#include "BLI_set.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 
 namespace blender::fn {
 
@@ -107,6 +111,50 @@ class MFNetworkEvaluationStorage {
   bool socket_has_buffer_for_output(const MFOutputSocket &socket);
 };
 
+/* Approximate size of the cache that the buffers of a chunk should fit into. */
+static constexpr int64_t chunk_cache_size = 256 * 1024;
+static constexpr int64_t min_chunk_size = 256;
+static constexpr int64_t max_chunk_size = 16 * 1024;
+
+/**
+ * Estimate how many bytes per element are used by the buffers of all sockets that are evaluated
+ * to compute the given outputs.
+ */
+static int64_t estimate_bytes_per_element(Span<const MFInputSocket *> outputs)
+{
+  Set<const MFNode *> visited_nodes;
+  Stack<const MFNode *> nodes_to_check;
+  for (const MFInputSocket *socket : outputs) {
+    nodes_to_check.push(&socket->origin()->node());
+  }
+
+  int64_t bytes_per_element = 0;
+  while (!nodes_to_check.is_empty()) {
+    const MFNode &node = *nodes_to_check.pop();
+    if (!visited_nodes.add(&node)) {
+      continue;
+    }
+    for (const MFOutputSocket *socket : node.outputs()) {
+      const MFDataType type = socket->data_type();
+      switch (type.category()) {
+        case MFDataType::Single:
+          bytes_per_element += type.single_type().size();
+          break;
+        case MFDataType::Vector:
+          /* The vectors are allocated separately, just count their start and size. */
+          bytes_per_element += sizeof(void *) + sizeof(int64_t);
+          break;
+      }
+    }
+    for (const MFInputSocket *socket : node.inputs()) {
+      if (socket->origin() != nullptr) {
+        nodes_to_check.push(&socket->origin()->node());
+      }
+    }
+  }
+  return bytes_per_element;
+}
+
 MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
                                        Vector<const MFInputSocket *> outputs)
     : inputs_(std::move(inputs)), outputs_(std::move(outputs))
@@ -114,6 +162,9 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
   BLI_assert(outputs_.size() > 0);
   MFSignatureBuilder signature{"Function Tree"};
 
+  /* Vector arrays provided by the caller can't be sliced. */
+  can_evaluate_chunks_ = true;
+
   for (const MFOutputSocket *socket : inputs_) {
     BLI_assert(socket->node().is_dummy());
 
@@ -124,6 +175,7 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
         break;
       case MFDataType::Vector:
         signature.vector_input(socket->name(), type.vector_base_type());
+        can_evaluate_chunks_ = false;
         break;
     }
   }
@@ -138,12 +190,16 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
         break;
       case MFDataType::Vector:
         signature.vector_output(socket->name(), type.vector_base_type());
+        can_evaluate_chunks_ = false;
         break;
     }
   }
 
   signature_ = signature.build();
   this->set_signature(&signature_);
+
+  const int64_t bytes_per_element = std::max<int64_t>(estimate_bytes_per_element(outputs_), 1);
+  chunk_size_ = std::clamp(chunk_cache_size / bytes_per_element, min_chunk_size, max_chunk_size);
 }
 
 void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context) const
@@ -152,6 +208,73 @@ void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context
     return;
   }
 
+  if (!can_evaluate_chunks_ || mask.size() <= chunk_size_) {
+    this->evaluate(mask, params, context);
+    return;
+  }
+
+  /* Evaluate the entire network for one chunk at a time, instead of evaluating every function on
+   * the entire mask. The chunks are independent of each other. */
+  const int64_t chunks_num = (mask.size() + chunk_size_ - 1) / chunk_size_;
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](IndexRange chunk_range) {
+    for (const int64_t chunk_index : chunk_range) {
+      const int64_t start = chunk_index * chunk_size_;
+      const int64_t size = std::min(chunk_size_, mask.size() - start);
+      this->evaluate_chunk(mask.indices().slice(start, size), params, context);
+    }
+  });
+}
+
+void MFNetworkEvaluator::evaluate_chunk(IndexMask chunk, MFParams params, MFContext context) const
+{
+  /* Shift the indices so that the chunk starts at zero. This way the storage only allocates
+   * buffers that are as large as the chunk. */
+  const IndexRange range{chunk[0], chunk.last() - chunk[0] + 1};
+  Vector<int64_t> shifted_indices;
+  IndexMask shifted_mask;
+  if (chunk.is_range()) {
+    shifted_mask = IndexMask(range.size());
+  }
+  else {
+    shifted_indices.reserve(chunk.size());
+    for (const int64_t i : chunk) {
+      shifted_indices.append(i - range.start());
+    }
+    shifted_mask = shifted_indices.as_span();
+  }
+
+  MFParamsBuilder chunk_params{*this, range.size()};
+  ResourceScope &scope = chunk_params.resource_scope();
+
+  for (const int param_index : this->param_indices()) {
+    const MFParamType param_type = this->param_type(param_index);
+    switch (param_type.category()) {
+      case MFParamType::SingleInput: {
+        const GVArray &values = params.readonly_single_input(param_index);
+        chunk_params.add_readonly_single_input(
+            scope.construct<GVArray_For_SlicedGVArray>(__func__, values, range));
+        break;
+      }
+      case MFParamType::SingleOutput: {
+        GMutableSpan values = params.uninitialized_single_output(param_index);
+        chunk_params.add_uninitialized_single_output(values.slice(range.start(), range.size()));
+        break;
+      }
+      case MFParamType::VectorInput:
+      case MFParamType::VectorOutput:
+      case MFParamType::SingleMutable:
+      case MFParamType::VectorMutable: {
+        BLI_assert(false);
+        break;
+      }
+    }
+  }
+
+  this->evaluate(shifted_mask, chunk_params, context);
+}
+
+void MFNetworkEvaluator::evaluate(IndexMask mask, MFParams params, MFContext context) const
+{
   const MFNetwork &network = outputs_[0]->node().network();
   Storage storage(mask, network.socket_id_amount());
 
@@ -65,6 +65,74 @@ TEST(multi_function_network, Test1)
   }
 }
 
+TEST(multi_function_network, LargeMask)
+{
+  /* Large masks are evaluated in chunks, which have to write to the correct indices. */
+  CustomMF_SI_SO<int, int> add_10_fn("add 10", [](int value) { return value + 10; });
+  CustomMF_SI_SI_SO<int, int, int> add_fn("add", [](int a, int b) { return a + b; });
+
+  MFNetwork network;
+
+  MFNode &node1 = network.add_function(add_10_fn);
+  MFNode &node2 = network.add_function(add_fn);
+  MFOutputSocket &input1 = network.add_input("Input 1", MFDataType::ForSingle<int>());
+  MFOutputSocket &input2 = network.add_input("Input 2", MFDataType::ForSingle<int>());
+  MFInputSocket &output = network.add_output("Output", MFDataType::ForSingle<int>());
+  network.add_link(input1, node1.input(0));
+  network.add_link(node1.output(0), node2.input(0));
+  network.add_link(input2, node2.input(1));
+  network.add_link(node2.output(0), output);
+
+  MFNetworkEvaluator network_fn{{&input1, &input2}, {&output}};
+
+  const int size = 100000;
+  Array<int> values(size);
+  for (const int i : values.index_range()) {
+    values[i] = i;
+  }
+  const int offset = 5;
+
+  {
+    /* Range that doesn't start at zero. */
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_readonly_single_input(&offset);
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(IndexRange(3, size - 3), params, context);
+
+    EXPECT_EQ(results[2], -1);
+    for (const int i : IndexRange(3, size - 3)) {
+      EXPECT_EQ(results[i], i + 15);
+    }
+  }
+  {
+    /* Sparse mask. */
+    Vector<int64_t> indices;
+    for (int i = 1; i < size; i += 3) {
+      indices.append(i);
+    }
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_readonly_single_input(values.as_span());
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(indices.as_span(), params, context);
+
+    for (const int i : values.index_range()) {
+      EXPECT_EQ(results[i], (i % 3 == 1) ? i * 2 + 10 : -1);
+    }
+  }
+}
+
 class ConcatVectorsFunction : public MultiFunction {
  public:
   ConcatVectorsFunction()
@@ -5,6 +5,8 @@
 #include "FN_multi_function.hh"
 #include "FN_multi_function_builder.hh"
 
+#include "BLI_timeit.hh"
+
 namespace blender::fn::tests {
 namespace {
 
@@ -278,6 +280,90 @@ TEST(multi_function, CustomMF_SI_SI_SO)
   EXPECT_EQ(outputs[3], 90);
 }
 
+TEST(multi_function, CustomMF_SI_SO_Single)
+{
+  int calls = 0;
+  CustomMF_SI_SO<int, int> fn("square", [&](int a) {
+    calls++;
+    return a * a;
+  });
+
+  int value = 5;
+  Array<int> outputs(4, -1);
+
+  MFParamsBuilder params(fn, outputs.size());
+  params.add_readonly_single_input(&value);
+  params.add_uninitialized_single_output(outputs.as_mutable_span());
+
+  MFContextBuilder context;
+
+  fn.call({0, 2, 3}, params, context);
+
+  /* A single input value is only computed once. */
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(outputs[0], 25);
+  EXPECT_EQ(outputs[1], -1);
+  EXPECT_EQ(outputs[2], 25);
+  EXPECT_EQ(outputs[3], 25);
+}
+
+static void test_devirtualized_sub(const GVArray &varray_a, const GVArray &varray_b)
+{
+  CustomMF_SI_SI_SO<int, int, int> fn("sub", [](int a, int b) { return a - b; });
+  CustomMF_SI_SI_SO<int, int, int> fn_virtual(
+      "sub", CustomMF_SI_SI_SO<int, int, int>::create_function([](int a, int b) { return a - b; },
+                                                               false));
+
+  const int64_t size = varray_a.size();
+  const Vector<int64_t> indices = {1, 2, 5, 6, 9};
+  for (const IndexMask mask : {IndexMask(size), IndexMask(IndexRange(2, 5)), IndexMask(indices)}) {
+    Array<int> outputs(size, -1);
+    Array<int> expected_outputs(size, -1);
+
+    MFParamsBuilder params(fn, size);
+    params.add_readonly_single_input(varray_a);
+    params.add_readonly_single_input(varray_b);
+    params.add_uninitialized_single_output(outputs.as_mutable_span());
+
+    MFParamsBuilder params_virtual(fn_virtual, size);
+    params_virtual.add_readonly_single_input(varray_a);
+    params_virtual.add_readonly_single_input(varray_b);
+    params_virtual.add_uninitialized_single_output(expected_outputs.as_mutable_span());
+
+    MFContextBuilder context;
+    fn.call(mask, params, context);
+    fn_virtual.call(mask, params_virtual, context);
+
+    for (const int64_t i : IndexRange(size)) {
+      EXPECT_EQ(outputs[i], expected_outputs[i]);
+    }
+  }
+}
+
+TEST(multi_function, CustomMF_SI_SI_SO_Devirtualized)
+{
+  Array<int> values_a = {1, 4, 2, 6, 8, 9, 3, 6, 7, 2};
+  Array<int> values_b = {5, 3, 8, 3, 2, 6, 7, 8, 1, 0};
+  int value_a = 10;
+  int value_b = 3;
+  const int64_t size = values_a.size();
+
+  GVArray_For_GSpan span_a{values_a.as_span()};
+  GVArray_For_GSpan span_b{values_b.as_span()};
+  GVArray_For_SingleValueRef single_a{CPPType::get<int>(), size, &value_a};
+  GVArray_For_SingleValueRef single_b{CPPType::get<int>(), size, &value_b};
+  auto func = [](int64_t index) { return (int)(index * 3); };
+  VArray_For_Func<int, decltype(func)> func_varray{size, func};
+  GVArray_For_VArray<int> func_b{func_varray};
+
+  test_devirtualized_sub(span_a, span_b);
+  test_devirtualized_sub(span_a, single_b);
+  test_devirtualized_sub(single_a, span_b);
+  test_devirtualized_sub(single_a, single_b);
+  test_devirtualized_sub(span_a, func_b);
+  test_devirtualized_sub(single_a, func_b);
+}
+
 TEST(multi_function, CustomMF_SI_SI_SI_SO)
 {
   CustomMF_SI_SI_SI_SO<int, std::string, bool, uint> fn{
@@ -412,5 +498,100 @@ TEST(multi_function, CustomMF_Convert)
   EXPECT_EQ(outputs[2], 9);
 }
 
+/**
+ * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
+ */
+#if 0
+/**
+ * Compares the virtual path, the devirtualized path without the special case for single inputs,
+ * and the current implementation of #CustomMF_SI_SI_SO.
+ */
+template<typename ElementFuncT>
+BLI_NOINLINE static void benchmark_SI_SI_SO(StringRef name,
+                                            const ElementFuncT &element_fn,
+                                            const GVArray &varray_a,
+                                            const GVArray &varray_b)
+{
+  using MF = CustomMF_SI_SI_SO<float, float, float>;
+  MF fn_virtual("virtual", MF::create_function(element_fn, false));
+  using FunctionT = std::function<void(
+      IndexMask, const VArray<float> &, const VArray<float> &, MutableSpan<float>)>;
+  const FunctionT devirtualized_function = [=](IndexMask mask,
+                                               const VArray<float> &in1,
+                                               const VArray<float> &in2,
+                                               MutableSpan<float> out1) {
+    devirtualize_varray2(in1, in2, [&](const auto &in1, const auto &in2) {
+      mask.foreach_index([&](int i) { out1[i] = element_fn(in1[i], in2[i]); });
+    });
+  };
+  MF fn_devirtualized("devirtualized", devirtualized_function);
+  MF fn("current", element_fn);
+
+  const int64_t size = varray_a.size();
+  Array<float> outputs(size);
+  MFContextBuilder context;
+
+  for (const MF *function : {&fn_virtual, &fn_devirtualized, &fn}) {
+    MFParamsBuilder params(*function, size);
+    params.add_readonly_single_input(varray_a);
+    params.add_readonly_single_input(varray_b);
+    params.add_uninitialized_single_output(outputs.as_mutable_span());
+    SCOPED_TIMER(name + " " + function->name());
+    function->call(IndexRange(size), params, context);
+  }
+
+  /* Print a value for simple error checking and to avoid some compiler optimizations. */
+  std::cout << "Last: " << outputs.last() << "\n";
+}
+
+TEST(multi_function, DevirtualizedBenchmark)
+{
+  const int64_t size = 10000000;
+  Array<float> values_a(size);
+  Array<float> values_b(size);
+  for (const int64_t i : IndexRange(size)) {
+    values_a[i] = i * 0.5f;
+    values_b[i] = i * 0.25f;
+  }
+  const float value_a = 2.0f;
+  const float value_b = 3.0f;
+
+  GVArray_For_GSpan span_a{values_a.as_span()};
+  GVArray_For_GSpan span_b{values_b.as_span()};
+  GVArray_For_SingleValueRef single_a{CPPType::get<float>(), size, &value_a};
+  GVArray_For_SingleValueRef single_b{CPPType::get<float>(), size, &value_b};
+
+  const auto multiply_add = [](float a, float b) { return a * b + a; };
+  const auto power_sine = [](float a, float b) { return powf(a, b) + sinf(a * b); };
+
+  for (int i = 0; i < 3; i++) {
+    benchmark_SI_SI_SO("multiply add span * span    ", multiply_add, span_a, span_b);
+    benchmark_SI_SI_SO("multiply add span * single  ", multiply_add, span_a, single_b);
+    benchmark_SI_SI_SO("multiply add single * single", multiply_add, single_a, single_b);
+    benchmark_SI_SI_SO("power sine single * single  ", power_sine, single_a, single_b);
+  }
+}
+
+/**
+ * Timings of the same loops with the -O2 build of GCC 12 on a single core. Devirtualization makes
+ * the multiply add 2.5-6x faster. Computing the output of single inputs once only matters when
+ * the compiler can't move the function out of the loop itself.
+ *
+ * Timer 'multiply add span * span     virtual' took 32.65 ms
+ * Timer 'multiply add span * span     devirtualized' took 13.18 ms
+ * Timer 'multiply add span * span     current' took 15.13 ms
+ * Timer 'multiply add span * single   virtual' took 45.68 ms
+ * Timer 'multiply add span * single   devirtualized' took 13.06 ms
+ * Timer 'multiply add span * single   current' took 12.81 ms
+ * Timer 'multiply add single * single virtual' took 44.47 ms
+ * Timer 'multiply add single * single devirtualized' took 7.69 ms
+ * Timer 'multiply add single * single current' took 7.90 ms
+ * Timer 'power sine single * single   virtual' took 106.33 ms
+ * Timer 'power sine single * single   devirtualized' took 98.99 ms
+ * Timer 'power sine single * single   current' took 6.01 ms
+ */
+
+#endif /* Benchmark */
+
 }  // namespace
 }  // namespace blender::fn::tests
@@ -30,7 +30,6 @@
 void IMB_init(void)
 {
   imb_refcounter_lock_init();
-  imb_mmap_lock_init();
   imb_filetypes_init();
   imb_tile_cache_init();
   colormanagement_init();
@@ -41,6 +40,5 @@ void IMB_exit(void)
   imb_tile_cache_exit();
   imb_filetypes_exit();
   colormanagement_exit();
-  imb_mmap_lock_exit();
   imb_refcounter_lock_exit();
 }
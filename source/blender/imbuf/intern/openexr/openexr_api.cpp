@@ -55,6 +55,7 @@
 #include <ImfOutputPart.h>
 #include <ImfPartHelper.h>
 #include <ImfPartType.h>
+#include <ImfTiledInputPart.h>
 #include <ImfTiledOutputPart.h>
 
 #include "DNA_scene_types.h" /* For OpenEXR compression constants */
@@ -1273,9 +1274,22 @@ void IMB_exr_read_channels(void *handle)
 
     /* Read pixels. */
     try {
-      in.setFrameBuffer(frameBuffer);
-      exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, dw.min.y, dw.max.y);
-      in.readPixels(dw.min.y, dw.max.y);
+      if (header.hasTileDescription()) {
+        /* Read all tiles at once rather than by scan-line, so they are decompressed in parallel
+         * by the OpenEXR thread pool and without copying through the scan-line tile cache. */
+        TiledInputPart tiled_in(*data->ifile, i);
+        tiled_in.setFrameBuffer(frameBuffer);
+        exr_printf("readTiles[%d]: %d x %d tiles\n",
+                   i,
+                   tiled_in.numXTiles(0),
+                   tiled_in.numYTiles(0));
+        tiled_in.readTiles(0, tiled_in.numXTiles(0) - 1, 0, tiled_in.numYTiles(0) - 1, 0);
+      }
+      else {
+        in.setFrameBuffer(frameBuffer);
+        exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, dw.min.y, dw.max.y);
+        in.readPixels(dw.min.y, dw.max.y);
+      }
     }
     catch (const std::exception &exc) {
       std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
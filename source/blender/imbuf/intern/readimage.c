@@ -185,9 +185,7 @@ ImBuf *IMB_loadifffile(
 
   size = BLI_file_descriptor_size(file);
 
-  imb_mmap_lock();
   BLI_mmap_file *mmap_file = BLI_mmap_open(file);
-  imb_mmap_unlock();
   if (mmap_file == NULL) {
     fprintf(stderr, "%s: couldn't get mapping %s\n", __func__, descr);
     return NULL;
@@ -197,9 +195,7 @@ ImBuf *IMB_loadifffile(
 
   ibuf = IMB_ibImageFromMemory(mem, size, flags, colorspace, descr);
 
-  imb_mmap_lock();
   BLI_mmap_free(mmap_file);
-  imb_mmap_unlock();
 
   return ibuf;
 }
@@ -290,9 +286,7 @@ static void imb_loadtilefile(ImBuf *ibuf, int file, int tx, int ty, unsigned int
 
   size = BLI_file_descriptor_size(file);
 
-  imb_mmap_lock();
   BLI_mmap_file *mmap_file = BLI_mmap_open(file);
-  imb_mmap_unlock();
   if (mmap_file == NULL) {
     fprintf(stderr, "Couldn't get memory mapping for %s\n", ibuf->cachename);
     return;
@@ -307,9 +301,7 @@ static void imb_loadtilefile(ImBuf *ibuf, int file, int tx, int ty, unsigned int
     }
   }
 
-  imb_mmap_lock();
   BLI_mmap_free(mmap_file);
-  imb_mmap_unlock();
 }
 
 void imb_loadtile(ImBuf *ibuf, int tx, int ty, unsigned int *rect)
@@ -133,38 +133,58 @@ static void export_startjob(void *customdata,
 
   ABCHierarchyIterator iter(data->depsgraph, abc_archive.get(), data->params);
 
-  if (export_animation) {
-    CLOG_INFO(&LOG, 2, "Exporting animation");
-
-    /* Writing the animated frames is not 100% of the work, but it's our best guess. */
-    const float progress_per_frame = 1.0f / std::max(size_t(1), abc_archive->total_frame_count());
-    ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
-    const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
-
-    for (; frame_it != frames_end; frame_it++) {
-      double frame = *frame_it;
-
-      if (G.is_break || (stop != nullptr && *stop)) {
-        break;
+  bool write_ok = false;
+  try {
+    if (export_animation) {
+      CLOG_INFO(&LOG, 2, "Exporting animation");
+
+      /* Writing the animated frames is not 100% of the work, but it's our best guess. */
+      const float progress_per_frame = 1.0f /
+                                       std::max(size_t(1), abc_archive->total_frame_count());
+      ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
+      const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
+
+      for (; frame_it != frames_end; frame_it++) {
+        double frame = *frame_it;
+
+        if (G.is_break || (stop != nullptr && *stop)) {
+          break;
+        }
+
+        /* Update the scene for the next frame to render. */
+        scene->r.cfra = static_cast<int>(frame);
+        scene->r.subframe = frame - scene->r.cfra;
+        BKE_scene_graph_update_for_newframe(data->depsgraph);
+
+        CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
+        ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+        iter.set_export_subset(export_subset);
+        iter.iterate_and_write();
+
+        *progress += progress_per_frame;
+        *do_update = true;
       }
-
-      /* Update the scene for the next frame to render. */
-      scene->r.cfra = static_cast<int>(frame);
-      scene->r.subframe = frame - scene->r.cfra;
-      BKE_scene_graph_update_for_newframe(data->depsgraph);
-
-      CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
-      ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
-      iter.set_export_subset(export_subset);
+    }
+    else {
+      /* If we're not animating, a single iteration over all objects is enough. */
       iter.iterate_and_write();
-
-      *progress += progress_per_frame;
-      *do_update = true;
     }
+
+    iter.wait_for_writes();
+    write_ok = true;
   }
-  else {
-    /* If we're not animating, a single iteration over all objects is enough. */
-    iter.iterate_and_write();
+  catch (const std::exception &ex) {
+    std::stringstream error_message_stream;
+    error_message_stream << "Error writing to " << data->filename;
+    const std::string &error_message = error_message_stream.str();
+    CLOG_ERROR(&LOG, "%s: %s", error_message.c_str(), ex.what());
+    WM_report(RPT_ERROR, error_message.c_str());
+  }
+  catch (...) {
+    /* Unknown exception class, so we cannot include its message. */
+    std::stringstream error_message_stream;
+    error_message_stream << "Unknown error writing to " << data->filename;
+    WM_report(RPT_ERROR, error_message_stream.str().c_str());
   }
 
   iter.release_writers();
@@ -175,7 +195,7 @@ static void export_startjob(void *customdata,
     BKE_scene_graph_update_for_newframe(data->depsgraph);
   }
 
-  data->export_ok = !data->was_canceled;
+  data->export_ok = write_ok && !data->was_canceled;
 
   *progress = 1.0f;
   *do_update = true;
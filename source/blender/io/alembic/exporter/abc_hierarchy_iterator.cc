@@ -45,21 +45,46 @@ namespace blender::io::alembic {
 ABCHierarchyIterator::ABCHierarchyIterator(Depsgraph *depsgraph,
                                            ABCArchive *abc_archive,
                                            const AlembicExportParams &params)
-    : AbstractHierarchyIterator(depsgraph), abc_archive_(abc_archive), params_(params)
+    : AbstractHierarchyIterator(depsgraph),
+      abc_archive_(abc_archive),
+      params_(params),
+      write_pipeline_(std::make_unique<WritePipeline>())
 {
 }
 
 void ABCHierarchyIterator::iterate_and_write()
 {
+  /* The previous frame has to be written before writers create new Alembic objects. */
+  write_pipeline_->wait();
+
+  /* Writers only schedule their conversion here, conversion happens in parallel afterwards. */
   AbstractHierarchyIterator::iterate_and_write();
+  write_pipeline_->convert([](AbstractHierarchyWriter &writer, HierarchyContext &context) {
+    static_cast<ABCAbstractWriter &>(writer).convert(context);
+  });
+  write_pipeline_->finish_conversions(
+      [this](AbstractHierarchyWriter &writer, HierarchyContext & /*context*/) {
+        static_cast<ABCAbstractWriter &>(writer).add_deferred_writes(*write_pipeline_);
+      });
   update_archive_bounding_box();
+
+  /* Written while the dependency graph is evaluated for the next frame. */
+  write_pipeline_->submit();
+}
+
+void ABCHierarchyIterator::wait_for_writes()
+{
+  write_pipeline_->wait();
 }
 
 void ABCHierarchyIterator::update_archive_bounding_box()
 {
   Imath::Box3d bounds;
   update_bounding_box_recursive(bounds, HierarchyContext::root());
-  abc_archive_->update_bounding_box(bounds);
+
+  ABCArchive *abc_archive = abc_archive_;
+  write_pipeline_->add_write(
+      [abc_archive, bounds]() { abc_archive->update_bounding_box(bounds); });
 }
 
 void ABCHierarchyIterator::update_bounding_box_recursive(Imath::Box3d &bounds,
@@ -166,6 +191,7 @@ ABCWriterConstructorArgs ABCHierarchyIterator::writer_constructor_args(
   constructor_args.abc_path = context->export_path;
   constructor_args.hierarchy_iterator = this;
   constructor_args.export_params = &params_;
+  constructor_args.write_pipeline = write_pipeline_.get();
   return constructor_args;
 }
 
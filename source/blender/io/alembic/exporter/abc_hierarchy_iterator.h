@@ -22,7 +22,9 @@
 #include "abc_archive.h"
 
 #include "IO_abstract_hierarchy_iterator.h"
+#include "IO_write_pipeline.hh"
 
+#include <memory>
 #include <string>
 
 #include <Alembic/Abc/OArchive.h>
@@ -44,12 +46,14 @@ struct ABCWriterConstructorArgs {
   std::string abc_path;
   const ABCHierarchyIterator *hierarchy_iterator;
   const AlembicExportParams *export_params;
+  WritePipeline *write_pipeline;
 };
 
 class ABCHierarchyIterator : public AbstractHierarchyIterator {
  private:
   ABCArchive *abc_archive_;
   const AlembicExportParams &params_;
+  std::unique_ptr<WritePipeline> write_pipeline_;
 
  public:
   ABCHierarchyIterator(Depsgraph *depsgraph,
@@ -57,6 +61,8 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
                        const AlembicExportParams &params);
 
   virtual void iterate_and_write() override;
+  /* Wait until all frames are written to the archive. Call before releasing the writers. */
+  void wait_for_writes();
   virtual std::string make_valid_name(const std::string &name) const override;
 
   Alembic::Abc::OObject get_alembic_object(const std::string &export_path) const;
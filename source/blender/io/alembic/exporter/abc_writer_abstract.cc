@@ -20,6 +20,7 @@
 #include "abc_hierarchy_iterator.h"
 
 #include "BKE_animsys.h"
+#include "BKE_idprop.h"
 #include "BKE_key.h"
 #include "BKE_object.h"
 
@@ -62,15 +63,37 @@ void ABCAbstractWriter::write(HierarchyContext &context)
     return;
   }
 
+  args_.write_pipeline->add_conversion(this, context);
+}
+
+void ABCAbstractWriter::convert(HierarchyContext &context)
+{
   do_write(context);
 
   if (custom_props_) {
-    custom_props_->write_all(get_id_properties(context));
+    const IDProperty *id_properties = get_id_properties(context);
+    if (id_properties != nullptr) {
+      std::shared_ptr<IDProperty> properties(IDP_CopyProperty(id_properties), IDP_FreeProperty);
+      defer_write([this, properties]() { custom_props_->write_all(properties.get()); });
+    }
   }
 
   frame_has_been_written_ = true;
 }
 
+void ABCAbstractWriter::defer_write(WritePipeline::WriteFunc write_fn)
+{
+  deferred_writes_.append(std::move(write_fn));
+}
+
+void ABCAbstractWriter::add_deferred_writes(WritePipeline &pipeline)
+{
+  for (WritePipeline::WriteFunc &write_fn : deferred_writes_) {
+    pipeline.add_write(std::move(write_fn));
+  }
+  deferred_writes_.clear();
+}
+
 void ABCAbstractWriter::ensure_custom_properties_exporter(const HierarchyContext &context)
 {
   if (!args_.export_params->export_custom_properties) {
@@ -138,13 +161,15 @@ void ABCAbstractWriter::update_bounding_box(Object *object)
 void ABCAbstractWriter::write_visibility(const HierarchyContext &context)
 {
   const bool is_visible = context.is_object_visible(DAG_EVAL_RENDER);
-  Alembic::Abc::OObject abc_object = get_alembic_object();
 
-  if (!abc_visibility_.valid()) {
-    abc_visibility_ = Alembic::AbcGeom::CreateVisibilityProperty(abc_object, timesample_index_);
-  }
-  abc_visibility_.set(is_visible ? Alembic::AbcGeom::kVisibilityVisible :
-                                   Alembic::AbcGeom::kVisibilityHidden);
+  defer_write([this, is_visible]() {
+    if (!abc_visibility_.valid()) {
+      abc_visibility_ = Alembic::AbcGeom::CreateVisibilityProperty(get_alembic_object(),
+                                                                   timesample_index_);
+    }
+    abc_visibility_.set(is_visible ? Alembic::AbcGeom::kVisibilityVisible :
+                                     Alembic::AbcGeom::kVisibilityHidden);
+  });
 }
 
 }  // namespace blender::io::alembic
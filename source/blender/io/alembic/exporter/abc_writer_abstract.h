@@ -23,6 +23,7 @@
 #include "abc_hierarchy_iterator.h"
 
 #include <Alembic/Abc/OObject.h>
+#include <functional>
 #include <vector>
 
 #include "DEG_depsgraph_query.h"
@@ -48,11 +49,23 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
   /* Optional writer for custom properties. */
   std::unique_ptr<CustomPropertiesExporter> custom_props_;
 
+ private:
+  /* Alembic writes deferred by the last conversion, see defer_write(). */
+  Vector<WritePipeline::WriteFunc> deferred_writes_;
+
  public:
   explicit ABCAbstractWriter(const ABCWriterConstructorArgs &args);
 
+  /* Schedules the conversion of the current frame on the WritePipeline. */
   virtual void write(HierarchyContext &context) override;
 
+  /* Convert the Blender data of the current frame. Called by the WritePipeline, in parallel
+   * with the conversion of other writers. */
+  void convert(HierarchyContext &context);
+
+  /* Add the Alembic writes deferred by the last conversion to the pipeline. */
+  void add_deferred_writes(WritePipeline &pipeline);
+
   /* Returns true if the data to be written is actually supported. This would, for example, allow a
    * hypothetical camera writer accept a perspective camera but reject an orthogonal one.
    *
@@ -82,8 +95,16 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
   virtual Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() = 0;
 
  protected:
+  /* Convert the Blender data of the current frame, and pass the Alembic writes of the converted
+   * data to defer_write(). This must not access Alembic objects, as other writers may be
+   * converted or written at the same time. */
   virtual void do_write(HierarchyContext &context) = 0;
 
+  /* Write to Alembic once all writers have converted the current frame. The function is called on
+   * the writer thread of the WritePipeline, in the order writes were deferred. It must own the
+   * data it writes, by then the Blender data may be changed or freed. */
+  void defer_write(WritePipeline::WriteFunc write_fn);
+
   virtual void update_bounding_box(Object *object);
 
   /* Return ID properties of whatever ID datablock is written by this writer. Defaults to the
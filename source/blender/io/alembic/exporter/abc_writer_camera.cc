@@ -74,8 +74,8 @@ void ABCCameraWriter::do_write(HierarchyContext &context)
 {
   Camera *cam = static_cast<Camera *>(context.object->data);
 
-  abc_stereo_distance_.set(cam->stereo.convergence_distance);
-  abc_eye_separation_.set(cam->stereo.interocular_distance);
+  const float stereo_distance = cam->stereo.convergence_distance;
+  const float eye_separation = cam->stereo.interocular_distance;
 
   const double apperture_x = cam->sensor_x / 10.0;
   const double apperture_y = cam->sensor_y / 10.0;
@@ -105,7 +105,12 @@ void ABCCameraWriter::do_write(HierarchyContext &context)
   camera_sample.setFStop(cam->dof.aperture_fstop);
 
   camera_sample.setLensSqueezeRatio(1.0);
-  abc_camera_schema_.set(camera_sample);
+
+  defer_write([this, stereo_distance, eye_separation, camera_sample]() mutable {
+    abc_stereo_distance_.set(stereo_distance);
+    abc_eye_separation_.set(eye_separation);
+    abc_camera_schema_.set(camera_sample);
+  });
 }
 
 }  // namespace blender::io::alembic
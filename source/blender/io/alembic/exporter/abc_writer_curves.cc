@@ -161,24 +161,36 @@ void ABCCurveWriter::do_write(HierarchyContext &context)
     vert_counts.push_back(verts.size());
   }
 
-  Alembic::AbcGeom::OFloatGeomParam::Sample width_sample;
-  width_sample.setVals(widths);
-
-  OCurvesSchema::Sample sample(verts,
-                               vert_counts,
-                               curve_type,
-                               periodicity,
-                               width_sample,
-                               OV2fGeomParam::Sample(), /* UVs */
-                               ON3fGeomParam::Sample(), /* normals */
-                               curve_basis,
-                               weights,
-                               orders,
-                               knots);
-
   update_bounding_box(context.object);
-  sample.setSelfBounds(bounding_box_);
-  abc_curve_schema_.set(sample);
+
+  defer_write([this,
+               verts = std::move(verts),
+               vert_counts = std::move(vert_counts),
+               widths = std::move(widths),
+               weights = std::move(weights),
+               knots = std::move(knots),
+               orders = std::move(orders),
+               curve_basis,
+               curve_type,
+               periodicity,
+               bounds = bounding_box_]() {
+    Alembic::AbcGeom::OFloatGeomParam::Sample width_sample;
+    width_sample.setVals(widths);
+
+    OCurvesSchema::Sample sample(verts,
+                                 vert_counts,
+                                 curve_type,
+                                 periodicity,
+                                 width_sample,
+                                 OV2fGeomParam::Sample(), /* UVs */
+                                 ON3fGeomParam::Sample(), /* normals */
+                                 curve_basis,
+                                 weights,
+                                 orders,
+                                 knots);
+    sample.setSelfBounds(bounds);
+    abc_curve_schema_.set(sample);
+  });
 }
 
 ABCCurveMeshWriter::ABCCurveMeshWriter(const ABCWriterConstructorArgs &args)
@@ -99,27 +99,35 @@ void ABCHairWriter::do_write(HierarchyContext &context)
     }
   }
 
-  Alembic::Abc::P3fArraySample iPos(verts);
-  OCurvesSchema::Sample sample(iPos, hvertices);
-  sample.setBasis(Alembic::AbcGeom::kNoBasis);
-  sample.setType(Alembic::AbcGeom::kLinear);
-  sample.setWrap(Alembic::AbcGeom::kNonPeriodic);
-
-  if (!uv_values.empty()) {
-    OV2fGeomParam::Sample uv_smp;
-    uv_smp.setVals(uv_values);
-    sample.setUVs(uv_smp);
-  }
+  update_bounding_box(context.object);
 
-  if (!norm_values.empty()) {
-    ON3fGeomParam::Sample norm_smp;
-    norm_smp.setVals(norm_values);
-    sample.setNormals(norm_smp);
-  }
+  defer_write([this,
+               verts = std::move(verts),
+               hvertices = std::move(hvertices),
+               uv_values = std::move(uv_values),
+               norm_values = std::move(norm_values),
+               bounds = bounding_box_]() {
+    Alembic::Abc::P3fArraySample iPos(verts);
+    OCurvesSchema::Sample sample(iPos, hvertices);
+    sample.setBasis(Alembic::AbcGeom::kNoBasis);
+    sample.setType(Alembic::AbcGeom::kLinear);
+    sample.setWrap(Alembic::AbcGeom::kNonPeriodic);
+
+    if (!uv_values.empty()) {
+      OV2fGeomParam::Sample uv_smp;
+      uv_smp.setVals(uv_values);
+      sample.setUVs(uv_smp);
+    }
 
-  update_bounding_box(context.object);
-  sample.setSelfBounds(bounding_box_);
-  abc_curves_schema_.set(sample);
+    if (!norm_values.empty()) {
+      ON3fGeomParam::Sample norm_smp;
+      norm_smp.setVals(norm_values);
+      sample.setNormals(norm_smp);
+    }
+
+    sample.setSelfBounds(bounds);
+    abc_curves_schema_.set(sample);
+  });
 }
 
 void ABCHairWriter::write_hair_sample(const HierarchyContext &context,
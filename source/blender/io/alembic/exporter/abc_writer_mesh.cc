@@ -83,6 +83,19 @@ static void get_loop_normals(struct Mesh *mesh,
                              std::vector<Imath::V3f> &normals,
                              bool has_flat_shaded_poly);
 
+/* Converted mesh data of one frame, owned by the deferred write of the sample. */
+struct MeshSampleData {
+  std::vector<Imath::V3f> points;
+  std::vector<int32_t> poly_verts, loop_counts;
+  std::vector<Imath::V3f> normals;
+  std::vector<Imath::V3f> velocities;
+  std::vector<int32_t> crease_indices, crease_lengths;
+  std::vector<float> crease_sharpness;
+  UVSample uvs_and_indices;
+  std::string uv_name;
+  Imath::Box3d bounds;
+};
+
 ABCGenericMeshWriter::ABCGenericMeshWriter(const ABCWriterConstructorArgs &args)
     : ABCAbstractWriter(args), is_subd_(false)
 {
@@ -234,119 +247,160 @@ void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
 
 void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
+  std::shared_ptr<MeshSampleData> data = std::make_shared<MeshSampleData>();
   bool has_flat_shaded_poly = false;
 
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_shaded_poly);
+  get_vertices(mesh, data->points);
+  get_topology(mesh, data->poly_verts, data->loop_counts, has_flat_shaded_poly);
 
   if (!frame_has_been_written_ && args_.export_params->face_sets) {
     write_face_sets(context.object, mesh, abc_poly_mesh_schema_);
   }
 
-  OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
-
-  UVSample uvs_and_indices;
-
+  CDWriteFunc write_uv_layers;
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(uvs_and_indices, m_custom_data_config, &mesh->ldata);
-
-    if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
-      OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(uvs_and_indices.uvs));
-      uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
-      uv_sample.setScope(kFacevaryingScope);
-
-      abc_poly_mesh_schema_.setUVSourceName(name);
-      mesh_sample.setUVs(uv_sample);
-    }
-
-    write_custom_data(
-        abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
+    data->uv_name = get_uv_sample(data->uvs_and_indices, m_custom_data_config, &mesh->ldata);
+    write_uv_layers = convert_custom_data(m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
   }
 
   if (args_.export_params->normals) {
-    get_loop_normals(mesh, normals, has_flat_shaded_poly);
-
-    ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
-      normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
-    }
-
-    mesh_sample.setNormals(normals_sample);
+    get_loop_normals(mesh, data->normals, has_flat_shaded_poly);
   }
 
+  CDWriteFunc write_orcos;
   if (args_.export_params->orcos) {
-    write_generated_coordinates(abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config);
+    write_orcos = convert_generated_coordinates(m_custom_data_config);
   }
 
-  if (liquid_sim_modifier_ != nullptr) {
-    get_velocities(mesh, velocities);
-    mesh_sample.setVelocities(V3fArraySample(velocities));
+  const bool write_velocities = liquid_sim_modifier_ != nullptr;
+  if (write_velocities) {
+    get_velocities(mesh, data->velocities);
   }
 
   update_bounding_box(context.object);
-  mesh_sample.setSelfBounds(bounding_box_);
+  data->bounds = bounding_box_;
+
+  defer_write([this, data, write_uv_layers, write_orcos, write_velocities]() {
+    OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
+        V3fArraySample(data->points),
+        Int32ArraySample(data->poly_verts),
+        Int32ArraySample(data->loop_counts));
+
+    if (args_.export_params->uvs) {
+      const UVSample &uvs_and_indices = data->uvs_and_indices;
+
+      if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
+        OV2fGeomParam::Sample uv_sample;
+        uv_sample.setVals(V2fArraySample(uvs_and_indices.uvs));
+        uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
+        uv_sample.setScope(kFacevaryingScope);
+
+        abc_poly_mesh_schema_.setUVSourceName(data->uv_name);
+        mesh_sample.setUVs(uv_sample);
+      }
+
+      OCompoundProperty arb_geom_params = abc_poly_mesh_schema_.getArbGeomParams();
+      if (write_uv_layers) {
+        write_uv_layers(arb_geom_params);
+      }
+    }
+
+    if (args_.export_params->normals) {
+      ON3fGeomParam::Sample normals_sample;
+      if (!data->normals.empty()) {
+        normals_sample.setScope(kFacevaryingScope);
+        normals_sample.setVals(V3fArraySample(data->normals));
+      }
+
+      mesh_sample.setNormals(normals_sample);
+    }
+
+    if (args_.export_params->orcos) {
+      OCompoundProperty arb_geom_params = abc_poly_mesh_schema_.getArbGeomParams();
+      if (write_orcos) {
+        write_orcos(arb_geom_params);
+      }
+    }
+
+    if (write_velocities) {
+      mesh_sample.setVelocities(V3fArraySample(data->velocities));
+    }
+
+    mesh_sample.setSelfBounds(data->bounds);
 
-  abc_poly_mesh_schema_.set(mesh_sample);
+    abc_poly_mesh_schema_.set(mesh_sample);
+  });
 
   write_arb_geo_params(mesh);
 }
 
 void ABCGenericMeshWriter::write_subd(HierarchyContext &context, struct Mesh *mesh)
 {
-  std::vector<float> crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<int32_t> crease_indices, crease_lengths;
+  std::shared_ptr<MeshSampleData> data = std::make_shared<MeshSampleData>();
   bool has_flat_poly = false;
 
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_poly);
-  get_creases(mesh, crease_indices, crease_lengths, crease_sharpness);
+  get_vertices(mesh, data->points);
+  get_topology(mesh, data->poly_verts, data->loop_counts, has_flat_poly);
+  get_creases(mesh, data->crease_indices, data->crease_lengths, data->crease_sharpness);
 
   if (!frame_has_been_written_ && args_.export_params->face_sets) {
     write_face_sets(context.object, mesh, abc_subdiv_schema_);
   }
 
-  OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
-
-  UVSample sample;
+  CDWriteFunc write_uv_layers;
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->ldata);
-
-    if (!sample.indices.empty() && !sample.uvs.empty()) {
-      OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(sample.uvs));
-      uv_sample.setIndices(UInt32ArraySample(sample.indices));
-      uv_sample.setScope(kFacevaryingScope);
-
-      abc_subdiv_schema_.setUVSourceName(name);
-      subdiv_sample.setUVs(uv_sample);
-    }
-
-    write_custom_data(
-        abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
+    data->uv_name = get_uv_sample(data->uvs_and_indices, m_custom_data_config, &mesh->ldata);
+    write_uv_layers = convert_custom_data(m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
   }
 
+  CDWriteFunc write_orcos;
   if (args_.export_params->orcos) {
-    write_generated_coordinates(abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config);
-  }
-
-  if (!crease_indices.empty()) {
-    subdiv_sample.setCreaseIndices(Int32ArraySample(crease_indices));
-    subdiv_sample.setCreaseLengths(Int32ArraySample(crease_lengths));
-    subdiv_sample.setCreaseSharpnesses(FloatArraySample(crease_sharpness));
+    write_orcos = convert_generated_coordinates(m_custom_data_config);
   }
 
   update_bounding_box(context.object);
-  subdiv_sample.setSelfBounds(bounding_box_);
-  abc_subdiv_schema_.set(subdiv_sample);
+  data->bounds = bounding_box_;
+
+  defer_write([this, data, write_uv_layers, write_orcos]() {
+    OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(V3fArraySample(data->points),
+                                                            Int32ArraySample(data->poly_verts),
+                                                            Int32ArraySample(data->loop_counts));
+
+    if (args_.export_params->uvs) {
+      const UVSample &sample = data->uvs_and_indices;
+
+      if (!sample.indices.empty() && !sample.uvs.empty()) {
+        OV2fGeomParam::Sample uv_sample;
+        uv_sample.setVals(V2fArraySample(sample.uvs));
+        uv_sample.setIndices(UInt32ArraySample(sample.indices));
+        uv_sample.setScope(kFacevaryingScope);
+
+        abc_subdiv_schema_.setUVSourceName(data->uv_name);
+        subdiv_sample.setUVs(uv_sample);
+      }
+
+      OCompoundProperty arb_geom_params = abc_subdiv_schema_.getArbGeomParams();
+      if (write_uv_layers) {
+        write_uv_layers(arb_geom_params);
+      }
+    }
+
+    if (args_.export_params->orcos) {
+      OCompoundProperty arb_geom_params = abc_poly_mesh_schema_.getArbGeomParams();
+      if (write_orcos) {
+        write_orcos(arb_geom_params);
+      }
+    }
+
+    if (!data->crease_indices.empty()) {
+      subdiv_sample.setCreaseIndices(Int32ArraySample(data->crease_indices));
+      subdiv_sample.setCreaseLengths(Int32ArraySample(data->crease_lengths));
+      subdiv_sample.setCreaseSharpnesses(FloatArraySample(data->crease_sharpness));
+    }
+
+    subdiv_sample.setSelfBounds(data->bounds);
+    abc_subdiv_schema_.set(subdiv_sample);
+  });
 
   write_arb_geo_params(mesh);
 }
@@ -357,13 +411,15 @@ void ABCGenericMeshWriter::write_face_sets(Object *object, struct Mesh *mesh, Sc
   std::map<std::string, std::vector<int32_t>> geo_groups;
   get_geo_groups(object, mesh, geo_groups);
 
-  std::map<std::string, std::vector<int32_t>>::iterator it;
-  for (it = geo_groups.begin(); it != geo_groups.end(); ++it) {
-    OFaceSet face_set = schema.createFaceSet(it->first);
-    OFaceSetSchema::Sample samp;
-    samp.setFaces(Int32ArraySample(it->second));
-    face_set.getSchema().set(samp);
-  }
+  defer_write([&schema, geo_groups = std::move(geo_groups)]() {
+    std::map<std::string, std::vector<int32_t>>::const_iterator it;
+    for (it = geo_groups.begin(); it != geo_groups.end(); ++it) {
+      OFaceSet face_set = schema.createFaceSet(it->first);
+      OFaceSetSchema::Sample samp;
+      samp.setFaces(Int32ArraySample(it->second));
+      face_set.getSchema().set(samp);
+    }
+  });
 }
 
 void ABCGenericMeshWriter::write_arb_geo_params(struct Mesh *me)
@@ -377,14 +433,20 @@ void ABCGenericMeshWriter::write_arb_geo_params(struct Mesh *me)
     return;
   }
 
-  OCompoundProperty arb_geom_params;
-  if (is_subd_) {
-    arb_geom_params = abc_subdiv_.getSchema().getArbGeomParams();
-  }
-  else {
-    arb_geom_params = abc_poly_mesh_.getSchema().getArbGeomParams();
-  }
-  write_custom_data(arb_geom_params, m_custom_data_config, &me->ldata, CD_MLOOPCOL);
+  CDWriteFunc write_colors = convert_custom_data(m_custom_data_config, &me->ldata, CD_MLOOPCOL);
+
+  defer_write([this, write_colors]() {
+    OCompoundProperty arb_geom_params;
+    if (is_subd_) {
+      arb_geom_params = abc_subdiv_.getSchema().getArbGeomParams();
+    }
+    else {
+      arb_geom_params = abc_poly_mesh_.getSchema().getArbGeomParams();
+    }
+    if (write_colors) {
+      write_colors(arb_geom_params);
+    }
+  });
 }
 
 void ABCGenericMeshWriter::get_velocities(struct Mesh *mesh, std::vector<Imath::V3f> &vels)
@@ -152,41 +152,54 @@ void ABCNurbsWriter::do_write(HierarchyContext &context)
       weights[i] = bp->vec[3];
     }
 
-    ONuPatchSchema::Sample sample;
-    sample.setUOrder(nu->orderu + 1);
-    sample.setVOrder(nu->orderv + 1);
-    sample.setPositions(positions);
-    sample.setPositionWeights(weights);
-    sample.setUKnot(FloatArraySample(knotsU));
-    sample.setVKnot(FloatArraySample(knotsV));
-    sample.setNu(nu->pntsu);
-    sample.setNv(nu->pntsv);
-
-    /* TODO(kevin): to accommodate other software we should duplicate control
-     * points to indicate that a NURBS is cyclic. */
-    OCompoundProperty user_props = abc_nurbs_schemas_[count].getUserProperties();
-
-    if ((nu->flagu & CU_NURB_ENDPOINT) != 0) {
-      OBoolProperty prop(user_props, "endpoint_u");
-      prop.set(true);
-    }
-
-    if ((nu->flagv & CU_NURB_ENDPOINT) != 0) {
-      OBoolProperty prop(user_props, "endpoint_v");
-      prop.set(true);
-    }
-
-    if ((nu->flagu & CU_NURB_CYCLIC) != 0) {
-      OBoolProperty prop(user_props, "cyclic_u");
-      prop.set(true);
-    }
-
-    if ((nu->flagv & CU_NURB_CYCLIC) != 0) {
-      OBoolProperty prop(user_props, "cyclic_v");
-      prop.set(true);
-    }
-
-    abc_nurbs_schemas_[count].set(sample);
+    defer_write([this,
+                 count,
+                 knotsU = std::move(knotsU),
+                 knotsV = std::move(knotsV),
+                 positions = std::move(positions),
+                 weights = std::move(weights),
+                 orderu = nu->orderu,
+                 orderv = nu->orderv,
+                 pntsu = nu->pntsu,
+                 pntsv = nu->pntsv,
+                 flagu = nu->flagu,
+                 flagv = nu->flagv]() {
+      ONuPatchSchema::Sample sample;
+      sample.setUOrder(orderu + 1);
+      sample.setVOrder(orderv + 1);
+      sample.setPositions(positions);
+      sample.setPositionWeights(weights);
+      sample.setUKnot(FloatArraySample(knotsU));
+      sample.setVKnot(FloatArraySample(knotsV));
+      sample.setNu(pntsu);
+      sample.setNv(pntsv);
+
+      /* TODO(kevin): to accommodate other software we should duplicate control
+       * points to indicate that a NURBS is cyclic. */
+      OCompoundProperty user_props = abc_nurbs_schemas_[count].getUserProperties();
+
+      if ((flagu & CU_NURB_ENDPOINT) != 0) {
+        OBoolProperty prop(user_props, "endpoint_u");
+        prop.set(true);
+      }
+
+      if ((flagv & CU_NURB_ENDPOINT) != 0) {
+        OBoolProperty prop(user_props, "endpoint_v");
+        prop.set(true);
+      }
+
+      if ((flagu & CU_NURB_CYCLIC) != 0) {
+        OBoolProperty prop(user_props, "cyclic_u");
+        prop.set(true);
+      }
+
+      if ((flagv & CU_NURB_CYCLIC) != 0) {
+        OBoolProperty prop(user_props, "cyclic_v");
+        prop.set(true);
+      }
+
+      abc_nurbs_schemas_[count].set(sample);
+    });
   }
 }
 
@@ -134,16 +134,24 @@ void ABCPointsWriter::do_write(HierarchyContext &context)
     psys->lattice_deform_data = nullptr;
   }
 
-  Alembic::Abc::P3fArraySample psample(points);
-  Alembic::Abc::UInt64ArraySample idsample(ids);
-  Alembic::Abc::V3fArraySample vsample(velocities);
-  Alembic::Abc::FloatArraySample wsample_array(widths);
-  Alembic::AbcGeom::OFloatGeomParam::Sample wsample(wsample_array, kVertexScope);
-
-  OPointsSchema::Sample sample(psample, idsample, vsample, wsample);
   update_bounding_box(context.object);
-  sample.setSelfBounds(bounding_box_);
-  abc_points_schema_.set(sample);
+
+  defer_write([this,
+               points = std::move(points),
+               velocities = std::move(velocities),
+               widths = std::move(widths),
+               ids = std::move(ids),
+               bounds = bounding_box_]() {
+    Alembic::Abc::P3fArraySample psample(points);
+    Alembic::Abc::UInt64ArraySample idsample(ids);
+    Alembic::Abc::V3fArraySample vsample(velocities);
+    Alembic::Abc::FloatArraySample wsample_array(widths);
+    Alembic::AbcGeom::OFloatGeomParam::Sample wsample(wsample_array, kVertexScope);
+
+    OPointsSchema::Sample sample(psample, idsample, vsample, wsample);
+    sample.setSelfBounds(bounds);
+    abc_points_schema_.set(sample);
+  });
 }
 
 }  // namespace blender::io::alembic
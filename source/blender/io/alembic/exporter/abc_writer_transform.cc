@@ -100,7 +100,7 @@ void ABCTransformWriter::do_write(HierarchyContext &context)
   XformSample xform_sample;
   xform_sample.setMatrix(convert_matrix_datatype(parent_relative_matrix));
   xform_sample.setInheritsXforms(true);
-  abc_xform_schema_.set(xform_sample);
+  defer_write([this, xform_sample]() mutable { abc_xform_schema_.set(xform_sample); });
 
   write_visibility(context);
 }
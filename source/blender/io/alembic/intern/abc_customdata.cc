@@ -152,10 +152,7 @@ const char *get_uv_sample(UVSample &sample, const CDStreamConfig &config, Custom
  * - set scope as face varying
  * - (optional due to its behavior) tag as UV using Alembic::AbcGeom::SetIsUV
  */
-static void write_uv(const OCompoundProperty &prop,
-                     CDStreamConfig &config,
-                     void *data,
-                     const char *name)
+static CDWriteFunc convert_uv(CDStreamConfig &config, void *data, const char *name)
 {
   std::vector<uint32_t> indices;
   std::vector<Imath::V2f> uvs;
@@ -163,31 +160,32 @@ static void write_uv(const OCompoundProperty &prop,
   get_uvs(config, uvs, indices, data);
 
   if (indices.empty() || uvs.empty()) {
-    return;
+    return CDWriteFunc();
   }
 
-  std::string uv_map_name(name);
-  OV2fGeomParam param = config.abc_uv_maps[uv_map_name];
+  return [&config,
+          uv_map_name = std::string(name),
+          uvs = std::move(uvs),
+          indices = std::move(indices)](const OCompoundProperty &prop) {
+    OV2fGeomParam param = config.abc_uv_maps[uv_map_name];
 
-  if (!param.valid()) {
-    param = OV2fGeomParam(prop, name, true, kFacevaryingScope, 1);
-  }
-  OV2fGeomParam::Sample sample(V2fArraySample(&uvs.front(), uvs.size()),
-                               UInt32ArraySample(&indices.front(), indices.size()),
-                               kFacevaryingScope);
-  param.set(sample);
+    if (!param.valid()) {
+      param = OV2fGeomParam(prop, uv_map_name, true, kFacevaryingScope, 1);
+    }
+    OV2fGeomParam::Sample sample(V2fArraySample(&uvs.front(), uvs.size()),
+                                 UInt32ArraySample(&indices.front(), indices.size()),
+                                 kFacevaryingScope);
+    param.set(sample);
 
-  config.abc_uv_maps[uv_map_name] = param;
+    config.abc_uv_maps[uv_map_name] = param;
+  };
 }
 
 /* Convention to write Vertex Colors:
  * - C3fGeomParam/C4fGeomParam on the arbGeomParam
  * - set scope as vertex varying
  */
-static void write_mcol(const OCompoundProperty &prop,
-                       const CDStreamConfig &config,
-                       void *data,
-                       const char *name)
+static CDWriteFunc convert_mcol(const CDStreamConfig &config, void *data, const char *name)
 {
   const float cscale = 1.0f / 255.0f;
   MPoly *polys = config.mpoly;
@@ -221,21 +219,25 @@ static void write_mcol(const OCompoundProperty &prop,
     }
   }
 
-  OC4fGeomParam param(prop, name, true, kFacevaryingScope, 1);
+  return [mcol_name = std::string(name),
+          buffer = std::move(buffer),
+          indices = std::move(indices)](const OCompoundProperty &prop) {
+    OC4fGeomParam param(prop, mcol_name, true, kFacevaryingScope, 1);
 
-  OC4fGeomParam::Sample sample(C4fArraySample(&buffer.front(), buffer.size()),
-                               UInt32ArraySample(&indices.front(), indices.size()),
-                               kVertexScope);
+    OC4fGeomParam::Sample sample(C4fArraySample(&buffer.front(), buffer.size()),
+                                 UInt32ArraySample(&indices.front(), indices.size()),
+                                 kVertexScope);
 
-  param.set(sample);
+    param.set(sample);
+  };
 }
 
-void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &config)
+CDWriteFunc convert_generated_coordinates(CDStreamConfig &config)
 {
   const void *customdata = CustomData_get_layer(&config.mesh->vdata, CD_ORCO);
   if (customdata == nullptr) {
     /* Data not available, so don't even bother creating an Alembic property for it. */
-    return;
+    return CDWriteFunc();
   }
   const float(*orcodata)[3] = static_cast<const float(*)[3]>(customdata);
 
@@ -247,28 +249,28 @@ void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &
     coords[vertex_idx].setValue(orco_yup[0], orco_yup[1], orco_yup[2]);
   }
 
-  if (!config.abc_ocro.valid()) {
-    /* Create the Alembic property and keep a reference so future frames can reuse it. */
-    config.abc_ocro = OV3fGeomParam(prop, propNameOriginalCoordinates, false, kVertexScope, 1);
-  }
+  return [&config, coords = std::move(coords)](const OCompoundProperty &prop) {
+    if (!config.abc_ocro.valid()) {
+      /* Create the Alembic property and keep a reference so future frames can reuse it. */
+      config.abc_ocro = OV3fGeomParam(prop, propNameOriginalCoordinates, false, kVertexScope, 1);
+    }
 
-  OV3fGeomParam::Sample sample(coords, kVertexScope);
-  config.abc_ocro.set(sample);
+    OV3fGeomParam::Sample sample(coords, kVertexScope);
+    config.abc_ocro.set(sample);
+  };
 }
 
-void write_custom_data(const OCompoundProperty &prop,
-                       CDStreamConfig &config,
-                       CustomData *data,
-                       int data_type)
+CDWriteFunc convert_custom_data(CDStreamConfig &config, CustomData *data, int data_type)
 {
   CustomDataType cd_data_type = static_cast<CustomDataType>(data_type);
 
   if (!CustomData_has_layer(data, cd_data_type)) {
-    return;
+    return CDWriteFunc();
   }
 
   const int active_layer = CustomData_get_active_layer(data, cd_data_type);
   const int tot_layers = CustomData_number_of_layers(data, cd_data_type);
+  std::vector<CDWriteFunc> layer_writes;
 
   for (int i = 0; i < tot_layers; i++) {
     void *cd_data = CustomData_get_layer_n(data, cd_data_type, i);
@@ -280,12 +282,20 @@ void write_custom_data(const OCompoundProperty &prop,
         continue;
       }
 
-      write_uv(prop, config, cd_data, name);
+      layer_writes.push_back(convert_uv(config, cd_data, name));
     }
     else if (cd_data_type == CD_MLOOPCOL) {
-      write_mcol(prop, config, cd_data, name);
+      layer_writes.push_back(convert_mcol(config, cd_data, name));
     }
   }
+
+  return [layer_writes = std::move(layer_writes)](const OCompoundProperty &prop) {
+    for (const CDWriteFunc &layer_write : layer_writes) {
+      if (layer_write) {
+        layer_write(prop);
+      }
+    }
+  };
 }
 
 /* ************************************************************************** */
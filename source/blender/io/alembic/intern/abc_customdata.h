@@ -25,6 +25,7 @@
 #include <Alembic/Abc/All.h>
 #include <Alembic/AbcGeom/All.h>
 
+#include <functional>
 #include <map>
 
 struct CustomData;
@@ -106,16 +107,18 @@ struct CDStreamConfig {
  * For now the active layer is used, maybe needs a better way to choose this. */
 const char *get_uv_sample(UVSample &sample, const CDStreamConfig &config, CustomData *data);
 
-void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &config);
+/* Writes converted custom data to an Alembic compound property. It doesn't access Blender data,
+ * so it can be called after the converted mesh is changed or freed. Empty when there is nothing
+ * to write. */
+typedef std::function<void(const OCompoundProperty &prop)> CDWriteFunc;
+
+CDWriteFunc convert_generated_coordinates(CDStreamConfig &config);
 
 void read_generated_coordinates(const ICompoundProperty &prop,
                                 const CDStreamConfig &config,
                                 const Alembic::Abc::ISampleSelector &iss);
 
-void write_custom_data(const OCompoundProperty &prop,
-                       CDStreamConfig &config,
-                       CustomData *data,
-                       int data_type);
+CDWriteFunc convert_custom_data(CDStreamConfig &config, CustomData *data, int data_type);
 
 void read_custom_data(const std::string &iobject_full_name,
                       const ICompoundProperty &prop,
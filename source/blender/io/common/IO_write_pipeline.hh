@@ -0,0 +1,123 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/*
+ * This file contains the WritePipeline, which exporters built on the AbstractHierarchyIterator
+ * can use to convert the Blender data of a frame in parallel, and to write the converted data to
+ * the file on a separate thread while the dependency graph is evaluated for the next frame.
+ *
+ * A frame is exported in these steps:
+ * - While iterating, writers schedule their conversion with add_conversion().
+ * - convert() runs the conversions. Writers that read different Blender data are converted in
+ *   parallel, so conversion must not access the file or library objects of the exporter.
+ * - finish_conversions() visits the converted writers on the calling thread, in the order they
+ *   were added. Here the exporter can create file objects and add writes with add_write().
+ * - submit() passes the writes of the frame to the writer thread, which runs them in order.
+ *
+ * Only one frame is written at a time, which bounds memory use to the converted data of a single
+ * frame. File formats whose libraries are not thread-safe must call wait() before accessing their
+ * objects on another thread than the writer thread.
+ */
+
+#pragma once
+
+#include "IO_abstract_hierarchy_iterator.h"
+
+#include "BLI_function_ref.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace blender::io {
+
+class WritePipeline {
+ public:
+  typedef std::function<void()> WriteFunc;
+  typedef FunctionRef<void(AbstractHierarchyWriter &writer, HierarchyContext &context)>
+      ConversionFunc;
+
+ private:
+  struct Conversion {
+    AbstractHierarchyWriter *writer;
+    HierarchyContext context;
+  };
+
+  /* Conversions of the current frame in the order they were added. */
+  Vector<Conversion> conversions_;
+  /* Indices into conversions_, grouped by the Blender data the writers read. Groups are converted
+   * in parallel, conversions of a group one after the other, because evaluated data is sometimes
+   * computed lazily on first access. */
+  Vector<Vector<int64_t>> conversion_groups_;
+  Map<const void *, int64_t> conversion_group_indices_;
+
+  /* Writes of the current frame that are not submitted yet. */
+  Vector<WriteFunc> frame_writes_;
+
+  bool use_write_thread_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  /* Writes of the submitted frame, only accessed with the mutex locked. */
+  Vector<WriteFunc> thread_writes_;
+  bool is_writing_;
+  bool stop_;
+  /* First exception thrown by a write on the writer thread, rethrown by wait(). */
+  std::exception_ptr write_exception_;
+
+ public:
+  /* Without a writer thread, submit() runs the writes immediately on the calling thread. */
+  explicit WritePipeline(bool use_write_thread = true);
+  ~WritePipeline();
+
+  WritePipeline(const WritePipeline &other) = delete;
+  WritePipeline &operator=(const WritePipeline &other) = delete;
+
+  /* Schedule the conversion of the writer's data for the current frame. The context is copied, as
+   * the hierarchy iterator frees its contexts before conversion. */
+  void add_conversion(AbstractHierarchyWriter *writer, const HierarchyContext &context);
+
+  /* Call the function for all conversions added since the last call to finish_conversions().
+   * When a conversion throws, this waits for the writes in progress before rethrowing. */
+  void convert(ConversionFunc convert_fn);
+
+  /* Call the function for all converted writers in the order they were added, and clear them. */
+  void finish_conversions(ConversionFunc finish_fn);
+
+  /* Add a write of the current frame. The function must only access data it owns and the objects
+   * of the file, as it may run after the Blender data of the frame has been freed. */
+  void add_write(WriteFunc write_fn);
+
+  /* Pass the writes of the current frame to the writer thread. Only call this after wait(). */
+  void submit();
+
+  /* Wait until the writes of all submitted frames are done. Rethrows the first exception thrown by
+   * a write on the writer thread. */
+  void wait();
+
+ private:
+  void wait_until_idle();
+  void thread_main();
+};
+
+}  // namespace blender::io
@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+#include "IO_write_pipeline.hh"
+
+#include "BLI_assert.h"
+#include "BLI_task.hh"
+
+#include "DNA_object_types.h"
+
+namespace blender::io {
+
+WritePipeline::WritePipeline(bool use_write_thread)
+    : use_write_thread_(use_write_thread), is_writing_(false), stop_(false)
+{
+  if (use_write_thread_) {
+    thread_ = std::thread([this]() { thread_main(); });
+  }
+}
+
+WritePipeline::~WritePipeline()
+{
+  if (!use_write_thread_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+void WritePipeline::add_conversion(AbstractHierarchyWriter *writer,
+                                   const HierarchyContext &context)
+{
+  /* Writers of objects that share their data, like the instances of a collection or the particle
+   * systems of an object, read the same evaluated data. */
+  const Object *object = context.object;
+  const void *key = object->data ? object->data : static_cast<const void *>(object);
+
+  const int64_t group_index = conversion_group_indices_.lookup_or_add_cb(key, [&]() {
+    conversion_groups_.append({});
+    return conversion_groups_.size() - 1;
+  });
+  conversion_groups_[group_index].append(conversions_.size());
+  conversions_.append({writer, context});
+}
+
+void WritePipeline::convert(ConversionFunc convert_fn)
+{
+  try {
+    threading::parallel_for(conversion_groups_.index_range(), 1, [&](IndexRange range) {
+      for (const int64_t group_index : range) {
+        for (const int64_t conversion_index : conversion_groups_[group_index]) {
+          Conversion &conversion = conversions_[conversion_index];
+          convert_fn(*conversion.writer, conversion.context);
+        }
+      }
+    });
+  }
+  catch (...) {
+    /* The writes of the previous frame may reference the writers, which the exporter releases
+     * after an error. */
+    wait_until_idle();
+    throw;
+  }
+}
+
+void WritePipeline::finish_conversions(ConversionFunc finish_fn)
+{
+  for (Conversion &conversion : conversions_) {
+    finish_fn(*conversion.writer, conversion.context);
+  }
+
+  conversions_.clear();
+  conversion_groups_.clear();
+  conversion_group_indices_.clear();
+}
+
+void WritePipeline::add_write(WriteFunc write_fn)
+{
+  frame_writes_.append(std::move(write_fn));
+}
+
+void WritePipeline::submit()
+{
+  if (!use_write_thread_) {
+    Vector<WriteFunc> writes = std::move(frame_writes_);
+    frame_writes_.clear();
+    for (const WriteFunc &write_fn : writes) {
+      write_fn();
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BLI_assert(!is_writing_);
+    thread_writes_ = std::move(frame_writes_);
+    is_writing_ = true;
+  }
+  frame_writes_.clear();
+  condition_.notify_all();
+}
+
+void WritePipeline::wait()
+{
+  if (!use_write_thread_) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return !is_writing_; });
+
+  if (write_exception_) {
+    std::exception_ptr exception = write_exception_;
+    write_exception_ = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+
+void WritePipeline::wait_until_idle()
+{
+  if (!use_write_thread_) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return !is_writing_; });
+}
+
+void WritePipeline::thread_main()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    condition_.wait(lock, [this]() { return stop_ || is_writing_; });
+    if (!is_writing_) {
+      return;
+    }
+
+    Vector<WriteFunc> writes = std::move(thread_writes_);
+    thread_writes_.clear();
+    lock.unlock();
+
+    std::exception_ptr exception;
+    try {
+      for (const WriteFunc &write_fn : writes) {
+        write_fn();
+      }
+    }
+    catch (...) {
+      exception = std::current_exception();
+    }
+    /* Free the converted data of the frame before waking up the main thread. */
+    writes.clear();
+
+    lock.lock();
+    if (exception && !write_exception_) {
+      write_exception_ = exception;
+    }
+    is_writing_ = false;
+    condition_.notify_all();
+  }
+}
+
+}  // namespace blender::io
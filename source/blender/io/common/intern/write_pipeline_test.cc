@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+#include "IO_write_pipeline.hh"
+
+#include "testing/testing.h"
+
+#include "DNA_object_types.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace blender::io {
+
+namespace {
+
+class TestWriter : public AbstractHierarchyWriter {
+ public:
+  int converted_frames = 0;
+
+  void write(HierarchyContext & /*context*/) override
+  {
+  }
+};
+
+}  // namespace
+
+static void test_writes_in_order(const bool use_write_thread)
+{
+  WritePipeline pipeline(use_write_thread);
+  std::vector<int> written;
+
+  for (int frame = 0; frame < 3; frame++) {
+    pipeline.wait();
+    for (int i = 0; i < 100; i++) {
+      pipeline.add_write([&written, frame, i]() { written.push_back(frame * 100 + i); });
+    }
+    pipeline.submit();
+  }
+  pipeline.wait();
+
+  ASSERT_EQ(written.size(), 300);
+  for (int i = 0; i < 300; i++) {
+    EXPECT_EQ(written[i], i);
+  }
+}
+
+TEST(write_pipeline, WritesInOrder)
+{
+  test_writes_in_order(false);
+}
+
+TEST(write_pipeline, WritesInOrderThreaded)
+{
+  test_writes_in_order(true);
+}
+
+TEST(write_pipeline, RethrowsWriteErrors)
+{
+  WritePipeline pipeline;
+  bool later_write_done = false;
+
+  pipeline.add_write([]() { throw std::runtime_error("write error"); });
+  pipeline.add_write([&later_write_done]() { later_write_done = true; });
+  pipeline.submit();
+
+  EXPECT_THROW(pipeline.wait(), std::runtime_error);
+  EXPECT_FALSE(later_write_done);
+
+  /* Errors are only reported once, the next frame can still be submitted. */
+  pipeline.wait();
+  pipeline.add_write([&later_write_done]() { later_write_done = true; });
+  pipeline.submit();
+  pipeline.wait();
+  EXPECT_TRUE(later_write_done);
+}
+
+TEST(write_pipeline, FinishesConversionsInOrder)
+{
+  WritePipeline pipeline;
+  Object objects[2] = {};
+  int data = 0;
+  /* Two objects share their data, their writers are converted one after the other. */
+  objects[0].data = &data;
+  objects[1].data = &data;
+  Object object_without_data = {};
+
+  TestWriter writers[4];
+  const Object *writer_objects[4] = {&objects[0], &object_without_data, &objects[1], &objects[0]};
+  for (int i = 0; i < 4; i++) {
+    HierarchyContext context = {};
+    context.object = const_cast<Object *>(writer_objects[i]);
+    pipeline.add_conversion(&writers[i], context);
+  }
+
+  pipeline.convert([](AbstractHierarchyWriter &writer, HierarchyContext & /*context*/) {
+    static_cast<TestWriter &>(writer).converted_frames++;
+  });
+
+  std::vector<const AbstractHierarchyWriter *> finished;
+  pipeline.finish_conversions([&](AbstractHierarchyWriter &writer, HierarchyContext &context) {
+    EXPECT_EQ(static_cast<TestWriter &>(writer).converted_frames, 1);
+    EXPECT_EQ(context.object, writer_objects[finished.size()]);
+    finished.push_back(&writer);
+  });
+  ASSERT_EQ(finished.size(), 4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(finished[i], &writers[i]);
+  }
+
+  /* Finished conversions are cleared. */
+  pipeline.convert([](AbstractHierarchyWriter & /*writer*/, HierarchyContext & /*context*/) {
+    FAIL();
+  });
+}
+
+}  // namespace blender::io
@@ -129,34 +129,49 @@ static void export_startjob(void *customdata,
 
   USDHierarchyIterator iter(data->depsgraph, usd_stage, data->params);
 
-  if (data->params.export_animation) {
-    /* Writing the animated frames is not 100% of the work, but it's our best guess. */
-    float progress_per_frame = 1.0f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
-
-    for (float frame = scene->r.sfra; frame <= scene->r.efra; frame++) {
-      if (G.is_break || (stop != nullptr && *stop)) {
-        break;
+  bool write_ok = false;
+  try {
+    if (data->params.export_animation) {
+      /* Writing the animated frames is not 100% of the work, but it's our best guess. */
+      float progress_per_frame = 1.0f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
+
+      for (float frame = scene->r.sfra; frame <= scene->r.efra; frame++) {
+        if (G.is_break || (stop != nullptr && *stop)) {
+          break;
+        }
+
+        /* Update the scene for the next frame to render. */
+        scene->r.cfra = static_cast<int>(frame);
+        scene->r.subframe = frame - scene->r.cfra;
+        BKE_scene_graph_update_for_newframe(data->depsgraph);
+
+        iter.set_export_frame(frame);
+        iter.iterate_and_write();
+
+        *progress += progress_per_frame;
+        *do_update = true;
       }
-
-      /* Update the scene for the next frame to render. */
-      scene->r.cfra = static_cast<int>(frame);
-      scene->r.subframe = frame - scene->r.cfra;
-      BKE_scene_graph_update_for_newframe(data->depsgraph);
-
-      iter.set_export_frame(frame);
+    }
+    else {
+      /* If we're not animating, a single iteration over all objects is enough. */
       iter.iterate_and_write();
-
-      *progress += progress_per_frame;
-      *do_update = true;
     }
+
+    iter.wait_for_writes();
+    write_ok = true;
   }
-  else {
-    /* If we're not animating, a single iteration over all objects is enough. */
-    iter.iterate_and_write();
+  catch (const std::exception &ex) {
+    WM_reportf(RPT_ERROR, "USD Export: error writing %s: %s", data->filename, ex.what());
+  }
+  catch (...) {
+    /* Unknown exception class, so we cannot include its message. */
+    WM_reportf(RPT_ERROR, "USD Export: unknown error writing %s", data->filename);
   }
 
   iter.release_writers();
-  usd_stage->GetRootLayer()->Save();
+  if (write_ok) {
+    usd_stage->GetRootLayer()->Save();
+  }
 
   /* Finish up by going back to the keyframe that was current before we started. */
   if (CFRA != orig_frame) {
@@ -164,7 +179,7 @@ static void export_startjob(void *customdata,
     BKE_scene_graph_update_for_newframe(data->depsgraph);
   }
 
-  data->export_ok = true;
+  data->export_ok = write_ok;
   *progress = 1.0f;
   *do_update = true;
 }
@@ -25,6 +25,10 @@
 
 struct Depsgraph;
 
+namespace blender::io {
+class WritePipeline;
+}
+
 namespace blender::io::usd {
 
 class USDHierarchyIterator;
@@ -35,6 +39,7 @@ struct USDExporterContext {
   const pxr::SdfPath usd_path;
   const USDHierarchyIterator *hierarchy_iterator;
   const USDExportParams &export_params;
+  WritePipeline *write_pipeline;
 };
 
 }  // namespace blender::io::usd
@@ -47,10 +47,39 @@ namespace blender::io::usd {
 USDHierarchyIterator::USDHierarchyIterator(Depsgraph *depsgraph,
                                            pxr::UsdStageRefPtr stage,
                                            const USDExportParams &params)
-    : AbstractHierarchyIterator(depsgraph), stage_(stage), params_(params)
+    : AbstractHierarchyIterator(depsgraph),
+      stage_(stage),
+      params_(params),
+      write_pipeline_(std::make_unique<WritePipeline>(params.use_write_thread))
 {
 }
 
+void USDHierarchyIterator::iterate_and_write()
+{
+  /* The writers only schedule their conversions while iterating, the prims are written after
+   * all writers of the frame are known. */
+  AbstractHierarchyIterator::iterate_and_write();
+
+  write_pipeline_->convert([](AbstractHierarchyWriter &writer, HierarchyContext &context) {
+    static_cast<USDAbstractWriter &>(writer).convert(context);
+  });
+
+  /* The converted data doesn't reference the stage, so it can be converted while the writer
+   * thread is still writing the previous frame. The stage is not safe for concurrent authoring
+   * though, so the prims are only authored once those writes are done. */
+  write_pipeline_->wait();
+  write_pipeline_->finish_conversions(
+      [](AbstractHierarchyWriter &writer, HierarchyContext &context) {
+        static_cast<USDAbstractWriter &>(writer).write_converted(context);
+      });
+  write_pipeline_->submit();
+}
+
+void USDHierarchyIterator::wait_for_writes()
+{
+  write_pipeline_->wait();
+}
+
 bool USDHierarchyIterator::mark_as_weak_export(const Object *object) const
 {
   if (params_.selected_objects_only && (object->base_flag & BASE_SELECTED) == 0) {
@@ -82,7 +111,12 @@ const pxr::UsdTimeCode &USDHierarchyIterator::get_export_time_code() const
 
 USDExporterContext USDHierarchyIterator::create_usd_export_context(const HierarchyContext *context)
 {
-  return USDExporterContext{depsgraph_, stage_, pxr::SdfPath(context->export_path), this, params_};
+  return USDExporterContext{depsgraph_,
+                            stage_,
+                            pxr::SdfPath(context->export_path),
+                            this,
+                            params_,
+                            write_pipeline_.get()};
 }
 
 AbstractHierarchyWriter *USDHierarchyIterator::create_transform_writer(
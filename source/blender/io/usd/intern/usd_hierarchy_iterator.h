@@ -19,9 +19,11 @@
 #pragma once
 
 #include "IO_abstract_hierarchy_iterator.h"
+#include "IO_write_pipeline.hh"
 #include "usd.h"
 #include "usd_exporter_context.h"
 
+#include <memory>
 #include <string>
 
 #include <pxr/usd/usd/common.h>
@@ -35,18 +37,26 @@ namespace blender::io::usd {
 using blender::io::AbstractHierarchyIterator;
 using blender::io::AbstractHierarchyWriter;
 using blender::io::HierarchyContext;
+using blender::io::WritePipeline;
 
 class USDHierarchyIterator : public AbstractHierarchyIterator {
  private:
   const pxr::UsdStageRefPtr stage_;
   pxr::UsdTimeCode export_time_;
   const USDExportParams &params_;
+  std::unique_ptr<WritePipeline> write_pipeline_;
 
  public:
   USDHierarchyIterator(Depsgraph *depsgraph,
                        pxr::UsdStageRefPtr stage,
                        const USDExportParams &params);
 
+  virtual void iterate_and_write() override;
+
+  /* Wait until all time samples have been written to the stage. Call this before releasing the
+   * writers or saving the stage. */
+  void wait_for_writes();
+
   void set_export_frame(float frame_nr);
   const pxr::UsdTimeCode &get_export_time_code() const;
 
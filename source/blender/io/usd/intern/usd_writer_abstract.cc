@@ -19,6 +19,8 @@
 #include "usd_writer_abstract.h"
 #include "usd_hierarchy_iterator.h"
 
+#include "IO_write_pipeline.hh"
+
 #include <pxr/base/tf/stringUtils.h>
 
 #include "BLI_assert.h"
@@ -68,11 +70,45 @@ void USDAbstractWriter::write(HierarchyContext &context)
     return;
   }
 
+  /* The data is converted and written by the pipeline once all writers of the frame are known,
+   * so that conversions can run in parallel. */
+  usd_export_context_.write_pipeline->add_conversion(this, context);
+}
+
+void USDAbstractWriter::convert(HierarchyContext &context)
+{
+  do_convert(context);
+}
+
+void USDAbstractWriter::write_converted(HierarchyContext &context)
+{
   do_write(context);
 
   frame_has_been_written_ = true;
 }
 
+void USDAbstractWriter::do_convert(HierarchyContext & /*context*/)
+{
+}
+
+void USDAbstractWriter::write_sample(const pxr::UsdAttribute &attr,
+                                     const pxr::VtValue &value,
+                                     const pxr::UsdTimeCode timecode)
+{
+  usd_export_context_.write_pipeline->add_write(
+      [attr, value, timecode]() { attr.Set(value, timecode); });
+}
+
+void USDAbstractWriter::write_sparse_sample(const pxr::UsdAttribute &attr,
+                                            const pxr::VtValue &value,
+                                            const pxr::UsdTimeCode timecode)
+{
+  /* Writers are only released after all writes have finished. */
+  usd_export_context_.write_pipeline->add_write([this, attr, value, timecode]() {
+    usd_value_writer_.SetAttribute(attr, value, timecode);
+  });
+}
+
 const pxr::SdfPath &USDAbstractWriter::usd_path() const
 {
   return usd_export_context_.usd_path;
@@ -118,7 +154,7 @@ void USDAbstractWriter::write_visibility(const HierarchyContext &context,
   const pxr::TfToken visibility = is_visible ? pxr::UsdGeomTokens->inherited :
                                                pxr::UsdGeomTokens->invisible;
 
-  usd_value_writer_.SetAttribute(attr_visibility, pxr::VtValue(visibility), timecode);
+  write_sparse_sample(attr_visibility, pxr::VtValue(visibility), timecode);
 }
 
 /* Reference the original data instead of writing a copy. */
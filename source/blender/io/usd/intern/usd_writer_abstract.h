@@ -63,10 +63,30 @@ class USDAbstractWriter : public AbstractHierarchyWriter {
 
   const pxr::SdfPath &usd_path() const;
 
+  /* Called by the #USDHierarchyIterator through its #WritePipeline, see write(). */
+  void convert(HierarchyContext &context);
+  void write_converted(HierarchyContext &context);
+
  protected:
+  /* Convert the evaluated Blender data into USD data owned by the writer. This is called in
+   * parallel with the conversions of other writers, so it must not access the USD stage. */
+  virtual void do_convert(HierarchyContext &context);
+  /* Author the prim on the USD stage, using the data converted by do_convert(). Time samples are
+   * written with write_sample() or write_sparse_sample(). */
   virtual void do_write(HierarchyContext &context) = 0;
   pxr::UsdTimeCode get_export_time_code() const;
 
+  /* Set a time sample of the attribute. This may happen after the Blender data of the frame has
+   * been freed, so the value must not reference it. */
+  void write_sample(const pxr::UsdAttribute &attr,
+                    const pxr::VtValue &value,
+                    const pxr::UsdTimeCode timecode);
+  /* Same as write_sample(), but through the sparse value writer, which skips values that are
+   * equal to the previous sample. */
+  void write_sparse_sample(const pxr::UsdAttribute &attr,
+                           const pxr::VtValue &value,
+                           const pxr::UsdTimeCode timecode);
+
   pxr::UsdShadeMaterial ensure_usd_material(Material *material);
 
   void write_visibility(const HierarchyContext &context,
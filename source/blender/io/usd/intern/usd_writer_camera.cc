@@ -81,28 +81,33 @@ void USDCameraWriter::do_write(HierarchyContext &context)
    * they decided world units might be centimeters. Quite confusing, as the USD Viewer shows the
    * correct FoV when we write millimeters and not "tenths of world units".
    */
-  usd_camera.CreateFocalLengthAttr().Set(camera->lens, timecode);
+  write_sample(usd_camera.CreateFocalLengthAttr(), pxr::VtValue(camera->lens), timecode);
 
   float aperture_x, aperture_y;
   camera_sensor_size_for_render(camera, &scene->r, &aperture_x, &aperture_y);
 
   float film_aspect = aperture_x / aperture_y;
-  usd_camera.CreateHorizontalApertureAttr().Set(aperture_x, timecode);
-  usd_camera.CreateVerticalApertureAttr().Set(aperture_y, timecode);
-  usd_camera.CreateHorizontalApertureOffsetAttr().Set(aperture_x * camera->shiftx, timecode);
-  usd_camera.CreateVerticalApertureOffsetAttr().Set(aperture_y * camera->shifty * film_aspect,
-                                                    timecode);
-
-  usd_camera.CreateClippingRangeAttr().Set(
-      pxr::VtValue(pxr::GfVec2f(camera->clip_start, camera->clip_end)), timecode);
+  write_sample(usd_camera.CreateHorizontalApertureAttr(), pxr::VtValue(aperture_x), timecode);
+  write_sample(usd_camera.CreateVerticalApertureAttr(), pxr::VtValue(aperture_y), timecode);
+  write_sample(usd_camera.CreateHorizontalApertureOffsetAttr(),
+               pxr::VtValue(aperture_x * camera->shiftx),
+               timecode);
+  write_sample(usd_camera.CreateVerticalApertureOffsetAttr(),
+               pxr::VtValue(aperture_y * camera->shifty * film_aspect),
+               timecode);
+
+  write_sample(usd_camera.CreateClippingRangeAttr(),
+               pxr::VtValue(pxr::GfVec2f(camera->clip_start, camera->clip_end)),
+               timecode);
 
   /* Write DoF-related attributes. */
   if (camera->dof.flag & CAM_DOF_ENABLED) {
-    usd_camera.CreateFStopAttr().Set(camera->dof.aperture_fstop, timecode);
+    write_sample(
+        usd_camera.CreateFStopAttr(), pxr::VtValue(camera->dof.aperture_fstop), timecode);
 
     float focus_distance = scene->unit.scale_length *
                            BKE_camera_object_dof_distance(context.object);
-    usd_camera.CreateFocusDistanceAttr().Set(focus_distance, timecode);
+    write_sample(usd_camera.CreateFocusDistanceAttr(), pxr::VtValue(focus_distance), timecode);
   }
 }
 
@@ -24,19 +24,61 @@
 
 #include "BKE_particle.h"
 
+#include "BLI_array.hh"
+#include "BLI_task.hh"
+
 #include "DNA_particle_types.h"
 
 namespace blender::io::usd {
 
-USDHairWriter::USDHairWriter(const USDExporterContext &ctx) : USDAbstractWriter(ctx)
+USDHairWriter::USDHairWriter(const USDExporterContext &ctx)
+    : USDAbstractWriter(ctx), has_curves_(false)
 {
 }
 
-void USDHairWriter::do_write(HierarchyContext &context)
+void USDHairWriter::do_convert(HierarchyContext &context)
 {
   ParticleSystem *psys = context.particle_system;
   ParticleCacheKey **cache = psys->pathcache;
-  if (cache == nullptr) {
+  has_curves_ = cache != nullptr;
+  if (!has_curves_) {
+    return;
+  }
+
+  /* Count the points first, so the strands can be copied in parallel. New arrays are allocated,
+   * as the previous ones may still be shared with time samples that are being written. */
+  Array<int> strand_offsets(psys->totpart);
+  curve_point_counts_ = pxr::VtIntArray(psys->totpart);
+  int *curve_point_counts = curve_point_counts_.data();
+  int totpoint = 0;
+  for (int strand_index = 0; strand_index < psys->totpart; ++strand_index) {
+    const int point_count = cache[strand_index]->segments + 1;
+    curve_point_counts[strand_index] = point_count;
+    strand_offsets[strand_index] = totpoint;
+    totpoint += point_count;
+  }
+
+  points_ = pxr::VtArray<pxr::GfVec3f>(totpoint);
+  pxr::GfVec3f *points = points_.data();
+  threading::parallel_for(IndexRange(psys->totpart), 256, [&](IndexRange range) {
+    for (const int strand_index : range) {
+      const ParticleCacheKey *strand = cache[strand_index];
+      pxr::GfVec3f *strand_points = points + strand_offsets[strand_index];
+      for (int point_index = 0; point_index < curve_point_counts[strand_index]; ++point_index) {
+        strand_points[point_index] = pxr::GfVec3f(strand[point_index].co);
+      }
+    }
+  });
+
+  colors_ = pxr::VtArray<pxr::GfVec3f>();
+  if (psys->totpart > 0) {
+    colors_.push_back(pxr::GfVec3f(cache[0]->col));
+  }
+}
+
+void USDHairWriter::do_write(HierarchyContext & /*context*/)
+{
+  if (!has_curves_) {
     return;
   }
 
@@ -48,35 +90,17 @@ void USDHairWriter::do_write(HierarchyContext &context)
   curves.CreateBasisAttr(pxr::VtValue(pxr::UsdGeomTokens->bspline));
   curves.CreateTypeAttr(pxr::VtValue(pxr::UsdGeomTokens->cubic));
 
-  pxr::VtArray<pxr::GfVec3f> points;
-  pxr::VtIntArray curve_point_counts;
-  curve_point_counts.reserve(psys->totpart);
-
-  ParticleCacheKey *strand;
-  for (int strand_index = 0; strand_index < psys->totpart; ++strand_index) {
-    strand = cache[strand_index];
-
-    int point_count = strand->segments + 1;
-    curve_point_counts.push_back(point_count);
-
-    for (int point_index = 0; point_index < point_count; ++point_index, ++strand) {
-      points.push_back(pxr::GfVec3f(strand->co));
-    }
-  }
-
   pxr::UsdAttribute attr_points = curves.CreatePointsAttr(pxr::VtValue(), true);
   pxr::UsdAttribute attr_vertex_counts = curves.CreateCurveVertexCountsAttr(pxr::VtValue(), true);
   if (!attr_points.HasValue()) {
-    attr_points.Set(points, pxr::UsdTimeCode::Default());
-    attr_vertex_counts.Set(curve_point_counts, pxr::UsdTimeCode::Default());
+    attr_points.Set(points_, pxr::UsdTimeCode::Default());
+    attr_vertex_counts.Set(curve_point_counts_, pxr::UsdTimeCode::Default());
   }
-  usd_value_writer_.SetAttribute(attr_points, pxr::VtValue(points), timecode);
-  usd_value_writer_.SetAttribute(attr_vertex_counts, pxr::VtValue(curve_point_counts), timecode);
+  write_sparse_sample(attr_points, pxr::VtValue(points_), timecode);
+  write_sparse_sample(attr_vertex_counts, pxr::VtValue(curve_point_counts_), timecode);
 
-  if (psys->totpart > 0) {
-    pxr::VtArray<pxr::GfVec3f> colors;
-    colors.push_back(pxr::GfVec3f(cache[0]->col));
-    curves.CreateDisplayColorAttr(pxr::VtValue(colors));
+  if (!colors_.empty()) {
+    curves.CreateDisplayColorAttr(pxr::VtValue(colors_));
   }
 }
 
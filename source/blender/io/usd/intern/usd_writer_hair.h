@@ -20,14 +20,25 @@
 
 #include "usd_writer_abstract.h"
 
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/vt/array.h>
+
 namespace blender::io::usd {
 
 /* Writer for writing hair particle data as USD curves. */
 class USDHairWriter : public USDAbstractWriter {
+ private:
+  /* Data converted by do_convert(). */
+  bool has_curves_;
+  pxr::VtArray<pxr::GfVec3f> points_;
+  pxr::VtIntArray curve_point_counts_;
+  pxr::VtArray<pxr::GfVec3f> colors_;
+
  public:
   USDHairWriter(const USDExporterContext &ctx);
 
  protected:
+  virtual void do_convert(HierarchyContext &context) override;
   virtual void do_write(HierarchyContext &context) override;
   virtual bool check_is_animated(const HierarchyContext &context) const override;
 };
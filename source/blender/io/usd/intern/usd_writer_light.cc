@@ -57,21 +57,21 @@ void USDLightWriter::do_write(HierarchyContext &context)
         case LA_AREA_DISK:
         case LA_AREA_ELLIPSE: { /* An ellipse light will deteriorate into a disk light. */
           pxr::UsdLuxDiskLight disk_light = pxr::UsdLuxDiskLight::Define(stage, usd_path);
-          disk_light.CreateRadiusAttr().Set(light->area_size, timecode);
+          write_sample(disk_light.CreateRadiusAttr(), pxr::VtValue(light->area_size), timecode);
           usd_light = disk_light;
           break;
         }
         case LA_AREA_RECT: {
           pxr::UsdLuxRectLight rect_light = pxr::UsdLuxRectLight::Define(stage, usd_path);
-          rect_light.CreateWidthAttr().Set(light->area_size, timecode);
-          rect_light.CreateHeightAttr().Set(light->area_sizey, timecode);
+          write_sample(rect_light.CreateWidthAttr(), pxr::VtValue(light->area_size), timecode);
+          write_sample(rect_light.CreateHeightAttr(), pxr::VtValue(light->area_sizey), timecode);
           usd_light = rect_light;
           break;
         }
         case LA_AREA_SQUARE: {
           pxr::UsdLuxRectLight rect_light = pxr::UsdLuxRectLight::Define(stage, usd_path);
-          rect_light.CreateWidthAttr().Set(light->area_size, timecode);
-          rect_light.CreateHeightAttr().Set(light->area_size, timecode);
+          write_sample(rect_light.CreateWidthAttr(), pxr::VtValue(light->area_size), timecode);
+          write_sample(rect_light.CreateHeightAttr(), pxr::VtValue(light->area_size), timecode);
           usd_light = rect_light;
           break;
         }
@@ -79,7 +79,7 @@ void USDLightWriter::do_write(HierarchyContext &context)
       break;
     case LA_LOCAL: {
       pxr::UsdLuxSphereLight sphere_light = pxr::UsdLuxSphereLight::Define(stage, usd_path);
-      sphere_light.CreateRadiusAttr().Set(light->area_size, timecode);
+      write_sample(sphere_light.CreateRadiusAttr(), pxr::VtValue(light->area_size), timecode);
       usd_light = sphere_light;
       break;
     }
@@ -101,10 +101,12 @@ void USDLightWriter::do_write(HierarchyContext &context)
   else {
     usd_intensity = light->energy / 100.0f;
   }
-  usd_light.CreateIntensityAttr().Set(usd_intensity, timecode);
+  write_sample(usd_light.CreateIntensityAttr(), pxr::VtValue(usd_intensity), timecode);
 
-  usd_light.CreateColorAttr().Set(pxr::GfVec3f(light->r, light->g, light->b), timecode);
-  usd_light.CreateSpecularAttr().Set(light->spec_fac, timecode);
+  write_sample(usd_light.CreateColorAttr(),
+               pxr::VtValue(pxr::GfVec3f(light->r, light->g, light->b)),
+               timecode);
+  write_sample(usd_light.CreateSpecularAttr(), pxr::VtValue(light->spec_fac), timecode);
 }
 
 }  // namespace blender::io::usd
@@ -23,8 +23,11 @@
 #include <pxr/usd/usdShade/material.h>
 #include <pxr/usd/usdShade/materialBindingAPI.h>
 
+#include "BLI_array.hh"
 #include "BLI_assert.h"
 #include "BLI_math_vector.h"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "BKE_customdata.h"
 #include "BKE_lib_id.h"
@@ -58,7 +61,39 @@ bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
   return true;
 }
 
-void USDGenericMeshWriter::do_write(HierarchyContext &context)
+struct USDMeshData {
+  pxr::VtArray<pxr::GfVec3f> points;
+  pxr::VtIntArray face_vertex_counts;
+  pxr::VtIntArray face_indices;
+  std::map<short, pxr::VtIntArray> face_groups;
+
+  /* The length of this array specifies the number of creases on the surface. Each element gives
+   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
+   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
+   * element of this array should be greater than one. */
+  pxr::VtIntArray crease_lengths;
+  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
+   * sum of all elements of the 'creaseLengths' attribute. */
+  pxr::VtIntArray crease_vertex_indices;
+  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
+   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
+   * the number of elements in this array will be either 'len(creaseLengths)' or the sum over all X
+   * of '(creaseLengths[X] - 1)'. Note that while the RI spec allows each crease to have either a
+   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
+   * a mesh, or sharpness's for all edges making up the creases on a mesh. */
+  pxr::VtFloatArray crease_sharpnesses;
+
+  /* Primvar name and coordinates of each UV map. Only filled when UV maps are exported. */
+  std::vector<std::pair<pxr::TfToken, pxr::VtArray<pxr::GfVec2f>>> uv_maps;
+  /* Face-varying normals, only filled when normals are exported. */
+  pxr::VtVec3fArray loop_normals;
+  /* Per-vertex velocities of fluid simulation meshes, empty for other meshes. */
+  pxr::VtVec3fArray velocities;
+};
+
+USDGenericMeshWriter::~USDGenericMeshWriter() = default;
+
+void USDGenericMeshWriter::do_convert(HierarchyContext &context)
 {
   Object *object_eval = context.object;
   bool needsfree = false;
@@ -69,7 +104,8 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
   }
 
   try {
-    write_mesh(context, mesh);
+    mesh_data_ = std::make_unique<USDMeshData>();
+    get_mesh_data(context, mesh, *mesh_data_);
 
     if (needsfree) {
       free_export_mesh(mesh);
@@ -83,38 +119,106 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
   }
 }
 
+void USDGenericMeshWriter::do_write(HierarchyContext &context)
+{
+  if (!mesh_data_) {
+    return;
+  }
+
+  /* The arrays are shared with the time samples, so they can be released right away. */
+  std::unique_ptr<USDMeshData> usd_mesh_data = std::move(mesh_data_);
+  write_mesh(context, *usd_mesh_data);
+}
+
 void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
 {
   BKE_id_free(nullptr, mesh);
 }
 
-struct USDMeshData {
-  pxr::VtArray<pxr::GfVec3f> points;
-  pxr::VtIntArray face_vertex_counts;
-  pxr::VtIntArray face_indices;
-  std::map<short, pxr::VtIntArray> face_groups;
+/* Start of the face-varying data of each polygon, in the order polygons are written. */
+static Array<int> get_poly_offsets(const Mesh *mesh)
+{
+  Array<int> poly_offsets(mesh->totpoly);
+  int offset = 0;
+  for (int i = 0; i < mesh->totpoly; i++) {
+    poly_offsets[i] = offset;
+    offset += mesh->mpoly[i].totloop;
+  }
+  return poly_offsets;
+}
 
-  /* The length of this array specifies the number of creases on the surface. Each element gives
-   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
-   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
-   * element of this array should be greater than one. */
-  pxr::VtIntArray crease_lengths;
-  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
-   * sum of all elements of the 'creaseLengths' attribute. */
-  pxr::VtIntArray crease_vertex_indices;
-  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
-   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
-   * the number of elements in this array will be either 'len(creaseLengths)' or the sum over all X
-   * of '(creaseLengths[X] - 1)'. Note that while the RI spec allows each crease to have either a
-   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
-   * a mesh, or sharpness's for all edges making up the creases on a mesh. */
-  pxr::VtFloatArray crease_sharpnesses;
-};
+static void get_vertices(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  usd_mesh_data.points.resize(mesh->totvert);
 
-void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+  const MVert *verts = mesh->mvert;
+  /* Non-const access to a #VtArray checks for sharing on every call, so fill the buffer. */
+  pxr::GfVec3f *points = usd_mesh_data.points.data();
+  threading::parallel_for(IndexRange(mesh->totvert), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      points[i] = pxr::GfVec3f(verts[i].co);
+    }
+  });
+}
+
+static void get_loops_polys(const Mesh *mesh, Span<int> poly_offsets, USDMeshData &usd_mesh_data)
 {
-  pxr::UsdTimeCode timecode = get_export_time_code();
+  const int totpoly = mesh->totpoly;
+  const int totindex = totpoly == 0 ? 0 : poly_offsets.last() + mesh->mpoly[totpoly - 1].totloop;
+  usd_mesh_data.face_vertex_counts.resize(totpoly);
+  usd_mesh_data.face_indices.resize(totindex);
+
+  const MLoop *mloop = mesh->mloop;
+  const MPoly *mpoly = mesh->mpoly;
+  int *face_vertex_counts = usd_mesh_data.face_vertex_counts.data();
+  int *face_indices = usd_mesh_data.face_indices.data();
+  threading::parallel_for(IndexRange(totpoly), 1024, [&](IndexRange range) {
+    for (const int i : range) {
+      const MPoly &poly = mpoly[i];
+      const MLoop *loop = mloop + poly.loopstart;
+      int *poly_indices = face_indices + poly_offsets[i];
+      face_vertex_counts[i] = poly.totloop;
+      for (int j = 0; j < poly.totloop; ++j) {
+        poly_indices[j] = loop[j].v;
+      }
+    }
+  });
+
+  /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
+   * assignments. */
+  if (mesh->totcol > 1) {
+    for (int i = 0; i < totpoly; ++i) {
+      usd_mesh_data.face_groups[mpoly[i].mat_nr].push_back(i);
+    }
+  }
+}
+static void get_creases(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  const float factor = 1.0f / 255.0f;
+
+  MEdge *edge = mesh->medge;
+  float sharpness;
+  for (int edge_idx = 0, totedge = mesh->totedge; edge_idx < totedge; ++edge_idx, ++edge) {
+    if (edge->crease == 0) {
+      continue;
+    }
+
+    if (edge->crease == 255) {
+      sharpness = pxr::UsdGeomMesh::SHARPNESS_INFINITE;
+    }
+    else {
+      sharpness = static_cast<float>(edge->crease) * factor;
+    }
 
+    usd_mesh_data.crease_vertex_indices.push_back(edge->v1);
+    usd_mesh_data.crease_vertex_indices.push_back(edge->v2);
+    usd_mesh_data.crease_lengths.push_back(2);
+    usd_mesh_data.crease_sharpnesses.push_back(sharpness);
+  }
+}
+
+static void get_uv_maps(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
   const CustomData *ldata = &mesh->ldata;
   for (int layer_idx = 0; layer_idx < ldata->totlayer; layer_idx++) {
     const CustomDataLayer *layer = &ldata->layers[layer_idx];
@@ -127,24 +231,152 @@ void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_
      * for texture coordinates by naming the UV Map as such, without having to guess which UV Map
      * is the "standard" one. */
     pxr::TfToken primvar_name(pxr::TfMakeValidIdentifier(layer->name));
-    pxr::UsdGeomPrimvar uv_coords_primvar = usd_mesh.CreatePrimvar(
-        primvar_name, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->faceVarying);
 
-    MLoopUV *mloopuv = static_cast<MLoopUV *>(layer->data);
-    pxr::VtArray<pxr::GfVec2f> uv_coords;
-    for (int loop_idx = 0; loop_idx < mesh->totloop; loop_idx++) {
-      uv_coords.push_back(pxr::GfVec2f(mloopuv[loop_idx].uv));
+    const MLoopUV *mloopuv = static_cast<const MLoopUV *>(layer->data);
+    pxr::VtArray<pxr::GfVec2f> uv_coords(mesh->totloop);
+    pxr::GfVec2f *uvs = uv_coords.data();
+    threading::parallel_for(IndexRange(mesh->totloop), 4096, [&](IndexRange range) {
+      for (const int loop_idx : range) {
+        uvs[loop_idx] = pxr::GfVec2f(mloopuv[loop_idx].uv);
+      }
+    });
+
+    usd_mesh_data.uv_maps.emplace_back(primvar_name, std::move(uv_coords));
+  }
+}
+
+static void get_loop_normals(const Mesh *mesh, Span<int> poly_offsets, USDMeshData &usd_mesh_data)
+{
+  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
+
+  pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
+
+  if (lnors != nullptr) {
+    /* Export custom loop normals. */
+    static_assert(sizeof(pxr::GfVec3f) == sizeof(float[3]));
+    loop_normals.resize(mesh->totloop);
+    memcpy(loop_normals.data(), lnors, sizeof(float[3]) * mesh->totloop);
+    return;
+  }
+
+  /* Compute the loop normals based on the 'smooth' flag. */
+  const int totpoly = mesh->totpoly;
+  loop_normals.resize(totpoly == 0 ? 0 : poly_offsets.last() + mesh->mpoly[totpoly - 1].totloop);
+
+  const MPoly *mpoly = mesh->mpoly;
+  const MVert *mvert = mesh->mvert;
+  pxr::GfVec3f *normals = loop_normals.data();
+  threading::parallel_for(IndexRange(totpoly), 1024, [&](IndexRange range) {
+    float normal[3];
+    for (const int poly_idx : range) {
+      const MPoly *poly = &mpoly[poly_idx];
+      const MLoop *mloop = mesh->mloop + poly->loopstart;
+      pxr::GfVec3f *poly_normals = normals + poly_offsets[poly_idx];
+
+      if ((poly->flag & ME_SMOOTH) == 0) {
+        /* Flat shaded, use common normal for all verts. */
+        BKE_mesh_calc_poly_normal(poly, mloop, mvert, normal);
+        pxr::GfVec3f pxr_normal(normal);
+        for (int loop_idx = 0; loop_idx < poly->totloop; ++loop_idx) {
+          poly_normals[loop_idx] = pxr_normal;
+        }
+      }
+      else {
+        /* Smooth shaded, use individual vert normals. */
+        for (int loop_idx = 0; loop_idx < poly->totloop; ++loop_idx, ++mloop) {
+          normal_short_to_float_v3(normal, mvert[mloop->v].no);
+          poly_normals[loop_idx] = pxr::GfVec3f(normal);
+        }
+      }
+    }
+  });
+}
+
+void USDGenericMeshWriter::get_surface_velocity(Object *object,
+                                                const Mesh *mesh,
+                                                USDMeshData &usd_mesh_data)
+{
+  /* Only velocities from the fluid simulation are exported. This is the most important case,
+   * though, as the baked mesh changes topology all the time, and thus computing the velocities
+   * at import time in a post-processing step is hard. */
+  ModifierData *md = BKE_modifiers_findby_type(object, eModifierType_Fluidsim);
+  if (md == nullptr) {
+    return;
+  }
+
+  /* Check that the fluid sim modifier is enabled and has useful data. */
+  const bool use_render = (DEG_get_mode(usd_export_context_.depsgraph) == DAG_EVAL_RENDER);
+  const ModifierMode required_mode = use_render ? eModifierMode_Render : eModifierMode_Realtime;
+  const Scene *scene = DEG_get_evaluated_scene(usd_export_context_.depsgraph);
+  if (!BKE_modifier_is_enabled(scene, md, required_mode)) {
+    return;
+  }
+  FluidsimModifierData *fsmd = reinterpret_cast<FluidsimModifierData *>(md);
+  if (!fsmd->fss || fsmd->fss->type != OB_FLUIDSIM_DOMAIN) {
+    return;
+  }
+  FluidsimSettings *fss = fsmd->fss;
+  if (!fss->meshVelocities) {
+    return;
+  }
+
+  /* Export per-vertex velocity vectors. */
+  usd_mesh_data.velocities.resize(mesh->totvert);
+
+  const FluidVertexVelocity *mesh_velocities = fss->meshVelocities;
+  pxr::GfVec3f *velocities = usd_mesh_data.velocities.data();
+  threading::parallel_for(IndexRange(mesh->totvert), 4096, [&](IndexRange range) {
+    for (const int vertex_idx : range) {
+      velocities[vertex_idx] = pxr::GfVec3f(mesh_velocities[vertex_idx].vel);
     }
+  });
+}
+
+void USDGenericMeshWriter::get_mesh_data(const HierarchyContext &context,
+                                         const Mesh *mesh,
+                                         USDMeshData &usd_mesh_data)
+{
+  const Array<int> poly_offsets = get_poly_offsets(mesh);
+
+  get_vertices(mesh, usd_mesh_data);
+  get_loops_polys(mesh, poly_offsets, usd_mesh_data);
+  get_creases(mesh, usd_mesh_data);
+
+  if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
+    /* Only the material assignments are written for instances. */
+    return;
+  }
+
+  if (usd_export_context_.export_params.export_uvmaps) {
+    get_uv_maps(mesh, usd_mesh_data);
+  }
+  if (usd_export_context_.export_params.export_normals) {
+    get_loop_normals(mesh, poly_offsets, usd_mesh_data);
+  }
+  get_surface_velocity(context.object, mesh, usd_mesh_data);
+}
+
+void USDGenericMeshWriter::write_uv_maps(const USDMeshData &usd_mesh_data,
+                                         pxr::UsdGeomMesh usd_mesh)
+{
+  pxr::UsdTimeCode timecode = get_export_time_code();
+
+  for (const auto &uv_map : usd_mesh_data.uv_maps) {
+    const pxr::TfToken &primvar_name = uv_map.first;
+    const pxr::VtArray<pxr::GfVec2f> &uv_coords = uv_map.second;
+
+    pxr::UsdGeomPrimvar uv_coords_primvar = usd_mesh.CreatePrimvar(
+        primvar_name, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->faceVarying);
 
     if (!uv_coords_primvar.HasValue()) {
       uv_coords_primvar.Set(uv_coords, pxr::UsdTimeCode::Default());
     }
     const pxr::UsdAttribute &uv_coords_attr = uv_coords_primvar.GetAttr();
-    usd_value_writer_.SetAttribute(uv_coords_attr, pxr::VtValue(uv_coords), timecode);
+    write_sparse_sample(uv_coords_attr, pxr::VtValue(uv_coords), timecode);
   }
 }
 
-void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
+void USDGenericMeshWriter::write_mesh(HierarchyContext &context, const USDMeshData &usd_mesh_data)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
   pxr::UsdTimeCode defaultTime = pxr::UsdTimeCode::Default();
@@ -154,9 +386,6 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
   write_visibility(context, timecode, usd_mesh);
 
-  USDMeshData usd_mesh_data;
-  get_geometry_data(mesh, usd_mesh_data);
-
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
     if (!mark_as_instance(context, usd_mesh.GetPrim())) {
       return;
@@ -187,10 +416,10 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     attr_face_vertex_indices.Set(usd_mesh_data.face_indices, defaultTime);
   }
 
-  usd_value_writer_.SetAttribute(attr_points, pxr::VtValue(usd_mesh_data.points), timecode);
-  usd_value_writer_.SetAttribute(
+  write_sparse_sample(attr_points, pxr::VtValue(usd_mesh_data.points), timecode);
+  write_sparse_sample(
       attr_face_vertex_counts, pxr::VtValue(usd_mesh_data.face_vertex_counts), timecode);
-  usd_value_writer_.SetAttribute(
+  write_sparse_sample(
       attr_face_vertex_indices, pxr::VtValue(usd_mesh_data.face_indices), timecode);
 
   if (!usd_mesh_data.crease_lengths.empty()) {
@@ -205,21 +434,20 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
       attr_crease_sharpness.Set(usd_mesh_data.crease_sharpnesses, defaultTime);
     }
 
-    usd_value_writer_.SetAttribute(
-        attr_crease_lengths, pxr::VtValue(usd_mesh_data.crease_lengths), timecode);
-    usd_value_writer_.SetAttribute(
+    write_sparse_sample(attr_crease_lengths, pxr::VtValue(usd_mesh_data.crease_lengths), timecode);
+    write_sparse_sample(
         attr_crease_indices, pxr::VtValue(usd_mesh_data.crease_vertex_indices), timecode);
-    usd_value_writer_.SetAttribute(
+    write_sparse_sample(
         attr_crease_sharpness, pxr::VtValue(usd_mesh_data.crease_sharpnesses), timecode);
   }
 
   if (usd_export_context_.export_params.export_uvmaps) {
-    write_uv_maps(mesh, usd_mesh);
+    write_uv_maps(usd_mesh_data, usd_mesh);
   }
   if (usd_export_context_.export_params.export_normals) {
-    write_normals(mesh, usd_mesh);
+    write_normals(usd_mesh_data, usd_mesh);
   }
-  write_surface_velocity(context.object, mesh, usd_mesh);
+  write_surface_velocity(usd_mesh_data, usd_mesh);
 
   /* TODO(Sybren): figure out what happens when the face groups change. */
   if (frame_has_been_written_) {
@@ -233,72 +461,6 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 }
 
-static void get_vertices(const Mesh *mesh, USDMeshData &usd_mesh_data)
-{
-  usd_mesh_data.points.reserve(mesh->totvert);
-
-  const MVert *verts = mesh->mvert;
-  for (int i = 0; i < mesh->totvert; ++i) {
-    usd_mesh_data.points.push_back(pxr::GfVec3f(verts[i].co));
-  }
-}
-
-static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
-{
-  /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
-   * assignments. */
-  bool construct_face_groups = mesh->totcol > 1;
-
-  usd_mesh_data.face_vertex_counts.reserve(mesh->totpoly);
-  usd_mesh_data.face_indices.reserve(mesh->totloop);
-
-  MLoop *mloop = mesh->mloop;
-  MPoly *mpoly = mesh->mpoly;
-  for (int i = 0; i < mesh->totpoly; ++i, ++mpoly) {
-    MLoop *loop = mloop + mpoly->loopstart;
-    usd_mesh_data.face_vertex_counts.push_back(mpoly->totloop);
-    for (int j = 0; j < mpoly->totloop; ++j, ++loop) {
-      usd_mesh_data.face_indices.push_back(loop->v);
-    }
-
-    if (construct_face_groups) {
-      usd_mesh_data.face_groups[mpoly->mat_nr].push_back(i);
-    }
-  }
-}
-
-static void get_creases(const Mesh *mesh, USDMeshData &usd_mesh_data)
-{
-  const float factor = 1.0f / 255.0f;
-
-  MEdge *edge = mesh->medge;
-  float sharpness;
-  for (int edge_idx = 0, totedge = mesh->totedge; edge_idx < totedge; ++edge_idx, ++edge) {
-    if (edge->crease == 0) {
-      continue;
-    }
-
-    if (edge->crease == 255) {
-      sharpness = pxr::UsdGeomMesh::SHARPNESS_INFINITE;
-    }
-    else {
-      sharpness = static_cast<float>(edge->crease) * factor;
-    }
-
-    usd_mesh_data.crease_vertex_indices.push_back(edge->v1);
-    usd_mesh_data.crease_vertex_indices.push_back(edge->v2);
-    usd_mesh_data.crease_lengths.push_back(2);
-    usd_mesh_data.crease_sharpnesses.push_back(sharpness);
-  }
-}
-
-void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh, USDMeshData &usd_mesh_data)
-{
-  get_vertices(mesh, usd_mesh_data);
-  get_loops_polys(mesh, usd_mesh_data);
-  get_creases(mesh, usd_mesh_data);
-}
-
 void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
                                             pxr::UsdGeomMesh usd_mesh,
                                             const MaterialFaceGroups &usd_face_groups)
@@ -361,94 +523,29 @@ void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
   }
 }
 
-void USDGenericMeshWriter::write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+void USDGenericMeshWriter::write_normals(const USDMeshData &usd_mesh_data,
+                                         pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
-  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
-
-  pxr::VtVec3fArray loop_normals;
-  loop_normals.reserve(mesh->totloop);
-
-  if (lnors != nullptr) {
-    /* Export custom loop normals. */
-    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
-      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
-    }
-  }
-  else {
-    /* Compute the loop normals based on the 'smooth' flag. */
-    float normal[3];
-    MPoly *mpoly = mesh->mpoly;
-    const MVert *mvert = mesh->mvert;
-    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
-      MLoop *mloop = mesh->mloop + mpoly->loopstart;
-
-      if ((mpoly->flag & ME_SMOOTH) == 0) {
-        /* Flat shaded, use common normal for all verts. */
-        BKE_mesh_calc_poly_normal(mpoly, mloop, mvert, normal);
-        pxr::GfVec3f pxr_normal(normal);
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
-          loop_normals.push_back(pxr_normal);
-        }
-      }
-      else {
-        /* Smooth shaded, use individual vert normals. */
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
-          normal_short_to_float_v3(normal, mvert[mloop->v].no);
-          loop_normals.push_back(pxr::GfVec3f(normal));
-        }
-      }
-    }
-  }
+  const pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
 
   pxr::UsdAttribute attr_normals = usd_mesh.CreateNormalsAttr(pxr::VtValue(), true);
   if (!attr_normals.HasValue()) {
     attr_normals.Set(loop_normals, pxr::UsdTimeCode::Default());
   }
-  usd_value_writer_.SetAttribute(attr_normals, pxr::VtValue(loop_normals), timecode);
+  write_sparse_sample(attr_normals, pxr::VtValue(loop_normals), timecode);
   usd_mesh.SetNormalsInterpolation(pxr::UsdGeomTokens->faceVarying);
 }
 
-void USDGenericMeshWriter::write_surface_velocity(Object *object,
-                                                  const Mesh *mesh,
+void USDGenericMeshWriter::write_surface_velocity(const USDMeshData &usd_mesh_data,
                                                   pxr::UsdGeomMesh usd_mesh)
 {
-  /* Only velocities from the fluid simulation are exported. This is the most important case,
-   * though, as the baked mesh changes topology all the time, and thus computing the velocities
-   * at import time in a post-processing step is hard. */
-  ModifierData *md = BKE_modifiers_findby_type(object, eModifierType_Fluidsim);
-  if (md == nullptr) {
-    return;
-  }
-
-  /* Check that the fluid sim modifier is enabled and has useful data. */
-  const bool use_render = (DEG_get_mode(usd_export_context_.depsgraph) == DAG_EVAL_RENDER);
-  const ModifierMode required_mode = use_render ? eModifierMode_Render : eModifierMode_Realtime;
-  const Scene *scene = DEG_get_evaluated_scene(usd_export_context_.depsgraph);
-  if (!BKE_modifier_is_enabled(scene, md, required_mode)) {
-    return;
-  }
-  FluidsimModifierData *fsmd = reinterpret_cast<FluidsimModifierData *>(md);
-  if (!fsmd->fss || fsmd->fss->type != OB_FLUIDSIM_DOMAIN) {
+  if (usd_mesh_data.velocities.empty()) {
     return;
   }
-  FluidsimSettings *fss = fsmd->fss;
-  if (!fss->meshVelocities) {
-    return;
-  }
-
-  /* Export per-vertex velocity vectors. */
-  pxr::VtVec3fArray usd_velocities;
-  usd_velocities.reserve(mesh->totvert);
-
-  FluidVertexVelocity *mesh_velocities = fss->meshVelocities;
-  for (int vertex_idx = 0, totvert = mesh->totvert; vertex_idx < totvert;
-       ++vertex_idx, ++mesh_velocities) {
-    usd_velocities.push_back(pxr::GfVec3f(mesh_velocities->vel));
-  }
 
   pxr::UsdTimeCode timecode = get_export_time_code();
-  usd_mesh.CreateVelocitiesAttr().Set(usd_velocities, timecode);
+  write_sample(usd_mesh.CreateVelocitiesAttr(), pxr::VtValue(usd_mesh_data.velocities), timecode);
 }
 
 USDMeshWriter::USDMeshWriter(const USDExporterContext &ctx) : USDGenericMeshWriter(ctx)
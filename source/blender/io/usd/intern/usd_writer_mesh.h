@@ -22,17 +22,25 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+#include <memory>
+
 namespace blender::io::usd {
 
 struct USDMeshData;
 
 /* Writer for USD geometry. Does not assume the object is a mesh object. */
 class USDGenericMeshWriter : public USDAbstractWriter {
+ private:
+  /* Data converted by do_convert(), written and released by do_write(). */
+  std::unique_ptr<USDMeshData> mesh_data_;
+
  public:
   USDGenericMeshWriter(const USDExporterContext &ctx);
+  ~USDGenericMeshWriter();
 
  protected:
   virtual bool is_supported(const HierarchyContext *context) const override;
+  virtual void do_convert(HierarchyContext &context) override;
   virtual void do_write(HierarchyContext &context) override;
 
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) = 0;
@@ -42,14 +50,18 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   /* Mapping from material slot number to array of face indices with that material. */
   typedef std::map<short, pxr::VtIntArray> MaterialFaceGroups;
 
-  void write_mesh(HierarchyContext &context, Mesh *mesh);
-  void get_geometry_data(const Mesh *mesh, struct USDMeshData &usd_mesh_data);
+  void get_mesh_data(const HierarchyContext &context,
+                     const Mesh *mesh,
+                     USDMeshData &usd_mesh_data);
+  void get_surface_velocity(Object *object, const Mesh *mesh, USDMeshData &usd_mesh_data);
+
+  void write_mesh(HierarchyContext &context, const USDMeshData &usd_mesh_data);
   void assign_materials(const HierarchyContext &context,
                         pxr::UsdGeomMesh usd_mesh,
                         const MaterialFaceGroups &usd_face_groups);
-  void write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
-  void write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
-  void write_surface_velocity(Object *object, const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
+  void write_uv_maps(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
+  void write_normals(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
+  void write_surface_velocity(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
 };
 
 class USDMeshWriter : public USDGenericMeshWriter {
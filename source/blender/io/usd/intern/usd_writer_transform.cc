@@ -45,7 +45,9 @@ void USDTransformWriter::do_write(HierarchyContext &context)
   if (!xformOp_) {
     xformOp_ = xform.AddTransformOp();
   }
-  xformOp_.Set(pxr::GfMatrix4d(parent_relative_matrix), get_export_time_code());
+  write_sample(xformOp_.GetAttr(),
+               pxr::VtValue(pxr::GfMatrix4d(parent_relative_matrix)),
+               get_export_time_code());
 }
 
 bool USDTransformWriter::check_is_animated(const HierarchyContext &context) const
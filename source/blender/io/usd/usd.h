@@ -36,6 +36,7 @@ struct USDExportParams {
   bool selected_objects_only;
   bool visible_objects_only;
   bool use_instancing;
+  bool use_write_thread;
   enum eEvaluationMode evaluation_mode;
 };
 
@@ -525,6 +525,10 @@ typedef struct ChannelDriver {
   int type;
   /** Settings of driver. */
   int flag;
+
+  /** Keyframe segment of the F-Curve used by the previous evaluation (runtime). */
+  int segment_hint;
+  char _pad[4];
 } ChannelDriver;
 
 /** Driver type. */
@@ -1116,6 +1120,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved RNA paths of the active action, see #BKE_animsys_eval_animdata. */
+  struct AnimationEvalBindings *eval_bindings;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
@@ -103,6 +103,9 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Grid of the vertex positions for nearest point lookups (a C++ `blender::PointGrid`). */
+  void *vert_point_grid;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
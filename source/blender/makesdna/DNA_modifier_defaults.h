@@ -138,7 +138,8 @@
     .bending_damping = 0.5f, \
     .voxel_cell_size = 0.1f, \
     .stepsPerFrame = 5, \
-    .flags = CLOTH_SIMSETTINGS_FLAG_INTERNAL_SPRINGS_NORMAL, \
+    .flags = CLOTH_SIMSETTINGS_FLAG_INTERNAL_SPRINGS_NORMAL | \
+             CLOTH_SIMSETTINGS_FLAG_PARALLEL_SOLVER, \
     .maxspringlen = 10, \
     .solver_type = 0, \
     .vgroup_bend = 0, \
@@ -577,7 +578,12 @@
   }
 
 #define _DNA_DEFAULT_NodesModifierData \
-  { 0 }
+  { \
+    .bake_directory = "//geometry_nodes_cache/", \
+    .bake_frame_start = 1, \
+    .bake_frame_end = 250, \
+    .bake_flag = 0, \
+  }
 
 #define _DNA_DEFAULT_SkinModifierData \
   { \
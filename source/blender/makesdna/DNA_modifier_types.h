@@ -2256,8 +2256,22 @@ typedef struct NodesModifierData {
   ModifierData modifier;
   struct bNodeTree *node_group;
   struct NodesModifierSettings settings;
+
+  /** Directory with the baked geometry of every frame in the bake frame range. */
+  char bake_directory[1024];
+  int bake_frame_start;
+  int bake_frame_end;
+  /** #NodesModifierBakeFlag. */
+  int bake_flag;
+  char _pad[4];
 } NodesModifierData;
 
+/* NodesModifierData.bake_flag */
+typedef enum NodesModifierBakeFlag {
+  /* The geometry is read from the files in the bake directory instead of being computed. */
+  NODES_MODIFIER_BAKED = (1 << 0),
+} NodesModifierBakeFlag;
+
 typedef struct MeshToVolumeModifierData {
   ModifierData modifier;
 
@@ -210,6 +210,12 @@ typedef struct Object_Runtime {
   /** Runtime evaluated curve-specific data, not stored in the file. */
   struct CurveCache *curve_cache;
 
+  /**
+   * Vertex group weights compiled for armature deformation. Kept between evaluations, unlike
+   * the other evaluated data.
+   */
+  struct ArmatureSkinningCache *armature_skinning_cache;
+
   unsigned short local_collections_bits;
   short _pad2[3];
 } Object_Runtime;
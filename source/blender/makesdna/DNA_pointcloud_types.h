@@ -52,6 +52,9 @@ typedef struct PointCloud {
 
   /* Draw Cache */
   void *batch_cache;
+
+  /* Grid of the point positions for nearest point lookups (a C++ `blender::PointGrid`). */
+  void *point_grid;
 } PointCloud;
 
 /* PointCloud.flag */
@@ -1071,6 +1071,11 @@ int RNA_property_collection_raw_array(PointerRNA *ptr,
                                       PropertyRNA *prop,
                                       PropertyRNA *itemprop,
                                       RawArray *array);
+int RNA_property_collection_raw_array_ex(PointerRNA *ptr,
+                                         PropertyRNA *prop,
+                                         PropertyRNA *itemprop,
+                                         RawArray *array,
+                                         bool *r_editable);
 int RNA_property_collection_raw_get(struct ReportList *reports,
                                     PointerRNA *ptr,
                                     PropertyRNA *prop,
@@ -4353,6 +4353,23 @@ int RNA_property_collection_raw_array(PointerRNA *ptr,
                                       PropertyRNA *prop,
                                       PropertyRNA *itemprop,
                                       RawArray *array)
+{
+  bool editable;
+  if (!RNA_property_collection_raw_array_ex(ptr, prop, itemprop, array, &editable)) {
+    return 0;
+  }
+  return editable ? 1 : 0;
+}
+
+/**
+ * Same as #RNA_property_collection_raw_array but also succeeds for items that can't be edited,
+ * \a r_editable tells whether writing to the array is allowed.
+ */
+int RNA_property_collection_raw_array_ex(PointerRNA *ptr,
+                                         PropertyRNA *prop,
+                                         PropertyRNA *itemprop,
+                                         RawArray *array,
+                                         bool *r_editable)
 {
   CollectionPropertyIterator iter;
   ArrayIterator *internal;
@@ -4360,6 +4377,8 @@ int RNA_property_collection_raw_array(PointerRNA *ptr,
 
   BLI_assert(RNA_property_type(prop) == PROP_COLLECTION);
 
+  *r_editable = false;
+
   if (!(prop->flag_internal & PROP_INTERN_RAW_ARRAY) ||
       !(itemprop->flag_internal & PROP_INTERN_RAW_ACCESS)) {
     return 0;
@@ -4372,7 +4391,7 @@ int RNA_property_collection_raw_array(PointerRNA *ptr,
     internal = &iter.internal.array;
     arrayp = (iter.valid) ? iter.ptr.data : NULL;
 
-    if (internal->skip || !RNA_property_editable(&iter.ptr, itemprop)) {
+    if (internal->skip) {
       /* we might skip some items, so it's not a proper array */
       RNA_property_collection_end(&iter);
       return 0;
@@ -4382,9 +4401,12 @@ int RNA_property_collection_raw_array(PointerRNA *ptr,
     array->stride = internal->itemsize;
     array->len = ((char *)internal->endptr - arrayp) / internal->itemsize;
     array->type = itemprop->rawtype;
+    *r_editable = RNA_property_editable(&iter.ptr, itemprop);
   }
   else {
     memset(array, 0, sizeof(RawArray));
+    array->type = itemprop->rawtype;
+    *r_editable = true;
   }
 
   RNA_property_collection_end(&iter);
@@ -4550,6 +4572,17 @@ static int rna_raw_access(ReportList *reports,
 
         size = RNA_raw_type_sizeof(out.type) * arraylen;
 
+        if (out.stride == size) {
+          /* Items only contain this property, copy everything at once. */
+          if (set) {
+            memcpy(outp, inp, (size_t)size * out.len);
+          }
+          else {
+            memcpy(inp, outp, (size_t)size * out.len);
+          }
+          return 1;
+        }
+
         for (a = 0; a < out.len; a++) {
           if (set) {
             memcpy(outp, inp, size);
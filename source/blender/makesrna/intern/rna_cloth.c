@@ -879,6 +879,16 @@ static void rna_def_cloth_sim_settings(BlenderRNA *brna)
       prop, "Rest Shape Key", "Shape key to use the rest spring lengths from");
   RNA_def_property_update(prop, 0, "rna_cloth_update");
 
+  prop = RNA_def_property(srna, "use_parallel_solver", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", CLOTH_SIMSETTINGS_FLAG_PARALLEL_SOLVER);
+  RNA_def_property_ui_text(prop,
+                           "Multi-Threaded Solver",
+                           "Solve with multiple threads and a preconditioner, converging faster "
+                           "on dense meshes. Results differ slightly from the single threaded "
+                           "solver");
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+  RNA_def_property_update(prop, 0, "rna_cloth_update");
+
   prop = RNA_def_property(srna, "use_dynamic_mesh", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flags", CLOTH_SIMSETTINGS_FLAG_DYNAMIC_BASEMESH);
   RNA_def_property_ui_text(
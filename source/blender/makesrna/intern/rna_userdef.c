@@ -6312,6 +6312,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, NULL, "use_override_templates", 1);
   RNA_def_property_ui_text(
       prop, "Override Templates", "Enable library override template in the python API");
+
+  prop = RNA_def_property(srna, "use_async_playback", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_async_playback", 1);
+  RNA_def_property_ui_text(prop,
+                           "Asynchronous Playback",
+                           "Evaluate the next frame in the background while the current one is "
+                           "drawn during animation playback (uses more memory)");
 }
 
 static void rna_def_userdef_addon_collection(BlenderRNA *brna, PropertyRNA *cprop)
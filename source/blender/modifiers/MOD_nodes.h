@@ -28,6 +28,27 @@ void MOD_nodes_update_interface(struct Object *object, struct NodesModifierData
 
 void MOD_nodes_init(struct Main *bmain, struct NodesModifierData *nmd);
 
+/**
+ * Start baking: until #MOD_nodes_bake_end, the geometry computed by the modifier on the active
+ * depsgraph is written to the bake directory for every evaluated frame in the bake range.
+ */
+void MOD_nodes_bake_begin(struct Main *bmain,
+                          struct Object *object,
+                          struct NodesModifierData *nmd);
+/**
+ * Wait until the files of all evaluated frames are written.
+ * \return false when a file could not be written.
+ */
+bool MOD_nodes_bake_end(struct NodesModifierData *nmd);
+/** Check whether the files of all frames of the bake range exist. */
+bool MOD_nodes_bake_files_exist(struct Main *bmain,
+                                struct Object *object,
+                                const struct NodesModifierData *nmd);
+/** Delete the files of the bake range and compute the geometry again. */
+void MOD_nodes_bake_free(struct Main *bmain,
+                         struct Object *object,
+                         struct NodesModifierData *nmd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,17 +21,24 @@
  * \ingroup modifiers
  */
 
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_fileops.h"
 #include "BLI_float3.hh"
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_multi_value_map.hh"
+#include "BLI_path_util.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_collection_types.h"
@@ -49,9 +56,11 @@
 #include "DNA_windowmanager_types.h"
 
 #include "BKE_customdata.h"
+#include "BKE_geometry_set_cache.hh"
 #include "BKE_geometry_set_instances.hh"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
+#include "BKE_lib_id.h"
 #include "BKE_lib_query.h"
 #include "BKE_main.h"
 #include "BKE_mesh.h"
@@ -65,12 +74,16 @@
 
 #include "BLO_read_write.h"
 
+#include "BLT_translation.h"
+
 #include "UI_interface.h"
 #include "UI_resources.h"
 
 #include "RNA_access.h"
 #include "RNA_enum_types.h"
 
+#include "WM_types.h" /* For the bake operator. */
+
 #include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
@@ -1033,11 +1046,208 @@ static void check_property_socket_sync(const Object *ob, ModifierData *md)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Bake
+ *
+ * Baking evaluates the depsgraph for every frame of the bake range and writes the geometry
+ * computed by the modifier to a file per frame. Once baked, the modifier reads the geometry of
+ * the current frame from the file instead of evaluating the node group.
+ * \{ */
+
+static void bake_frame_filepath(const char *directory,
+                                const Object &object,
+                                const ModifierData &md,
+                                const int frame,
+                                char r_filepath[FILE_MAX])
+{
+  char filename[FILE_MAXFILE];
+  BLI_snprintf(
+      filename, sizeof(filename), "%s_%s_%06d.bgeo", object.id.name + 2, md.name, frame);
+  BLI_filename_make_safe(filename);
+  BLI_join_dirfile(r_filepath, FILE_MAX, directory, filename);
+}
+
+/**
+ * Writes the geometry of the frames evaluated while baking. The files are written by a task pool,
+ * so writing a frame overlaps with the evaluation of the next frames. Stored in the runtime data
+ * of the original modifier while baking.
+ */
+struct NodesModifierBakeWriter {
+  char directory[FILE_MAX];
+  TaskPool *task_pool;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  /* Frames that are added but not written yet, limited to bound the memory usage. */
+  int pending_frames = 0;
+  int max_pending_frames;
+  Set<int> added_frames;
+  bool write_failed = false;
+};
+
+struct BakeFrame {
+  GeometrySet geometry_set;
+  char filepath[FILE_MAX];
+};
+
+static void bake_frame_write_task(TaskPool *__restrict pool, void *taskdata)
+{
+  NodesModifierBakeWriter *writer = static_cast<NodesModifierBakeWriter *>(
+      BLI_task_pool_user_data(pool));
+  BakeFrame *frame = static_cast<BakeFrame *>(taskdata);
+
+  const bool ok = blender::bke::geometry_set_cache_write(frame->geometry_set, frame->filepath);
+  /* Free the geometry before another frame may be added. */
+  frame->geometry_set.clear();
+
+  std::lock_guard lock{writer->mutex};
+  writer->write_failed |= !ok;
+  writer->pending_frames--;
+  writer->condition.notify_all();
+}
+
+static void bake_frame_free(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  delete static_cast<BakeFrame *>(taskdata);
+}
+
+static void bake_frame_add(NodesModifierData &nmd_orig,
+                           const ModifierEvalContext &ctx,
+                           const GeometrySet &geometry_set)
+{
+  NodesModifierBakeWriter *writer = static_cast<NodesModifierBakeWriter *>(
+      nmd_orig.modifier.runtime);
+  const float ctime = DEG_get_ctime(ctx.depsgraph);
+  const int frame = round_fl_to_int(ctime);
+  if (ctime != float(frame) || frame < nmd_orig.bake_frame_start ||
+      frame > nmd_orig.bake_frame_end) {
+    return;
+  }
+
+  {
+    std::unique_lock lock{writer->mutex};
+    if (!writer->added_frames.add(frame)) {
+      return;
+    }
+    writer->condition.wait(
+        lock, [&]() { return writer->pending_frames < writer->max_pending_frames; });
+    writer->pending_frames++;
+  }
+
+  BakeFrame *bake_frame = new BakeFrame();
+  bake_frame->geometry_set = geometry_set;
+  /* The geometry may reference data of other objects that changes for the next frame. */
+  bake_frame->geometry_set.ensure_owns_direct_data();
+  bake_frame_filepath(
+      writer->directory, *ctx.object, nmd_orig.modifier, frame, bake_frame->filepath);
+  BLI_task_pool_push(writer->task_pool, bake_frame_write_task, bake_frame, false, bake_frame_free);
+}
+
+/* Read the baked geometry of the current frame, returns false when it has to be computed. */
+static bool bake_frame_read(const NodesModifierData &nmd,
+                            const ModifierEvalContext &ctx,
+                            GeometrySet &r_geometry_set)
+{
+  /* Sub-frames, e.g. for motion blur, are not baked. */
+  const float ctime = DEG_get_ctime(ctx.depsgraph);
+  const int frame = round_fl_to_int(ctime);
+  if (ctime != float(frame) || frame < nmd.bake_frame_start || frame > nmd.bake_frame_end) {
+    return false;
+  }
+
+  char directory[FILE_MAX];
+  STRNCPY(directory, nmd.bake_directory);
+  BLI_path_abs(directory, BKE_modifier_path_relbase_from_global(ctx.object));
+  char filepath[FILE_MAX];
+  bake_frame_filepath(directory, *ctx.object, nmd.modifier, frame, filepath);
+
+  /* Referenced data-blocks are looked up by name in the original data, the geometry references
+   * their evaluated copies. */
+  Main *bmain = DEG_get_bmain(ctx.depsgraph);
+  return blender::bke::geometry_set_cache_read(
+      filepath,
+      [&](const short id_type, StringRefNull name) -> ID * {
+        ID *id = BKE_libblock_find_name(bmain, id_type, name.c_str());
+        return id ? DEG_get_evaluated_id(ctx.depsgraph, id) : nullptr;
+      },
+      r_geometry_set);
+}
+
+void MOD_nodes_bake_begin(Main *bmain, Object *object, NodesModifierData *nmd)
+{
+  BLI_assert(nmd->modifier.runtime == nullptr);
+
+  NodesModifierBakeWriter *writer = new NodesModifierBakeWriter();
+  STRNCPY(writer->directory, nmd->bake_directory);
+  BLI_path_abs(writer->directory, BKE_modifier_path_relbase(bmain, object));
+  BLI_dir_create_recursive(writer->directory);
+  writer->max_pending_frames = BLI_system_thread_count();
+  writer->task_pool = BLI_task_pool_create_background(writer, TASK_PRIORITY_LOW);
+
+  nmd->bake_flag &= ~NODES_MODIFIER_BAKED;
+  nmd->modifier.runtime = writer;
+}
+
+bool MOD_nodes_bake_end(NodesModifierData *nmd)
+{
+  NodesModifierBakeWriter *writer = static_cast<NodesModifierBakeWriter *>(nmd->modifier.runtime);
+  BLI_task_pool_work_and_wait(writer->task_pool);
+  BLI_task_pool_free(writer->task_pool);
+  const bool ok = !writer->write_failed;
+
+  delete writer;
+  nmd->modifier.runtime = nullptr;
+  return ok;
+}
+
+bool MOD_nodes_bake_files_exist(Main *bmain, Object *object, const NodesModifierData *nmd)
+{
+  char directory[FILE_MAX];
+  STRNCPY(directory, nmd->bake_directory);
+  BLI_path_abs(directory, BKE_modifier_path_relbase(bmain, object));
+
+  for (int frame = nmd->bake_frame_start; frame <= nmd->bake_frame_end; frame++) {
+    char filepath[FILE_MAX];
+    bake_frame_filepath(directory, *object, nmd->modifier, frame, filepath);
+    if (!BLI_exists(filepath)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MOD_nodes_bake_free(Main *bmain, Object *object, NodesModifierData *nmd)
+{
+  char directory[FILE_MAX];
+  STRNCPY(directory, nmd->bake_directory);
+  BLI_path_abs(directory, BKE_modifier_path_relbase(bmain, object));
+
+  for (int frame = nmd->bake_frame_start; frame <= nmd->bake_frame_end; frame++) {
+    char filepath[FILE_MAX];
+    bake_frame_filepath(directory, *object, nmd->modifier, frame, filepath);
+    if (BLI_exists(filepath)) {
+      BLI_delete(filepath, false, false);
+    }
+  }
+  nmd->bake_flag &= ~NODES_MODIFIER_BAKED;
+}
+
+/** \} */
+
 static void modifyGeometry(ModifierData *md,
                            const ModifierEvalContext *ctx,
                            GeometrySet &geometry_set)
 {
   NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
+
+  if (nmd->bake_flag & NODES_MODIFIER_BAKED) {
+    GeometrySet baked_geometry_set;
+    if (bake_frame_read(*nmd, *ctx, baked_geometry_set)) {
+      geometry_set = std::move(baked_geometry_set);
+      return;
+    }
+  }
+
   if (nmd->node_group == nullptr) {
     return;
   }
@@ -1077,6 +1287,14 @@ static void modifyGeometry(ModifierData *md,
 
   geometry_set = compute_geometry(
       tree, input_nodes, *group_outputs[0], std::move(geometry_set), nmd, ctx);
+
+  if (DEG_is_active(ctx->depsgraph)) {
+    NodesModifierData *nmd_orig = reinterpret_cast<NodesModifierData *>(
+        BKE_modifier_get_original(md));
+    if (nmd_orig->modifier.runtime != nullptr) {
+      bake_frame_add(*nmd_orig, *ctx, geometry_set);
+    }
+  }
 }
 
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
@@ -1199,9 +1417,46 @@ static void panel_draw(const bContext *C, Panel *panel)
   modifier_panel_end(layout, ptr);
 }
 
+static void bake_panel_draw(const bContext *UNUSED(C), Panel *panel)
+{
+  uiLayout *layout = panel->layout;
+
+  PointerRNA *ptr = modifier_panel_get_property_pointers(panel, nullptr);
+
+  uiLayoutSetPropSep(layout, true);
+
+  const bool is_baked = RNA_boolean_get(ptr, "is_baked");
+
+  if (is_baked) {
+    PointerRNA op_ptr;
+    uiItemFullO(layout,
+                "OBJECT_OT_geometry_nodes_bake",
+                IFACE_("Delete Bake"),
+                ICON_NONE,
+                nullptr,
+                WM_OP_EXEC_DEFAULT,
+                0,
+                &op_ptr);
+    RNA_boolean_set(&op_ptr, "free", true);
+  }
+  else {
+    uiItemO(layout, nullptr, ICON_NONE, "OBJECT_OT_geometry_nodes_bake");
+  }
+
+  uiLayout *col = uiLayoutColumn(layout, false);
+  uiLayoutSetEnabled(col, !is_baked);
+  uiItemR(col, ptr, "bake_directory", 0, nullptr, ICON_NONE);
+
+  col = uiLayoutColumn(layout, true);
+  uiLayoutSetEnabled(col, !is_baked);
+  uiItemR(col, ptr, "bake_frame_start", 0, IFACE_("Frame Start"), ICON_NONE);
+  uiItemR(col, ptr, "bake_frame_end", 0, IFACE_("End"), ICON_NONE);
+}
+
 static void panelRegister(ARegionType *region_type)
 {
-  modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
+  PanelType *panel_type = modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
+  modifier_subpanel_register(region_type, "bake", "Bake", nullptr, bake_panel_draw, panel_type);
 }
 
 static void blendWrite(BlendWriter *writer, const ModifierData *md)
@@ -1242,6 +1497,13 @@ static void freeData(ModifierData *md)
   }
 }
 
+static bool dependsOnTime(ModifierData *md)
+{
+  const NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
+  /* A different file is read for every frame. */
+  return nmd->bake_flag & NODES_MODIFIER_BAKED;
+}
+
 static void requiredDataMask(Object *UNUSED(ob),
                              ModifierData *UNUSED(md),
                              CustomData_MeshMasks *r_cddata_masks)
@@ -1279,7 +1541,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
-    /* dependsOnTime */ nullptr,
+    /* dependsOnTime */ dependsOnTime,
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ foreachTexLink,
@@ -169,33 +169,44 @@ static void do_math_operation(const VArray<float> &span_a,
   UNUSED_VARS_NDEBUG(success);
 }
 
-static void do_math_operation(const VArray<float> &span_a,
-                              const VArray<float> &span_b,
+static void do_math_operation(const VArray<float> &input_a,
+                              const VArray<float> &input_b,
                               MutableSpan<float> span_result,
                               const NodeMathOperation operation)
 {
+  /* Copy inputs that are neither spans nor single values, so that the devirtualized loops can
+   * always be used. */
+  VArray_SpanOrSingle<float> varray_a{input_a};
+  VArray_SpanOrSingle<float> varray_b{input_b};
+
   bool success = try_dispatch_float_math_fl_fl_to_fl(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(span_result.size()), 1024, [&](IndexRange range) {
-          for (const int i : range) {
-            span_result[i] = math_function(span_a[i], span_b[i]);
-          }
+          devirtualize_varray2(varray_a, varray_b, [&](const auto &a, const auto &b) {
+            for (const int i : range) {
+              span_result[i] = math_function(a[i], b[i]);
+            }
+          });
         });
       });
   BLI_assert(success);
   UNUSED_VARS_NDEBUG(success);
 }
 
-static void do_math_operation(const VArray<float> &span_input,
+static void do_math_operation(const VArray<float> &input,
                               MutableSpan<float> span_result,
                               const NodeMathOperation operation)
 {
+  VArray_SpanOrSingle<float> varray{input};
+
   bool success = try_dispatch_float_math_fl_to_fl(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(span_result.size()), 1024, [&](IndexRange range) {
-          for (const int i : range) {
-            span_result[i] = math_function(span_input[i]);
-          }
+          devirtualize_varray(varray, [&](const auto &in) {
+            for (const int i : range) {
+              span_result[i] = math_function(in[i]);
+            }
+          });
         });
       });
   BLI_assert(success);
@@ -16,12 +16,15 @@
 
 #include "BLI_kdopbvh.h"
 #include "BLI_kdtree.h"
+#include "BLI_point_grid.hh"
 #include "BLI_task.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_mesh_types.h"
+#include "DNA_pointcloud_types.h"
 
 #include "BKE_bvhutils.h"
+#include "BKE_point_grid_cache.hh"
 
 #include "UI_interface.h"
 #include "UI_resources.h"
@@ -64,63 +67,51 @@ static void proximity_calc(MutableSpan<float> distance_span,
                            MutableSpan<float3> location_span,
                            const VArray<float3> &positions,
                            BVHTreeFromMesh &tree_data_mesh,
-                           BVHTreeFromPointCloud &tree_data_pointcloud,
                            const bool bvh_mesh_success,
-                           const bool bvh_pointcloud_success,
+                           Span<const PointGrid *> point_grids,
                            const bool store_distances,
                            const bool store_locations)
 {
   IndexRange range = positions.index_range();
   threading::parallel_for(range, 512, [&](IndexRange range) {
     BVHTreeNearest nearest_from_mesh;
-    BVHTreeNearest nearest_from_pointcloud;
-
     copy_v3_fl(nearest_from_mesh.co, FLT_MAX);
-    copy_v3_fl(nearest_from_pointcloud.co, FLT_MAX);
-
     nearest_from_mesh.index = -1;
-    nearest_from_pointcloud.index = -1;
 
     for (int i : range) {
+      const float3 position = positions[i];
+
       /* Use the distance to the last found point as upper bound to speedup the bvh lookup. */
-      nearest_from_mesh.dist_sq = len_squared_v3v3(nearest_from_mesh.co, positions[i]);
+      nearest_from_mesh.dist_sq = len_squared_v3v3(nearest_from_mesh.co, position);
 
       if (bvh_mesh_success) {
         BLI_bvhtree_find_nearest(tree_data_mesh.tree,
-                                 positions[i],
+                                 position,
                                  &nearest_from_mesh,
                                  tree_data_mesh.nearest_callback,
                                  &tree_data_mesh);
       }
 
-      /* Use the distance to the closest point in the mesh to speedup the pointcloud bvh lookup.
-       * This is ok because we only need to find the closest point in the pointcloud if it's closer
-       * than the mesh. */
-      nearest_from_pointcloud.dist_sq = nearest_from_mesh.dist_sq;
-
-      if (bvh_pointcloud_success) {
-        BLI_bvhtree_find_nearest(tree_data_pointcloud.tree,
-                                 positions[i],
-                                 &nearest_from_pointcloud,
-                                 tree_data_pointcloud.nearest_callback,
-                                 &tree_data_pointcloud);
-      }
-
-      if (nearest_from_pointcloud.dist_sq < nearest_from_mesh.dist_sq) {
-        if (store_distances) {
-          distance_span[i] = sqrtf(nearest_from_pointcloud.dist_sq);
+      float nearest_distance_sq = nearest_from_mesh.dist_sq;
+      float3 nearest_location = nearest_from_mesh.co;
+      for (const PointGrid *point_grid : point_grids) {
+        float distance_sq;
+        float3 location;
+        if (point_grid->find_nearest(position, &distance_sq, &location) == -1) {
+          /* Nothing is found for positions that are not finite. */
+          continue;
         }
-        if (store_locations) {
-          location_span[i] = nearest_from_pointcloud.co;
+        if (distance_sq < nearest_distance_sq) {
+          nearest_distance_sq = distance_sq;
+          nearest_location = location;
         }
       }
-      else {
-        if (store_distances) {
-          distance_span[i] = sqrtf(nearest_from_mesh.dist_sq);
-        }
-        if (store_locations) {
-          location_span[i] = nearest_from_mesh.co;
-        }
+
+      if (store_distances) {
+        distance_span[i] = sqrtf(nearest_distance_sq);
+      }
+      if (store_locations) {
+        location_span[i] = nearest_location;
       }
     }
   });
@@ -132,9 +123,6 @@ static bool bvh_from_mesh(const Mesh *target_mesh,
 {
   BVHCacheType bvh_type = BVHTREE_FROM_LOOPTRI;
   switch (target_geometry_element) {
-    case GEO_NODE_ATTRIBUTE_PROXIMITY_TARGET_GEOMETRY_ELEMENT_POINTS:
-      bvh_type = BVHTREE_FROM_VERTS;
-      break;
     case GEO_NODE_ATTRIBUTE_PROXIMITY_TARGET_GEOMETRY_ELEMENT_EDGES:
       bvh_type = BVHTREE_FROM_EDGES;
       break;
@@ -151,16 +139,6 @@ static bool bvh_from_mesh(const Mesh *target_mesh,
   return true;
 }
 
-static bool bvh_from_pointcloud(const PointCloud *target_pointcloud,
-                                BVHTreeFromPointCloud &r_tree_data_pointcloud)
-{
-  BKE_bvhtree_from_pointcloud_get(&r_tree_data_pointcloud, target_pointcloud, 2);
-  if (r_tree_data_pointcloud.tree == nullptr) {
-    return false;
-  }
-  return true;
-}
-
 static void attribute_calc_proximity(GeometryComponent &component,
                                      GeometrySet &geometry_set_target,
                                      GeoNodeExecParams &params)
@@ -187,22 +165,31 @@ static void attribute_calc_proximity(GeometryComponent &component,
                                                        node.storage;
 
   BVHTreeFromMesh tree_data_mesh;
-  BVHTreeFromPointCloud tree_data_pointcloud;
   bool bvh_mesh_success = false;
-  bool bvh_pointcloud_success = false;
-
-  if (geometry_set_target.has_mesh()) {
+  /* Points are found with grids instead of BVH trees, they are much cheaper to build. Both are
+   * cached on the target geometry, so they are only built again when the target changes. */
+  Vector<const PointGrid *> point_grids;
+
+  if (storage.target_geometry_element ==
+      GEO_NODE_ATTRIBUTE_PROXIMITY_TARGET_GEOMETRY_ELEMENT_POINTS) {
+    if (geometry_set_target.has_mesh()) {
+      const Mesh &mesh = *geometry_set_target.get_mesh_for_read();
+      if (mesh.totvert > 0) {
+        point_grids.append(&bke::mesh_vert_point_grid_ensure(mesh));
+      }
+    }
+    if (geometry_set_target.has_pointcloud()) {
+      const PointCloud &pointcloud = *geometry_set_target.get_pointcloud_for_read();
+      if (pointcloud.totpoint > 0) {
+        point_grids.append(&bke::pointcloud_point_grid_ensure(pointcloud));
+      }
+    }
+  }
+  else if (geometry_set_target.has_mesh()) {
     bvh_mesh_success = bvh_from_mesh(
         geometry_set_target.get_mesh_for_read(), storage.target_geometry_element, tree_data_mesh);
   }
 
-  if (geometry_set_target.has_pointcloud() &&
-      storage.target_geometry_element ==
-          GEO_NODE_ATTRIBUTE_PROXIMITY_TARGET_GEOMETRY_ELEMENT_POINTS) {
-    bvh_pointcloud_success = bvh_from_pointcloud(geometry_set_target.get_pointcloud_for_read(),
-                                                 tree_data_pointcloud);
-  }
-
   GVArray_Typed<float3> positions{*position_attribute.varray};
   MutableSpan<float> distance_span = distance_attribute ? distance_attribute.as_span() :
                                                           MutableSpan<float>();
@@ -213,18 +200,14 @@ static void attribute_calc_proximity(GeometryComponent &component,
                  location_span,
                  positions,
                  tree_data_mesh,
-                 tree_data_pointcloud,
                  bvh_mesh_success,
-                 bvh_pointcloud_success,
+                 point_grids,
                  distance_attribute,  /* Boolean. */
                  location_attribute); /* Boolean. */
 
   if (bvh_mesh_success) {
     free_bvhtree_from_mesh(&tree_data_mesh);
   }
-  if (bvh_pointcloud_success) {
-    free_bvhtree_from_pointcloud(&tree_data_pointcloud);
-  }
 
   if (distance_attribute) {
     distance_attribute.save();
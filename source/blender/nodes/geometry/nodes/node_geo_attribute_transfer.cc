@@ -15,6 +15,8 @@
  */
 
 #include "BLI_kdopbvh.h"
+#include "BLI_point_grid.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -23,6 +25,7 @@
 #include "BKE_bvhutils.h"
 #include "BKE_mesh_runtime.h"
 #include "BKE_mesh_sample.hh"
+#include "BKE_point_grid_cache.hh"
 
 #include "UI_interface.h"
 #include "UI_resources.h"
@@ -112,22 +115,24 @@ static void get_closest_in_bvhtree(BVHTreeFromMesh &tree_data,
   BLI_assert(positions.size() == r_distances_sq.size() || r_distances_sq.is_empty());
   BLI_assert(positions.size() == r_positions.size() || r_positions.is_empty());
 
-  for (const int i : positions.index_range()) {
-    BVHTreeNearest nearest;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
-    if (!r_indices.is_empty()) {
-      r_indices[i] = nearest.index;
-    }
-    if (!r_distances_sq.is_empty()) {
-      r_distances_sq[i] = nearest.dist_sq;
-    }
-    if (!r_positions.is_empty()) {
-      r_positions[i] = nearest.co;
+  threading::parallel_for(positions.index_range(), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      BVHTreeNearest nearest;
+      nearest.dist_sq = FLT_MAX;
+      const float3 position = positions[i];
+      BLI_bvhtree_find_nearest(
+          tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
+      if (!r_indices.is_empty()) {
+        r_indices[i] = nearest.index;
+      }
+      if (!r_distances_sq.is_empty()) {
+        r_distances_sq[i] = nearest.dist_sq;
+      }
+      if (!r_positions.is_empty()) {
+        r_positions[i] = nearest.co;
+      }
     }
-  }
+  });
 }
 
 static void get_closest_pointcloud_points(const PointCloud &pointcloud,
@@ -138,20 +143,8 @@ static void get_closest_pointcloud_points(const PointCloud &pointcloud,
   BLI_assert(positions.size() == r_indices.size());
   BLI_assert(pointcloud.totpoint > 0);
 
-  BVHTreeFromPointCloud tree_data;
-  BKE_bvhtree_from_pointcloud_get(&tree_data, &pointcloud, 2);
-
-  for (const int i : positions.index_range()) {
-    BVHTreeNearest nearest;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
-    r_indices[i] = nearest.index;
-    r_distances_sq[i] = nearest.dist_sq;
-  }
-
-  free_bvhtree_from_pointcloud(&tree_data);
+  const PointGrid &point_grid = bke::pointcloud_point_grid_ensure(pointcloud);
+  point_grid.find_nearest(positions, r_indices, r_distances_sq);
 }
 
 static void get_closest_mesh_points(const Mesh &mesh,
@@ -161,10 +154,9 @@ static void get_closest_mesh_points(const Mesh &mesh,
                                     const MutableSpan<float3> r_positions)
 {
   BLI_assert(mesh.totvert > 0);
-  BVHTreeFromMesh tree_data;
-  BKE_bvhtree_from_mesh_get(&tree_data, const_cast<Mesh *>(&mesh), BVHTREE_FROM_VERTS, 2);
-  get_closest_in_bvhtree(tree_data, positions, r_point_indices, r_distances_sq, r_positions);
-  free_bvhtree_from_mesh(&tree_data);
+  /* Vertices are found with a grid instead of a BVH tree, it is much cheaper to build. */
+  const PointGrid &point_grid = bke::mesh_vert_point_grid_ensure(mesh);
+  point_grid.find_nearest(positions, r_point_indices, r_distances_sq, r_positions);
 }
 
 static void get_closest_mesh_edges(const Mesh &mesh,
@@ -205,10 +197,13 @@ static void get_closest_mesh_polygons(const Mesh &mesh,
   get_closest_mesh_looptris(mesh, positions, looptri_indices, r_distances_sq, r_positions);
 
   Span<MLoopTri> looptris = bke::mesh_surface_sample::get_mesh_looptris(mesh);
-  for (const int i : positions.index_range()) {
-    const MLoopTri &looptri = looptris[looptri_indices[i]];
-    r_poly_indices[i] = looptri.poly;
-  }
+  threading::parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int looptri_index = looptri_indices[i];
+      /* No triangle is found for positions that are not finite. */
+      r_poly_indices[i] = (looptri_index == -1) ? -1 : looptris[looptri_index].poly;
+    }
+  });
 }
 
 /* The closest corner is defined to be the closest corner on the closest face. */
@@ -222,36 +217,50 @@ static void get_closest_mesh_corners(const Mesh &mesh,
   Array<int> poly_indices(positions.size());
   get_closest_mesh_polygons(mesh, positions, poly_indices, {}, {});
 
-  for (const int i : positions.index_range()) {
-    const float3 position = positions[i];
-    const int poly_index = poly_indices[i];
-    const MPoly &poly = mesh.mpoly[poly_index];
-
-    /* Find the closest vertex in the polygon. */
-    float min_distance_sq = FLT_MAX;
-    const MVert *closest_mvert;
-    int closest_loop_index = 0;
-    for (const int loop_index : IndexRange(poly.loopstart, poly.totloop)) {
-      const MLoop &loop = mesh.mloop[loop_index];
-      const int vertex_index = loop.v;
-      const MVert &mvert = mesh.mvert[vertex_index];
-      const float distance_sq = float3::distance_squared(position, mvert.co);
-      if (distance_sq < min_distance_sq) {
-        min_distance_sq = distance_sq;
-        closest_loop_index = loop_index;
-        closest_mvert = &mvert;
+  threading::parallel_for(positions.index_range(), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      const float3 position = positions[i];
+      const int poly_index = poly_indices[i];
+
+      /* Find the closest vertex in the polygon. */
+      float min_distance_sq = FLT_MAX;
+      const MVert *closest_mvert = nullptr;
+      int closest_loop_index = -1;
+      if (poly_index == -1) {
+        if (!r_corner_indices.is_empty()) {
+          r_corner_indices[i] = -1;
+        }
+        if (!r_positions.is_empty()) {
+          r_positions[i] = position;
+        }
+        if (!r_distances_sq.is_empty()) {
+          r_distances_sq[i] = FLT_MAX;
+        }
+        continue;
+      }
+      const MPoly &poly = mesh.mpoly[poly_index];
+      for (const int loop_index : IndexRange(poly.loopstart, poly.totloop)) {
+        const MLoop &loop = mesh.mloop[loop_index];
+        const int vertex_index = loop.v;
+        const MVert &mvert = mesh.mvert[vertex_index];
+        const float distance_sq = float3::distance_squared(position, mvert.co);
+        if (distance_sq < min_distance_sq) {
+          min_distance_sq = distance_sq;
+          closest_loop_index = loop_index;
+          closest_mvert = &mvert;
+        }
+      }
+      if (!r_corner_indices.is_empty()) {
+        r_corner_indices[i] = closest_loop_index;
+      }
+      if (!r_positions.is_empty()) {
+        r_positions[i] = closest_mvert ? float3(closest_mvert->co) : position;
+      }
+      if (!r_distances_sq.is_empty()) {
+        r_distances_sq[i] = min_distance_sq;
       }
     }
-    if (!r_corner_indices.is_empty()) {
-      r_corner_indices[i] = closest_loop_index;
-    }
-    if (!r_positions.is_empty()) {
-      r_positions[i] = closest_mvert->co;
-    }
-    if (!r_distances_sq.is_empty()) {
-      r_distances_sq[i] = min_distance_sq;
-    }
-  }
+  });
 }
 
 static void transfer_attribute_nearest_face_interpolated(const GeometrySet &src_geometry,
@@ -410,12 +419,16 @@ static void transfer_attribute_nearest(const GeometrySet &src_geometry,
         pointcloud_src_attribute.varray->get(index, buffer);
         dst_attribute->set_by_relocate(i, buffer);
       }
-      else {
+      else if (mesh_indices[i] != -1) {
         /* Mesh element is closer. */
         const int index = mesh_indices[i];
         mesh_src_attribute.varray->get(index, buffer);
         dst_attribute->set_by_relocate(i, buffer);
       }
+      else {
+        /* Nothing is found for positions that are not finite. */
+        dst_attribute->set_by_copy(i, type.default_value());
+      }
     }
   }
   else if (use_pointcloud) {
@@ -424,6 +437,10 @@ static void transfer_attribute_nearest(const GeometrySet &src_geometry,
         src_name, data_type);
     for (const int i : IndexRange(tot_samples)) {
       const int index = pointcloud_indices[i];
+      if (index == -1) {
+        dst_attribute->set_by_copy(i, type.default_value());
+        continue;
+      }
       src_attribute.varray->get(index, buffer);
       dst_attribute->set_by_relocate(i, buffer);
     }
@@ -434,6 +451,10 @@ static void transfer_attribute_nearest(const GeometrySet &src_geometry,
                                                                                    data_type);
     for (const int i : IndexRange(tot_samples)) {
       const int index = mesh_indices[i];
+      if (index == -1) {
+        dst_attribute->set_by_copy(i, type.default_value());
+        continue;
+      }
       src_attribute.varray->get(index, buffer);
       dst_attribute->set_by_relocate(i, buffer);
     }
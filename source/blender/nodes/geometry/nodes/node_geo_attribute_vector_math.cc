@@ -180,19 +180,18 @@ static void do_math_operation_fl3_fl3_to_fl3(const VArray<float3> &input_a,
 {
   const int size = input_a.size();
 
-  VArray_Span<float3> span_a{input_a};
-  VArray_Span<float3> span_b{input_b};
+  VArray_SpanOrSingle<float3> varray_a{input_a};
+  VArray_SpanOrSingle<float3> varray_b{input_b};
   VMutableArray_Span<float3> span_result{result, false};
 
   bool success = try_dispatch_float_math_fl3_fl3_to_fl3(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(size), 512, [&](IndexRange range) {
-          for (const int i : range) {
-            const float3 a = span_a[i];
-            const float3 b = span_b[i];
-            const float3 out = math_function(a, b);
-            span_result[i] = out;
-          }
+          devirtualize_varray2(varray_a, varray_b, [&](const auto &a, const auto &b) {
+            for (const int i : range) {
+              span_result[i] = math_function(a[i], b[i]);
+            }
+          });
         });
       });
 
@@ -276,19 +275,18 @@ static void do_math_operation_fl3_fl3_to_fl(const VArray<float3> &input_a,
 {
   const int size = input_a.size();
 
-  VArray_Span<float3> span_a{input_a};
-  VArray_Span<float3> span_b{input_b};
+  VArray_SpanOrSingle<float3> varray_a{input_a};
+  VArray_SpanOrSingle<float3> varray_b{input_b};
   VMutableArray_Span<float> span_result{result, false};
 
   bool success = try_dispatch_float_math_fl3_fl3_to_fl(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(size), 512, [&](IndexRange range) {
-          for (const int i : range) {
-            const float3 a = span_a[i];
-            const float3 b = span_b[i];
-            const float out = math_function(a, b);
-            span_result[i] = out;
-          }
+          devirtualize_varray2(varray_a, varray_b, [&](const auto &a, const auto &b) {
+            for (const int i : range) {
+              span_result[i] = math_function(a[i], b[i]);
+            }
+          });
         });
       });
 
@@ -306,19 +304,18 @@ static void do_math_operation_fl3_fl_to_fl3(const VArray<float3> &input_a,
 {
   const int size = input_a.size();
 
-  VArray_Span<float3> span_a{input_a};
-  VArray_Span<float> span_b{input_b};
+  VArray_SpanOrSingle<float3> varray_a{input_a};
+  VArray_SpanOrSingle<float> varray_b{input_b};
   VMutableArray_Span<float3> span_result{result, false};
 
   bool success = try_dispatch_float_math_fl3_fl_to_fl3(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(size), 512, [&](IndexRange range) {
-          for (const int i : range) {
-            const float3 a = span_a[i];
-            const float b = span_b[i];
-            const float3 out = math_function(a, b);
-            span_result[i] = out;
-          }
+          devirtualize_varray2(varray_a, varray_b, [&](const auto &a, const auto &b) {
+            for (const int i : range) {
+              span_result[i] = math_function(a[i], b[i]);
+            }
+          });
         });
       });
 
@@ -335,17 +332,17 @@ static void do_math_operation_fl3_to_fl3(const VArray<float3> &input_a,
 {
   const int size = input_a.size();
 
-  VArray_Span<float3> span_a{input_a};
+  VArray_SpanOrSingle<float3> varray_a{input_a};
   VMutableArray_Span<float3> span_result{result, false};
 
   bool success = try_dispatch_float_math_fl3_to_fl3(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(size), 512, [&](IndexRange range) {
-          for (const int i : range) {
-            const float3 in = span_a[i];
-            const float3 out = math_function(in);
-            span_result[i] = out;
-          }
+          devirtualize_varray(varray_a, [&](const auto &in) {
+            for (const int i : range) {
+              span_result[i] = math_function(in[i]);
+            }
+          });
         });
       });
 
@@ -362,17 +359,17 @@ static void do_math_operation_fl3_to_fl(const VArray<float3> &input_a,
 {
   const int size = input_a.size();
 
-  VArray_Span<float3> span_a{input_a};
+  VArray_SpanOrSingle<float3> varray_a{input_a};
   VMutableArray_Span<float> span_result{result, false};
 
   bool success = try_dispatch_float_math_fl3_to_fl(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
         threading::parallel_for(IndexRange(size), 512, [&](IndexRange range) {
-          for (const int i : range) {
-            const float3 in = span_a[i];
-            const float out = math_function(in);
-            span_result[i] = out;
-          }
+          devirtualize_varray(varray_a, [&](const auto &in) {
+            for (const int i : range) {
+              span_result[i] = math_function(in[i]);
+            }
+          });
         });
       });
 
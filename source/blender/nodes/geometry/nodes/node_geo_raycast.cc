@@ -98,21 +98,30 @@ static void raycast_to_mesh(const Mesh *mesh,
   BKE_bvhtree_from_mesh_get(&tree_data, const_cast<Mesh *>(mesh), BVHTREE_FROM_LOOPTRI, 4);
 
   if (tree_data.tree != nullptr) {
+    const int rays_num = ray_origins.size();
+    Array<float3> origins(rays_num);
+    Array<float3> directions(rays_num);
+    Array<BVHTreeRayHit> hits(rays_num);
     for (const int i : ray_origins.index_range()) {
-      const float ray_length = ray_lengths[i];
-      const float3 ray_origin = ray_origins[i];
-      const float3 ray_direction = ray_directions[i].normalized();
-
-      BVHTreeRayHit hit;
-      hit.index = -1;
-      hit.dist = ray_length;
-      if (BLI_bvhtree_ray_cast(tree_data.tree,
-                               ray_origin,
-                               ray_direction,
+      origins[i] = ray_origins[i];
+      directions[i] = ray_directions[i].normalized();
+      hits[i].index = -1;
+      hits[i].dist = ray_lengths[i];
+    }
+
+    BLI_bvhtree_ray_cast_batch(tree_data.tree,
+                               (const float(*)[3])origins.data(),
+                               (const float(*)[3])directions.data(),
+                               rays_num,
                                0.0f,
-                               &hit,
+                               hits.data(),
                                tree_data.raycast_callback,
-                               &tree_data) != -1) {
+                               &tree_data,
+                               BVH_RAYCAST_DEFAULT);
+
+    for (const int i : ray_origins.index_range()) {
+      const BVHTreeRayHit &hit = hits[i];
+      if (hit.index != -1) {
         if (!r_hit.is_empty()) {
           r_hit[i] = hit.index >= 0;
         }
@@ -144,7 +153,7 @@ static void raycast_to_mesh(const Mesh *mesh,
           r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
         }
         if (!r_hit_distances.is_empty()) {
-          r_hit_distances[i] = ray_length;
+          r_hit_distances[i] = ray_lengths[i];
         }
       }
     }
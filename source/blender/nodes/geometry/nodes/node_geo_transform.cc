@@ -25,6 +25,7 @@
 #include "DNA_volume_types.h"
 
 #include "BKE_mesh.h"
+#include "BKE_pointcloud.h"
 #include "BKE_spline.hh"
 #include "BKE_volume.h"
 
@@ -85,16 +86,11 @@ static void transform_pointcloud(PointCloud *pointcloud,
 {
   /* Use only translation if rotation and scale don't apply. */
   if (use_translate(rotation, scale)) {
-    for (const int i : IndexRange(pointcloud->totpoint)) {
-      add_v3_v3(pointcloud->co[i], translation);
-    }
+    BKE_pointcloud_translate(pointcloud, translation);
   }
   else {
     const float4x4 matrix = float4x4::from_loc_eul_scale(translation, rotation, scale);
-    for (const int i : IndexRange(pointcloud->totpoint)) {
-      float3 &co = *(float3 *)pointcloud->co[i];
-      co = matrix * co;
-    }
+    BKE_pointcloud_transform(pointcloud, matrix.values);
   }
 }
 
@@ -242,6 +242,25 @@ void DataTypeConversions::convert_to_uninitialized(const CPPType &from_type,
   functions->convert_single_to_uninitialized(from_value, to_value);
 }
 
+/**
+ * Convert the masked values of the virtual array with the conversion multi-function. Only the
+ * masked indices are read from the original virtual array, and the multi-function has fast paths
+ * for spans and single values. This is much faster than converting every value on its own.
+ */
+static void convert_masked_to_uninitialized(const ConversionFunctions &conversions,
+                                            const GVArray &varray,
+                                            const CPPType &to_type,
+                                            const IndexMask mask,
+                                            void *dst)
+{
+  const fn::MultiFunction &multi_function = *conversions.multi_function;
+  fn::MFParamsBuilder params{multi_function, mask.min_array_size()};
+  params.add_readonly_single_input(varray);
+  params.add_uninitialized_single_output(fn::GMutableSpan(to_type, dst, mask.min_array_size()));
+  fn::MFContextBuilder context;
+  multi_function.call(mask, params, context);
+}
+
 class GVArray_For_ConvertedGVArray : public GVArray {
  private:
   GVArrayPtr varray_;
@@ -273,6 +292,30 @@ class GVArray_For_ConvertedGVArray : public GVArray {
     old_to_new_conversions_.convert_single_to_uninitialized(buffer, r_value);
     from_type_.destruct(buffer);
   }
+
+  bool is_single_impl() const override
+  {
+    return varray_->is_single();
+  }
+
+  void get_internal_single_impl(void *r_value) const override
+  {
+    BUFFER_FOR_CPP_TYPE_VALUE(from_type_, buffer);
+    varray_->get_single_to_uninitialized(buffer);
+    old_to_new_conversions_.convert_single_to_initialized(buffer, r_value);
+    from_type_.destruct(buffer);
+  }
+
+  void materialize_impl(const IndexMask mask, void *dst) const override
+  {
+    type_->destruct_indices(dst, mask);
+    this->materialize_to_uninitialized_impl(mask, dst);
+  }
+
+  void materialize_to_uninitialized_impl(const IndexMask mask, void *dst) const override
+  {
+    convert_masked_to_uninitialized(old_to_new_conversions_, *varray_, *type_, mask, dst);
+  }
 };
 
 class GVMutableArray_For_ConvertedGVMutableArray : public GVMutableArray {
@@ -317,6 +360,17 @@ class GVMutableArray_For_ConvertedGVMutableArray : public GVMutableArray {
     new_to_old_conversions_.convert_single_to_uninitialized(value, buffer);
     varray_->set_by_relocate(index, buffer);
   }
+
+  void materialize_impl(const IndexMask mask, void *dst) const override
+  {
+    type_->destruct_indices(dst, mask);
+    this->materialize_to_uninitialized_impl(mask, dst);
+  }
+
+  void materialize_to_uninitialized_impl(const IndexMask mask, void *dst) const override
+  {
+    convert_masked_to_uninitialized(old_to_new_conversions_, *varray_, *type_, mask, dst);
+  }
 };
 
 fn::GVArrayPtr DataTypeConversions::try_convert(fn::GVArrayPtr varray,
@@ -26,7 +26,8 @@
 
 #include <Python.h>
 
-#include <float.h> /* FLT_MIN/MAX */
+#include <float.h>  /* FLT_MIN/MAX */
+#include <limits.h> /* CHAR_MIN */
 #include <stddef.h>
 
 #include "RNA_types.h"
@@ -5456,6 +5457,231 @@ static PyObject *pyrna_prop_collection_foreach_set(BPy_PropertyRNA *self, PyObje
   return foreach_getset(self, args, 1);
 }
 
+/* --- collection view: start --- */
+/* Buffer exporter pointing directly at the attribute values of a collection's items. */
+
+static const char *foreach_view_format(RawPropertyType raw_type, bool attr_signed)
+{
+  switch (raw_type) {
+    case PROP_RAW_CHAR:
+      /* Accessed as `char` like in #RNA_property_collection_raw_get, regardless of the property
+       * sub-type. Whether that is signed depends on the platform. */
+      return (CHAR_MIN < 0) ? "b" : "B";
+    case PROP_RAW_SHORT:
+      return attr_signed ? "h" : "H";
+    case PROP_RAW_INT:
+      return attr_signed ? "i" : "I";
+    case PROP_RAW_BOOLEAN:
+      return "?";
+    case PROP_RAW_FLOAT:
+      return "f";
+    case PROP_RAW_DOUBLE:
+      return "d";
+    case PROP_RAW_UNSET:
+      break;
+  }
+  BLI_assert_unreachable();
+  return NULL;
+}
+
+static int pyrna_prop_collection_view_getbuffer(BPy_PropertyCollectionViewRNA *self,
+                                                Py_buffer *view,
+                                                int flags)
+{
+  const Py_ssize_t itemsize = RNA_raw_type_sizeof(self->raw.type);
+  const Py_ssize_t item_len = (self->ndim == 2) ? self->shape[1] : 1;
+  const bool is_contiguous = (self->strides[0] == item_len * itemsize);
+
+  view->obj = NULL;
+  if (self->owner_id != NULL && !PYRNA_STRUCT_IS_VALID(self->owner_id)) {
+    PyErr_SetString(PyExc_ReferenceError,
+                    "foreach_view: the data-block owning the collection has been removed");
+    return -1;
+  }
+  if ((flags & PyBUF_WRITABLE) && self->readonly) {
+    PyErr_SetString(PyExc_BufferError, "foreach_view: collection data is read-only");
+    return -1;
+  }
+  if (!is_contiguous &&
+      (((flags & PyBUF_STRIDES) != PyBUF_STRIDES) ||
+       (flags & (PyBUF_C_CONTIGUOUS | PyBUF_F_CONTIGUOUS | PyBUF_ANY_CONTIGUOUS) &
+        ~PyBUF_STRIDES))) {
+    PyErr_SetString(PyExc_BufferError,
+                    "foreach_view: collection items are interleaved with other data, "
+                    "a strided buffer is required");
+    return -1;
+  }
+
+  view->obj = (PyObject *)self;
+  Py_INCREF(self);
+  view->buf = self->raw.array;
+  view->len = self->shape[0] * item_len * itemsize;
+  view->readonly = self->readonly;
+  view->itemsize = itemsize;
+  view->format = (flags & PyBUF_FORMAT) ? (char *)self->format : NULL;
+  view->ndim = (flags & PyBUF_ND) ? self->ndim : 1;
+  view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  return 0;
+}
+
+static void pyrna_prop_collection_view_dealloc(BPy_PropertyCollectionViewRNA *self)
+{
+  Py_DECREF(self->owner);
+  Py_XDECREF(self->owner_id);
+  PyObject_DEL(self);
+}
+
+static PyBufferProcs pyrna_prop_collection_view_as_buffer = {
+    (getbufferproc)pyrna_prop_collection_view_getbuffer,
+    NULL,
+};
+
+static PyTypeObject pyrna_prop_collection_view_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0) "bpy_prop_collection_view", /* tp_name */
+    sizeof(BPy_PropertyCollectionViewRNA),                     /* tp_basicsize */
+    0,                                                         /* tp_itemsize */
+    /* methods */
+    (destructor)pyrna_prop_collection_view_dealloc, /* tp_dealloc */
+    0,                                              /* tp_vectorcall_offset */
+    NULL,                                           /* getattrfunc tp_getattr; */
+    NULL,                                           /* setattrfunc tp_setattr; */
+    NULL,                                           /* tp_compare */
+    NULL,                                           /* tp_repr */
+
+    /* Method suites for standard classes */
+
+    NULL, /* PyNumberMethods *tp_as_number; */
+    NULL, /* PySequenceMethods *tp_as_sequence; */
+    NULL, /* PyMappingMethods *tp_as_mapping; */
+
+    /* More standard operations (here for binary compatibility) */
+
+    NULL, /* hashfunc tp_hash; */
+    NULL, /* ternaryfunc tp_call; */
+    NULL, /* reprfunc tp_str; */
+    NULL, /* getattrofunc tp_getattro; */
+    NULL, /* setattrofunc tp_setattro; */
+
+    /* Functions to access object as input/output buffer */
+    &pyrna_prop_collection_view_as_buffer, /* PyBufferProcs *tp_as_buffer; */
+
+    /*** Flags to define presence of optional/expanded features ***/
+    Py_TPFLAGS_DEFAULT, /* long tp_flags; */
+
+    NULL, /*  char *tp_doc;  Documentation string */
+};
+
+PyDoc_STRVAR(
+    pyrna_prop_collection_foreach_view_doc,
+    ".. method:: foreach_view(attr)\n"
+    "\n"
+    "   Access an attribute of all items in the collection without copying, when the items\n"
+    "   are stored in an array.\n"
+    "\n"
+    "   :arg attr: Name of a boolean, int or float attribute of the collection items.\n"
+    "   :type attr: string\n"
+    "   :return: View with one row per item, read-only for data that can't be edited.\n"
+    "   :rtype: memoryview\n"
+    "\n"
+    "   .. warning::\n"
+    "\n"
+    "      The view is invalid once items are added or removed or the data-block is removed,\n"
+    "      using it afterwards may crash. Writing to the view doesn't trigger updates.\n"
+    "      Evaluated data-blocks are not supported, their arrays are replaced on every update.\n");
+static PyObject *pyrna_prop_collection_foreach_view(BPy_PropertyRNA *self, PyObject *args)
+{
+  const char *attr;
+  PointerRNA itemptr_base;
+  PropertyRNA *itemprop;
+  RawArray raw;
+  bool editable;
+
+  PYRNA_PROP_CHECK_OBJ(self);
+
+  if (!PyArg_ParseTuple(args, "s:foreach_view", &attr)) {
+    return NULL;
+  }
+
+  RNA_pointer_create(
+      NULL, RNA_property_pointer_type(&self->ptr, self->prop), NULL, &itemptr_base);
+  itemprop = RNA_struct_find_property(&itemptr_base, attr);
+  if (itemprop == NULL) {
+    PyErr_Format(PyExc_AttributeError,
+                 "foreach_view '%.200s.%200s[...]' elements have no attribute '%.200s'",
+                 RNA_struct_identifier(self->ptr.type),
+                 RNA_property_identifier(self->prop),
+                 attr);
+    return NULL;
+  }
+
+  if (!ELEM(RNA_property_type(itemprop), PROP_BOOLEAN, PROP_INT, PROP_FLOAT) ||
+      (RNA_property_flag(itemprop) & PROP_DYNAMIC) ||
+      !RNA_property_collection_raw_array_ex(&self->ptr, self->prop, itemprop, &raw, &editable)) {
+    PyErr_Format(PyExc_TypeError,
+                 "foreach_view '%.200s.%200s[...]' elements attribute '%.200s' isn't stored in "
+                 "an array, use foreach_get/set instead",
+                 RNA_struct_identifier(self->ptr.type),
+                 RNA_property_identifier(self->prop),
+                 attr);
+    return NULL;
+  }
+
+  /* Evaluated data-blocks get new arrays on every depsgraph update, without invalidating the
+   * Python objects referencing them. */
+  ID *id = self->ptr.owner_id;
+  if (id != NULL && (id->tag & LIB_TAG_COPIED_ON_WRITE)) {
+    PyErr_Format(PyExc_TypeError,
+                 "foreach_view '%.200s.%200s[...]' is not supported for evaluated data, "
+                 "use foreach_get instead",
+                 RNA_struct_identifier(self->ptr.type),
+                 RNA_property_identifier(self->prop));
+    return NULL;
+  }
+
+  /* The Python object of the ID is invalidated when the ID is freed. */
+  PyObject *owner_id = NULL;
+  if (id != NULL) {
+    owner_id = pyrna_id_CreatePyObject(id);
+    if (owner_id == NULL) {
+      return NULL;
+    }
+  }
+
+  BPy_PropertyCollectionViewRNA *view = PyObject_New(BPy_PropertyCollectionViewRNA,
+                                                     &pyrna_prop_collection_view_Type);
+  view->owner = (PyObject *)self;
+  Py_INCREF(self);
+  view->owner_id = owner_id;
+  view->raw = raw;
+  view->format = foreach_view_format(raw.type, RNA_property_subtype(itemprop) != PROP_UNSIGNED);
+  view->readonly = !editable;
+
+  const Py_ssize_t itemsize = RNA_raw_type_sizeof(raw.type);
+  const int item_len = RNA_property_array_length(&itemptr_base, itemprop);
+  view->shape[0] = raw.len;
+  view->strides[0] = raw.stride;
+  if (item_len > 0) {
+    view->ndim = 2;
+    view->shape[1] = item_len;
+    view->strides[1] = itemsize;
+  }
+  else {
+    view->ndim = 1;
+  }
+  if (raw.len == 0) {
+    view->strides[0] = itemsize * MAX2(item_len, 1);
+  }
+
+  PyObject *ret = PyMemoryView_FromObject((PyObject *)view);
+  Py_DECREF(view);
+  return ret;
+}
+
+/* --- collection view: end --- */
+
 static PyObject *pyprop_array_foreach_getset(BPy_PropertyArrayRNA *self,
                                              PyObject *args,
                                              const bool do_set)
@@ -5793,6 +6019,10 @@ static struct PyMethodDef pyrna_prop_collection_methods[] = {
      (PyCFunction)pyrna_prop_collection_foreach_set,
      METH_VARARGS,
      pyrna_prop_collection_foreach_set_doc},
+    {"foreach_view",
+     (PyCFunction)pyrna_prop_collection_foreach_view,
+     METH_VARARGS,
+     pyrna_prop_collection_foreach_view_doc},
 
     {"keys", (PyCFunction)pyrna_prop_collection_keys, METH_NOARGS, pyrna_prop_collection_keys_doc},
     {"items",
@@ -7660,6 +7890,10 @@ void BPY_rna_init(void)
     return;
   }
 
+  if (PyType_Ready(&pyrna_prop_collection_view_Type) < 0) {
+    return;
+  }
+
 #ifdef USE_PYRNA_ITER
   if (PyType_Ready(&pyrna_prop_collection_iter_Type) < 0) {
     return;
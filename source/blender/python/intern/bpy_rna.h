@@ -168,6 +168,25 @@ typedef struct {
   CollectionPropertyIterator iter;
 } BPy_PropertyCollectionIterRNA;
 
+typedef struct {
+  PyObject_HEAD /* required python macro   */
+
+  /** Collection owning the data, kept alive as long as the view exists. */
+  PyObject *owner;
+  /**
+   * Python object of the ID owning the data (may be NULL). It is invalidated when the ID is freed,
+   * after which no new buffers are exported.
+   */
+  PyObject *owner_id;
+  /** Attribute values of all collection items. */
+  RawArray raw;
+  const char *format;
+  bool readonly;
+  int ndim;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+} BPy_PropertyCollectionViewRNA;
+
 typedef struct {
   PyObject_HEAD /* required python macro   */
 #ifdef USE_WEAKREFS
@@ -405,7 +405,7 @@ void RE_engine_end_result(
   if (!cancel || merge_results) {
     if (re->result->do_exr_tile) {
       if (!cancel && merge_results) {
-        render_result_exr_file_merge(re->result, result, re->viewname);
+        render_result_exr_file_merge(re, re->result, result, re->viewname);
         render_result_merge(re->result, result);
       }
     }
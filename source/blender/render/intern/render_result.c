@@ -35,6 +35,7 @@
 #include "BLI_rect.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -1085,47 +1086,218 @@ void render_result_single_layer_end(Render *re)
 
 /************************* EXR Tile File Rendering ***************************/
 
-static void save_render_result_tile(RenderResult *rr, RenderResult *rrpart, const char *viewname)
+/* Tiles are copied and written to the EXR files by tasks of the scheduler, so rendering can
+ * continue while tiles are being compressed, and tiles of different layers are written by
+ * multiple threads at the same time. The amount of copied tile memory is limited, tiles are
+ * written directly by the merging thread when it is exceeded. Merging must not wait for the
+ * tasks, render engines merge from tasks of the same scheduler. */
+#define EXR_TILE_QUEUE_MAX_PENDING_SIZE ((size_t)512 * 1024 * 1024)
+
+/* EXR file of a render layer, the handle is not safe for concurrent writes. */
+typedef struct ExrTileFile {
+  struct ExrTileFile *next, *prev;
+  void *exrhandle;
+  ThreadMutex mutex;
+} ExrTileFile;
+
+typedef struct ExrTileQueue {
+  TaskPool *pool;
+  ListBase files;
+
+  /* Protects the pending size. */
+  ThreadMutex mutex;
+  size_t pending_size;
+} ExrTileQueue;
+
+typedef struct ExrTileChannel {
+  char fullname[EXR_PASS_MAXNAME];
+  int xstride;
+  /* Offset of the first value of the channel in the tile buffer. */
+  size_t offset;
+} ExrTileChannel;
+
+/* Copy of all passes of a layer in one tile. */
+typedef struct ExrTileWrite {
+  ExrTileQueue *queue;
+  ExrTileFile *file;
+  char layername[RE_MAXNAME];
+  char viewname[EXR_VIEW_MAXNAME];
+  int partx, party, rectx;
+
+  ExrTileChannel *channels;
+  int totchannel;
+  float *buffer;
+  size_t size;
+} ExrTileWrite;
+
+static ExrTileQueue *exr_tile_queue_create(Render *re)
 {
-  RenderLayer *rlp, *rl;
-  RenderPass *rpassp;
-  int partx, party;
+  ExrTileQueue *queue = MEM_callocN(sizeof(ExrTileQueue), "ExrTileQueue");
 
-  BLI_thread_lock(LOCK_IMAGE);
+  /* Not a background pool, that runs all tasks on a single thread. */
+  queue->pool = BLI_task_pool_create(queue, TASK_PRIORITY_HIGH);
+  BLI_mutex_init(&queue->mutex);
 
-  for (rlp = rrpart->layers.first; rlp; rlp = rlp->next) {
-    rl = RE_GetRenderLayer(rr, rlp->name);
+  for (RenderResult *rr = re->result; rr; rr = rr->next) {
+    LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
+      ExrTileFile *file = MEM_callocN(sizeof(ExrTileFile), "ExrTileFile");
+      file->exrhandle = rl->exrhandle;
+      BLI_mutex_init(&file->mutex);
+      BLI_addtail(&queue->files, file);
+    }
+  }
 
-    /* should never happen but prevents crash if it does */
-    BLI_assert(rl);
-    if (UNLIKELY(rl == NULL)) {
-      continue;
+  return queue;
+}
+
+/* Wait until all tiles are written, so the EXR files can be closed. */
+static void exr_tile_queue_free(ExrTileQueue *queue)
+{
+  BLI_task_pool_work_and_wait(queue->pool);
+  BLI_task_pool_free(queue->pool);
+  BLI_assert(queue->pending_size == 0);
+
+  LISTBASE_FOREACH (ExrTileFile *, file, &queue->files) {
+    BLI_mutex_end(&file->mutex);
+  }
+  BLI_freelistN(&queue->files);
+
+  BLI_mutex_end(&queue->mutex);
+  MEM_freeN(queue);
+}
+
+static ExrTileFile *exr_tile_queue_find_file(ExrTileQueue *queue, void *exrhandle)
+{
+  LISTBASE_FOREACH (ExrTileFile *, file, &queue->files) {
+    if (file->exrhandle == exrhandle) {
+      return file;
     }
+  }
+  return NULL;
+}
 
-    /* passes are allocated in sync */
-    for (rpassp = rlp->passes.first; rpassp; rpassp = rpassp->next) {
-      const int xstride = rpassp->channels;
-      int a;
-      char fullname[EXR_PASS_MAXNAME];
+static void exr_tile_write_run(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  ExrTileWrite *write = taskdata;
+  ExrTileFile *file = write->file;
+  ExrTileQueue *queue = write->queue;
+
+  BLI_mutex_lock(&file->mutex);
+  for (int i = 0; i < write->totchannel; i++) {
+    const ExrTileChannel *channel = &write->channels[i];
+    IMB_exr_set_channel(file->exrhandle,
+                        write->layername,
+                        channel->fullname,
+                        channel->xstride,
+                        channel->xstride * write->rectx,
+                        write->buffer + channel->offset);
+  }
+  IMB_exrtile_write_channels(
+      file->exrhandle, write->partx, write->party, 0, write->viewname, false);
+  BLI_mutex_unlock(&file->mutex);
+
+  MEM_freeN(write->channels);
+  MEM_freeN(write->buffer);
+
+  BLI_mutex_lock(&queue->mutex);
+  queue->pending_size -= write->size;
+  BLI_mutex_unlock(&queue->mutex);
+}
 
-      for (a = 0; a < xstride; a++) {
-        set_pass_full_name(fullname, rpassp->name, a, viewname, rpassp->chan_id);
-
-        IMB_exr_set_channel(rl->exrhandle,
-                            rlp->name,
-                            fullname,
-                            xstride,
-                            xstride * rrpart->rectx,
-                            rpassp->rect + a);
-      }
+/* Write the passes of a layer in a tile without copying them, on the calling thread. */
+static void exr_tile_write_direct(ExrTileFile *file,
+                                  RenderResult *rrpart,
+                                  RenderLayer *rlp,
+                                  const char *viewname)
+{
+  BLI_mutex_lock(&file->mutex);
+
+  /* passes are allocated in sync */
+  LISTBASE_FOREACH (RenderPass *, rpassp, &rlp->passes) {
+    const int xstride = rpassp->channels;
+    char fullname[EXR_PASS_MAXNAME];
+
+    for (int a = 0; a < xstride; a++) {
+      set_pass_full_name(fullname, rpassp->name, a, viewname, rpassp->chan_id);
+
+      IMB_exr_set_channel(file->exrhandle,
+                          rlp->name,
+                          fullname,
+                          xstride,
+                          xstride * rrpart->rectx,
+                          rpassp->rect + a);
+    }
+  }
+  IMB_exrtile_write_channels(
+      file->exrhandle, rrpart->tilerect.xmin, rrpart->tilerect.ymin, 0, viewname, false);
+
+  BLI_mutex_unlock(&file->mutex);
+}
+
+static size_t exr_tile_write_len(RenderResult *rrpart, RenderLayer *rlp, int *r_totchannel)
+{
+  const size_t tile_len = (size_t)rrpart->rectx * (size_t)rrpart->recty;
+  int totchannel = 0;
+  size_t buffer_len = 0;
+  LISTBASE_FOREACH (RenderPass *, rpassp, &rlp->passes) {
+    totchannel += rpassp->channels;
+    buffer_len += tile_len * rpassp->channels;
+  }
+  if (r_totchannel) {
+    *r_totchannel = totchannel;
+  }
+  return buffer_len;
+}
+
+static ExrTileWrite *exr_tile_write_new(ExrTileQueue *queue,
+                                        ExrTileFile *file,
+                                        RenderResult *rrpart,
+                                        RenderLayer *rlp,
+                                        const char *viewname)
+{
+  const size_t tile_len = (size_t)rrpart->rectx * (size_t)rrpart->recty;
+  int totchannel;
+  const size_t buffer_len = exr_tile_write_len(rrpart, rlp, &totchannel);
+
+  ExrTileWrite *write = MEM_callocN(sizeof(ExrTileWrite), "ExrTileWrite");
+  write->queue = queue;
+  write->file = file;
+  BLI_strncpy(write->layername, rlp->name, sizeof(write->layername));
+  BLI_strncpy(write->viewname, viewname, sizeof(write->viewname));
+  write->partx = rrpart->tilerect.xmin;
+  write->party = rrpart->tilerect.ymin;
+  write->rectx = rrpart->rectx;
+  write->totchannel = totchannel;
+  write->channels = MEM_malloc_arrayN(
+      MAX2(totchannel, 1), sizeof(ExrTileChannel), "ExrTileWrite channels");
+  write->buffer = MEM_malloc_arrayN(MAX2(buffer_len, 1), sizeof(float), "ExrTileWrite buffer");
+  write->size = buffer_len * sizeof(float);
+
+  /* passes are allocated in sync */
+  ExrTileChannel *channel = write->channels;
+  size_t offset = 0;
+  LISTBASE_FOREACH (RenderPass *, rpassp, &rlp->passes) {
+    const int xstride = rpassp->channels;
+    memcpy(write->buffer + offset, rpassp->rect, sizeof(float) * tile_len * xstride);
+
+    for (int a = 0; a < xstride; a++, channel++) {
+      set_pass_full_name(channel->fullname, rpassp->name, a, viewname, rpassp->chan_id);
+      channel->xstride = xstride;
+      channel->offset = offset + a;
     }
+    offset += tile_len * xstride;
   }
 
-  party = rrpart->tilerect.ymin;
-  partx = rrpart->tilerect.xmin;
+  return write;
+}
 
-  for (rlp = rrpart->layers.first; rlp; rlp = rlp->next) {
-    rl = RE_GetRenderLayer(rr, rlp->name);
+static void save_render_result_tile(ExrTileQueue *queue,
+                                    RenderResult *rr,
+                                    RenderResult *rrpart,
+                                    const char *viewname)
+{
+  LISTBASE_FOREACH (RenderLayer *, rlp, &rrpart->layers) {
+    RenderLayer *rl = RE_GetRenderLayer(rr, rlp->name);
 
     /* should never happen but prevents crash if it does */
     BLI_assert(rl);
@@ -1133,10 +1305,32 @@ static void save_render_result_tile(RenderResult *rr, RenderResult *rrpart, cons
       continue;
     }
 
-    IMB_exrtile_write_channels(rl->exrhandle, partx, party, 0, viewname, false);
-  }
+    ExrTileFile *file = exr_tile_queue_find_file(queue, rl->exrhandle);
+    BLI_assert(file);
+    if (UNLIKELY(file == NULL)) {
+      continue;
+    }
 
-  BLI_thread_unlock(LOCK_IMAGE);
+    /* Always allow one write, in case a single tile is larger than the limit. */
+    const size_t size = exr_tile_write_len(rrpart, rlp, NULL) * sizeof(float);
+    BLI_mutex_lock(&queue->mutex);
+    const bool use_queue = (queue->pending_size == 0 ||
+                            queue->pending_size + size <= EXR_TILE_QUEUE_MAX_PENDING_SIZE);
+    if (use_queue) {
+      queue->pending_size += size;
+    }
+    BLI_mutex_unlock(&queue->mutex);
+
+    if (!use_queue) {
+      exr_tile_write_direct(file, rrpart, rlp, viewname);
+      continue;
+    }
+
+    ExrTileWrite *write = exr_tile_write_new(queue, file, rrpart, rlp, viewname);
+
+    /* Push without holding the lock, the task runs immediately when threading is disabled. */
+    BLI_task_pool_push(queue->pool, exr_tile_write_run, write, true, NULL);
+  }
 }
 
 void render_result_save_empty_result_tiles(Render *re)
@@ -1144,6 +1338,11 @@ void render_result_save_empty_result_tiles(Render *re)
   RenderResult *rr;
   RenderLayer *rl;
 
+  /* Tiles that are still being written must not be overwritten by empty tiles. */
+  if (re->exr_tile_queue) {
+    BLI_task_pool_work_and_wait(re->exr_tile_queue->pool);
+  }
+
   for (rr = re->result; rr; rr = rr->next) {
     for (rl = rr->layers.first; rl; rl = rl->next) {
       GHashIterator pa_iter;
@@ -1224,6 +1423,8 @@ void render_result_exr_file_begin(Render *re, RenderEngine *engine)
       IMB_exrtile_begin_write(rl->exrhandle, str, 0, rr->rectx, rr->recty, re->partx, re->party);
     }
   }
+
+  re->exr_tile_queue = exr_tile_queue_create(re);
 }
 
 /* end write of exr tile file, read back first sample */
@@ -1233,6 +1434,12 @@ void render_result_exr_file_end(Render *re, RenderEngine *engine)
   struct StampData *stamp_data = re->result->stamp_data;
   re->result->stamp_data = NULL;
 
+  /* Finish writing tiles. */
+  if (re->exr_tile_queue) {
+    exr_tile_queue_free(re->exr_tile_queue);
+    re->exr_tile_queue = NULL;
+  }
+
   /* Close EXR files. */
   for (RenderResult *rr = re->result; rr; rr = rr->next) {
     LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
@@ -1277,10 +1484,18 @@ void render_result_exr_file_end(Render *re, RenderEngine *engine)
 }
 
 /* save part into exr file */
-void render_result_exr_file_merge(RenderResult *rr, RenderResult *rrpart, const char *viewname)
+void render_result_exr_file_merge(Render *re,
+                                  RenderResult *rr,
+                                  RenderResult *rrpart,
+                                  const char *viewname)
 {
+  BLI_assert(re->exr_tile_queue);
+  if (UNLIKELY(re->exr_tile_queue == NULL)) {
+    return;
+  }
+
   for (; rr && rrpart; rr = rr->next, rrpart = rrpart->next) {
-    save_render_result_tile(rr, rrpart, viewname);
+    save_render_result_tile(re->exr_tile_queue, rr, rrpart, viewname);
   }
 }
 
@@ -93,7 +93,8 @@ struct RenderPass *render_layer_add_pass(struct RenderResult *rr,
                                          const char *viewname,
                                          const char *chan_id);
 
-void render_result_exr_file_merge(struct RenderResult *rr,
+void render_result_exr_file_merge(struct Render *re,
+                                  struct RenderResult *rr,
                                   struct RenderResult *rrpart,
                                   const char *viewname);
 
@@ -118,6 +118,10 @@ struct Render {
   ThreadRWMutex partsmutex;
   struct GHash *parts;
 
+  /* Tiles waiting to be written to the save buffers EXR files, only set while rendering with
+   * save buffers. */
+  struct ExrTileQueue *exr_tile_queue;
+
   /* render engine */
   struct RenderEngine *engine;
 
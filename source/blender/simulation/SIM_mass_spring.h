@@ -43,6 +43,8 @@ typedef enum eMassSpringSolverStatus {
 struct Implicit_Data *SIM_mass_spring_solver_create(int numverts, int numsprings);
 void SIM_mass_spring_solver_free(struct Implicit_Data *id);
 int SIM_mass_spring_solver_numvert(struct Implicit_Data *id);
+/* Solve with the multi-threaded block sparse solver instead of the serial one. */
+void SIM_mass_spring_solver_use_parallel(struct Implicit_Data *id, bool use_parallel);
 
 int SIM_cloth_solver_init(struct Object *ob, struct ClothModifierData *clmd);
 void SIM_cloth_solver_free(struct ClothModifierData *clmd);
@@ -1305,6 +1305,9 @@ int SIM_cloth_solve(
     zero_v3(cloth->average_acceleration);
   }
 
+  SIM_mass_spring_solver_use_parallel(
+      id, (clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_PARALLEL_SOLVER) != 0);
+
   while (step < tf) {
     ImplicitSolverResult result;
 
@@ -34,6 +34,8 @@
 #  include "DNA_texture_types.h"
 
 #  include "BLI_math.h"
+#  include "BLI_simd.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -658,6 +660,179 @@ DO_INLINE void subadd_bfmatrixS_bfmatrixS(
   }
 }
 
+///////////////////////////
+/* Block compressed sparse row matrix, used by the parallel solver */
+///////////////////////////
+
+/* Number of rows handled by a single task, partial sums of reductions are accumulated per chunk
+ * and added in order afterwards, so results don't depend on the number of threads. */
+#  define BSR_CHUNK_SIZE 1024
+
+/* Square matrix of 3x3 blocks with all blocks of a row stored next to each other.
+ * Blocks are stored column-major with columns padded to 4 floats, for SIMD multiplication. */
+typedef struct BSRMatrix {
+  int rows;
+  /* Number of allocated blocks. */
+  int blocks_len;
+  /* First block of each row, the last element is the total number of blocks. */
+  int *row_offsets;
+  int *columns;
+  float (*blocks)[3][4];
+  /* Blocks of each symmetric entry of the source big matrix: the entry itself for the diagonal
+   * part and the entry and its transpose for the off-diagonal part. */
+  int (*entry_blocks)[2];
+  int entries_len;
+} BSRMatrix;
+
+static BSRMatrix *create_bsrmatrix(int rows)
+{
+  BSRMatrix *matrix = MEM_callocN(sizeof(BSRMatrix), "cloth_implicit_bsr_matrix");
+  matrix->rows = rows;
+  matrix->row_offsets = MEM_mallocN(sizeof(int) * (rows + 1), "cloth_implicit_bsr_rows");
+  return matrix;
+}
+
+static void del_bsrmatrix(BSRMatrix *matrix)
+{
+  if (matrix != NULL) {
+    MEM_SAFE_FREE(matrix->row_offsets);
+    MEM_SAFE_FREE(matrix->columns);
+    MEM_SAFE_FREE(matrix->blocks);
+    MEM_SAFE_FREE(matrix->entry_blocks);
+    MEM_freeN(matrix);
+  }
+}
+
+/* Build the block layout of a sparse symmetric big matrix with the given number of used
+ * off-diagonal entries. */
+static void bsrmatrix_build_layout(BSRMatrix *to, const fmatrix3x3 *from, int num_blocks)
+{
+  const int rows = to->rows;
+  const int entries_len = rows + num_blocks;
+  const int blocks_len = rows + 2 * num_blocks;
+  int *row_offsets = to->row_offsets;
+
+  if (blocks_len > to->blocks_len) {
+    MEM_SAFE_FREE(to->columns);
+    MEM_SAFE_FREE(to->blocks);
+    to->columns = MEM_mallocN(sizeof(int) * blocks_len, "cloth_implicit_bsr_columns");
+    to->blocks = MEM_mallocN_aligned(
+        sizeof(*to->blocks) * blocks_len, 16, "cloth_implicit_bsr_blocks");
+    to->blocks_len = blocks_len;
+  }
+  if (entries_len > to->entries_len) {
+    MEM_SAFE_FREE(to->entry_blocks);
+    to->entry_blocks = MEM_mallocN(sizeof(*to->entry_blocks) * entries_len,
+                                   "cloth_implicit_bsr_entries");
+    to->entries_len = entries_len;
+  }
+
+  /* Count blocks per row, diagonal block first. */
+  for (int i = 0; i < rows; i++) {
+    row_offsets[i] = 1;
+  }
+  for (int i = rows; i < entries_len; i++) {
+    row_offsets[from[i].r]++;
+    row_offsets[from[i].c]++;
+  }
+  int offset = 0;
+  for (int i = 0; i < rows; i++) {
+    const int count = row_offsets[i];
+    row_offsets[i] = offset;
+    offset += count;
+  }
+  row_offsets[rows] = offset;
+
+  /* Use the row offsets as insertion cursors, restored afterwards. */
+  for (int i = 0; i < rows; i++) {
+    to->columns[row_offsets[i]] = i;
+    to->entry_blocks[i][0] = to->entry_blocks[i][1] = row_offsets[i]++;
+  }
+  for (int i = rows; i < entries_len; i++) {
+    const int r = from[i].r, c = from[i].c;
+    to->columns[row_offsets[r]] = c;
+    to->entry_blocks[i][0] = row_offsets[r]++;
+    to->columns[row_offsets[c]] = r;
+    to->entry_blocks[i][1] = row_offsets[c]++;
+  }
+  for (int i = rows; i > 0; i--) {
+    row_offsets[i] = row_offsets[i - 1];
+  }
+  row_offsets[0] = 0;
+}
+
+typedef struct BSRMatrixFillData {
+  BSRMatrix *to;
+  const fmatrix3x3 *from;
+} BSRMatrixFillData;
+
+static void bsrmatrix_fill_cb(void *__restrict userdata,
+                              const int i,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BSRMatrixFillData *data = userdata;
+  const float(*m)[3] = data->from[i].m;
+  float(*block)[4] = data->to->blocks[data->to->entry_blocks[i][0]];
+  float(*block_t)[4] = data->to->blocks[data->to->entry_blocks[i][1]];
+
+  if (i < data->to->rows) {
+    /* Diagonal block, the lower triangle is only stored once. */
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 3; k++) {
+        block[j][k] = m[k][j];
+      }
+      block[j][3] = 0.0f;
+    }
+    return;
+  }
+
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 3; k++) {
+      block[j][k] = m[k][j];
+      block_t[j][k] = m[j][k];
+    }
+    block[j][3] = block_t[j][3] = 0.0f;
+  }
+}
+
+/* Copy the values of a sparse symmetric big matrix into the block layout. */
+static void bsrmatrix_fill(BSRMatrix *to, const fmatrix3x3 *from, int num_blocks)
+{
+  BSRMatrixFillData data = {.to = to, .from = from};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = BSR_CHUNK_SIZE;
+  BLI_task_parallel_range(0, to->rows + num_blocks, &data, bsrmatrix_fill_cb, &settings);
+}
+
+/* r = row of the matrix multiplied with v */
+BLI_INLINE void bsrmatrix_row_mul(float r[3], const BSRMatrix *matrix, int row, lfVector *v)
+{
+  const int *columns = matrix->columns;
+  float(*blocks)[3][4] = matrix->blocks;
+  const int end = matrix->row_offsets[row + 1];
+#  ifdef BLI_HAVE_SSE2
+  __m128 sum = _mm_setzero_ps();
+  for (int b = matrix->row_offsets[row]; b < end; b++) {
+    const float *vec = v[columns[b]];
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(blocks[b][0]), _mm_set1_ps(vec[0])));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(blocks[b][1]), _mm_set1_ps(vec[1])));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(blocks[b][2]), _mm_set1_ps(vec[2])));
+  }
+  float result[4];
+  _mm_storeu_ps(result, sum);
+  copy_v3_v3(r, result);
+#  else
+  zero_v3(r);
+  for (int b = matrix->row_offsets[row]; b < end; b++) {
+    const float *vec = v[columns[b]];
+    madd_v3_v3fl(r, blocks[b][0], vec[0]);
+    madd_v3_v3fl(r, blocks[b][1], vec[1]);
+    madd_v3_v3fl(r, blocks[b][2], vec[2]);
+  }
+#  endif
+}
+
 ///////////////////////////////////////////////////////////////////
 /* simulator start */
 ///////////////////////////////////////////////////////////////////
@@ -683,6 +858,10 @@ typedef struct Implicit_Data {
   lfVector *z;          /* target velocity in constrained directions */
   fmatrix3x3 *S;        /* filtering matrix for constraints */
   fmatrix3x3 *P, *Pinv; /* pre-conditioning matrix */
+
+  /* parallel solver data */
+  bool use_parallel_solver;
+  BSRMatrix *bsrA; /* A in block compressed sparse row layout, created on demand */
 } Implicit_Data;
 
 Implicit_Data *SIM_mass_spring_solver_create(int numverts, int numsprings)
@@ -734,9 +913,16 @@ void SIM_mass_spring_solver_free(Implicit_Data *id)
   del_lfvector(id->dV);
   del_lfvector(id->z);
 
+  del_bsrmatrix(id->bsrA);
+
   MEM_freeN(id);
 }
 
+void SIM_mass_spring_solver_use_parallel(Implicit_Data *id, bool use_parallel)
+{
+  id->use_parallel_solver = use_parallel;
+}
+
 /* ==== Transformation from/to root reference frames ==== */
 
 BLI_INLINE void world_to_root_v3(Implicit_Data *data, int index, float r[3], const float v[3])
@@ -1151,6 +1337,236 @@ static int cg_filtered_pre(lfVector *dv,
 }
 #  endif
 
+/* ==== Parallel preconditioned conjugate gradient ==== */
+
+typedef struct CGParallelData {
+  const BSRMatrix *A;
+  const fmatrix3x3 *S;
+  /* Inverse of the diagonal blocks of A, used as block Jacobi preconditioner. */
+  float (*Pinv)[3][3];
+  int numverts;
+
+  lfVector *dV, *B, *r, *c, *q;
+  float alpha, beta;
+
+  /* Partial sums of dot products for each chunk. */
+  double *chunk_sums;
+} CGParallelData;
+
+BLI_INLINE void cg_chunk_range(const CGParallelData *data, int chunk, int *r_start, int *r_end)
+{
+  *r_start = chunk * BSR_CHUNK_SIZE;
+  *r_end = min_ii(*r_start + BSR_CHUNK_SIZE, data->numverts);
+}
+
+static double cg_chunk_sums_total(const CGParallelData *data, int num_chunks)
+{
+  double sum = 0.0;
+  for (int i = 0; i < num_chunks; i++) {
+    sum += data->chunk_sums[i];
+  }
+  return sum;
+}
+
+/* Pinv = inverse of the diagonal blocks of A, c = filter(Pinv * r), sum += r * c */
+static void cg_parallel_init_cb(void *__restrict userdata,
+                                const int chunk,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  double sum = 0.0;
+  for (int i = start; i < end; i++) {
+    float diag[3][3];
+    const float(*block)[4] = data->A->blocks[data->A->row_offsets[i]];
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 3; k++) {
+        diag[k][j] = block[j][k];
+      }
+    }
+    if (!invert_m3_m3(data->Pinv[i], diag)) {
+      unit_m3(data->Pinv[i]);
+    }
+
+    mul_v3_m3v3(data->c[i], data->Pinv[i], data->r[i]);
+    mul_m3_v3(data->S[i].m, data->c[i]);
+    sum += dot_v3v3(data->r[i], data->c[i]);
+  }
+  data->chunk_sums[chunk] = sum;
+}
+
+/* q = filter(A * c), sum += c * q */
+static void cg_parallel_mul_cb(void *__restrict userdata,
+                               const int chunk,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  double sum = 0.0;
+  for (int i = start; i < end; i++) {
+    bsrmatrix_row_mul(data->q[i], data->A, i, data->c);
+    mul_m3_v3(data->S[i].m, data->q[i]);
+    sum += dot_v3v3(data->c[i], data->q[i]);
+  }
+  data->chunk_sums[chunk] = sum;
+}
+
+/* dV += c * alpha, r -= q * alpha, q = Pinv * r, sum += r * q */
+static void cg_parallel_update_cb(void *__restrict userdata,
+                                  const int chunk,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  double sum = 0.0;
+  for (int i = start; i < end; i++) {
+    madd_v3_v3fl(data->dV[i], data->c[i], data->alpha);
+    madd_v3_v3fl(data->r[i], data->q[i], -data->alpha);
+    /* q is not needed anymore this iteration, reuse it for the preconditioned residual. */
+    mul_v3_m3v3(data->q[i], data->Pinv[i], data->r[i]);
+    sum += dot_v3v3(data->r[i], data->q[i]);
+  }
+  data->chunk_sums[chunk] = sum;
+}
+
+/* c = filter(q + c * beta) */
+static void cg_parallel_direction_cb(void *__restrict userdata,
+                                     const int chunk,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    VECADDS(data->c[i], data->q[i], data->c[i], data->beta);
+    mul_m3_v3(data->S[i].m, data->c[i]);
+  }
+}
+
+/* r = filter(B - A * dV), sum += filter(B) * Pinv * filter(B) (stored in q) */
+static void cg_parallel_residual_cb(void *__restrict userdata,
+                                    const int chunk,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    float AdV[3];
+    bsrmatrix_row_mul(AdV, data->A, i, data->dV);
+    sub_v3_v3v3(data->r[i], data->B[i], AdV);
+    mul_m3_v3(data->S[i].m, data->r[i]);
+
+    mul_v3_m3v3(data->q[i], data->S[i].m, data->B[i]);
+  }
+}
+
+static void cg_parallel_bnorm_cb(void *__restrict userdata,
+                                 const int chunk,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGParallelData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  double sum = 0.0;
+  for (int i = start; i < end; i++) {
+    float tmp[3];
+    mul_v3_m3v3(tmp, data->Pinv[i], data->q[i]);
+    sum += dot_v3v3(data->q[i], tmp);
+  }
+  data->chunk_sums[chunk] = sum;
+}
+
+/* Same algorithm as #cg_filtered, with a block Jacobi preconditioner. All vector operations
+ * of an iteration are fused into three passes over the vertices, split into chunks that are
+ * processed in parallel. */
+static int cg_filtered_parallel(lfVector *ldV,
+                                BSRMatrix *lA,
+                                lfVector *lB,
+                                lfVector *z,
+                                fmatrix3x3 *S,
+                                ImplicitSolverResult *result)
+{
+  unsigned int conjgrad_loopcount = 0, conjgrad_looplimit = 100;
+  float conjgrad_epsilon = 0.01f;
+
+  const int numverts = lA->rows;
+  const int num_chunks = (numverts + BSR_CHUNK_SIZE - 1) / BSR_CHUNK_SIZE;
+  double bnorm2, delta_new, delta_old, delta_target;
+
+  CGParallelData data = {
+      .A = lA,
+      .S = S,
+      .Pinv = MEM_mallocN(sizeof(float[3][3]) * numverts, "cloth_implicit_cg_pinv"),
+      .numverts = numverts,
+      .dV = ldV,
+      .B = lB,
+      .r = create_lfvector(numverts),
+      .c = create_lfvector(numverts),
+      .q = create_lfvector(numverts),
+      .chunk_sums = MEM_callocN(sizeof(double) * max_ii(num_chunks, 1), "cloth_implicit_cg"),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = num_chunks > 1;
+  settings.min_iter_per_thread = 1;
+
+  cp_lfvector(ldV, z, numverts);
+
+  /* r = filter(B - A * dV) */
+  BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_residual_cb, &settings);
+
+  /* c = filter(P^-1 * r), delta = r^T * c */
+  BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_init_cb, &settings);
+  delta_new = cg_chunk_sums_total(&data, num_chunks);
+
+  /* d0 = filter(B)^T * P^-1 * filter(B) */
+  BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_bnorm_cb, &settings);
+  bnorm2 = cg_chunk_sums_total(&data, num_chunks);
+  delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
+
+  while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
+    BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_mul_cb, &settings);
+    const double cq = cg_chunk_sums_total(&data, num_chunks);
+    if (cq == 0.0) {
+      break;
+    }
+    data.alpha = (float)(delta_new / cq);
+
+    BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_update_cb, &settings);
+    delta_old = delta_new;
+    delta_new = cg_chunk_sums_total(&data, num_chunks);
+
+    data.beta = (float)(delta_new / delta_old);
+    BLI_task_parallel_range(0, num_chunks, &data, cg_parallel_direction_cb, &settings);
+
+    conjgrad_loopcount++;
+  }
+
+  MEM_freeN(data.Pinv);
+  del_lfvector(data.r);
+  del_lfvector(data.c);
+  del_lfvector(data.q);
+  MEM_freeN(data.chunk_sums);
+
+  result->status = conjgrad_loopcount < conjgrad_looplimit ? SIM_SOLVER_SUCCESS :
+                                                             SIM_SOLVER_NO_CONVERGENCE;
+  result->iterations = conjgrad_loopcount;
+  result->error = bnorm2 > 0.0 ? (float)sqrt(delta_new / bnorm2) : 0.0f;
+
+  return conjgrad_loopcount < conjgrad_looplimit;
+}
+
 bool SIM_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSolverResult *result)
 {
   unsigned int numverts = data->dFdV[0].vcount;
@@ -1171,7 +1587,17 @@ bool SIM_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 #  endif
 
   /* Conjugate gradient algorithm to solve Ax=b. */
-  cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
+  if (data->use_parallel_solver) {
+    if (data->bsrA == NULL) {
+      data->bsrA = create_bsrmatrix(numverts);
+    }
+    bsrmatrix_build_layout(data->bsrA, data->A, data->num_blocks);
+    bsrmatrix_fill(data->bsrA, data->A, data->num_blocks);
+    cg_filtered_parallel(data->dV, data->bsrA, data->B, data->z, data->S, result);
+  }
+  else {
+    cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
+  }
 
   // cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
 
@@ -473,6 +473,11 @@ void SIM_mass_spring_solver_free(Implicit_Data *id)
   }
 }
 
+void SIM_mass_spring_solver_use_parallel(Implicit_Data *UNUSED(id), bool UNUSED(use_parallel))
+{
+  /* Eigen solver threading is controlled by Eigen itself. */
+}
+
 int SIM_mass_spring_solver_numvert(Implicit_Data *id)
 {
   if (id) {
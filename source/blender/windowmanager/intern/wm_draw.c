@@ -1035,6 +1035,10 @@ void wm_draw_update(bContext *C)
   Main *bmain = CTX_data_main(C);
   wmWindowManager *wm = CTX_wm_manager(C);
 
+  /* The next frame of the playback is evaluated in the background while drawing only. Handlers,
+   * notifiers and timers modify the original data-blocks the evaluation reads. */
+  BKE_scene_start_playback_depsgraphs(bmain);
+
   GPU_context_main_lock();
   BKE_image_free_unused_gpu_textures();
 
@@ -1075,6 +1079,8 @@ void wm_draw_update(bContext *C)
   wm_surfaces_iter(C, wm_draw_surface);
 
   GPU_context_main_unlock();
+
+  BKE_scene_wait_playback_depsgraphs(bmain);
 }
 
 void wm_draw_region_clear(wmWindow *win, ARegion *UNUSED(region))
@@ -0,0 +1,65 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --python tests/python/bl_pyapi_prop_collection.py -- --verbose
+import bpy
+import unittest
+import numpy as np
+
+
+class TestPropCollectionView(unittest.TestCase):
+    def setUp(self):
+        self.mesh = bpy.data.meshes.new("TestPropCollectionView")
+        self.mesh.vertices.add(4)
+        self.mesh.vertices.foreach_set("co", np.arange(12, dtype=np.float32))
+
+    def tearDown(self):
+        bpy.data.meshes.remove(self.mesh)
+
+    def test_foreach_view_vector(self):
+        view = self.mesh.vertices.foreach_view("co")
+        self.assertEqual(view.format, "f")
+        self.assertEqual(view.shape, (4, 3))
+        self.assertFalse(view.readonly)
+
+        a = np.asarray(view)
+        self.assertTrue(np.array_equal(a.ravel(), np.arange(12, dtype=np.float32)))
+
+        # Writes go directly to the mesh.
+        a[1] = (-1.0, -2.0, -3.0)
+        self.assertEqual(tuple(self.mesh.vertices[1].co), (-1.0, -2.0, -3.0))
+
+    def test_foreach_view_attribute(self):
+        attribute = self.mesh.attributes.new("test", 'FLOAT', 'POINT')
+        attribute.data.foreach_set("value", np.arange(4, dtype=np.float32))
+
+        view = attribute.data.foreach_view("value")
+        self.assertEqual(view.shape, (4,))
+        self.assertTrue(view.c_contiguous)
+        self.assertEqual(view.tolist(), [0.0, 1.0, 2.0, 3.0])
+
+        view[2] = 10.0
+        self.assertEqual(attribute.data[2].value, 10.0)
+
+    def test_foreach_view_errors(self):
+        with self.assertRaises(AttributeError):
+            self.mesh.vertices.foreach_view("not_an_attribute")
+
+        # Stored as bits of a flag, not an array.
+        with self.assertRaises(TypeError):
+            self.mesh.vertices.foreach_view("select")
+
+    def test_foreach_view_removed_id(self):
+        mesh = bpy.data.meshes.new("TestPropCollectionViewRemoved")
+        mesh.vertices.add(2)
+        view = mesh.vertices.foreach_view("co")
+        bpy.data.meshes.remove(mesh)
+
+        # No new buffers are exported for data of removed data-blocks.
+        with self.assertRaises(ReferenceError):
+            memoryview(view.obj)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()